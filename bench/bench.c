@@ -0,0 +1,347 @@
+/*
+*******************************************************************************
+\file bench.c
+\brief Benchmark framework
+\project bee2/bench
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/blob.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include "bench.h"
+
+/*
+*******************************************************************************
+Аппаратные счетчики
+
+Счетчики тактов и инструкций открываются одной группой с помощью
+системного вызова perf_event_open(). Учитываются только действия
+в пространстве пользователя. Если ядро не поддерживает perf_event
+или доступ к счетчикам запрещен (см. /proc/sys/kernel/perf_event_paranoid),
+то счетчики не используются.
+*******************************************************************************
+*/
+
+#if defined(__linux__)
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+typedef struct
+{
+	int fd[2];				/*< дескрипторы (такты, инструкции) */
+} bench_perf_st;
+
+static int benchPerfOpen1(u64 config, int group)
+{
+	struct perf_event_attr pe;
+	memset(&pe, 0, sizeof(pe));
+	pe.type = PERF_TYPE_HARDWARE;
+	pe.size = sizeof(pe);
+	pe.config = config;
+	pe.disabled = group == -1;
+	pe.exclude_kernel = 1;
+	pe.exclude_hv = 1;
+	pe.read_format = PERF_FORMAT_GROUP;
+	return (int)syscall(__NR_perf_event_open, &pe, 0, -1, group, 0);
+}
+
+static bool_t benchPerfOpen(bench_perf_st* perf)
+{
+	perf->fd[0] = benchPerfOpen1(PERF_COUNT_HW_CPU_CYCLES, -1);
+	if (perf->fd[0] == -1)
+		return FALSE;
+	perf->fd[1] = benchPerfOpen1(PERF_COUNT_HW_INSTRUCTIONS, perf->fd[0]);
+	if (perf->fd[1] == -1)
+	{
+		close(perf->fd[0]);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void benchPerfStart(bench_perf_st* perf)
+{
+	ioctl(perf->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(perf->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static bool_t benchPerfStop(u64* cycles, u64* insns, bench_perf_st* perf)
+{
+	u64 buf[3];
+	ioctl(perf->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	if (read(perf->fd[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf) ||
+		buf[0] != 2)
+		return FALSE;
+	*cycles = buf[1], *insns = buf[2];
+	return TRUE;
+}
+
+static void benchPerfClose(bench_perf_st* perf)
+{
+	close(perf->fd[1]);
+	close(perf->fd[0]);
+}
+
+#else
+
+typedef struct
+{
+	int dummy;
+} bench_perf_st;
+
+#define benchPerfOpen(perf) FALSE
+#define benchPerfStart(perf)
+#define benchPerfStop(cycles, insns, perf) FALSE
+#define benchPerfClose(perf)
+
+#endif
+
+/*
+*******************************************************************************
+Статистика
+
+Процентили определяются по методу ближайшего ранга на упорядоченной
+выборке.
+*******************************************************************************
+*/
+
+#define BENCH_REPS_MAX	1000	/*< максимальное число выборок */
+
+static void benchSort(double a[], size_t count)
+{
+	size_t i, j;
+	for (i = 1; i < count; ++i)
+	{
+		double t = a[i];
+		for (j = i; j && a[j - 1] > t; --j)
+			a[j] = a[j - 1];
+		a[j] = t;
+	}
+}
+
+static double benchPercentile(const double a[], size_t count, size_t p)
+{
+	size_t r;
+	ASSERT(count > 0 && p <= 100);
+	r = (p * count + 99) / 100;
+	return a[r ? r - 1 : 0];
+}
+
+/*
+*******************************************************************************
+Выполнение замера
+*******************************************************************************
+*/
+
+static bool_t benchBatch(tm_ticks_t* ticks, const bench_case* bc,
+	void* state, size_t batch)
+{
+	size_t i;
+	*ticks = tmTicks();
+	for (i = 0; i < batch; ++i)
+		if (!bc->step(state))
+			return FALSE;
+	*ticks = tmTicks() - *ticks;
+	return TRUE;
+}
+
+bool_t benchRun(bench_result* res, const bench_case* bc,
+	const bench_settings* settings)
+{
+	const double freq = (double)tmFreq();
+	tm_ticks_t target;
+	tm_ticks_t ticks;
+	bench_perf_st perf[1];
+	double times[BENCH_REPS_MAX];
+	double cycles[BENCH_REPS_MAX];
+	double insns[BENCH_REPS_MAX];
+	void* state;
+	size_t i;
+	// pre
+	ASSERT(memIsValid(res, sizeof(bench_result)));
+	ASSERT(memIsValid(bc, sizeof(bench_case)));
+	ASSERT(memIsValid(settings, sizeof(bench_settings)));
+	// подготовить результаты
+	memSetZero(res, sizeof(bench_result));
+	res->bc = bc;
+	res->reps = MAX2(settings->reps, 1);
+	res->reps = MIN2(res->reps, BENCH_REPS_MAX);
+	if (freq == 0)
+		return FALSE;
+	target = (tm_ticks_t)(freq * settings->time / 1000);
+	// подготовить состояние
+	state = blobCreate(MAX2(bc->keep, 1));
+	if (state == 0)
+		return FALSE;
+	if (!bc->start(state, bc->arg))
+	{
+		blobClose(state);
+		return FALSE;
+	}
+	// подобрать длину пакета (с прогревом)
+	for (res->batch = 1; ; res->batch *= 2)
+	{
+		if (!benchBatch(&ticks, bc, state, res->batch))
+		{
+			blobClose(state);
+			return FALSE;
+		}
+		if (ticks >= target || res->batch >= SIZE_MAX / 4)
+			break;
+	}
+	// прогрев
+	for (i = 0; i < settings->warmup; ++i)
+		if (!benchBatch(&ticks, bc, state, res->batch))
+		{
+			blobClose(state);
+			return FALSE;
+		}
+	// аппаратные счетчики
+	memSetZero(perf, sizeof(bench_perf_st));
+	res->hw = settings->perf && benchPerfOpen(perf);
+	// выборки
+	for (i = 0; i < res->reps; ++i)
+	{
+		u64 c = 0, n = 0;
+		bool_t ok;
+		if (res->hw)
+			benchPerfStart(perf);
+		ok = benchBatch(&ticks, bc, state, res->batch);
+		if (res->hw && !benchPerfStop(&c, &n, perf))
+			benchPerfClose(perf), res->hw = FALSE;
+		if (!ok)
+		{
+			if (res->hw)
+				benchPerfClose(perf);
+			blobClose(state);
+			return FALSE;
+		}
+		times[i] = (double)ticks * 1e9 / freq / (double)res->batch;
+		if (res->hw)
+		{
+			cycles[i] = (double)c / (double)res->batch;
+			insns[i] = (double)n / (double)res->batch;
+		}
+	}
+	if (res->hw)
+		benchPerfClose(perf);
+	blobClose(state);
+	// статистика
+	benchSort(times, res->reps);
+	res->median = benchPercentile(times, res->reps, 50);
+	res->p10 = benchPercentile(times, res->reps, 10);
+	res->p90 = benchPercentile(times, res->reps, 90);
+	res->min = times[0];
+	if (res->hw)
+	{
+		benchSort(cycles, res->reps);
+		benchSort(insns, res->reps);
+		res->cycles = benchPercentile(cycles, res->reps, 50);
+		res->insns = benchPercentile(insns, res->reps, 50);
+	}
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Отчеты
+
+Производные величины: число операций в секунду (по медиане) и, если
+операция обрабатывает данные, скорость обработки в МБ/с (10^6 октетов
+в секунду). В форматах JSON и CSV отсутствующие величины задаются пустыми
+значениями (null в JSON).
+*******************************************************************************
+*/
+
+static double benchOps(const bench_result* res)
+{
+	return res->median > 0 ? 1e9 / res->median : 0;
+}
+
+static double benchMBs(const bench_result* res)
+{
+	return res->median > 0 ? 1e3 * res->bc->size / res->median : 0;
+}
+
+void benchPrintStart(bench_format fmt)
+{
+	switch (fmt)
+	{
+	case bench_json:
+		printf("{\n  \"version\": \"%s\",\n  \"timer_hz\": %.0f,\n"
+			"  \"results\": [", utilVersion(), (double)tmFreq());
+		break;
+	case bench_csv:
+		printf("name,size,reps,batch,median_ns,p10_ns,p90_ns,min_ns,"
+			"ops_sec,mb_sec,cycles_op,insns_op\n");
+		break;
+	default:
+		printf("%-24s %11s %11s %11s %11s %9s %9s %9s\n", "name",
+			"median,ns", "p10,ns", "p90,ns", "ops/sec", "MB/sec",
+			"cyc/op", "ins/op");
+	}
+}
+
+void benchPrint(const bench_result* res, bench_format fmt, bool_t first)
+{
+	switch (fmt)
+	{
+	case bench_json:
+		printf("%s\n    {\"name\": \"%s\", \"size\": %u, \"reps\": %u, "
+			"\"batch\": %u, \"ns_op\": {\"median\": %.1f, \"p10\": %.1f, "
+			"\"p90\": %.1f, \"min\": %.1f}, \"ops_sec\": %.1f, ",
+			first ? "" : ",", res->bc->name, (unsigned)res->bc->size,
+			(unsigned)res->reps, (unsigned)res->batch, res->median,
+			res->p10, res->p90, res->min, benchOps(res));
+		if (res->bc->size)
+			printf("\"mb_sec\": %.2f, ", benchMBs(res));
+		else
+			printf("\"mb_sec\": null, ");
+		if (res->hw)
+			printf("\"cycles_op\": %.1f, \"insns_op\": %.1f}",
+				res->cycles, res->insns);
+		else
+			printf("\"cycles_op\": null, \"insns_op\": null}");
+		break;
+	case bench_csv:
+		printf("%s,%u,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,", res->bc->name,
+			(unsigned)res->bc->size, (unsigned)res->reps,
+			(unsigned)res->batch, res->median, res->p10, res->p90,
+			res->min, benchOps(res));
+		if (res->bc->size)
+			printf("%.2f", benchMBs(res));
+		if (res->hw)
+			printf(",%.1f,%.1f\n", res->cycles, res->insns);
+		else
+			printf(",,\n");
+		break;
+	default:
+		printf("%-24s %11.1f %11.1f %11.1f %11.1f ", res->bc->name,
+			res->median, res->p10, res->p90, benchOps(res));
+		if (res->bc->size)
+			printf("%9.1f", benchMBs(res));
+		else
+			printf("%9s", "-");
+		if (res->hw)
+			printf(" %9.1f %9.1f\n", res->cycles, res->insns);
+		else
+			printf(" %9s %9s\n", "-", "-");
+	}
+}
+
+void benchPrintStop(bench_format fmt)
+{
+	if (fmt == bench_json)
+		printf("\n  ]\n}\n");
+}
@@ -0,0 +1,175 @@
+/*
+*******************************************************************************
+\file bench.h
+\brief Benchmark framework
+\project bee2/bench
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#ifndef __BEE2_BENCH_H
+#define __BEE2_BENCH_H
+
+#include <bee2/defs.h>
+#include <bee2/core/tm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+*******************************************************************************
+\file bench.h
+
+Замер -- это многократное выполнение операции step над состоянием,
+которое подготовлено функцией start. Состояние размещается в куче
+и имеет длину keep октетов. Функция start получает параметр arg,
+что позволяет описывать одной парой (start, step) семейство замеров,
+например, для разных уровней стойкости.
+
+Операции выполняются пакетами. Длина пакета подбирается так, чтобы
+выполнение пакета занимало не меньше заданного времени. Подбор длины
+пакета совмещается с прогревом (кэши, предсказатель переходов, частота
+процессора), после подбора выполняется warmup дополнительных
+неучитываемых пакетов. Затем выполняется reps учитываемых пакетов (выборок).
+По выборкам определяются медиана, 10-й и 90-й процентили и минимум
+времени выполнения одной операции.
+
+В Linux могут дополнительно использоваться аппаратные счетчики тактов
+и инструкций (perf_event_open()). Если счетчики недоступны, то в отчете
+они не указываются.
+*******************************************************************************
+*/
+
+/*!	\brief Подготовка замера
+
+	В state подготавливается состояние замера с параметром arg.
+	\return Признак успеха.
+*/
+typedef bool_t (*bench_start_i)(
+	void* state,			/*!< [out] состояние */
+	size_t arg				/*!< [in] параметр */
+);
+
+/*!	\brief Операция замера
+
+	Выполняется одна операция над состоянием state.
+	\return Признак успеха.
+*/
+typedef bool_t (*bench_step_i)(
+	void* state				/*!< [in,out] состояние */
+);
+
+/*!	\brief Описание замера */
+typedef struct
+{
+	const char* name;		/*!< имя замера */
+	size_t size;			/*!< число октетов данных операции (или 0) */
+	size_t keep;			/*!< длина состояния */
+	bench_start_i start;	/*!< подготовка */
+	bench_step_i step;		/*!< операция */
+	size_t arg;				/*!< параметр start */
+} bench_case;
+
+/*!	\brief Настройки замеров */
+typedef struct
+{
+	size_t reps;			/*!< число выборок */
+	size_t warmup;			/*!< число прогревочных пакетов */
+	size_t time;			/*!< минимальное время пакета (мс) */
+	bool_t perf;			/*!< использовать аппаратные счетчики */
+} bench_settings;
+
+/*!	\brief Результаты замера
+
+	Времена выражаются в наносекундах на операцию.
+*/
+typedef struct
+{
+	const bench_case* bc;	/*!< замер */
+	size_t reps;			/*!< число выборок */
+	size_t batch;			/*!< длина пакета */
+	double median;			/*!< медиана */
+	double p10;				/*!< 10-й процентиль */
+	double p90;				/*!< 90-й процентиль */
+	double min;				/*!< минимум */
+	bool_t hw;				/*!< аппаратные счетчики получены */
+	double cycles;			/*!< медиана числа тактов */
+	double insns;			/*!< медиана числа инструкций */
+} bench_result;
+
+/*!	\brief Формат отчета */
+typedef enum
+{
+	bench_text,				/*!< текст */
+	bench_json,				/*!< JSON */
+	bench_csv,				/*!< CSV */
+} bench_format;
+
+/*!	\brief Выполнение замера
+
+	Выполняется замер bc с настройками settings. Результаты
+	записываются в res.
+	\return Признак успеха.
+*/
+bool_t benchRun(
+	bench_result* res,					/*!< [out] результаты */
+	const bench_case* bc,				/*!< [in] замер */
+	const bench_settings* settings		/*!< [in] настройки */
+);
+
+/*!	\brief Начало отчета
+
+	Печатается начало отчета в формате fmt.
+*/
+void benchPrintStart(
+	bench_format fmt					/*!< [in] формат */
+);
+
+/*!	\brief Результаты в отчете
+
+	Печатаются результаты res в формате fmt. Признак first указывает
+	на первый элемент отчета.
+*/
+void benchPrint(
+	const bench_result* res,			/*!< [in] результаты */
+	bench_format fmt,					/*!< [in] формат */
+	bool_t first						/*!< [in] первый элемент */
+);
+
+/*!	\brief Окончание отчета
+
+	Печатается окончание отчета в формате fmt.
+*/
+void benchPrintStop(
+	bench_format fmt					/*!< [in] формат */
+);
+
+/*!	\brief Замеры симметричных алгоритмов
+
+	Возвращается таблица замеров belt, bash, botp. Число замеров
+	записывается в count.
+	\return Таблица замеров.
+*/
+const bench_case* benchSym(
+	size_t* count						/*!< [out] число замеров */
+);
+
+/*!	\brief Замеры асимметричных алгоритмов
+
+	Возвращается таблица замеров bign, bake, bels, pfok, g12s, dstu. Число
+	замеров записывается в count.
+	\return Таблица замеров.
+*/
+const bench_case* benchPK(
+	size_t* count						/*!< [out] число замеров */
+);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __BEE2_BENCH_H */
@@ -0,0 +1,147 @@
+/*
+*******************************************************************************
+\file bench_main.c
+\brief Benchmark runner
+\project bee2/bench
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/dec.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
+#include "bench.h"
+
+/*
+*******************************************************************************
+Командная строка
+
+bee2bench [options] [prefix...]
+
+Замеры выбираются по префиксам имен (если префиксы не заданы, то
+выполняются все замеры). Опции:
+	--list            напечатать имена замеров и завершить работу;
+	--format=FMT      формат отчета: text (по умолчанию), json, csv;
+	--reps=N          число выборок (по умолчанию 11);
+	--warmup=N        число прогревочных пакетов (по умолчанию 2);
+	--time=MS         минимальное время пакета в мс (по умолчанию 20);
+	--perf            использовать аппаратные счетчики (Linux).
+*******************************************************************************
+*/
+
+static int benchUsage()
+{
+	printf(
+		"bee2bench: benchmarks for the bee2 library [v%s]\n"
+		"Usage:\n"
+		"  bee2bench [options] [prefix...]\n"
+		"  options:\n"
+		"    --list          list benchmarks\n"
+		"    --format=FMT    report format: text (default), json, csv\n"
+		"    --reps=N        number of samples (default 11)\n"
+		"    --warmup=N      number of warmup batches (default 2)\n"
+		"    --time=MS       minimal batch time in ms (default 20)\n"
+		"    --perf          use hardware counters (Linux)\n",
+		utilVersion());
+	return -1;
+}
+
+static bool_t benchArgNum(size_t* num, const char* arg, const char* opt)
+{
+	if (!strStartsWith(arg, opt))
+		return FALSE;
+	arg += strLen(opt);
+	if (!decIsValid(arg) || strLen(arg) == 0 || strLen(arg) > 6)
+		return FALSE;
+	*num = (size_t)decToU32(arg);
+	return TRUE;
+}
+
+static bool_t benchIsSelected(const bench_case* bc, int argc,
+	char* argv[])
+{
+	int i;
+	bool_t any = FALSE;
+	for (i = 1; i < argc; ++i)
+		if (!strStartsWith(argv[i], "--"))
+		{
+			any = TRUE;
+			if (strStartsWith(bc->name, argv[i]))
+				return TRUE;
+		}
+	return !any;
+}
+
+int main(int argc, char* argv[])
+{
+	bench_settings settings[1];
+	bench_format fmt = bench_text;
+	bool_t list = FALSE;
+	const bench_case* tables[2];
+	size_t counts[2];
+	size_t i, j;
+	bool_t first = TRUE;
+	int ret = 0;
+	int k;
+	// настройки по умолчанию
+	settings->reps = 11;
+	settings->warmup = 2;
+	settings->time = 20;
+	settings->perf = FALSE;
+	// разбор опций
+	for (k = 1; k < argc; ++k)
+	{
+		if (!strStartsWith(argv[k], "--"))
+			continue;
+		if (strEq(argv[k], "--list"))
+			list = TRUE;
+		else if (strEq(argv[k], "--perf"))
+			settings->perf = TRUE;
+		else if (strEq(argv[k], "--format=text"))
+			fmt = bench_text;
+		else if (strEq(argv[k], "--format=json"))
+			fmt = bench_json;
+		else if (strEq(argv[k], "--format=csv"))
+			fmt = bench_csv;
+		else if (!benchArgNum(&settings->reps, argv[k], "--reps=") &&
+			!benchArgNum(&settings->warmup, argv[k], "--warmup=") &&
+			!benchArgNum(&settings->time, argv[k], "--time="))
+			return benchUsage();
+	}
+	// таблицы замеров
+	tables[0] = benchSym(counts + 0);
+	tables[1] = benchPK(counts + 1);
+	// список
+	if (list)
+	{
+		for (i = 0; i < COUNT_OF(tables); ++i)
+			for (j = 0; j < counts[i]; ++j)
+				if (benchIsSelected(tables[i] + j, argc, argv))
+					printf("%s\n", tables[i][j].name);
+		return 0;
+	}
+	// замеры
+	benchPrintStart(fmt);
+	for (i = 0; i < COUNT_OF(tables); ++i)
+		for (j = 0; j < counts[i]; ++j)
+		{
+			bench_result res[1];
+			if (!benchIsSelected(tables[i] + j, argc, argv))
+				continue;
+			if (!benchRun(res, tables[i] + j, settings))
+			{
+				fprintf(stderr, "bee2bench: %s failed\n", tables[i][j].name);
+				ret = -1;
+				continue;
+			}
+			benchPrint(res, fmt, first);
+			first = FALSE;
+			fflush(stdout);
+		}
+	benchPrintStop(fmt);
+	return ret;
+}
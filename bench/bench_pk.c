@@ -0,0 +1,537 @@
+/*
+*******************************************************************************
+\file bench_pk.c
+\brief Benchmarks for public-key algorithms
+\project bee2/bench
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <bee2/core/err.h>
+#include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bake.h>
+#include <bee2/crypto/bels.h>
+#include <bee2/crypto/bign.h>
+#include <bee2/crypto/dstu.h>
+#include <bee2/crypto/g12s.h>
+#include <bee2/crypto/pfok.h>
+#include "bench.h"
+
+/*
+*******************************************************************************
+bign
+
+Параметр arg -- уровень стойкости l. Используются стандартные
+параметры 1.2.112.0.2.0.34.101.45.3.{1,2,3} и идентификатор belt-hash.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	bign_params params[1];		/*< параметры */
+	octet oid_der[16];			/*< идентификатор хэш-алгоритма */
+	size_t oid_len;				/*< длина oid_der */
+	octet privkey[64];			/*< личный ключ */
+	octet pubkey[128];			/*< открытый ключ */
+	octet hash[64];				/*< хэш-значение */
+	octet sig[96];				/*< подпись */
+	octet key[32];				/*< транспортируемый ключ */
+	octet token[32 + 16 + 64];	/*< токен ключа */
+	octet combo_state[256];		/*< состояние генератора */
+} bench_bign_st;
+
+static bool_t benchBignStart(void* state, size_t arg)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	const char* name;
+	switch (arg)
+	{
+	case 128: name = "1.2.112.0.2.0.34.101.45.3.1"; break;
+	case 192: name = "1.2.112.0.2.0.34.101.45.3.2"; break;
+	case 256: name = "1.2.112.0.2.0.34.101.45.3.3"; break;
+	default: return FALSE;
+	}
+	st->oid_len = sizeof(st->oid_der);
+	if (sizeof(st->combo_state) < prngCOMBO_keep() ||
+		bignParamsStd(st->params, name) != ERR_OK ||
+		bignOidToDER(st->oid_der, &st->oid_len,
+			"1.2.112.0.2.0.34.101.31.81") != ERR_OK)
+		return FALSE;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	prngCOMBOStepR(st->hash, sizeof(st->hash), st->combo_state);
+	prngCOMBOStepR(st->key, sizeof(st->key), st->combo_state);
+	return bignKeypairGen(st->privkey, st->pubkey, st->params,
+			prngCOMBOStepR, st->combo_state) == ERR_OK &&
+		bignSign(st->sig, st->params, st->oid_der, st->oid_len, st->hash,
+			st->privkey, prngCOMBOStepR, st->combo_state) == ERR_OK &&
+		bignKeyWrap(st->token, st->params, st->key, 32, 0, st->pubkey,
+			prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBignKeygenStep(void* state)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	return bignKeypairGen(st->privkey, st->pubkey, st->params,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBignSignStep(void* state)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	return bignSign(st->sig, st->params, st->oid_der, st->oid_len, st->hash,
+		st->privkey, prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBignVerifyStep(void* state)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	return bignVerify(st->params, st->oid_der, st->oid_len, st->hash,
+		st->sig, st->pubkey) == ERR_OK;
+}
+
+static bool_t benchBignWrapStep(void* state)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	return bignKeyWrap(st->token, st->params, st->key, 32, 0, st->pubkey,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBignUnwrapStep(void* state)
+{
+	bench_bign_st* st = (bench_bign_st*)state;
+	return bignKeyUnwrap(st->key, st->params, st->token,
+		32 + 16 + st->params->l / 4, 0, st->privkey) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+bake
+
+Операция -- полный сеанс протокола BMQV или BPACE (действия обеих сторон)
+на уровне стойкости 128. Ключи и сертификаты сторон взяты из таблицы Б.1
+СТБ 34.101.66.
+*******************************************************************************
+*/
+
+static const char _bake_da[] =
+	"1F66B5B84B7339674533F0329C74F218"
+	"34281FED0732429E0C79235FC273E269";
+
+static const char _bake_db[] =
+	"4C0E74B2CD5811AD21F23DE7E0FA742C"
+	"3ED6EC483C461CE15C33A77AA308B7D2";
+
+static const char _bake_certa[] =
+	"416C696365"
+	"BD1A5650179D79E03FCEE49D4C2BD5DD"
+	"F54CE46D0CF11E4FF87BF7A890857FD0"
+	"7AC6A60361E8C8173491686D461B2826"
+	"190C2EDA5909054A9AB84D2AB9D99A90";
+
+static const char _bake_certb[] =
+	"426F62"
+	"CCEEF1A313A406649D15DA0A851D486A"
+	"695B641B20611776252FFDCE39C71060"
+	"7C9EA1F33C23D20DFCB8485A88BE6523"
+	"A28ECC3215B47FA289D6C9BE1CE837C0";
+
+typedef struct
+{
+	bign_params params[1];		/*< параметры */
+	bake_settings settings[1];	/*< настройки */
+	octet da[32];				/*< личный ключ A */
+	octet db[32];				/*< личный ключ B */
+	octet certdataa[5 + 64 + 3];/*< сертификат A */
+	octet certdatab[3 + 64 + 5];/*< сертификат B */
+	bake_cert certa[1];			/*< описание сертификата A */
+	bake_cert certb[1];			/*< описание сертификата B */
+	octet msga[80];				/*< сообщение A */
+	octet msgb[80];				/*< сообщение B */
+	octet keya[32];				/*< ключ A */
+	octet keyb[32];				/*< ключ B */
+	octet sta[4096];			/*< состояние A */
+	octet stb[4096];			/*< состояние B */
+	octet combo_state[256];		/*< состояние генератора */
+} bench_bake_st;
+
+static err_t benchBakeCertVal(octet* pubkey, const bign_params* params,
+	const octet* data, size_t len)
+{
+	if (!memIsValid(params, sizeof(bign_params)) ||
+		(params->l != 128 && params->l != 192 && params->l != 256) ||
+		!memIsNullOrValid(pubkey, params->l / 2))
+		return ERR_BAD_INPUT;
+	if (!memIsValid(data, len) ||
+		len < params->l / 2)
+		return ERR_BAD_CERT;
+	if (pubkey)
+		memCopy(pubkey, data + (len - params->l / 2), params->l / 2);
+	return ERR_OK;
+}
+
+static bool_t benchBakeStart(void* state, size_t arg)
+{
+	bench_bake_st* st = (bench_bake_st*)state;
+	if (sizeof(st->combo_state) < prngCOMBO_keep() ||
+		sizeof(st->sta) < utilMax(2, bakeBMQV_keep(128),
+			bakeBPACE_keep(128)) ||
+		bignParamsStd(st->params, "1.2.112.0.2.0.34.101.45.3.1") != ERR_OK)
+		return FALSE;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	memSetZero(st->settings, sizeof(bake_settings));
+	st->settings->kca = st->settings->kcb = TRUE;
+	st->settings->rng = prngCOMBOStepR;
+	st->settings->rng_state = st->combo_state;
+	hexTo(st->da, _bake_da);
+	hexTo(st->db, _bake_db);
+	hexTo(st->certdataa, _bake_certa);
+	hexTo(st->certdatab, _bake_certb);
+	st->certa->data = st->certdataa;
+	st->certa->len = strLen(_bake_certa) / 2;
+	st->certb->data = st->certdatab;
+	st->certb->len = strLen(_bake_certb) / 2;
+	st->certa->val = st->certb->val = benchBakeCertVal;
+	return TRUE;
+}
+
+static bool_t benchBakeBMQVStep(void* state)
+{
+	bench_bake_st* st = (bench_bake_st*)state;
+	return bakeBMQVStart(st->stb, st->params, st->settings, st->db,
+			st->certb) == ERR_OK &&
+		bakeBMQVStart(st->sta, st->params, st->settings, st->da,
+			st->certa) == ERR_OK &&
+		bakeBMQVStep2(st->msgb, st->stb) == ERR_OK &&
+		bakeBMQVStep3(st->msga, st->msgb, st->certb, st->sta) == ERR_OK &&
+		bakeBMQVStep4(st->msgb, st->msga, st->certa, st->stb) == ERR_OK &&
+		bakeBMQVStep5(st->msgb, st->sta) == ERR_OK &&
+		bakeBMQVStepG(st->keya, st->sta) == ERR_OK &&
+		bakeBMQVStepG(st->keyb, st->stb) == ERR_OK &&
+		memEq(st->keya, st->keyb, 32);
+}
+
+static bool_t benchBakeBPACEStep(void* state)
+{
+	bench_bake_st* st = (bench_bake_st*)state;
+	const octet pwd[] = { '8', '0', '8', '6' };
+	return bakeBPACEStart(st->stb, st->params, st->settings, pwd,
+			sizeof(pwd)) == ERR_OK &&
+		bakeBPACEStart(st->sta, st->params, st->settings, pwd,
+			sizeof(pwd)) == ERR_OK &&
+		bakeBPACEStep2(st->msgb, st->stb) == ERR_OK &&
+		bakeBPACEStep3(st->msga, st->msgb, st->sta) == ERR_OK &&
+		bakeBPACEStep4(st->msgb, st->msga, st->stb) == ERR_OK &&
+		bakeBPACEStep5(st->msga, st->msgb, st->sta) == ERR_OK &&
+		bakeBPACEStep6(st->msga, st->stb) == ERR_OK &&
+		bakeBPACEStepG(st->keya, st->sta) == ERR_OK &&
+		bakeBPACEStepG(st->keyb, st->stb) == ERR_OK &&
+		memEq(st->keya, st->keyb, 32);
+}
+
+/*
+*******************************************************************************
+bels
+
+Параметр arg -- длина секрета в октетах. Секрет разделяется между
+BENCH_BELS_COUNT пользователями с порогом BENCH_BELS_THRESHOLD
+на стандартных открытых ключах.
+*******************************************************************************
+*/
+
+#define BENCH_BELS_COUNT		5
+#define BENCH_BELS_THRESHOLD	3
+
+typedef struct
+{
+	size_t len;					/*< длина секрета */
+	octet s[32];				/*< секрет */
+	octet si[BENCH_BELS_COUNT * 33];	/*< частичные секреты */
+	octet combo_state[256];		/*< состояние генератора */
+} bench_bels_st;
+
+static bool_t benchBelsStart(void* state, size_t arg)
+{
+	bench_bels_st* st = (bench_bels_st*)state;
+	if (sizeof(st->combo_state) < prngCOMBO_keep() || arg > 32)
+		return FALSE;
+	st->len = arg;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	prngCOMBOStepR(st->s, sizeof(st->s), st->combo_state);
+	return belsShare2(st->si, BENCH_BELS_COUNT, BENCH_BELS_THRESHOLD,
+		st->len, st->s, prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBelsShareStep(void* state)
+{
+	bench_bels_st* st = (bench_bels_st*)state;
+	return belsShare2(st->si, BENCH_BELS_COUNT, BENCH_BELS_THRESHOLD,
+		st->len, st->s, prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchBelsRecoverStep(void* state)
+{
+	bench_bels_st* st = (bench_bels_st*)state;
+	return belsRecover2(st->s, BENCH_BELS_THRESHOLD, st->len,
+		st->si) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+pfok
+
+Параметр arg -- номер стандартных параметров 1.2.112.0.2.0.1176.2.3.arg.2.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	pfok_params params[1];		/*< параметры */
+	octet x[368];				/*< долговременный личный ключ */
+	octet y[368];				/*< долговременный открытый ключ */
+	octet u[368];				/*< одноразовый личный ключ */
+	octet v[368];				/*< одноразовый открытый ключ */
+	octet key[368];				/*< общий ключ */
+	octet combo_state[256];		/*< состояние генератора */
+} bench_pfok_st;
+
+static bool_t benchPfokStart(void* state, size_t arg)
+{
+	bench_pfok_st* st = (bench_pfok_st*)state;
+	const char* name;
+	switch (arg)
+	{
+	case 3: name = "1.2.112.0.2.0.1176.2.3.3.2"; break;
+	case 6: name = "1.2.112.0.2.0.1176.2.3.6.2"; break;
+	case 10: name = "1.2.112.0.2.0.1176.2.3.10.2"; break;
+	default: return FALSE;
+	}
+	if (sizeof(st->combo_state) < prngCOMBO_keep() ||
+		pfokParamsStd(st->params, 0, name) != ERR_OK)
+		return FALSE;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	return pfokKeypairGen(st->x, st->y, st->params, prngCOMBOStepR,
+			st->combo_state) == ERR_OK &&
+		pfokKeypairGen(st->u, st->v, st->params, prngCOMBOStepR,
+			st->combo_state) == ERR_OK;
+}
+
+static bool_t benchPfokKeygenStep(void* state)
+{
+	bench_pfok_st* st = (bench_pfok_st*)state;
+	return pfokKeypairGen(st->u, st->v, st->params, prngCOMBOStepR,
+		st->combo_state) == ERR_OK;
+}
+
+static bool_t benchPfokMTIStep(void* state)
+{
+	bench_pfok_st* st = (bench_pfok_st*)state;
+	return pfokMTI(st->key, st->params, st->x, st->u, st->y,
+		st->v) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+g12s
+
+Параметр arg -- уровень стойкости l (256 или 512). Операции выполняются
+с контекстом кривой.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	g12s_params params[1];		/*< параметры */
+	octet privkey[G12S_ORDER_SIZE];		/*< личный ключ */
+	octet pubkey[2 * G12S_FIELD_SIZE];	/*< открытый ключ */
+	octet hash[G12S_ORDER_SIZE];		/*< хэш-значение */
+	octet sig[2 * G12S_ORDER_SIZE];		/*< подпись */
+	octet combo_state[256];		/*< состояние генератора */
+	octet ctx[16384];			/*< контекст кривой */
+} bench_g12s_st;
+
+static bool_t benchG12sStart(void* state, size_t arg)
+{
+	bench_g12s_st* st = (bench_g12s_st*)state;
+	const char* name;
+	switch (arg)
+	{
+	case 256: name = "1.2.643.2.2.35.1"; break;
+	case 512: name = "1.2.643.7.1.2.1.2.1"; break;
+	default: return FALSE;
+	}
+	if (sizeof(st->combo_state) < prngCOMBO_keep() ||
+		sizeof(st->ctx) < g12sCtx_keep(arg) ||
+		g12sParamsStd(st->params, name) != ERR_OK ||
+		g12sCtxStart(st->ctx, st->params) != ERR_OK)
+		return FALSE;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	prngCOMBOStepR(st->hash, sizeof(st->hash), st->combo_state);
+	return g12sKeypairGen2(st->privkey, st->pubkey, st->ctx,
+			prngCOMBOStepR, st->combo_state) == ERR_OK &&
+		g12sSign2(st->sig, st->ctx, st->hash, st->privkey, prngCOMBOStepR,
+			st->combo_state) == ERR_OK;
+}
+
+static bool_t benchG12sKeygenStep(void* state)
+{
+	bench_g12s_st* st = (bench_g12s_st*)state;
+	return g12sKeypairGen2(st->privkey, st->pubkey, st->ctx,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchG12sSignStep(void* state)
+{
+	bench_g12s_st* st = (bench_g12s_st*)state;
+	return g12sSign2(st->sig, st->ctx, st->hash, st->privkey,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchG12sVerifyStep(void* state)
+{
+	bench_g12s_st* st = (bench_g12s_st*)state;
+	return g12sVerify2(st->ctx, st->hash, st->sig, st->pubkey) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+dstu
+
+Параметр arg -- степень поля (163, 257 или 431). Используются кривые
+из таблицы Г.2 ДСТУ, базовые точки генерируются при подготовке. Операции
+выполняются с контекстом кривой.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	dstu_params params[1];		/*< параметры */
+	size_t ld;					/*< длина подписи в битах */
+	octet privkey[DSTU_SIZE];	/*< личный ключ */
+	octet pubkey[2 * DSTU_SIZE];/*< открытый ключ */
+	octet hash[32];				/*< хэш-значение */
+	octet sig[2 * DSTU_SIZE];	/*< подпись */
+	octet combo_state[256];		/*< состояние генератора */
+	octet ctx[8192];			/*< контекст кривой */
+} bench_dstu_st;
+
+static bool_t benchDstuStart(void* state, size_t arg)
+{
+	bench_dstu_st* st = (bench_dstu_st*)state;
+	const char* name;
+	switch (arg)
+	{
+	case 163: name = "1.2.804.2.1.1.1.1.3.1.1.1.2.0"; break;
+	case 257: name = "1.2.804.2.1.1.1.1.3.1.1.1.2.6"; break;
+	case 431: name = "1.2.804.2.1.1.1.1.3.1.1.1.2.9"; break;
+	default: return FALSE;
+	}
+	st->ld = 16 * ((2 * arg + 15) / 16);
+	if (sizeof(st->combo_state) < prngCOMBO_keep() ||
+		sizeof(st->ctx) < dstuCtx_keep(arg) ||
+		dstuParamsStd(st->params, name) != ERR_OK)
+		return FALSE;
+	prngCOMBOStart(st->combo_state, utilNonce32());
+	prngCOMBOStepR(st->hash, sizeof(st->hash), st->combo_state);
+	return dstuPointGen(st->params->P, st->params, prngCOMBOStepR,
+			st->combo_state) == ERR_OK &&
+		dstuCtxStart(st->ctx, st->params) == ERR_OK &&
+		dstuKeypairGen2(st->privkey, st->pubkey, st->ctx, prngCOMBOStepR,
+			st->combo_state) == ERR_OK &&
+		dstuSign2(st->sig, st->ctx, st->ld, st->hash, 32, st->privkey,
+			prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchDstuKeygenStep(void* state)
+{
+	bench_dstu_st* st = (bench_dstu_st*)state;
+	return dstuKeypairGen2(st->privkey, st->pubkey, st->ctx,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchDstuSignStep(void* state)
+{
+	bench_dstu_st* st = (bench_dstu_st*)state;
+	return dstuSign2(st->sig, st->ctx, st->ld, st->hash, 32, st->privkey,
+		prngCOMBOStepR, st->combo_state) == ERR_OK;
+}
+
+static bool_t benchDstuVerifyStep(void* state)
+{
+	bench_dstu_st* st = (bench_dstu_st*)state;
+	return dstuVerify2(st->ctx, st->ld, st->hash, 32, st->sig,
+		st->pubkey) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+Таблица замеров
+*******************************************************************************
+*/
+
+static const bench_case _cases[] = {
+	{ "bign128-keygen", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignKeygenStep, 128 },
+	{ "bign128-sign", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignSignStep, 128 },
+	{ "bign128-verify", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignVerifyStep, 128 },
+	{ "bign128-keywrap", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignWrapStep, 128 },
+	{ "bign128-keyunwrap", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignUnwrapStep, 128 },
+	{ "bign192-sign", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignSignStep, 192 },
+	{ "bign192-verify", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignVerifyStep, 192 },
+	{ "bign256-sign", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignSignStep, 256 },
+	{ "bign256-verify", 0, sizeof(bench_bign_st),
+		benchBignStart, benchBignVerifyStep, 256 },
+	{ "bake128-bmqv", 0, sizeof(bench_bake_st),
+		benchBakeStart, benchBakeBMQVStep, 128 },
+	{ "bake128-bpace", 0, sizeof(bench_bake_st),
+		benchBakeStart, benchBakeBPACEStep, 128 },
+	{ "bels256-share", 0, sizeof(bench_bels_st),
+		benchBelsStart, benchBelsShareStep, 32 },
+	{ "bels256-recover", 0, sizeof(bench_bels_st),
+		benchBelsStart, benchBelsRecoverStep, 32 },
+	{ "pfok3-keygen", 0, sizeof(bench_pfok_st),
+		benchPfokStart, benchPfokKeygenStep, 3 },
+	{ "pfok3-mti", 0, sizeof(bench_pfok_st),
+		benchPfokStart, benchPfokMTIStep, 3 },
+	{ "pfok10-mti", 0, sizeof(bench_pfok_st),
+		benchPfokStart, benchPfokMTIStep, 10 },
+	{ "g12s256-keygen", 0, sizeof(bench_g12s_st),
+		benchG12sStart, benchG12sKeygenStep, 256 },
+	{ "g12s256-sign", 0, sizeof(bench_g12s_st),
+		benchG12sStart, benchG12sSignStep, 256 },
+	{ "g12s256-verify", 0, sizeof(bench_g12s_st),
+		benchG12sStart, benchG12sVerifyStep, 256 },
+	{ "g12s512-sign", 0, sizeof(bench_g12s_st),
+		benchG12sStart, benchG12sSignStep, 512 },
+	{ "g12s512-verify", 0, sizeof(bench_g12s_st),
+		benchG12sStart, benchG12sVerifyStep, 512 },
+	{ "dstu163-keygen", 0, sizeof(bench_dstu_st),
+		benchDstuStart, benchDstuKeygenStep, 163 },
+	{ "dstu163-sign", 0, sizeof(bench_dstu_st),
+		benchDstuStart, benchDstuSignStep, 163 },
+	{ "dstu163-verify", 0, sizeof(bench_dstu_st),
+		benchDstuStart, benchDstuVerifyStep, 163 },
+	{ "dstu431-sign", 0, sizeof(bench_dstu_st),
+		benchDstuStart, benchDstuSignStep, 431 },
+	{ "dstu431-verify", 0, sizeof(bench_dstu_st),
+		benchDstuStart, benchDstuVerifyStep, 431 },
+};
+
+const bench_case* benchPK(size_t* count)
+{
+	*count = COUNT_OF(_cases);
+	return _cases;
+}
@@ -0,0 +1,355 @@
+/*
+*******************************************************************************
+\file bench_sym.c
+\brief Benchmarks for symmetric algorithms
+\project bee2/bench
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bash.h>
+#include <bee2/crypto/belt.h>
+#include <bee2/crypto/botp.h>
+#include "bench.h"
+
+/*
+*******************************************************************************
+Состояние
+
+Операция замера обрабатывает буфер buf из BENCH_SYM_SIZE октетов.
+Алгоритм запускается функцией benchSymStart() на ключе key и синхропосылке
+iv, состояние алгоритма размещается в alg. Параметр arg задает уровень
+стойкости bash и длину пароля botp.
+*******************************************************************************
+*/
+
+#define BENCH_SYM_SIZE	4096
+
+typedef struct
+{
+	octet buf[BENCH_SYM_SIZE];	/*< данные */
+	octet key[32];				/*< ключ */
+	octet iv[16];				/*< синхропосылка */
+	octet mac[64];				/*< имитовставка / хэш-значение */
+	char otp[10];				/*< одноразовый пароль */
+	size_t arg;					/*< параметр */
+	octet alg[1024];			/*< состояние алгоритма */
+} bench_sym_st;
+
+static bool_t benchSymStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	octet combo_state[256];
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(st->alg) < utilMax(14,
+			beltECB_keep(),
+			beltCBC_keep(),
+			beltCFB_keep(),
+			beltCTR_keep(),
+			beltMAC_keep(),
+			beltDWP_keep(),
+			beltCHE_keep(),
+			beltHash_keep(),
+			beltBDE_keep(),
+			beltSDE_keep(),
+			bashHash_keep(),
+			bashPrg_keep(),
+			botpHOTP_keep(),
+			botpTOTP_keep()))
+		return FALSE;
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(st->buf, sizeof(st->buf), combo_state);
+	prngCOMBOStepR(st->key, sizeof(st->key), combo_state);
+	prngCOMBOStepR(st->iv, sizeof(st->iv), combo_state);
+	memSetZero(st->otp, sizeof(st->otp));
+	st->arg = arg;
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+belt
+*******************************************************************************
+*/
+
+static bool_t benchBeltECBStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltECBStart(st->alg, st->key, 32);
+	return TRUE;
+}
+
+static bool_t benchBeltECBStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltECBStepE(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltCBCStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltCBCStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltCBCStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltCBCStepE(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltCFBStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltCFBStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltCFBStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltCFBStepE(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltCTRStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltCTRStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltCTRStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltCTRStepE(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltMACStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltMACStart(st->alg, st->key, 32);
+	return TRUE;
+}
+
+static bool_t benchBeltMACStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltMACStepA(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltDWPStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltDWPStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltDWPStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltDWPStepE(st->buf, sizeof(st->buf), st->alg);
+	beltDWPStepA(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltCHEStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltCHEStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltCHEStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltCHEStepE(st->buf, sizeof(st->buf), st->alg);
+	beltCHEStepA(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltHashStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltHashStart(st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltHashStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltHashStepH(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltBDEStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltBDEStart(st->alg, st->key, 32, st->iv);
+	return TRUE;
+}
+
+static bool_t benchBeltBDEStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltBDEStepE(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBeltSDEStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	beltSDEStart(st->alg, st->key, 32);
+	return TRUE;
+}
+
+static bool_t benchBeltSDEStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	beltSDEStepE(st->buf, sizeof(st->buf), st->iv, st->alg);
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+bash
+*******************************************************************************
+*/
+
+static bool_t benchBashHashStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	bashHashStart(st->alg, arg);
+	return TRUE;
+}
+
+static bool_t benchBashHashStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	bashHashStepH(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+static bool_t benchBashPrgStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	bashPrgStart(st->alg, arg, 2, 0, 0, st->key, arg / 8);
+	bashPrgEncrStart(st->alg);
+	return TRUE;
+}
+
+static bool_t benchBashPrgStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	bashPrgEncrStep(st->buf, sizeof(st->buf), st->alg);
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+botp
+*******************************************************************************
+*/
+
+static bool_t benchBotpHOTPStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	botpCtrNext(st->iv);
+	return botpHOTPRand(st->otp, st->arg, st->key, 32, st->iv) == ERR_OK;
+}
+
+static bool_t benchBotpTOTPStart(void* state, size_t arg)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	if (!benchSymStart(state, arg))
+		return FALSE;
+	return botpTOTPRand(st->otp, arg, st->key, 32, 1449165288 / 60) ==
+		ERR_OK;
+}
+
+static bool_t benchBotpTOTPStep(void* state)
+{
+	bench_sym_st* st = (bench_sym_st*)state;
+	return botpTOTPVerify(st->otp, st->key, 32, 1449165288 / 60) == ERR_OK;
+}
+
+/*
+*******************************************************************************
+Таблица замеров
+*******************************************************************************
+*/
+
+static const bench_case _cases[] = {
+	{ "belt-ecb", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltECBStart, benchBeltECBStep, 0 },
+	{ "belt-cbc", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltCBCStart, benchBeltCBCStep, 0 },
+	{ "belt-cfb", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltCFBStart, benchBeltCFBStep, 0 },
+	{ "belt-ctr", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltCTRStart, benchBeltCTRStep, 0 },
+	{ "belt-mac", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltMACStart, benchBeltMACStep, 0 },
+	{ "belt-dwp", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltDWPStart, benchBeltDWPStep, 0 },
+	{ "belt-che", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltCHEStart, benchBeltCHEStep, 0 },
+	{ "belt-hash", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltHashStart, benchBeltHashStep, 0 },
+	{ "belt-bde", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltBDEStart, benchBeltBDEStep, 0 },
+	{ "belt-sde", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBeltSDEStart, benchBeltSDEStep, 0 },
+	{ "bash256", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBashHashStart, benchBashHashStep, 128 },
+	{ "bash384", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBashHashStart, benchBashHashStep, 192 },
+	{ "bash512", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBashHashStart, benchBashHashStep, 256 },
+	{ "bash-prg-ae2562", BENCH_SYM_SIZE, sizeof(bench_sym_st),
+		benchBashPrgStart, benchBashPrgStep, 256 },
+	{ "botp-hotp", 0, sizeof(bench_sym_st),
+		benchSymStart, benchBotpHOTPStep, 8 },
+	{ "botp-totp-verify", 0, sizeof(bench_sym_st),
+		benchBotpTOTPStart, benchBotpTOTPStep, 8 },
+};
+
+const bench_case* benchSym(size_t* count)
+{
+	*count = COUNT_OF(_cases);
+	return _cases;
+}
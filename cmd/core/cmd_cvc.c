@@ -4,7 +4,7 @@
 \brief Command-line interface to Bee2: managing CV-certificates
 \project bee2/cmd
 \created 2022.08.20
-\version 2023.06.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,6 +13,7 @@
 #include "../cmd.h"
 #include <bee2/core/err.h>
 #include <bee2/core/blob.h>
+#include <bee2/core/der.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/str.h>
@@ -230,29 +231,34 @@ err_t cmdCVCsCheck(const octet* certs, size_t certs_len)
 {
 	err_t code;
 	void* stack;
+	void* state;
 	btok_cvc_t* cvc;
+	u32 tag;
+	const octet* cert;
+	size_t cert_len;
 	// pre
 	ASSERT(memIsValid(certs, certs_len));
 	// выделить и разметить память
-	code = cmdBlobCreate(stack, sizeof(btok_cvc_t));
+	code = cmdBlobCreate(stack, derStream_keep(0) + sizeof(btok_cvc_t));
 	ERR_CALL_CHECK(code);
-	cvc = (btok_cvc_t*)stack;
+	state = stack;
+	cvc = (btok_cvc_t*)((octet*)state + derStream_keep(0));
 	// цикл по сертификатам
-	while (certs_len)
+	code = derStreamStart2(state, certs, certs_len);
+	ERR_CALL_HANDLE(code, cmdBlobClose(stack));
+	while ((code = derStreamNext(&tag, 0, state)) != ERR_MAX)
 	{
 		// разобрать сертификат
-		size_t len = btokCVCLen(certs, certs_len);
-		if (len == SIZE_MAX)
+		if (code != ERR_OK || tag != 0x7F21 ||
+			derStreamTLV(&cert, &cert_len, state) != ERR_OK)
 			code = ERR_BAD_CERTRING;
 		else
-			code = btokCVCUnwrap(cvc, certs, len, 0, 0);
+			code = btokCVCUnwrap(cvc, cert, cert_len, 0, 0);
 		ERR_CALL_HANDLE(code, cmdBlobClose(stack));
-		// к следующему
-		certs += len, certs_len -= len;
 	}
 	// завершить
 	cmdBlobClose(stack);
-	return code;
+	return ERR_OK;
 }
 
 err_t cmdCVCsVal(const octet* certs, size_t certs_len, const octet date[6])
@@ -309,21 +315,29 @@ err_t cmdCVCsPrint(const octet* certs, size_t certs_len)
 {
 	err_t code;
 	void* stack;
+	void* state;
 	btok_cvc_t* cvc;
+	u32 tag;
+	const octet* cert;
+	size_t cert_len;
 	// pre
 	ASSERT(memIsValid(certs, certs_len));
 	// выделить и разметить память
-	code = cmdBlobCreate(stack, sizeof(btok_cvc_t));
-	cvc = (btok_cvc_t*)stack;
+	code = cmdBlobCreate(stack, derStream_keep(0) + sizeof(btok_cvc_t));
+	ERR_CALL_CHECK(code);
+	state = stack;
+	cvc = (btok_cvc_t*)((octet*)state + derStream_keep(0));
 	// цикл по сертификатам
-	while (certs_len)
+	code = derStreamStart2(state, certs, certs_len);
+	ERR_CALL_HANDLE(code, cmdBlobClose(stack));
+	while ((code = derStreamNext(&tag, 0, state)) != ERR_MAX)
 	{
 		// разобрать сертификат
-		size_t len = btokCVCLen(certs, certs_len);
-		if (len == SIZE_MAX)
+		if (code != ERR_OK || tag != 0x7F21 ||
+			derStreamTLV(&cert, &cert_len, state) != ERR_OK)
 			code = ERR_BAD_CERTRING;
 		else
-			code = btokCVCUnwrap(cvc, certs, len, 0, 0);
+			code = btokCVCUnwrap(cvc, cert, cert_len, 0, 0);
 		ERR_CALL_HANDLE(code, cmdBlobClose(stack));
 		// печатать
 		printf("  %s (%u bits, issued by %s, ",
@@ -334,10 +348,8 @@ err_t cmdCVCsPrint(const octet* certs, size_t certs_len)
 		code = cmdPrintDate(cvc->until);
 		ERR_CALL_HANDLE(code, cmdBlobClose(stack));
 		printf(")\n");
-		// к следующему
-		certs += len, certs_len -= len;
 	}
 	// завершить
 	cmdBlobClose(stack);
-	return code;
+	return ERR_OK;
 }
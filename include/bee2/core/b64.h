@@ -4,7 +4,7 @@
 \brief The Base64 encoding
 \project bee2 [cryptographic library]
 \created 2016.06.16
-\version 2023.02.02
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -52,8 +52,17 @@ Base64-строка -- это слово в алфавите
   не дописывается. Если последний блок состоял из 2 октетов, то будет 
   дописан 1 символ '=', если из 1 октета -- 2 символа. 
 
-\pre Во все функции, кроме возможно b64IsValid(), передаются корректные строки 
-и буферы памяти.
+Реализована также кодировка base64url (RFC 4648, раздел 5), в алфавите
+которой символы '+' и '/' заменены на '-' и '_'. При кодировании base64url
+строки дополняются символами '=' так же, как и base64. При декодировании
+base64url паддинг может отсутствовать: длина строки может давать
+остаток 2 или 3 при делении на 4.
+
+Длинные буферы кодируются и декодируются с помощью инструкций AVX2,
+если они поддерживаются платформой (см. utilAVX2IsAvail()).
+
+\pre Во все функции, кроме возможно b64IsValid() и b64UrlIsValid(),
+передаются корректные строки и буферы памяти.
 *******************************************************************************
 */
 
@@ -102,6 +111,150 @@ void b64To(
 	const char* src		/*!< [in] строка-источник */
 );
 
+/*!	\brief Корректная base64url-строка?
+
+	Проверяется корректность base64url-строки b64. Строка считается
+	корректной, если она удовлетворяет условиям b64IsValid() для алфавита
+	base64url или если она получена из такой строки удалением паддинга.
+	\return Признак корректности.
+	\safe Функция нерегулярна.
+*/
+bool_t b64UrlIsValid(
+	const char* b64		/*!< [in] base64url-строка */
+);
+
+/*!	\brief Кодирование буфера памяти в base64url
+
+	Буфер [count]src кодируется base64url-строкой
+	[4 * ((count + 2) / 3) + 1]dest.
+	\pre Буферы dest и src не пересекаются.
+*/
+void b64UrlFrom(
+	char* dest,			/*!< [out] строка-приемник */
+	const void* src,	/*!< [in] память-источник */
+	size_t count		/*!< [in] число октетов */
+);
+
+/*!	\brief Декодирование base64url-строки
+
+	Base64url-строка src декодируется в строку октетов [count?]dest.
+	\pre Если dest != 0, то буфер [count]dest корректен и его размер
+	достаточен для размещения декодированных данных.
+	\pre Буферы dest и src не пересекаются.
+	\pre b64UrlIsValid(src) == TRUE.
+*/
+void b64UrlTo(
+	void* dest,			/*!< [out] память-приемник */
+	size_t* count,		/*!< [in,out] размер dest / декодированных данных */
+	const char* src		/*!< [in] строка-источник */
+);
+
+/*
+*******************************************************************************
+Потоковое кодирование
+
+Данные кодируются (декодируются) фрагментами произвольной длины.
+Состояние хранит неполный блок предыдущего фрагмента. Строки
+и буферы, которые возвращаются по фрагментам, следует объединять.
+
+В отличие от b64To(), при потоковом декодировании корректность входных
+символов не предполагается, а проверяется.
+*******************************************************************************
+*/
+
+/*!	\brief Длина состояния потокового кодирования
+
+	Возвращается длина состояния (в октетах) потокового кодирования.
+	\return Длина состояния.
+*/
+size_t b64Enc_keep();
+
+/*!	\brief Начало потокового кодирования
+
+	В state формируется начальное состояние кодирования в base64
+	(url == FALSE) или base64url (url == TRUE).
+	\pre По адресу state зарезервировано b64Enc_keep() октетов.
+*/
+void b64EncStart(
+	void* state,		/*!< [out] состояние */
+	bool_t url			/*!< [in] кодировка base64url? */
+);
+
+/*!	\brief Шаг потокового кодирования
+
+	Фрагмент [count]src кодируется символами строки dest. Завершающий
+	нулевой символ не записывается.
+	\pre Буфер dest вмещает 4 * ((count + 2) / 3) символов.
+	\return Число записанных символов.
+*/
+size_t b64EncStep(
+	char* dest,			/*!< [out] символы-приемник */
+	const void* src,	/*!< [in] фрагмент */
+	size_t count,		/*!< [in] длина фрагмента */
+	void* state			/*!< [in,out] состояние */
+);
+
+/*!	\brief Окончание потокового кодирования
+
+	Кодируется (с паддингом) неполный блок, накопленный в state. Символы
+	записываются в строку dest, которая завершается нулевым символом.
+	\pre Буфер dest вмещает 5 символов.
+	\return Число записанных символов (без завершающего нулевого).
+*/
+size_t b64EncStop(
+	char* dest,			/*!< [out] строка-приемник */
+	void* state			/*!< [in,out] состояние */
+);
+
+/*!	\brief Длина состояния потокового декодирования
+
+	Возвращается длина состояния (в октетах) потокового декодирования.
+	\return Длина состояния.
+*/
+size_t b64Dec_keep();
+
+/*!	\brief Начало потокового декодирования
+
+	В state формируется начальное состояние декодирования base64
+	(url == FALSE) или base64url (url == TRUE).
+	\pre По адресу state зарезервировано b64Dec_keep() октетов.
+*/
+void b64DecStart(
+	void* state,		/*!< [out] состояние */
+	bool_t url			/*!< [in] кодировка base64url? */
+);
+
+/*!	\brief Шаг потокового декодирования
+
+	Фрагмент [len]src base64- или base64url-строки декодируется в буфер
+	[count]dest.
+	\pre Буфер dest вмещает 3 * ((len + 3) / 4) октетов.
+	\return ERR_OK, если фрагмент декодирован, или ERR_BAD_FORMAT, если
+	встретился недопустимый символ или неверный паддинг.
+	\remark Фрагмент не обязан завершаться нулевым символом.
+*/
+err_t b64DecStep(
+	void* dest,			/*!< [out] память-приемник */
+	size_t* count,		/*!< [out] число декодированных октетов */
+	const char* src,	/*!< [in] фрагмент */
+	size_t len,			/*!< [in] длина фрагмента */
+	void* state			/*!< [in,out] состояние */
+);
+
+/*!	\brief Окончание потокового декодирования
+
+	Проверяется, что строка завершена. Для base64url без паддинга
+	декодируется неполный блок, накопленный в state.
+	\pre Буфер dest вмещает 2 октета.
+	\return ERR_OK, если строка корректно завершена, или ERR_BAD_FORMAT
+	в противном случае.
+*/
+err_t b64DecStop(
+	void* dest,			/*!< [out] память-приемник */
+	size_t* count,		/*!< [out] число декодированных октетов */
+	void* state			/*!< [in,out] состояние */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
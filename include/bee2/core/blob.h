@@ -4,7 +4,7 @@
 \brief Blobs
 \project bee2 [cryptographic library]
 \created 2012.04.01
-\version 2022.06.17
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -153,6 +153,67 @@ int blobCmp(
 	const blob_t blob2		/*!< [in] второй блоб */
 );
 
+/*!
+*******************************************************************************
+\file blob.h
+
+\section blob-arena Арена блобов
+
+Небольшие блобы создаются не в куче, а в арене -- области памяти, 
+закрепленной за потоком. Арена создается при первом обращении потока 
+к blobCreate() и используется по стековой дисциплине: блобы, как правило, 
+закрываются в порядке, обратном порядку создания. Именно так создаются 
+и закрываются блобы со стеками функций высокого уровня (см. _deep-функции). 
+Блоб, который не помещается в арене, создается в куче.
+
+Память арены по возможности защищается от выгрузки в файл подкачки 
+(mlock(), VirtualLock()). При закрытии блоба его память очищается.
+
+Блоб арены можно закрыть в другом потоке, а также после завершения 
+потока-владельца. Арена освобождается после завершения потока-владельца
+(или после вызова blobArenaClose()) и закрытия всех ее блобов.
+
+Размер арены задается макросом BLOB_ARENA_SIZE при сборке библиотеки. 
+Нулевое значение макроса отключает арены.
+*******************************************************************************
+*/
+
+/*!	\brief Статистика блобов
+
+	Счетчики блобов текущего потока.
+*/
+typedef struct
+{
+	size_t arena_size;	/*!< размер арены */
+	size_t arena_used;	/*!< занято в арене */
+	size_t arena_peak;	/*!< наибольшее занятое в арене */
+	size_t arena_count;	/*!< число блобов, созданных в арене */
+	size_t heap_count;	/*!< число блобов, созданных в куче */
+	bool_t locked;		/*!< память арены защищена от выгрузки? */
+} blob_stat;
+
+/*!	\brief Статистика блобов потока
+
+	В stat возвращаются счетчики блобов текущего потока.
+	\remark Счетчики ведутся в арене. Если у потока нет арены (поток
+	еще не создавал блобы, арену не удалось создать или арены отключены), 
+	то счетчики нулевые.
+*/
+void blobStat(
+	blob_stat* stat		/*!< [out] статистика */
+);
+
+/*!	\brief Закрытие арены
+
+	Арена текущего потока отсоединяется от потока. Память арены очищается 
+	и освобождается после закрытия всех ее блобов. При следующем вызове
+	blobCreate() у потока будет создана новая арена.
+	\remark Арена закрывается автоматически при завершении потока. 
+	Исключение -- главный поток процесса: его арену рекомендуется закрывать 
+	явно.
+*/
+void blobArenaClose();
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
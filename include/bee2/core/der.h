@@ -4,7 +4,7 @@
 \brief Distinguished Encoding Rules
 \project bee2 [cryptographic library]
 \created 2014.04.21
-\version 2023.09.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -800,6 +800,165 @@ size_t derTSEQDecStop(
 /*!	\brief Завершить декодирование SEQ */
 #define derSEQDecStop derTSEQDecStop
 
+/*
+*******************************************************************************
+Потоковое декодирование
+
+Потоковый декодер последовательно извлекает TLV-элементы из DER-кода, который
+не обязательно целиком размещен в памяти. Код поступает либо из файла
+(функция чтения read_i), либо из буфера памяти (в том числе из отображения
+файла в память). При чтении из файла используется окно фиксированной длины,
+которое определяет максимальную длину значения или элемента, доступных для
+просмотра. Пропускаемые элементы через окно не проходят целиком и могут иметь
+произвольную длину.
+
+Декодер работает по схеме pull. Функция derStreamNext() читает префикс TL
+очередного элемента текущего уровня вложенности, при необходимости пропуская
+непросмотренное значение предыдущего элемента. Функция derStreamEnter()
+начинает перебор элементов, вложенных в текущий конструктивный элемент
+(например, в SEQUENCE или SET), функция derStreamLeave() пропускает
+оставшиеся вложенные элементы и возвращает декодер на прежний уровень.
+Функции derStreamVal() и derStreamTLV() возвращают указатели на значение
+и полный код текущего элемента. Данные не копируются: указатели ссылаются
+на окно (или на исходный буфер) и остаются действительными до следующего
+вызова функций потокового декодирования.
+
+Глубина вложенности ограничена константой реализации (16 уровней).
+
+Пример перебора сертификатов, записанных друг за другом:
+\code
+	while ((code = derStreamNext(&tag, &len, state)) == ERR_OK)
+	{
+		if (tag != 0x7F21)
+			break;
+		code = derStreamTLV(&cert, &cert_len, state);
+		...
+	}
+	if (code == ERR_MAX)
+		code = ERR_OK;
+\endcode
+*******************************************************************************
+*/
+
+/*!	\brief Длина состояния потокового декодера
+
+	Возвращается длина состояния (в октетах) потокового декодера с окном
+	из buf_len октетов. При декодировании буфера памяти (derStreamStart2())
+	следует передавать buf_len == 0.
+	\return Длина состояния.
+*/
+size_t derStream_keep(
+	size_t buf_len			/*!< [in] длина окна */
+);
+
+/*!	\brief Начать потоковое декодирование файла
+
+	В state формируется состояние потокового декодера, который читает
+	DER-код из файла file с помощью функции read. Используется окно из buf_len
+	октетов. Верхний уровень вложенности образуют элементы, записанные
+	в файле друг за другом вплоть до его окончания.
+	\expect{ERR_BAD_INPUT} buf_len >= 16.
+	\pre По адресу state зарезервировано derStream_keep(buf_len) октетов.
+	\return ERR_OK, если декодер подготовлен, и код ошибки в противном случае.
+*/
+err_t derStreamStart(
+	void* state,			/*!< [out] состояние */
+	size_t buf_len,			/*!< [in] длина окна */
+	read_i read,			/*!< [in] функция чтения */
+	void* file				/*!< [in,out] описание файла */
+);
+
+/*!	\brief Начать потоковое декодирование буфера
+
+	В state формируется состояние потокового декодера, который читает
+	DER-код из буфера [count]der. Верхний уровень вложенности образуют
+	элементы, записанные в буфере друг за другом.
+	\pre По адресу state зарезервировано derStream_keep(0) октетов.
+	\pre Буфер der остается корректным и неизменным в течение работы
+	декодера.
+	\return ERR_OK, если декодер подготовлен, и код ошибки в противном случае.
+*/
+err_t derStreamStart2(
+	void* state,			/*!< [out] состояние */
+	const octet der[],		/*!< [in] DER-код */
+	size_t count			/*!< [in] длина der в октетах */
+);
+
+/*!	\brief Следующий элемент
+
+	Декодируется префикс TL следующего элемента текущего уровня вложенности.
+	Определяются тег tag и длина значения len элемента.
+	\return ERR_OK, если элемент найден, ERR_MAX, если элементы текущего
+	уровня исчерпаны, ERR_BAD_FORMAT, если нарушен формат DER-кода,
+	или другой код ошибки (например, ошибки чтения).
+	\remark Любой из указателей tag и len может быть нулевым.
+*/
+err_t derStreamNext(
+	u32* tag,				/*!< [out] тег */
+	size_t* len,			/*!< [out] длина значения */
+	void* state				/*!< [in,out] состояние */
+);
+
+/*!	\brief Войти в элемент
+
+	Начинается перебор элементов, вложенных в текущий элемент.
+	\expect{ERR_BAD_LOGIC} Текущий элемент определен (последний вызов
+	derStreamNext() был успешным).
+	\expect{ERR_BAD_FORMAT} Текущий элемент является конструктивным.
+	\return ERR_OK, если перебор начат, и код ошибки в противном случае.
+	\remark При превышении максимальной глубины вложенности возвращается
+	ERR_OUTOFRANGE.
+*/
+err_t derStreamEnter(
+	void* state				/*!< [in,out] состояние */
+);
+
+/*!	\brief Выйти из элемента
+
+	Завершается перебор элементов, вложенных в элемент предыдущего уровня.
+	Оставшиеся элементы пропускаются. Следующий вызов derStreamNext()
+	вернет элемент, записанный после покинутого.
+	\expect{ERR_BAD_LOGIC} Ранее был выполнен вход в элемент.
+	\return ERR_OK, если выход выполнен, и код ошибки в противном случае.
+*/
+err_t derStreamLeave(
+	void* state				/*!< [in,out] состояние */
+);
+
+/*!	\brief Значение элемента
+
+	Определяется указатель val на значение текущего элемента. Длина значения
+	была возвращена derStreamNext().
+	\expect{ERR_BAD_LOGIC} Текущий элемент определен.
+	\return ERR_OK, если значение доступно, ERR_OUTOFMEMORY, если элемент
+	(вместе с префиксом TL) не помещается в окно, ERR_BAD_FORMAT, если
+	значение обрезано, или другой код ошибки.
+	\remark Указатель остается действительным до следующего вызова функций
+	потокового декодирования.
+*/
+err_t derStreamVal(
+	const octet** val,		/*!< [out] указатель на значение */
+	void* state				/*!< [in,out] состояние */
+);
+
+/*!	\brief Код элемента
+
+	Определяется указатель на DER-код [count]der текущего элемента
+	(октеты T, L и V). Полученный код можно передать, например,
+	в derDec() или btokCVCUnwrap().
+	\expect{ERR_BAD_LOGIC} Текущий элемент определен.
+	\return ERR_OK, если код доступен, ERR_OUTOFMEMORY, если код
+	не помещается в окно, ERR_BAD_FORMAT, если код обрезан, или другой
+	код ошибки.
+	\remark Указатель остается действительным до следующего вызова функций
+	потокового декодирования.
+*/
+err_t derStreamTLV(
+	const octet** der,		/*!< [out] указатель на DER-код */
+	size_t* count,			/*!< [out] длина der в октетах */
+	void* state				/*!< [in,out] состояние */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -4,7 +4,7 @@
 \brief Multithreading
 \project bee2 [cryptographic library]
 \created 2014.10.10
-\version 2023.02.02
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -134,9 +134,64 @@ void mtMtxClose(
 
 Управление потоками реализуется по схемам, заданным в стандарте языка Си
 ISO/IEC 9899:2011 (см. заголовочный файл threads.h).
+
+Поток создается функцией mtThrdCreate(). Созданный поток выполняет 
+функцию интерфейса mt_thrd_i. Завершения потока следует дождаться 
+с помощью функции mtThrdJoin().
+
+\typedef mt_thrd_t
+\brief Поток
 *******************************************************************************
 */
 
+#ifdef OS_WIN
+	typedef HANDLE mt_thrd_t;
+#elif defined OS_UNIX
+	typedef pthread_t mt_thrd_t;
+#else
+	typedef size_t mt_thrd_t;
+#endif
+
+/*!	\brief Функция потока
+
+	Выполняются действия потока с аргументом arg.
+*/
+typedef void (*mt_thrd_i)(
+	void* arg			/*!< [in,out] аргумент */
+);
+
+/*!	\brief Создание потока
+
+	Создается поток thrd, который выполняет функцию fn с аргументом arg.
+	\return Признак успеха.
+	\remark Если операционная система не распознана или не поддерживает 
+	многозадачность, то возвращается FALSE. Вызывающая сторона может 
+	в этом случае выполнить fn(arg) в текущем потоке.
+*/
+bool_t mtThrdCreate(
+	mt_thrd_t* thrd,	/*!< [out] поток */
+	mt_thrd_i fn,		/*!< [in] функция потока */
+	void* arg			/*!< [in,out] аргумент fn */
+);
+
+/*!	\brief Ожидание завершения потока
+
+	Ожидается завершение потока thrd, после чего ресурсы потока 
+	освобождаются.
+	\pre Поток thrd создан функцией mtThrdCreate().
+	\pre mtThrdJoin() вызывается для потока ровно один раз.
+*/
+void mtThrdJoin(
+	mt_thrd_t* thrd		/*!< [in,out] поток */
+);
+
+/*!	\brief Число процессоров
+
+	Определяется число логических процессоров, доступных процессу.
+	\return Число процессоров (не меньше 1).
+*/
+size_t mtThrdHWCount();
+
 /*!	\brief Приостановка потока
 
 	Текущий поток приостанавливается на ms миллисекунд.
@@ -210,6 +265,145 @@ size_t mtAtomicCmpSwap(
 	size_t swap		/*!< [in] новое значение */
 );
 
+/*!
+*******************************************************************************
+\file mt.h
+
+\section mt-pool Пул потоков
+
+Пул объединяет несколько рабочих потоков, которые выполняют задачи
+интерфейса mt_task_i. Задача получает индекс i, аргумент arg и стек stack
+фиксированной глубины deep, которая указывается при создании пула. Глубина
+определяется обычным образом, с помощью функций *_deep() тех алгоритмов,
+которые вызываются в задаче. Стеки размещаются в памяти пула, каждый поток
+пула (в том числе вызывающий) использует собственный стек. При закрытии пула
+стеки очищаются.
+
+Пул создается функцией mtPoolStart() в памяти размера mtPool_keep(). Число
+потоков threads учитывает вызывающий поток: создается threads - 1 рабочих
+потоков, а вызывающий поток подключается к выполнению задач в функциях
+mtPoolFor() и mtPoolWait(). Если рабочие потоки создать не удается,
+то задачи выполняются в вызывающем потоке.
+
+Функция mtPoolFor() выполняет параллельный цикл: задача вызывается для всех
+индексов i из интервала [0, count). Функция mtPoolRun() ставит в очередь
+отдельную задачу с заданным индексом, функция mtPoolWait() дожидается
+завершения всех поставленных задач.
+
+Каждый поток пула ведет собственную очередь (дек) заданий, где задание --
+это интервал индексов. Поток извлекает задания с конца своей очереди.
+Пока интервал задания длиннее порога дробления, поток делит его пополам
+и возвращает вторую половину в свою очередь. Поток, очередь которого
+опустела, забирает задания с начала очередей других потоков (work stealing).
+Таким образом, крупные интервалы достаются простаивающим потокам, а нагрузка
+выравнивается без централизованного распределения.
+
+\pre Функции mtPoolFor(), mtPoolRun(), mtPoolWait() и mtPoolClose()
+вызываются только в потоке, который создал пул. Задачи не обращаются
+к функциям пула.
+
+\warning Задачи выполняются в произвольном порядке и конкурентно.
+Задачи не должны изменять общие данные без синхронизации.
+*******************************************************************************
+*/
+
+/*!	\brief Задача пула
+
+	Выполняется задача с индексом i и аргументом arg. Задаче
+	предоставляется стек stack.
+*/
+typedef void (*mt_task_i)(
+	size_t i,			/*!< [in] индекс */
+	void* arg,			/*!< [in,out] аргумент */
+	void* stack			/*!< [in,out] стек */
+);
+
+/*!	\brief Длина состояния пула
+
+	Возвращается длина состояния (в октетах) пула из threads потоков,
+	задачи которого используют стеки глубины deep.
+	\return Длина состояния.
+	\remark Если threads == 0, то число потоков определяется функцией
+	mtThrdHWCount().
+*/
+size_t mtPool_keep(
+	size_t threads,		/*!< [in] число потоков */
+	size_t deep			/*!< [in] глубина стека задачи */
+);
+
+/*!	\brief Создание пула
+
+	В state создается пул из threads потоков (с учетом вызывающего),
+	задачи которого используют стеки глубины deep.
+	\pre По адресу state зарезервировано mtPool_keep(threads, deep)
+	октетов.
+	\return Признак успеха.
+	\remark Если threads == 0, то число потоков определяется функцией
+	mtThrdHWCount().
+	\remark Если не удается создать часть рабочих потоков, то пул
+	использует успешно созданные.
+	\post В случае успеха пул должен быть закрыт функцией mtPoolClose().
+*/
+bool_t mtPoolStart(
+	void* state,		/*!< [out] состояние */
+	size_t threads,		/*!< [in] число потоков */
+	size_t deep			/*!< [in] глубина стека задачи */
+);
+
+/*!	\brief Число потоков пула
+
+	Определяется число потоков пула state (с учетом вызывающего).
+	\return Число потоков.
+*/
+size_t mtPoolThreads(
+	const void* state	/*!< [in] состояние */
+);
+
+/*!	\brief Параллельный цикл
+
+	Задача fn с аргументом arg выполняется в потоках пула state
+	для всех индексов из интервала [0, count). Функция возвращает
+	управление после завершения всех задач пула.
+	\remark Вызывающий поток участвует в выполнении задач.
+*/
+void mtPoolFor(
+	void* state,		/*!< [in,out] состояние */
+	size_t count,		/*!< [in] число индексов */
+	mt_task_i fn,		/*!< [in] задача */
+	void* arg			/*!< [in,out] аргумент fn */
+);
+
+/*!	\brief Постановка задачи
+
+	Задача fn с индексом i и аргументом arg ставится в очередь пула state.
+	\remark Если очереди пула переполнены, то задача выполняется
+	в вызывающем потоке.
+*/
+void mtPoolRun(
+	void* state,		/*!< [in,out] состояние */
+	mt_task_i fn,		/*!< [in] задача */
+	size_t i,			/*!< [in] индекс */
+	void* arg			/*!< [in,out] аргумент fn */
+);
+
+/*!	\brief Ожидание задач
+
+	Ожидается завершение всех задач, поставленных в очередь пула state.
+	\remark Вызывающий поток участвует в выполнении задач.
+*/
+void mtPoolWait(
+	void* state			/*!< [in,out] состояние */
+);
+
+/*!	\brief Закрытие пула
+
+	Ожидается завершение задач пула state, рабочие потоки останавливаются,
+	стеки задач очищаются.
+*/
+void mtPoolClose(
+	void* state			/*!< [in,out] состояние */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
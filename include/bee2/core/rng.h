@@ -4,7 +4,7 @@
 \brief Entropy sources and random number generators
 \project bee2 [cryptographic library]
 \created 2014.10.13
-\version 2023.12.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -306,6 +306,80 @@ void rngStepR2(
 */
 void rngRekey();
 
+/*!
+*******************************************************************************
+\file rng.h
+
+\section rng-pool Фоновый сбор энтропии
+
+Функция rngStepR() опрашивает источники случайности синхронно. Опрос
+медленных источников (например, источника "timer") может занимать
+значительное время, в течение которого генератор заблокирован.
+
+Функция rngPoolStart() запускает фоновый поток, который опрашивает
+источники и накапливает полученные от них данные в пуле энтропии.
+Данные запрашиваются блоками по 2500 октетов. Каждый блок проверяется
+тестами rngTestFIPS1() -- rngTestFIPS4(). В пул попадают только блоки,
+прошедшие все тесты. Источники опрашиваются в порядке "trng", "trng2",
+"sys", "sys2", "timer" до получения подходящего блока.
+
+Пока фоновый поток запущен, функция rngStepR() не опрашивает источники,
+а забирает накопленные данные из пула. Если пул пуст или данных в нем
+недостаточно, то генерация выполняется без ожидания -- с теми данными,
+которые есть. Использованные данные удаляются из пула.
+
+Фоновый поток останавливается функцией rngPoolStop(), а также при
+закрытии генератора (последний вызов rngClose()).
+
+Счетчики пула можно получить с помощью функции rngPoolStat().
+*******************************************************************************
+*/
+
+/*!	\brief Запуск фонового сбора энтропии
+
+	Запускается поток, который накапливает данные от источников
+	случайности в пуле энтропии.
+	\pre Генератор корректен.
+	\return ERR_OK, если поток запущен или был запущен ранее,
+	и код ошибки в противном случае.
+	\remark Если поток создать не удалось (в частности, если потоки
+	не поддерживаются), то возвращается ERR_NOT_IMPLEMENTED. В этом случае
+	rngStepR() по-прежнему опрашивает источники синхронно.
+	\remark Если поток останавливается в другом потоке, то возвращается
+	ERR_BAD_LOGIC.
+*/
+err_t rngPoolStart();
+
+/*!	\brief Останов фонового сбора энтропии
+
+	Поток, запущенный функцией rngPoolStart(), останавливается,
+	пул энтропии очищается.
+	\remark Если поток не запущен, то ничего не делается.
+*/
+void rngPoolStop();
+
+/*!	\brief Статистика пула энтропии
+*/
+typedef struct
+{
+	size_t size;		/*!< емкость пула (в октетах) */
+	size_t level;		/*!< накоплено в пуле (в октетах) */
+	size_t blocks;		/*!< число блоков, принятых в пул */
+	size_t rejected;	/*!< число блоков, не прошедших тесты */
+	size_t served;		/*!< число октетов, выданных из пула */
+	size_t misses;		/*!< число обращений к rngStepR() при нехватке */
+	bool_t active;		/*!< фоновый поток запущен? */
+} rng_pool_stat;
+
+/*!	\brief Получение статистики пула
+
+	В stat возвращаются счетчики пула энтропии.
+	\remark Счетчики обнуляются при запуске фонового потока.
+*/
+void rngPoolStat(
+	rng_pool_stat* stat		/*!< [out] статистика */
+);
+
 /*!	\brief Закрытие генератора
 
 	Генератор случайных чисел закрывается.
@@ -4,7 +4,7 @@
 \brief Utilities
 \project bee2 [cryptographic library]
 \created 2012.07.16
-\version 2023.02.02
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -231,6 +231,28 @@ u32 utilFNV32(
 */
 u32 utilNonce32();
 
+/*!	\brief Поддержка AVX2
+
+	Проверяется, что процессор поддерживает инструкции AVX2, а операционная 
+	система сохраняет расширенные регистры при переключении задач.
+	\return Признак поддержки.
+	\remark Проверка выполняется при первом вызове, ее результат 
+	запоминается.
+	\remark На платформах, отличных от x86, возвращается FALSE.
+*/
+bool_t utilAVX2IsAvail();
+
+/*!	\brief Поддержка PCLMULQDQ
+
+	Проверяется, что процессор поддерживает инструкцию PCLMULQDQ 
+	(умножение двоичных многочленов без переносов).
+	\return Признак поддержки.
+	\remark Проверка выполняется при первом вызове, ее результат 
+	запоминается.
+	\remark На платформах, отличных от x86, возвращается FALSE.
+*/
+bool_t utilCLMULIsAvail();
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -4,7 +4,7 @@
 \brief STB 34.101.66 (bake): authenticated key establishment (AKE) protocols
 \project bee2 [cryptographic library]
 \created 2014.04.14
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -167,6 +167,27 @@ err_t bakeKDF(
 	size_t num				/*!< [in] номер ключа */
 );
 
+/*!	\brief Построение нескольких ключей
+
+	По секретному слову [secret_len]secret, дополнительному слову [iv_len]iv
+	строятся ключи [32]keys[0], [32]keys[1],..., [32]keys[count - 1] с 
+	номерами num, num + 1,..., num + count - 1.
+	\return ERR_OK, если ключи успешно построены, и код ошибки в противном 
+	случае.
+	\remark Результат совпадает с результатом count вызовов bakeKDF() 
+	с последовательными номерами. Хэширование secret || iv выполняется 
+	только один раз.
+*/
+err_t bakeKDF2(
+	octet keys[],			/*!< [out] ключи */
+	const octet secret[],	/*!< [in] секретное слово */
+	size_t secret_len,		/*!< [in] длина secret */
+	const octet iv[],		/*!< [in] дополнительное слово */
+	size_t iv_len,			/*!< [in] длина iv */
+	size_t num,				/*!< [in] номер первого ключа */
+	size_t count			/*!< [in] число ключей */
+);
+
 /*!	\brief Построение точки эллиптической кривой
 
 	При долговременных параметрах params по сообщению [l / 4]msg строится 
@@ -194,6 +215,83 @@ err_t bakeSWU(
 *******************************************************************************
 \file bake.h
 
+\section bake-resp Контекст долговременного ключа
+
+Сторона, которая участвует во многих сеансах протоколов BMQV и BSTS 
+с одним и тем же личным ключом (как правило, сторона B, сервер), может 
+заранее подготовить контекст долговременного ключа. Контекст содержит 
+описание эллиптической кривой, личный ключ, проверенный сертификат 
+стороны, таблицу предвычислений для ускоренного вычисления кратных 
+базовой точки, а также кэш проверенных сертификатов другой стороны.
+
+Контекст создается функцией bakeRespStart() и используется в функциях 
+bakeBMQVStart2() и bakeBSTSStart2() вместо параметров, личного ключа 
+и сертификата. В результате при запуске сеанса не выполняются построение
+описания кривой и проверка собственного сертификата, при выработке 
+одноразовых ключей используются предвычисления, а повторно предъявленные 
+сертификаты другой стороны проверяются по кэшу.
+
+Контекст можно одновременно использовать в нескольких потоках. Доступ 
+к кэшу синхронизируется внутри контекста.
+
+\expect Функция проверки сертификатов другой стороны (bake_cert::val или 
+аргумент vala) возвращает результат, который зависит только от 
+параметров и содержимого сертификата. Если это не так (например, 
+проверяется срок действия), кэш следует отключить (count == 0).
+\expect Контекст не копируется и не перемещается в памяти, пока 
+существуют состояния, созданные по нему.
+\expect bakeRespClose() вызывается после завершения всех сеансов, 
+использующих контекст.
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста долговременного ключа
+
+	Возвращается длина контекста (в октетах) для уровня стойкости l 
+	с кэшем на count сертификатов.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Длина контекста.
+*/
+size_t bakeResp_keep(
+	size_t l,						/*!< [in] уровень стойкости */
+	size_t count					/*!< [in] емкость кэша */
+);
+
+/*!	\brief Создание контекста долговременного ключа
+
+	По параметрам params, личному ключу [l / 4]privkey и сертификату cert 
+	соответствующего открытого ключа в resp формируется контекст 
+	долговременного ключа с кэшем на count сертификатов другой стороны.
+	\pre По адресу resp зарезервировано bakeResp_keep(l, count) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_CERT} Сертификат cert корректен.
+	\expect Ключ privkey и сертификат cert согласованы.
+	\return ERR_OK, если контекст успешно создан, и код ошибки в противном 
+	случае.
+	\remark При count == 0 кэш сертификатов не используется.
+*/
+err_t bakeRespStart(
+	void* resp,						/*!< [out] контекст */
+	const bign_params* params,		/*!< [in] долговременные параметры */
+	const octet privkey[],			/*!< [in] личный ключ */
+	const bake_cert* cert,			/*!< [in] сертификат */
+	size_t count					/*!< [in] емкость кэша */
+);
+
+/*!	\brief Закрытие контекста долговременного ключа
+
+	Контекст resp закрывается: освобождаются системные ресурсы, память
+	контекста очищается.
+	\expect Контекст создан функцией bakeRespStart().
+*/
+void bakeRespClose(
+	void* resp						/*!< [in,out] контекст */
+);
+
+/*!
+*******************************************************************************
+\file bake.h
+
 \section bake-bmqv Протокол BMQV
 *******************************************************************************
 */
@@ -234,6 +332,30 @@ err_t bakeBMQVStart(
 	const bake_cert* cert			/*!< [in] сертификат */
 );
 
+/*!	\brief Инициализация протокола BMQV по контексту
+
+	По настройкам settings и контексту долговременного ключа resp в state 
+	формируются структуры данных, необходимые для выполнения протокола BMQV.
+	Параметры, личный ключ и сертификат берутся из resp.
+	\pre По адресу state зарезервировано bakeBMQV_keep() октетов.
+	\expect{ERR_BAD_INPUT} Контекст resp создан функцией bakeRespStart().
+	\expect{ERR_BAD_INPUT} Указатель settings->helloa нулевой, либо буфер 
+	[settings->helloa_len]settings->helloa корректен. Аналогичное требование
+	касается полей settings->hellob, settings->hellob_len.
+	\expect{ERR_BAD_RNG} Генератор settings->rng (с состоянием 
+	settings->rng_state) корректен.
+	\expect Генератор settings->rng является криптографически стойким.
+	\return ERR_OK, если инициализация успешно выполнена, и код ошибки 
+	в противном случае.
+	\remark Состояние ссылается на resp. Контекст должен оставаться 
+	корректным до завершения протокола.
+*/
+err_t bakeBMQVStart2(
+	void* state,					/*!< [out] состояние */
+	const bake_settings* settings,	/*!< [in] настройки */
+	void* resp						/*!< [in,out] контекст */
+);
+
 /*!	\brief Шаг 2 протокола BMQV
 
 	Выполняется шаг 2 протокола BMQV с состоянием state. Сторона B формирует
@@ -402,6 +524,31 @@ err_t bakeBSTSStart(
 	const bake_cert* cert			/*!< [in] сертификат */
 );
 
+/*!	\brief Инициализация протокола BSTS по контексту
+
+	По настройкам settings и контексту долговременного ключа resp в state 
+	формируются структуры данных, необходимые для выполнения протокола BSTS.
+	Параметры, личный ключ и сертификат берутся из resp.
+	\pre По адресу state зарезервировано bakeBSTS_keep() октетов.
+	\expect{ERR_BAD_INPUT} Контекст resp создан функцией bakeRespStart().
+	\expect{ERR_BAD_INPUT} settings->kca == TRUE && settings->kcb == TRUE.
+	\expect{ERR_BAD_INPUT} Указатель settings->helloa нулевой, либо буфер 
+	[settings->helloa_len]settings->helloa корректен. Аналогичное требование
+	касается полей settings->hellob, settings->hellob_len.
+	\expect{ERR_BAD_RNG} Генератор settings->rng (с состоянием 
+	settings->rng_state) корректен.
+	\expect Генератор settings->rng является криптографически стойким.
+	\return ERR_OK, если инициализация успешно выполнена, и код ошибки 
+	в противном случае.
+	\remark Состояние ссылается на resp. Контекст должен оставаться 
+	корректным до завершения протокола.
+*/
+err_t bakeBSTSStart2(
+	void* state,					/*!< [out] состояние */
+	const bake_settings* settings,	/*!< [in] настройки */
+	void* resp						/*!< [in,out] контекст */
+);
+
 /*!	\brief Шаг 2 протокола BSTS
 
 	Выполняется шаг 2 протокола BSTS с состоянием state. Сторона B формирует
@@ -696,6 +843,215 @@ err_t bakeBPACERunA(
 	void* file						/*!< [in,out] канал связи */
 );
 
+/*!
+*******************************************************************************
+\file bake.h
+
+\section bake-srv Многосеансовый сервер
+
+Сервер выполняет протоколы BMQV и BPACE от лица стороны B одновременно с 
+многими клиентами (сторонами A). Состояние сервера содержит пул заранее 
+размещенных ячеек, в каждой из которых хранится состояние одного сеанса. 
+Сеанс идентифицируется номером ячейки sid.
+
+Сервер не блокируется на ожидании сообщений. Сеанс открывается функцией 
+bakeSrvOpenBMQV() или bakeSrvOpenBPACE(), которая выполняет шаги Start и 
+Step2 и возвращает первое сообщение стороны B. Далее при получении каждого 
+очередного сообщения стороны A вызывается функция bakeSrvStep(), которая 
+выполняет очередной шаг протокола (Step4 или Step6) и возвращает ответ. 
+Несколько поступивших сообщений можно обработать одним вызовом 
+bakeSrvStepBatch().
+
+После завершения протокола (bakeSrvIsDone()) общий ключ извлекается 
+функцией bakeSrvStepG(). Сеанс закрывается функцией bakeSrvClose(), при 
+этом ячейка очищается и возвращается в пул. При ошибке выполнения шага 
+сеанс закрывается автоматически.
+
+\expect Данные, переданные при открытии сеанса через указатели (настройки, 
+сертификат и т.д.), остаются корректными и постоянными до закрытия сеанса.
+\warning Функции сервера не потокобезопасны: обращения к одному состоянию
+сервера из разных потоков должны синхронизироваться вызывающей программой.
+*******************************************************************************
+*/
+
+/*!	\brief Протокол BMQV */
+#define BAKE_SRV_BMQV		1
+/*!	\brief Протокол BPACE */
+#define BAKE_SRV_BPACE		2
+
+/*!	\brief Событие сервера
+
+	Событие описывает входное сообщение сеанса sid и место для ответа. 
+	Поля out_len и code заполняются при обработке события.
+*/
+typedef struct
+{
+	size_t sid;					/*!< номер сеанса */
+	const octet* in;			/*!< входное сообщение */
+	size_t in_len;				/*!< длина in в октетах */
+	const bake_cert* certa;		/*!< сертификат стороны A (BMQV) */
+	octet* out;					/*!< выходное сообщение */
+	size_t out_len;				/*!< длина out в октетах */
+	err_t code;					/*!< код результата */
+} bake_srv_event;
+
+/*!	\brief Длина состояния сервера
+
+	Возвращается длина состояния (в октетах) сервера, обслуживающего не 
+	более count одновременных сеансов с уровнем стойкости l.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Длина состояния.
+*/
+size_t bakeSrv_keep(
+	size_t l,						/*!< [in] уровень стойкости */
+	size_t count					/*!< [in] число сеансов */
+);
+
+/*!	\brief Инициализация сервера
+
+	В state формируется пул из count свободных ячеек для сеансов с уровнем 
+	стойкости l.
+	\pre По адресу state зарезервировано bakeSrv_keep(l, count) октетов.
+	\expect{ERR_BAD_PARAMS} l == 128 || l == 192 || l == 256.
+	\expect{ERR_BAD_INPUT} count > 0.
+	\return ERR_OK, если инициализация успешно выполнена, и код ошибки 
+	в противном случае.
+*/
+err_t bakeSrvStart(
+	void* state,					/*!< [out] состояние */
+	size_t l,						/*!< [in] уровень стойкости */
+	size_t count					/*!< [in] число сеансов */
+);
+
+/*!	\brief Открытие сеанса BMQV
+
+	В свободной ячейке пула state открывается сеанс протокола BMQV. 
+	Выполняются функции bakeBMQVStart() и bakeBMQVStep2() с параметрами 
+	params, настройками settings, личным ключом privkeyb и сертификатом 
+	certb стороны B. Номер сеанса возвращается по адресу sid, сообщение 
+	M1 = [l / 2]out.
+	\expect{ERR_BAD_PARAMS} params->l совпадает с уровнем стойкости сервера.
+	\expect{ERR_OUTOFMEMORY} В пуле есть свободная ячейка.
+	\expect Повторяются условия функции bakeBMQVStart().
+	\return ERR_OK, если сеанс успешно открыт, и код ошибки в противном 
+	случае.
+*/
+err_t bakeSrvOpenBMQV(
+	size_t* sid,					/*!< [out] номер сеанса */
+	octet out[],					/*!< [out] выходное сообщение M1 */
+	void* state,					/*!< [in,out] состояние */
+	const bign_params* params,		/*!< [in] долговременные параметры */
+	const bake_settings* settings,	/*!< [in] настройки */
+	const octet privkeyb[],			/*!< [in] личный ключ стороны B */
+	const bake_cert* certb			/*!< [in] сертификат стороны B */
+);
+
+/*!	\brief Открытие сеанса BPACE
+
+	В свободной ячейке пула state открывается сеанс протокола BPACE. 
+	Выполняются функции bakeBPACEStart() и bakeBPACEStep2() с параметрами 
+	params, настройками settings и паролем [pwd_len]pwd. Номер сеанса 
+	возвращается по адресу sid, сообщение M1 = [l / 8]out.
+	\expect{ERR_BAD_PARAMS} params->l совпадает с уровнем стойкости сервера.
+	\expect{ERR_OUTOFMEMORY} В пуле есть свободная ячейка.
+	\expect Повторяются условия функции bakeBPACEStart().
+	\return ERR_OK, если сеанс успешно открыт, и код ошибки в противном 
+	случае.
+*/
+err_t bakeSrvOpenBPACE(
+	size_t* sid,					/*!< [out] номер сеанса */
+	octet out[],					/*!< [out] выходное сообщение M1 */
+	void* state,					/*!< [in,out] состояние */
+	const bign_params* params,		/*!< [in] долговременные параметры */
+	const bake_settings* settings,	/*!< [in] настройки */
+	const octet pwd[],				/*!< [in] пароль */
+	size_t pwd_len					/*!< [in] длина пароля */
+);
+
+/*!	\brief Шаг сеанса
+
+	Сообщение [in_len]in стороны A обрабатывается в сеансе sid сервера state.
+	Выполняется очередной шаг протокола:
+	-	BMQV: bakeBMQVStep4() с сертификатом certa;
+	-	BPACE: bakeBPACEStep4() или bakeBPACEStep6() (certa не используется).
+	.
+	Ответ стороны B записывается в [*out_len]out (возможно, *out_len == 0).
+	\expect{ERR_BAD_INPUT} Сеанс sid открыт.
+	\expect{ERR_BAD_LOGIC} Протокол в сеансе не завершен.
+	\expect{ERR_BAD_INPUT} in_len совпадает с длиной ожидаемого сообщения.
+	\expect Буфер out вмещает ответ: [l / 2 + 8] октетов для BPACE
+	и 8 октетов для BMQV.
+	\return ERR_OK, если шаг успешно выполнен, и код ошибки в противном 
+	случае.
+	\remark Если сеанс открыт и протокол в нем не завершен, то при ошибке 
+	выполнения шага (в том числе при неверной длине in) сеанс закрывается.
+*/
+err_t bakeSrvStep(
+	octet out[],					/*!< [out] выходное сообщение */
+	size_t* out_len,				/*!< [out] длина out */
+	size_t sid,						/*!< [in] номер сеанса */
+	const octet in[],				/*!< [in] входное сообщение */
+	size_t in_len,					/*!< [in] длина in */
+	const bake_cert* certa,			/*!< [in] сертификат стороны A */
+	void* state						/*!< [in,out] состояние */
+);
+
+/*!	\brief Пакетная обработка событий
+
+	Для каждого из событий ev[0], ev[1],..., ev[count - 1] вызывается 
+	функция bakeSrvStep(). Результаты записываются в поля out_len, code 
+	событий.
+	\remark Сеансы, указанные в событиях, должны быть различными.
+*/
+void bakeSrvStepBatch(
+	bake_srv_event ev[],			/*!< [in,out] события */
+	size_t count,					/*!< [in] число событий */
+	void* state						/*!< [in,out] состояние */
+);
+
+/*!	\brief Сеанс завершен?
+
+	Проверяется, что протокол в сеансе sid сервера state завершен.
+	\return Признак завершения.
+*/
+bool_t bakeSrvIsDone(
+	size_t sid,						/*!< [in] номер сеанса */
+	const void* state				/*!< [in] состояние */
+);
+
+/*!	\brief Извлечение ключа сеанса
+
+	Определяется общий ключ key, выработанный в сеансе sid сервера state.
+	\expect{ERR_BAD_INPUT} Сеанс sid открыт.
+	\expect{ERR_BAD_LOGIC} Протокол в сеансе завершен.
+	\return ERR_OK, если ключ успешно извлечен, и код ошибки в противном 
+	случае.
+*/
+err_t bakeSrvStepG(
+	octet key[32],					/*!< [out] общий ключ */
+	size_t sid,						/*!< [in] номер сеанса */
+	void* state						/*!< [in,out] состояние */
+);
+
+/*!	\brief Закрытие сеанса
+
+	Сеанс sid сервера state закрывается, его ячейка очищается и возвращается 
+	в пул. Закрытие свободной ячейки игнорируется.
+*/
+void bakeSrvClose(
+	size_t sid,						/*!< [in] номер сеанса */
+	void* state						/*!< [in,out] состояние */
+);
+
+/*!	\brief Число открытых сеансов
+
+	Возвращается число открытых сеансов сервера state.
+	\return Число открытых сеансов.
+*/
+size_t bakeSrvActive(
+	const void* state				/*!< [in] состояние */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -4,7 +4,7 @@
 \brief STB 34.101.60 (bels): secret sharing algorithms
 \project bee2 [cryptographic library]
 \created 2013.05.14
-\version 2023.02.02
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -325,6 +325,98 @@ err_t belsRecover2(
 	const octet si[]		/*!< [in] частичные секреты */
 );
 
+/*
+*******************************************************************************
+Контекст
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста
+
+	Возвращается длина контекста для разделения секретов из len октетов
+	между count пользователями и их восстановления.
+	\pre len == 16 || len == 24 || len == 32.
+	\return Длина контекста.
+*/
+size_t belsCtx_keep(
+	size_t count,			/*!< [in] число пользователей */
+	size_t len				/*!< [in] длина секрета в октетах */
+);
+
+/*!	\brief Запуск контекста
+
+	По общему открытому ключу [len]m0 и открытым ключам пользователей 
+	из массива [count * len]mi запускается контекст ctx. В контексте 
+	сохраняются данные, которые позволяют разделять секреты между 
+	пользователями и восстанавливать секреты по частичным секретам 
+	всех count пользователей без повторных расчетов, зависящих 
+	только от открытых ключей.
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	count > 0.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи m0, mi корректны и отличаются 
+	друг от друга.
+	\return ERR_OK, если контекст успешно запущен, и код ошибки 
+	в противном случае.
+	\remark Проверяется, что открытые ключи корректны и отличаются 
+	друг от друга.
+*/
+err_t belsCtxStart(
+	void* ctx,				/*!< [out] контекст */
+	size_t count,			/*!< [in] число пользователей */
+	size_t len,				/*!< [in] длина секрета в октетах */
+	const octet m0[],		/*!< [in] общий открытый ключ */
+	const octet mi[]		/*!< [in] открытые ключи пользователей */
+);
+
+/*!	\brief Разделение секретов на контексте
+
+	Каждый из секретов массива [num * len]s разделяется с порогом threshold 
+	на count частичных секретов. Параметры count, len и открытые ключи 
+	определяются контекстом ctx. Частичные секреты размещаются в массиве 
+	[num * count * len]si: сначала частичные секреты первого секрета, затем 
+	второго и т.д. Частичные секреты одного секрета размещаются так же, 
+	как в belsShare().
+	\expect{ERR_BAD_INPUT} 
+	-	контекст ctx корректен;
+	-	0 < threshold <= count.
+	.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Генератор rng является криптографически стойким.
+	\return ERR_OK, если секреты успешно разделены, и код ошибки
+	в противном случае.
+	\remark Результат совпадает с результатом num последовательных вызовов 
+	belsShare() с тем же генератором.
+*/
+err_t belsCtxShare(
+	octet si[],				/*!< [out] частичные секреты */
+	size_t num,				/*!< [in] число секретов */
+	size_t threshold,		/*!< [in] пороговое число */
+	const octet s[],		/*!< [in] секреты */
+	gen_i rng,				/*!< [in] генератор случайных чисел */
+	void* rng_state,		/*!< [in,out] состояние генератора */
+	const void* ctx			/*!< [in] контекст */
+);
+
+/*!	\brief Восстановление секретов на контексте
+
+	Каждый из num секретов массива [num * len]s восстанавливается по count 
+	частичным секретам. Параметры count, len и открытые ключи определяются 
+	контекстом ctx. Частичные секреты размещаются в массиве 
+	[num * count * len]si так же, как в belsCtxShare().
+	\expect{ERR_BAD_INPUT} Контекст ctx корректен.
+	\return ERR_OK, если секреты успешно восстановлены, и код ошибки 
+	в противном случае.
+	\remark Результат совпадает с результатом num вызовов belsRecover().
+*/
+err_t belsCtxRecover(
+	octet s[],				/*!< [out] восстановленные секреты */
+	size_t num,				/*!< [in] число секретов */
+	const octet si[],		/*!< [in] частичные секреты */
+	const void* ctx			/*!< [in] контекст */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
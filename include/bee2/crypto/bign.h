@@ -4,7 +4,7 @@
 \brief STB 34.101.45 (bign): digital signature and key transport algorithms
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.25
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -463,6 +463,85 @@ err_t bignKeyUnwrap(
 *******************************************************************************
 \file bign.h
 
+\section bign-ctx Контекст кривой
+
+Сторона, которая многократно создает токены ключа при одних и тех же 
+долговременных параметрах, может заранее подготовить контекст кривой. 
+Контекст содержит описание эллиптической кривой и таблицу кратных базовой 
+точки G, с помощью которой кратные G вычисляются быстрее, чем в функции 
+bignKeyWrap().
+
+Контекст создается функцией bignCtxStart() и используется в функции 
+bignKeyWrapBatch() вместо параметров. Контекст не содержит секретных данных 
+и не изменяется после создания, поэтому его можно одновременно использовать 
+в нескольких потоках.
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста кривой
+
+	Возвращается длина контекста (в октетах) для параметров с уровнем 
+	стойкости l.
+	\pre l == 128 || l == 192 || l == 256.
+	\return Длина контекста.
+*/
+size_t bignCtx_keep(
+	size_t l					/*!< [in] уровень стойкости */
+);
+
+/*!	\brief Создание контекста кривой
+
+	По долговременным параметрам params в ctx формируется контекст кривой.
+	\pre По адресу ctx зарезервировано bignCtx_keep(params->l) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст успешно создан, и код ошибки в противном 
+	случае.
+*/
+err_t bignCtxStart(
+	void* ctx,					/*!< [out] контекст */
+	const bign_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Создание токенов ключа для нескольких получателей
+
+	Для каждого из count получателей создается токен 
+	[l / 4 + 16 + len](tokens + (l / 4 + 16 + len) * i) ключа [len]key 
+	с заголовком [16]header. При создании i-го токена используются 
+	долговременные параметры, которые содержатся в контексте ctx, открытый 
+	ключ получателя [l / 2](pubkeys + l / 2 * i) и генератор rng 
+	с состоянием rng_state.
+	\expect{ERR_BAD_INPUT} 
+	-	контекст ctx создан функцией bignCtxStart();
+	-	len >= 16;
+	-	буфер tokens не пересекается с буферами key и header.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи pubkeys корректны.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если токены успешно созданы, и код ошибки в противном
+	случае.
+	\remark Одноразовые ключи вырабатываются в вызывающем потоке в порядке 
+	следования получателей. Поэтому токены совпадают с токенами, которые 
+	создаются последовательными вызовами bignKeyWrap() с тем же генератором.
+	\remark Токены могут создаваться в нескольких потоках. Генератор rng 
+	вызывается только из вызывающего потока.
+*/
+err_t bignKeyWrapBatch(
+	octet tokens[],				/*!< [out] токены ключа */
+	const void* ctx,			/*!< [in] контекст */
+	const octet key[],			/*!< [in] транспортируемый ключ */
+	size_t len,					/*!< [in] длина ключа в октетах */
+	const octet header[16],		/*!< [in] заголовок ключа */
+	size_t count,				/*!< [in] число получателей */
+	const octet pubkeys[],		/*!< [in] открытые ключи получателей */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in,out] состояние генератора */
+);
+
+/*!
+*******************************************************************************
+\file bign.h
+
 \section bign-ibs Идентификационная ЭЦП
 
 Идентификационная подпись при передаче и хранении должна объединяться 
@@ -592,6 +671,47 @@ err_t bignIdVerify(
 	const octet pubkey[]		/*!< [in] открытый ключ доверенной стороны */
 );
 
+/*!	\brief Пакетная проверка идентификационных ЭЦП
+
+	Проверяются count идентификационных ЭЦП, выработанных с участием одной 
+	доверенной стороны с открытым ключом [l / 4]pubkey. i-я подпись 
+	[3 * l / 8](id_sigs + 3 * l / 8 * i) проверяется так же, как в функции
+	bignIdVerify(), с хэш-значением сообщения [l / 4](hashes + l / 4 * i),
+	хэш-значением идентификатора [l / 4](id_hashes + l / 4 * i) и открытым 
+	ключом [l / 2](id_pubkeys + l / 2 * i). Если codes != 0, то в codes[i] 
+	записывается код результата проверки i-й подписи.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_OID} Идентификатор oid_der корректен.
+	\expect{ERR_BAD_PUBKEY}
+	-	открытые ключи id_pubkeys получены с помощью функции bignIdExtract();
+	-	открытый ключ pubkey корректен.
+	.
+	\return ERR_OK, если все подписи корректны, и код ошибки первой
+	некорректной подписи в противном случае.
+	\remark Если codes == 0, то проверка прекращается на первой 
+	некорректной подписи.
+	\remark Описание кривой, открытый ключ pubkey и хэширование oid_der 
+	обрабатываются один раз. При обработке нескольких подписей строятся 
+	таблицы предвычислений для базовой точки и pubkey, что ускоряет 
+	проверку каждой подписи.
+	\remark Проверочные соотношения подписей не объединяются случайной 
+	линейной комбинацией: в алгоритме B.2.5 проверяется хэш-значение 
+	от точки V, а не равенство точек. Поэтому результат пакетной проверки 
+	совпадает с результатами поэлементных вызовов bignIdVerify().
+*/
+err_t bignIdVerifyBatch(
+	err_t codes[],				/*!< [out] коды результатов (или 0) */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet oid_der[],		/*!< [in] идентификатор хэш-алгоритма */
+	size_t oid_len,				/*!< [in] длина oid_der в октетах */
+	size_t count,				/*!< [in] число подписей */
+	const octet id_hashes[],	/*!< [in] хэш-значения идентификаторов */
+	const octet hashes[],		/*!< [in] хэш-значения сообщений */
+	const octet id_sigs[],		/*!< [in] подписи */
+	const octet id_pubkeys[],	/*!< [in] открытые ключи */
+	const octet pubkey[]		/*!< [in] открытый ключ доверенной стороны */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
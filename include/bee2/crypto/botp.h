@@ -4,7 +4,7 @@
 \brief STB 34.101.47/botp: OTP algorithms
 \project bee2 [cryptographic library]
 \created 2015.11.02
-\version 2023.02.02
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -125,6 +125,12 @@ void botpCtrNext(
 botpHOTPStepV() счетчик, размещенный в состоянии, инкрементируется. 
 Обновленный счетчик можно использовать для генерации или проверки нового 
 пароля. Выгрузить счетчик из состояния можно с помощью функции botpHOTPStepG().
+
+Состояние режима HOTP содержит ключ HMAC, подготовленный в botpHOTPStart(). 
+Сервер, обслуживающий многих пользователей, может хранить состояния 
+пользователей и проверять пароли без повторной подготовки ключей. Функция 
+botpHOTPStepVW() проверяет пароль в окне из нескольких последовательных 
+значений счетчика (RFC 4226, п. 7.4).
 *******************************************************************************
 */
 
@@ -187,6 +193,25 @@ bool_t botpHOTPStepV(
 	void* state				/*!< [in,out] состояние */
 );
 
+/*!	\brief Проверка пароля в окне режима HOTP
+
+	По числу digit, ключу и счетчику ctr, размещенным в state, строятся 
+	одноразовые пароли для счетчиков ctr, ctr + 1,..., ctr + window - 1. 
+	Построенные пароли сравниваются с otp. Если найдено совпадение, 
+	то счетчик в state устанавливается в значение, следующее за первым 
+	подошедшим. Иначе счетчик не меняется.
+	\expect botpHOTPStepS() < botpHOTPStepVW()*.
+	\return Признак совпадения паролей.
+	\remark Пароли строятся парами соседних счетчиков. Просмотр 
+	окна прекращается после первой пары, в которой найдено совпадение. 
+	При отсутствии совпадения пароли строятся для всех счетчиков окна.
+*/
+bool_t botpHOTPStepVW(
+	const char* otp,		/*!< [in] контрольный пароль */
+	size_t window,			/*!< [in] размер окна */
+	void* state				/*!< [in,out] состояние */
+);
+
 /*!	\brief Возврат счетчика
 
 	В ctr возвращается текущий счетчик, размещенный в state.
@@ -300,6 +325,34 @@ bool_t botpTOTPStepV(
 	void* state				/*!< [in,out] состояние */
 );
 
+/*!	\brief Проверка пароля в окне режима TOTP
+
+	По округленной отметке t текущего времени, по числу digit и ключу, 
+	размещенным в state, строятся одноразовые пароли для отметок 
+	t - back,..., t + fwd. Построенные пароли сравниваются с otp. Отметки 
+	просматриваются в порядке t, t - 1, t + 1, t - 2, t + 2,..., и в ts 
+	возвращается первая отметка, для которой пароль подошел (или TIME_ERR).
+	\pre t != TIME_ERR.
+	\pre Буфер ts либо нулевой, либо не пересекается с другими буферами.
+	\expect botpTOTPStart() < botpTOTPStepVW()*.
+	\return Признак совпадения паролей.
+	\remark Пароли строятся парами соседних (в порядке просмотра) 
+	отметок. Просмотр окна прекращается после первой пары, в которой 
+	найдено совпадение. При отсутствии совпадения пароли строятся для всех 
+	отметок окна. Отметки, меньшие 0 или не представимые в tm_time_t, 
+	пропускаются.
+	\remark Отметку ts рекомендуется сохранять и отклонять последующие 
+	пароли с отметками, не превосходящими ts (защита от повтора).
+*/
+bool_t botpTOTPStepVW(
+	tm_time_t* ts,			/*!< [out] подошедшая отметка времени */
+	const char* otp,		/*!< [in] контрольный пароль */
+	tm_time_t t,			/*!< [in] округленная отметка времени */
+	size_t back,			/*!< [in] число отметок назад */
+	size_t fwd,				/*!< [in] число отметок вперед */
+	void* state				/*!< [in,out] состояние */
+);
+
 /*!	\brief Генерация пароля в режиме TOTP
 
 	По числу digit, ключу [key_len]key и округленной отметке t текущего 
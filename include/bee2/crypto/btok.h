@@ -4,7 +4,7 @@
 \brief STB 34.101.79 (btok): cryptographic tokens
 \project bee2 [cryptographic library]
 \created 2022.07.04
-\version 2023.06.17
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -532,9 +532,26 @@ err_t btokCVCMatch(
 \pre Входные и выходные буферы функций SM не пересекаются друг с другом.
 
 \remark Признаком защиты команды является бит 0x04 в поле CLA.
+
+\remark Ключи SM хранятся в состоянии в подготовленном виде (состояние 
+belt-mac после загрузки ключа, форматированный ключ belt-block), поэтому 
+обработка очередного APDU не требует повторной загрузки ключей.
+
+Функции btokSMCmdWrap2() и btokSMRespWrap2() предназначены для быстрой
+установки защиты. Данные команды (ответа) передаются в них набором 
+фрагментов, которые не нужно предварительно собирать в структуре 
+apdu_cmd_t (apdu_resp_t). Фрагменты зашифровываются непосредственно 
+в выходной буфер, и в том же проходе вычисляется имитовставка.
 *******************************************************************************
 */
 
+/*!	\brief Фрагмент данных APDU */
+typedef struct
+{
+	const void* buf;	/*!< данные */
+	size_t len;			/*!< длина данных в октетах */
+} btok_sm_frag;
+
 /*!	\brief Длина состояния SM
 
 	Возвращается длина состояния (в октетах) функций SM.
@@ -588,6 +605,35 @@ err_t btokSMCmdWrap(
 	void* state					/*!< [in,out] состояние SM */
 );
 
+/*!	\brief Кодирование и установка защиты команды по фрагментам
+
+	Команда с заголовком hdr = CLA || INS || P1 || P2, максимальной длиной 
+	данных ответа rdf_len и данными команды, составленными из фрагментов 
+	cdf[0], cdf[1],..., cdf[n - 1], кодируется и защищается с помощью 
+	объектов SM, размещенных в state. Результат возвращается в буфере 
+	[count?]apdu. Если apdu == 0, то определяется только длина кода.
+	\pre По адресу state зарезервировано btokSM_keep() октетов.
+	\pre Фрагменты не пересекаются с apdu.
+	\expect btokSMStart() < btokSMCmdWrap2()*.
+	\expect{ERR_BAD_APDU} В hdr[0] (CLA) снят бит 0x04 (признак защиты).
+	\expect{ERR_BAD_APDU} Общая длина фрагментов меньше 65536, 
+	rdf_len <= 65536.
+	\expect{ERR_BAD_LOGIC} Непосредственно а момент установки защиты
+	(apdu != 0) счетчик SM принимает нечетное значение.
+	\return ERR_OK в случае успеха и код ошибки в противном случае.
+	\remark Результат совпадает с результатом btokSMCmdWrap() для команды, 
+	данные которой получены конкатенацией фрагментов.
+*/
+err_t btokSMCmdWrap2(
+	octet apdu[],				/*!< [out] код команды */
+	size_t* count,				/*!< [out] длина кода команды */
+	const octet hdr[4],			/*!< [in] заголовок команды */
+	size_t rdf_len,				/*!< [in] максимальная длина данных ответа */
+	const btok_sm_frag cdf[],	/*!< [in] фрагменты данных команды */
+	size_t n,					/*!< [in] число фрагментов */
+	void* state					/*!< [in,out] состояние SM */
+);
+
 /*!	\brief Декодирование и снятие защиты команды с помощью SM
 
 	Код команды [count]apdu декодируется и одновременно с него снимается
@@ -630,6 +676,32 @@ err_t btokSMRespWrap(
 	void* state					/*!< [in,out] состояние SM */
 );
 
+/*!	\brief Кодирование и установка защиты ответа по фрагментам
+
+	Ответ со статусами sw = SW1 || SW2 и данными, составленными из 
+	фрагментов rdf[0], rdf[1],..., rdf[n - 1], кодируется и защищается 
+	с помощью объектов SM, размещенных в state. Результат возвращается 
+	в буфере [count?]apdu. Если apdu == 0, то определяется только длина 
+	кода.
+	\pre По адресу state зарезервировано btokSM_keep() октетов.
+	\pre Фрагменты не пересекаются с apdu.
+	\expect btokSMStart() < btokSMRespWrap2()*.
+	\expect{ERR_BAD_APDU} Общая длина фрагментов не превосходит 65536.
+	\expect{ERR_BAD_LOGIC} Непосредственно а момент установки защиты
+	(apdu != 0) счетчик SM принимает четное значение.
+	\return ERR_OK в случае успеха и код ошибки в противном случае.
+	\remark Результат совпадает с результатом btokSMRespWrap() для ответа, 
+	данные которого получены конкатенацией фрагментов.
+*/
+err_t btokSMRespWrap2(
+	octet apdu[],				/*!< [out] код ответа */
+	size_t* count,				/*!< [out] длина кода ответа */
+	const btok_sm_frag rdf[],	/*!< [in] фрагменты данных ответа */
+	size_t n,					/*!< [in] число фрагментов */
+	const octet sw[2],			/*!< [in] статусы */
+	void* state					/*!< [in,out] состояние SM */
+);
+
 /*!	\brief Декодирование и снятие защиты ответа с помощью SM
 
 	Код ответа [count]apdu декодируется и одновременно с него снимается
@@ -4,7 +4,7 @@
 \brief DSTU 4145-2002 (Ukraine): digital signature algorithms
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -279,6 +279,105 @@ err_t dstuVerify(
 	const octet pubkey[]			/*!< [in] открытый ключ */
 );
 
+/*
+*******************************************************************************
+Контекст кривой
+
+Сторона, которая многократно выполняет операции при одних и тех же 
+долговременных параметрах, может заранее подготовить контекст кривой. 
+Контекст содержит описание эллиптической кривой и таблицу кратных базовой 
+точки, с помощью которой кратные базовой точки вычисляются быстрее, чем 
+в функциях dstuKeypairGen(), dstuSign().
+
+Контекст создается функцией dstuCtxStart() и используется в функциях 
+dstuKeypairGen2(), dstuSign2(), dstuVerify2() вместо параметров. 
+В результате при вызове функций не выполняется построение описания кривой. 
+Контекст не содержит секретных данных и не изменяется после создания, 
+поэтому его можно одновременно использовать в нескольких потоках.
+
+\remark В функциях dstuKeypairGen(), dstuSign() кратная базовой точки
+вычисляется с помощью лестницы Монтгомери, в функциях dstuKeypairGen2(),
+dstuSign2() -- с помощью регулярного гребенчатого метода. В обоих случаях
+последовательность операций не зависит от кратности (личного или
+одноразового ключа).
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста кривой
+
+	Возвращается длина контекста (в октетах) для параметров со степенью 
+	расширения базового поля m.
+	\return Длина контекста.
+*/
+size_t dstuCtx_keep(
+	size_t m						/*!< [in] степень расширения */
+);
+
+/*!	\brief Создание контекста кривой
+
+	По долговременным параметрам params в ctx формируется контекст кривой.
+	\pre По адресу ctx зарезервировано dstuCtx_keep(params->p[0]) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст успешно создан, и код ошибки в противном 
+	случае.
+*/
+err_t dstuCtxStart(
+	void* ctx,						/*!< [out] контекст */
+	const dstu_params* params		/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Генерация пары ключей по контексту
+
+	Выполняются действия функции dstuKeypairGen() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией dstuCtxStart().
+	\return ERR_OK, если ключи сгенерированы, и код ошибки
+	в противном случае.
+*/
+err_t dstuKeypairGen2(
+	octet privkey[],				/*!< [out] личный ключ */
+	octet pubkey[],					/*!< [out] открытый ключ */
+	const void* ctx,				/*!< [in] контекст */
+	gen_i rng,						/*!< [in] генератор случайных чисел */
+	void* rng_state					/*!< [in,out] состояние генератора */
+);
+
+/*!	\brief Выработка ЭЦП по контексту
+
+	Выполняются действия функции dstuSign() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией dstuCtxStart().
+	\return ERR_OK, если подпись выработана, и код ошибки в противном
+	случае.
+*/
+err_t dstuSign2(
+	octet sig[],					/*!< [out] подпись */
+	const void* ctx,				/*!< [in] контекст */
+	size_t ld,						/*!< [in] длина подписи в битах */
+	const octet hash[],				/*!< [in] хэш-значение */
+	size_t hash_len,				/*!< [in] длина хэш-значения в октетах */
+	const octet privkey[],			/*!< [in] личный ключ */
+	gen_i rng,						/*!< [in] генератор случайных чисел */
+	void* rng_state					/*!< [in,out] состояние генератора */
+);
+
+/*!	\brief Проверка ЭЦП по контексту
+
+	Выполняются действия функции dstuVerify() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией dstuCtxStart().
+	\return ERR_OK, если подпись корректна, и код ошибки в противном
+	случае.
+*/
+err_t dstuVerify2(
+	const void* ctx,				/*!< [in] контекст */
+	size_t ld,						/*!< [in] длина подписи в битах */
+	const octet hash[],				/*!< [in] хэш-значение */
+	size_t hash_len,				/*!< [in] длина хэш-значения в октетах */
+	const octet sig[],				/*!< [in] подпись */
+	const octet pubkey[]			/*!< [in] открытый ключ */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
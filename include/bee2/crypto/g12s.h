@@ -4,7 +4,7 @@
 \brief GOST R 34.10-94 (Russia): digital signature algorithms
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -225,6 +225,102 @@ err_t g12sVerify(
 	const octet pubkey[]		/*!< [in] открытый ключ */
 );
 
+/*!
+*******************************************************************************
+\file g12s.h
+
+\section g12s-ctx Контекст кривой
+
+Сторона, которая многократно выполняет операции при одних и тех же 
+долговременных параметрах, может заранее подготовить контекст кривой. 
+Контекст содержит описание эллиптической кривой и таблицу кратных базовой 
+точки P, с помощью которой кратные P вычисляются быстрее, чем в функциях 
+g12sKeypairGen(), g12sSign().
+
+Контекст создается функцией g12sCtxStart() и используется в функциях 
+g12sKeypairGen2(), g12sSign2(), g12sVerify2() вместо параметров. 
+В результате при вызове функций не выполняется построение описания кривой. 
+Контекст не содержит секретных данных и не изменяется после создания, 
+поэтому его можно одновременно использовать в нескольких потоках.
+
+\remark В функциях g12sKeypairGen2(), g12sSign2() кратная точка
+вычисляется с помощью регулярного гребенчатого метода: последовательность
+операций и обращения к таблице не зависят от кратности (личного или
+одноразового ключа).
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста кривой
+
+	Возвращается длина контекста (в октетах) для параметров с уровнем 
+	стойкости l.
+	\pre l == 256 || l == 512.
+	\return Длина контекста.
+*/
+size_t g12sCtx_keep(
+	size_t l					/*!< [in] уровень стойкости */
+);
+
+/*!	\brief Создание контекста кривой
+
+	По долговременным параметрам params в ctx формируется контекст кривой.
+	\pre По адресу ctx зарезервировано g12sCtx_keep(params->l) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст успешно создан, и код ошибки в противном 
+	случае.
+*/
+err_t g12sCtxStart(
+	void* ctx,					/*!< [out] контекст */
+	const g12s_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Генерация пары ключей по контексту
+
+	Выполняются действия функции g12sKeypairGen() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией g12sCtxStart().
+	\return ERR_OK, если ключи сгенерированы, и код ошибки в противном
+	случае.
+*/
+err_t g12sKeypairGen2(
+	octet privkey[],			/*!< [out] личный ключ */
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* ctx,			/*!< [in] контекст */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in,out] состояние генератора */
+);
+
+/*!	\brief Выработка ЭЦП по контексту
+
+	Выполняются действия функции g12sSign() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией g12sCtxStart().
+	\return ERR_OK, если подпись выработана, и код ошибки в противном
+	случае.
+*/
+err_t g12sSign2(
+	octet sig[],				/*!< [out] подпись */
+	const void* ctx,			/*!< [in] контекст */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet privkey[],		/*!< [in] личный ключ */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in,out] состояние генератора */
+);
+
+/*!	\brief Проверка ЭЦП по контексту
+
+	Выполняются действия функции g12sVerify() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией g12sCtxStart().
+	\return ERR_OK, если подпись корректна, и код ошибки в противном случае.
+*/
+err_t g12sVerify2(
+	const void* ctx,			/*!< [in] контекст */
+	const octet hash[],			/*!< [in] хэш-значение */
+	const octet sig[],			/*!< [in] подпись */
+	const octet pubkey[]		/*!< [in] открытый ключ */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
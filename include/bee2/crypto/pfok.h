@@ -4,7 +4,7 @@
 \brief Draft of RD_RB: key establishment protocols in finite fields
 \project bee2 [cryptographic library]
 \created 2014.06.30
-\version 2024.01.11
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -347,6 +347,79 @@ err_t pfokMTI(
 	const octet pubkey1[]		/*!< [in] однораз. откр. ключ (др. стороны) */
 );
 
+/*!
+*******************************************************************************
+\file pfok.h
+
+\section pfok-ctx Контекст фиксированного основания
+
+Сторона, которая многократно вырабатывает ключи при одних и тех же 
+долговременных параметрах, может заранее подготовить контекст 
+фиксированного основания. Контекст содержит таблицу предвычисленных 
+степеней образующего g, с помощью которой степени g^(x) вычисляются 
+быстрее, чем в функциях pfokKeypairGen(), pfokPubkeyCalc().
+
+Контекст создается функцией pfokCtxStart() и используется в функциях 
+pfokKeypairGen2(), pfokPubkeyCalc2() вместо параметров. Контекст 
+не содержит секретных данных и не изменяется после создания, поэтому его 
+можно одновременно использовать в нескольких потоках.
+*******************************************************************************
+*/
+
+/*!	\brief Длина контекста фиксированного основания
+
+	Возвращается длина контекста (в октетах) для параметров с битовой 
+	длиной модуля l.
+	\return Длина контекста.
+*/
+size_t pfokCtx_keep(
+	size_t l					/*!< [in] битовая длина p */
+);
+
+/*!	\brief Создание контекста фиксированного основания
+
+	По долговременным параметрам params в ctx формируется контекст 
+	фиксированного основания.
+	\pre По адресу ctx зарезервировано pfokCtx_keep(params->l) октетов.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если контекст успешно создан, и код ошибки в противном 
+	случае.
+*/
+err_t pfokCtxStart(
+	void* ctx,					/*!< [out] контекст */
+	const pfok_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Генерация пары ключей по контексту
+
+	Выполняются действия функции pfokKeypairGen() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией pfokCtxStart().
+	\return ERR_OK, если ключи успешно сгенерированы, и код ошибки
+	в противном случае.
+*/
+err_t pfokKeypairGen2(
+	octet privkey[],			/*!< [out] личный ключ */
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* ctx,			/*!< [in] контекст */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in,out] состояние генератора */
+);
+
+/*!	\brief Построение открытого ключа по контексту
+
+	Выполняются действия функции pfokPubkeyCalc() при долговременных 
+	параметрах, которые содержатся в контексте ctx.
+	\expect{ERR_BAD_INPUT} Контекст ctx создан функцией pfokCtxStart().
+	\return ERR_OK, если открытый ключ успешно построен, и код ошибки
+	в противном случае.
+*/
+err_t pfokPubkeyCalc2(
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* ctx,			/*!< [in] контекст */
+	const octet privkey[]		/*!< [in] личный ключ */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -4,7 +4,7 @@
 \brief Elliptic curves
 \project bee2 [cryptographic library]
 \created 2012.04.19
-\version 2023.03.30
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -568,6 +568,120 @@ bool_t ecMulA(
 
 size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
 
+/*!	\brief Предвычисления для кратных фиксированной точки
+
+	Для аффинной точки [2 * ec->f->n]a эллиптической кривой ec 
+	рассчитывается таблица [(2^w - 1) * 2 * ec->f->n]pre аффинных точек,
+	которая используется при вычислении кратных a функцией ecMulCombA()
+	(гребенчатый метод с шириной гребенки w). Таблица рассчитывается для 
+	кратностей длины m машинных слов.
+	\pre Описание ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\pre 1 <= w <= 8.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec и имеет большой порядок.
+	\return TRUE, если все точки таблицы являются аффинными, и FALSE 
+	в противном случае.
+	\deep{stack} ecPreCombA_deep(ec->f->n, ec->d, ec->deep).
+*/
+bool_t ecPreCombA(
+	word pre[],			/*!< [out] таблица предвычислений */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t w,			/*!< [in] ширина гребенки */
+	size_t m,			/*!< [in] длина кратностей в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecPreCombA_deep(size_t n, size_t ec_d, size_t ec_deep);
+
+/*!	\brief Кратная фиксированной точки
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной точки a. Вместо a передается таблица 
+	предвычислений [(2^w - 1) * 2 * ec->f->n]pre, построенная функцией 
+	ecPreCombA() с теми же w и m.
+	\pre Описание ec работоспособно.
+	\pre 1 <= w <= 8.
+	\expect Таблица pre построена функцией ecPreCombA().
+	\return TRUE, если кратная точка является аффинной, и FALSE в противном
+	случае (b == O).
+	\remark Функция выполняет ceil(B_OF_W(m) / w) удвоений и не более 
+	стольких же сложений, и поэтому значительно быстрее ecMulA() при 
+	w >= 4. Время выполнения зависит от d.
+	\deep{stack} ecMulCombA_deep(ec->f->n, ec->d, ec->deep).
+*/
+bool_t ecMulCombA(
+	word b[],			/*!< [out] кратная точка */
+	const word pre[],	/*!< [in] таблица предвычислений */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t w,			/*!< [in] ширина гребенки */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulCombA_deep(size_t n, size_t ec_d, size_t ec_deep);
+
+/*!	\brief Предвычисления для регулярных кратных фиксированной точки
+
+	Для аффинной точки [2 * ec->f->n]a эллиптической кривой ec 
+	рассчитывается таблица [2^w * 2 * ec->f->n]pre аффинных точек,
+	которая используется при вычислении кратных a функцией ecMulSCombA()
+	(регулярный гребенчатый метод с шириной гребенки w). Таблица
+	рассчитывается для кратностей длины m машинных слов.
+	\pre Описание ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\pre 1 <= w <= 8.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec и имеет большой порядок.
+	\return TRUE, если все точки таблицы являются аффинными, и FALSE 
+	в противном случае.
+	\deep{stack} ecPreSCombA_deep(ec->f->n, ec->d, ec->deep).
+*/
+bool_t ecPreSCombA(
+	word pre[],			/*!< [out] таблица предвычислений */
+	const word a[],		/*!< [in] базовая точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t w,			/*!< [in] ширина гребенки */
+	size_t m,			/*!< [in] длина кратностей в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecPreSCombA_deep(size_t n, size_t ec_d, size_t ec_deep);
+
+/*!	\brief Регулярная кратная фиксированной точки
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной точки a порядка ec->order. Вместо a
+	передается таблица предвычислений [2^w * 2 * ec->f->n]pre, построенная
+	функцией ecPreSCombA() с теми же w и m.
+	\pre Описание ec работоспособно.
+	\pre 1 <= w <= 8.
+	\pre Порядок ec->order нечетен и укладывается в m машинных слов.
+	\pre d < ec->order.
+	\expect Таблица pre построена функцией ecPreSCombA().
+	\expect 0 < d.
+	\return TRUE, если кратная точка является аффинной, и FALSE в противном
+	случае (b == O).
+	\remark Функция выполняет ceil(B_OF_W(m) / w) - 1 удвоений и столько же
+	сложений. Последовательность операций и обращения к памяти не зависят
+	от d. Функцию следует применять для секретных кратностей. Для открытых 
+	кратностей быстрее ecMulCombA().
+	\deep{stack} ecMulSCombA_deep(ec->f->n, ec->d, ec->deep, m).
+*/
+bool_t ecMulSCombA(
+	word b[],			/*!< [out] кратная точка */
+	const word pre[],	/*!< [in] таблица предвычислений */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	size_t w,			/*!< [in] ширина гребенки */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulSCombA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
+
 /*!	\brief Имеет порядок?
 
 	Проверяется, что аффинная точка [2 * ec->f->n]a имеет порядок [m]q 
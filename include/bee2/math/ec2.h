@@ -4,7 +4,7 @@
 \brief Elliptic curves over binary fields
 \project bee2 [cryptographic library]
 \created 2012.04.19
-\version 2021.06.30
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -228,6 +228,45 @@ bool_t ec2SubAA(
 
 size_t ec2SubAA_deep(size_t n, size_t f_deep);
 
+/*
+*******************************************************************************
+Кратные точки
+*******************************************************************************
+*/
+
+/*!	\brief Кратная точка: лестница Монтгомери
+
+	Определяется кратная точка [2 * ec->f->n]b эллиптической кривой ec:
+	\code
+		b <- d a.
+	\endcode
+	Кратность [m]d обрабатывается по лестнице Монтгомери в проективных 
+	x-координатах Лопеса -- Дахаба. Обрабатывается фиксированное число 
+	битов d, равное битовой длине ec->order (или d, если d длиннее).
+	\pre Описание ec работоспособно.
+	\pre Описание группы точек ec работоспособно.
+	\pre Координаты a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на ec.
+	\return TRUE, если кратная точка является аффинной, и FALSE 
+	в противном случае (d a == O).
+	\remark Результат совпадает с результатом ecMulA(). По сравнению
+	с ecMulA() не используется предвычисление кратных a, а ветвления 
+	и обращения к памяти не зависят от битов d.
+	\remark На кривых Коблица (B == 1) удвоения выполняются быстрее.
+	\deep{stack} ec2MulLadderA_deep(n, ec->f->deep).
+*/
+bool_t ec2MulLadderA(
+	word b[],			/*!< [out] кратная точка */
+	const word a[],		/*!< [in] исходная точка */
+	const ec_o* ec,		/*!< [in] описание кривой */
+	const word d[],		/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в машинных словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ec2MulLadderA_deep(size_t n, size_t f_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -4,7 +4,7 @@
 \brief Primes
 \project bee2 [cryptographic library]
 \created 2012.08.13
-\version 2024.02.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -73,6 +73,8 @@ word priBasePrime(
 	Определяются остатки [count]mods от деления числа [n]a на первые count 
 	простых из факторной базы.
 	\pre count <= priBaseSize().
+	\remark Деления заменяются умножениями на заранее рассчитанные 
+	обратные к произведениям простых из факторной базы. 
 */
 void priBaseMod(
 	word mods[],		/*!< [out] остатки */
@@ -236,6 +238,9 @@ size_t priNextPrimeW_deep();
 	совпадают.
 	\pre base_count <= priBaseSize().
 	\return TRUE, если искомое простое найдено, и FALSE в противном случае.
+	\remark Кандидаты просеиваются окнами, непросеянные кандидаты длиной 
+	от 512 битов проверяются в нескольких потоках. Результат совпадает 
+	с результатом последовательной проверки кандидатов.
 	\deep{stack} priNextPrime_deep(n, base_count).
 */
 
@@ -310,6 +315,9 @@ size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count);
 	\remark Для применения теоремы Демитко требуется выполнение условия 
 	2 * a * r < 4 * q + 1. Ограничение l <= 2 * wwBitSize(q, n) гарантирует
 	выполнение этого условия.
+	\remark Кандидаты p просеиваются окнами, непросеянные кандидаты длиной 
+	от 512 битов проверяются в нескольких потоках. Результат зависит только 
+	от входных данных и выхода rng, но не от числа потоков.
 	\deep{stack} priExtendPrime2_deep(l, n, m, base_count).
 */
 
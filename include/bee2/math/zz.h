@@ -4,7 +4,7 @@
 \brief Multiple-precision unsigned integers
 \project bee2 [cryptographic library]
 \created 2012.04.22
-\version 2023.09.23
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -357,6 +357,7 @@ word zzSubMulW(
 		c <- a * b.
 	\endcode
 	\pre Буфер c не пересекается с буферами a и b.
+	\remark При n == m и достаточно больших n используется метод Карацубы.
 	\deep{stack} zzMul_deep(n, m).
 */
 void zzMul(
@@ -380,6 +381,7 @@ size_t zzMulADK(word c[], const word a[], const word b[], size_t n, void* stack)
 		b <- a * a.
 	\endcode
 	\pre Буфер b не пересекается с буфером a.
+	\remark При достаточно больших n используется метод Карацубы.
 	\deep{stack} zzSqr_deep(n).
 */
 void zzSqr(
@@ -1219,6 +1221,136 @@ word zzPowerModW(
 
 size_t zzPowerModW_deep();
 
+/*
+*******************************************************************************
+Арифметика Монтгомери
+
+Функции раздела работают с вычетами по нечетному модулю [n]mod в форме 
+Монтгомери: вычету u соответствует число u R \mod mod, R = B^n. Умножение 
+Монтгомери определяется как
+	u \circ v = u v R^{-1} \mod mod.
+Возведение в степень в группе Монтгомери обозначается круглыми скобками: 
+u^(v) --- произведение Монтгомери v экземпляров u.
+
+Для всех функций раздела:
+-	mod -- нечетное && mod[n - 1] != 0;
+-	mont_param рассчитан с помощью функции wordNegInv() по mod[0];
+-	длины показателей степени задаются в битах: показатель [W_OF_B(l)]b 
+	битовой длины не больше l. Время вычислений зависит только от l, 
+	но не от b.
+.
+*******************************************************************************
+*/
+
+/*!	\brief Умножение Монтгомери
+
+	Определяется произведение Монтгомери [n]c чисел [n]a и [n]b 
+	по модулю [n]mod:
+	\code
+		c <- a b R^{-1} \mod mod, R = B^n.
+	\endcode
+	\pre a, b < mod.
+	\pre Буфер c либо не пересекается, либо совпадает с буферами a, b.
+	\pre Буфер c не пересекается с буфером mod.
+	\remark Умножение и редукция выполняются за один проход (CIOS, 
+	[Koc C. K., Acar T., Kaliski B. S. Analyzing and comparing Montgomery 
+	multiplication algorithms. IEEE Micro, 16(3): 26-33, 1996]).
+	\deep{stack} zzMulMont_deep(n).
+	\safe Функция регулярна.
+*/
+void zzMulMont(
+	word c[],					/*!< [out] произведение */
+	const word a[],				/*!< [in] первый множитель */
+	const word b[],				/*!< [in] второй множитель */
+	const word mod[],			/*!< [in] модуль */
+	size_t n,					/*!< [in] длина чисел в машинных словах */
+	register word mont_param,	/*!< [in] параметр Монтгомери */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+size_t zzMulMont_deep(size_t n);
+
+/*!	\brief Возведение в степень Монтгомери
+
+	Определяется [W_OF_B(l)]b-ая степень Монтгомери [n]c числа [n]a 
+	по модулю [n]mod:
+	\code
+		c <- a^(b) = a^b R^{1 - b} \mod mod, R = B^n.
+	\endcode
+	\pre a < mod.
+	\pre wwBitSize(b) <= l.
+	\pre Буфер c либо не пересекается, либо совпадает с буфером a.
+	\remark Используется метод фиксированного окна. Выбор малой степени a 
+	из таблицы выполняется без ветвлений: просматриваются все элементы 
+	таблицы.
+	\remark 0^(0) == R \mod mod.
+	\deep{stack} zzPowerMont_deep(n, l).
+	\safe Функция регулярна.
+*/
+void zzPowerMont(
+	word c[],					/*!< [out] степень */
+	const word a[],				/*!< [in] основание */
+	const word b[],				/*!< [in] показатель */
+	size_t l,					/*!< [in] битовая длина b */
+	const word mod[],			/*!< [in] модуль */
+	size_t n,					/*!< [in] длина mod в машинных словах */
+	register word mont_param,	/*!< [in] параметр Монтгомери */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+size_t zzPowerMont_deep(size_t n, size_t l);
+
+/*!	\brief Предвычисления для фиксированного основания
+
+	Для возведения числа [n]a в степень Монтгомери с показателями битовой 
+	длины не больше l рассчитывается таблица [n * 2^w]pre (метод гребенки 
+	Лим -- Ли с шириной w).
+	\pre a < mod.
+	\pre 1 <= w <= 8 && w <= l.
+	\deep{stack} zzPowerMontPre_deep(n).
+*/
+void zzPowerMontPre(
+	word pre[],					/*!< [out] таблица предвычислений */
+	size_t w,					/*!< [in] ширина гребенки */
+	const word a[],				/*!< [in] основание */
+	size_t l,					/*!< [in] максимальная битовая длина показателя */
+	const word mod[],			/*!< [in] модуль */
+	size_t n,					/*!< [in] длина mod в машинных словах */
+	register word mont_param,	/*!< [in] параметр Монтгомери */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+size_t zzPowerMontPre_deep(size_t n);
+
+/*!	\brief Возведение фиксированного основания в степень Монтгомери
+
+	Определяется [W_OF_B(l)]b-ая степень Монтгомери [n]c числа a, 
+	для которого рассчитана таблица [n * 2^w]pre:
+	\code
+		c <- a^(b).
+	\endcode
+	\pre wwBitSize(b) <= l.
+	\expect Таблица pre рассчитана с помощью функции zzPowerMontPre() 
+	с теми же w и l.
+	\remark Выполняется ceil(l / w) возведений в квадрат и столько же
+	умножений. Элементы таблицы выбираются без ветвлений.
+	\deep{stack} zzPowerMontComb_deep(n).
+	\safe Функция регулярна.
+*/
+void zzPowerMontComb(
+	word c[],					/*!< [out] степень */
+	const word pre[],			/*!< [in] таблица предвычислений */
+	size_t w,					/*!< [in] ширина гребенки */
+	const word b[],				/*!< [in] показатель */
+	size_t l,					/*!< [in] битовая длина b */
+	const word mod[],			/*!< [in] модуль */
+	size_t n,					/*!< [in] длина mod в машинных словах */
+	register word mont_param,	/*!< [in] параметр Монтгомери */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+size_t zzPowerMontComb_deep(size_t n);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
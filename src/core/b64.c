@@ -4,13 +4,14 @@
 \brief The Base64 encoding
 \project bee2 [cryptographic library]
 \created 2016.06.16
-\version 2016.09.01
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
 #include "bee2/core/b64.h"
+#include "bee2/core/err.h"
 #include "bee2/core/mem.h"
 #include "bee2/core/str.h"
 #include "bee2/core/util.h"
@@ -19,7 +20,10 @@
 *******************************************************************************
 Таблицы
 
-\todo Кодировка base64url: + меняется на -, / меняется на _.
+Кодировка base64url отличается от base64 двумя последними символами
+алфавита: '+' меняется на '-', '/' меняется на '_'. Таблица декодирования
+b64_dec_table построена для base64, для base64url она корректируется
+функцией b64DecC().
 *******************************************************************************
 */
 
@@ -28,6 +32,11 @@ static const char b64_alphabet[] =
 	"abcdefghijklmnopqrstuvwxyz"
 	"0123456789+/";
 
+static const char b64url_alphabet[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+	"abcdefghijklmnopqrstuvwxyz"
+	"0123456789-_";
+
 static const octet b64_dec_table[256] = {
 	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
 	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
@@ -47,13 +56,170 @@ static const octet b64_dec_table[256] = {
 	0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
 };
 
+static octet b64DecC(char c, bool_t url)
+{
+	octet o = b64_dec_table[(octet)c];
+	if (url)
+	{
+		if (c == '-')
+			o = 62;
+		else if (c == '_')
+			o = 63;
+		else if (o >= 62)
+			o = 0xFF;
+	}
+	return o;
+}
+
+/*
+*******************************************************************************
+Кодирование и декодирование с помощью AVX2
+
+Используются алгоритмы из [Mula W., Lemire D. Faster Base64 Encoding and
+Decoding Using AVX2 Instructions. ACM Transactions on the Web, 2018].
+
+При кодировании за один шаг обрабатываются 24 октета: каждая 128-битовая
+половина регистра получает 12 октетов, которые инструкцией vpshufb
+расставляются так, что каждое 32-битовое слово содержит тройку октетов.
+Из троек выделяются 6-ки битов (умножения vpmulhuw и vpmullw заменяют
+сдвиги разной величины). Символ получается прибавлением к 6-ке сдвига,
+выбранного по номеру диапазона алфавита ('A'-'Z', 'a'-'z', '0'-'9', 62, 63).
+
+При декодировании за один шаг обрабатываются 32 символа. 6-ка получается
+прибавлением к символу сдвига, выбранного по старшему полуоктету символа
+(символ '/' обрабатывается отдельно). Символы base64url '-' и '_'
+предварительно заменяются на '+' и '/'. Корректность символов
+проверяется обратным кодированием: символ c корректен, если полученная
+по нему величина v меньше 64 и кодируется снова символом c. Кодирование
+6-ок инъективно, поэтому проверка точная. Блок, в котором встретился
+некорректный символ или символ '=', не обрабатывается, его обработка
+поручается вызывающей функции. 6-ки объединяются в октеты инструкциями
+vpmaddubsw и vpmaddwd.
+*******************************************************************************
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__i386__) || defined(__x86_64__))
+	#define B64_AVX2
+	#define B64_AVX2_FN __attribute__((target("avx2")))
+	#include <immintrin.h>
+#elif (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64))
+	#define B64_AVX2
+	#define B64_AVX2_FN
+	#include <immintrin.h>
+#endif
+
+#ifdef B64_AVX2
+
+B64_AVX2_FN static __m256i b64AVX2Lut(bool_t url)
+{
+	return url ?
+		_mm256_setr_epi8(71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17,
+			32, 65, 0, 0, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17,
+			32, 65, 0, 0) :
+		_mm256_setr_epi8(71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19,
+			-16, 65, 0, 0, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19,
+			-16, 65, 0, 0);
+}
+
+B64_AVX2_FN static __m256i b64AVX2Enc(__m256i x, __m256i lut)
+{
+	__m256i r = _mm256_subs_epu8(x, _mm256_set1_epi8(51));
+	__m256i t = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), x);
+	r = _mm256_or_si256(r, _mm256_and_si256(t, _mm256_set1_epi8(13)));
+	return _mm256_add_epi8(_mm256_shuffle_epi8(lut, r), x);
+}
+
+B64_AVX2_FN static size_t b64FromAVX2(char* dest, const octet* src,
+	size_t count, bool_t url)
+{
+	const __m256i shuf = _mm256_setr_epi8(
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m256i lut = b64AVX2Lut(url);
+	size_t n;
+	// загружается 28 октетов, используется 24
+	for (n = 0; n + 28 <= count; n += 24, src += 24, dest += 32)
+	{
+		__m256i x, t;
+		x = _mm256_inserti128_si256(_mm256_castsi128_si256(
+			_mm_loadu_si128((const __m128i*)src)),
+			_mm_loadu_si128((const __m128i*)(src + 12)), 1);
+		x = _mm256_shuffle_epi8(x, shuf);
+		// тройки октетов -> 6-ки битов
+		t = _mm256_mulhi_epu16(
+			_mm256_and_si256(x, _mm256_set1_epi32(0x0FC0FC00)),
+			_mm256_set1_epi32(0x04000040));
+		x = _mm256_mullo_epi16(
+			_mm256_and_si256(x, _mm256_set1_epi32(0x003F03F0)),
+			_mm256_set1_epi32(0x01000010));
+		x = _mm256_or_si256(x, t);
+		// 6-ки битов -> символы
+		_mm256_storeu_si256((__m256i*)dest, b64AVX2Enc(x, lut));
+	}
+	return n;
+}
+
+B64_AVX2_FN static size_t b64ToAVX2(octet* dest, const char* src,
+	size_t len, bool_t url)
+{
+	const __m256i roll = _mm256_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i shuf = _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m256i perm = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+	const __m256i lut = b64AVX2Lut(url);
+	const __m256i mask = _mm256_set1_epi8(15);
+	const __m256i hi2 = _mm256_set1_epi8((char)0xC0);
+	const __m256i slash = _mm256_set1_epi8('/');
+	size_t n;
+	for (n = 0; n + 32 <= len; n += 32, src += 32, dest += 24)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i*)src);
+		__m256i x = c;
+		__m256i t;
+		// base64url -> base64
+		if (url)
+		{
+			x = _mm256_blendv_epi8(x, _mm256_set1_epi8('+'),
+				_mm256_cmpeq_epi8(x, _mm256_set1_epi8('-')));
+			x = _mm256_blendv_epi8(x, slash,
+				_mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+		}
+		// символы -> 6-ки битов
+		t = _mm256_and_si256(_mm256_srli_epi32(x, 4), mask);
+		t = _mm256_add_epi8(_mm256_cmpeq_epi8(x, slash), t);
+		x = _mm256_add_epi8(x, _mm256_shuffle_epi8(roll, t));
+		// проверить символы
+		t = _mm256_and_si256(
+			_mm256_cmpeq_epi8(_mm256_and_si256(x, hi2),
+				_mm256_setzero_si256()),
+			_mm256_cmpeq_epi8(b64AVX2Enc(x, lut), c));
+		if (_mm256_movemask_epi8(t) != -1)
+			break;
+		// 6-ки битов -> октеты
+		x = _mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140));
+		x = _mm256_madd_epi16(x, _mm256_set1_epi32(0x00011000));
+		x = _mm256_shuffle_epi8(x, shuf);
+		x = _mm256_permutevar8x32_epi32(x, perm);
+		_mm_storeu_si128((__m128i*)dest, _mm256_castsi256_si128(x));
+		_mm_storel_epi64((__m128i*)(dest + 16),
+			_mm256_extracti128_si256(x, 1));
+	}
+	return n;
+}
+
+#endif // B64_AVX2
+
 /*
 *******************************************************************************
 Проверка
 *******************************************************************************
 */
 
-bool_t b64IsValid(const char* b64)
+static bool_t b64IsValidInt(const char* b64, bool_t url)
 {
 	size_t len;
 	if (!strIsValid(b64))
@@ -61,80 +227,143 @@ bool_t b64IsValid(const char* b64)
 	// проверить длину
 	len = strLen(b64);
 	if (len % 4)
-		return FALSE;
+	{
+		// base64url без паддинга?
+		if (!url || len % 4 == 1)
+			return FALSE;
+	}
 	// обработать паддинг 
-	if (len && b64[len - 1] == '=' && b64[--len - 1] == '=')
+	else if (len && b64[len - 1] == '=' && b64[--len - 1] == '=')
 		--len;
 	// последний блок данных из 2 октетов?
 	if (len % 4 == 3)
 	{
-		if (b64_dec_table[(octet)b64[len - 1]] & 3)
+		if (b64DecC(b64[len - 1], url) & 3)
 			return FALSE;
 		--len;
 	}
 	// последний блок данных из 1 октета?
 	else if (len % 4 == 2)
 	{
-		if (b64_dec_table[(octet)b64[len - 1]] & 15)
+		if (b64DecC(b64[len - 1], url) & 15)
 			return FALSE;
 		--len;
 	}
 	// проверить остальные символы 
 	for (; len--; ++b64)
-		if (b64_dec_table[(octet)*b64] == 0xFF)
+		if (b64DecC(*b64, url) == 0xFF)
 			return FALSE;
 	return TRUE;
 }
 
+bool_t b64IsValid(const char* b64)
+{
+	return b64IsValidInt(b64, FALSE);
+}
+
+bool_t b64UrlIsValid(const char* b64)
+{
+	return b64IsValidInt(b64, TRUE);
+}
+
 /*
 *******************************************************************************
 Кодирование
+
+Функция b64FromBlocks() кодирует полные тройки октетов, функция 
+b64FromTail() -- последний неполный блок (1 или 2 октета) с паддингом.
+Функции возвращают число записанных символов.
 *******************************************************************************
 */
 
-void b64From(char* dest, const void* src, size_t count)
+static size_t b64FromBlocks(char* dest, const octet* src, size_t count,
+	bool_t url)
 {
+	const char* alphabet = url ? b64url_alphabet : b64_alphabet;
 	register u32 block;
-	ASSERT(memIsDisjoint2(src, count, dest, 4 * ((count + 2) / 3) + 1));
+	size_t written = 0;
+	ASSERT(count % 3 == 0);
+#ifdef B64_AVX2
+	if (count >= 28 && utilAVX2IsAvail())
+	{
+		size_t n = b64FromAVX2(dest, src, count, url);
+		written = n / 3 * 4;
+		dest += written, src += n, count -= n;
+	}
+#endif
 	for (; count >= 3; count -= 3)
 	{
-		block  = ((const octet*)src)[0], block <<= 8;
-		block |= ((const octet*)src)[1], block <<= 8;
-		block |= ((const octet*)src)[2];
-		dest[3] = b64_alphabet[block & 63], block >>= 6;
-		dest[2] = b64_alphabet[block & 63], block >>= 6;
-		dest[1] = b64_alphabet[block & 63], block >>= 6;
-		dest[0] = b64_alphabet[block];
-		src = (const octet*)src + 3;
-		dest += 4;
+		block  = src[0], block <<= 8;
+		block |= src[1], block <<= 8;
+		block |= src[2];
+		dest[3] = alphabet[block & 63], block >>= 6;
+		dest[2] = alphabet[block & 63], block >>= 6;
+		dest[1] = alphabet[block & 63], block >>= 6;
+		dest[0] = alphabet[block];
+		src += 3;
+		dest += 4, written += 4;
 	}
+	block = 0;
+	return written;
+}
+
+static size_t b64FromTail(char* dest, const octet* src, size_t count,
+	bool_t url)
+{
+	const char* alphabet = url ? b64url_alphabet : b64_alphabet;
+	register u32 block;
+	ASSERT(count < 3);
 	if (count == 2)
 	{
-		block  = ((const octet*)src)[0], block <<= 8;
-		block |= ((const octet*)src)[1], block <<= 2;
+		block  = src[0], block <<= 8;
+		block |= src[1], block <<= 2;
 		dest[3] = '=';
-		dest[2] = b64_alphabet[block & 63], block >>= 6;
-		dest[1] = b64_alphabet[block & 63], block >>= 6;
-		dest[0] = b64_alphabet[block];
-		dest += 4;
+		dest[2] = alphabet[block & 63], block >>= 6;
+		dest[1] = alphabet[block & 63], block >>= 6;
+		dest[0] = alphabet[block];
 	}
 	else if (count == 1)
 	{
-		block  = ((const octet*)src)[0], block <<= 4;
+		block  = src[0], block <<= 4;
 		dest[3] = dest[2] = '=';
-		dest[1] = b64_alphabet[block & 63], block >>= 6;
-		dest[0] = b64_alphabet[block];
-		dest += 4;
+		dest[1] = alphabet[block & 63], block >>= 6;
+		dest[0] = alphabet[block];
 	}
-	*dest = '\0';
 	block = 0;
+	return count ? 4 : 0;
 }
 
-void b64To(void* dest, size_t* count, const char* src)
+static void b64FromInt(char* dest, const void* src, size_t count, 
+	bool_t url)
+{
+	size_t t = count - count % 3;
+	ASSERT(memIsDisjoint2(src, count, dest, 4 * ((count + 2) / 3) + 1));
+	dest += b64FromBlocks(dest, (const octet*)src, t, url);
+	dest += b64FromTail(dest, (const octet*)src + t, count - t, url);
+	*dest = '\0';
+}
+
+void b64From(char* dest, const void* src, size_t count)
+{
+	b64FromInt(dest, src, count, FALSE);
+}
+
+void b64UrlFrom(char* dest, const void* src, size_t count)
+{
+	b64FromInt(dest, src, count, TRUE);
+}
+
+/*
+*******************************************************************************
+Декодирование
+*******************************************************************************
+*/
+
+static void b64ToInt(void* dest, size_t* count, const char* src, bool_t url)
 {
 	register u32 block;
 	size_t len;
-	ASSERT(b64IsValid(src));
+	ASSERT(b64IsValidInt(src, url));
 	ASSERT(memIsValid(count, sizeof(size_t)));
 	ASSERT(memIsNullOrValid(dest, *count));
 	// размер dest
@@ -147,12 +376,19 @@ void b64To(void* dest, size_t* count, const char* src)
 		return;
 	// декодировать
 	ASSERT(memIsDisjoint2(src, strLen(src) + 1, dest, *count));
+#ifdef B64_AVX2
+	if (len >= 32 && utilAVX2IsAvail())
+	{
+		size_t n = b64ToAVX2((octet*)dest, src, len, url);
+		dest = (octet*)dest + n / 4 * 3, src += n, len -= n;
+	}
+#endif
 	for (; len >= 4; len -= 4)
 	{
-		block  = b64_dec_table[(octet)src[0]], block <<= 6;
-		block |= b64_dec_table[(octet)src[1]], block <<= 6;
-		block |= b64_dec_table[(octet)src[2]], block <<= 6;
-		block |= b64_dec_table[(octet)src[3]];
+		block  = b64DecC(src[0], url), block <<= 6;
+		block |= b64DecC(src[1], url), block <<= 6;
+		block |= b64DecC(src[2], url), block <<= 6;
+		block |= b64DecC(src[3], url);
 		((octet*)dest)[2] = block & 255, block >>= 8;
 		((octet*)dest)[1] = block & 255, block >>= 8;
 		((octet*)dest)[0] = block;
@@ -161,17 +397,266 @@ void b64To(void* dest, size_t* count, const char* src)
 	}
 	if (len == 3)
 	{
-		block  = b64_dec_table[(octet)src[0]], block <<= 6;
-		block |= b64_dec_table[(octet)src[1]], block <<= 6;
-		block |= b64_dec_table[(octet)src[2]], block >>= 2;
+		block  = b64DecC(src[0], url), block <<= 6;
+		block |= b64DecC(src[1], url), block <<= 6;
+		block |= b64DecC(src[2], url), block >>= 2;
 		((octet*)dest)[1] = block & 255, block >>= 8;
 		((octet*)dest)[0] = block;
 	}
 	else if (len == 2)
 	{
-		block  = b64_dec_table[(octet)src[0]], block <<= 6;
-		block |= b64_dec_table[(octet)src[1]], block >>= 4;
+		block  = b64DecC(src[0], url), block <<= 6;
+		block |= b64DecC(src[1], url), block >>= 4;
 		((octet*)dest)[0] = block;
 	}
 	block = 0;
 }
+
+void b64To(void* dest, size_t* count, const char* src)
+{
+	b64ToInt(dest, count, src, FALSE);
+}
+
+void b64UrlTo(void* dest, size_t* count, const char* src)
+{
+	b64ToInt(dest, count, src, TRUE);
+}
+
+/*
+*******************************************************************************
+Потоковое кодирование
+
+В состоянии кодирования накапливаются октеты неполного блока (не более 2).
+*******************************************************************************
+*/
+
+typedef struct
+{
+	bool_t url;				/*< base64url? */
+	octet block[3];			/*< неполный блок */
+	size_t filled;			/*< число октетов в block */
+} b64_enc_st;
+
+size_t b64Enc_keep()
+{
+	return sizeof(b64_enc_st);
+}
+
+void b64EncStart(void* state, bool_t url)
+{
+	b64_enc_st* st = (b64_enc_st*)state;
+	ASSERT(memIsValid(st, sizeof(b64_enc_st)));
+	st->url = url;
+	st->filled = 0;
+}
+
+size_t b64EncStep(char* dest, const void* src, size_t count, void* state)
+{
+	b64_enc_st* st = (b64_enc_st*)state;
+	size_t written = 0;
+	size_t t;
+	ASSERT(memIsValid(st, sizeof(b64_enc_st)));
+	ASSERT(memIsValid(src, count));
+	ASSERT(memIsValid(dest, 4 * ((st->filled + count) / 3)));
+	// дополнить неполный блок
+	if (st->filled)
+	{
+		t = MIN2(3 - st->filled, count);
+		memCopy(st->block + st->filled, src, t);
+		src = (const octet*)src + t, count -= t;
+		if ((st->filled += t) < 3)
+			return 0;
+		written = b64FromBlocks(dest, st->block, 3, st->url);
+		st->filled = 0;
+	}
+	// полные блоки
+	t = count - count % 3;
+	written += b64FromBlocks(dest + written, (const octet*)src, t, st->url);
+	// сохранить неполный блок
+	memCopy(st->block, (const octet*)src + t, st->filled = count - t);
+	return written;
+}
+
+size_t b64EncStop(char* dest, void* state)
+{
+	b64_enc_st* st = (b64_enc_st*)state;
+	size_t written;
+	ASSERT(memIsValid(st, sizeof(b64_enc_st)));
+	ASSERT(memIsValid(dest, st->filled ? 5 : 1));
+	written = b64FromTail(dest, st->block, st->filled, st->url);
+	dest[written] = '\0';
+	memWipe(st->block, sizeof(st->block));
+	st->filled = 0;
+	return written;
+}
+
+/*
+*******************************************************************************
+Потоковое декодирование
+
+В состоянии декодирования накапливаются 6-ки неполного блока (не более 3)
+и число символов '=' в последнем блоке. Блок с паддингом завершает
+декодирование: после него символы не допускаются.
+
+Длинные фрагменты полных блоков обрабатываются b64ToAVX2(), остальные
+полные блоки -- по таблице. И в том, и в другом случае символы
+проверяются. Блоки, которые не прошли проверку (в том числе блоки
+с паддингом), обрабатываются посимвольно функцией b64DecPush().
+*******************************************************************************
+*/
+
+typedef struct
+{
+	bool_t url;				/*< base64url? */
+	octet block[4];			/*< 6-ки неполного блока */
+	size_t filled;			/*< число 6-ок в block */
+	size_t pad;				/*< число символов '=' */
+	bool_t done;			/*< последний блок обработан? */
+} b64_dec_st;
+
+size_t b64Dec_keep()
+{
+	return sizeof(b64_dec_st);
+}
+
+void b64DecStart(void* state, bool_t url)
+{
+	b64_dec_st* st = (b64_dec_st*)state;
+	ASSERT(memIsValid(st, sizeof(b64_dec_st)));
+	st->url = url;
+	st->filled = st->pad = 0;
+	st->done = FALSE;
+}
+
+static size_t b64DecFlush(octet* dest, b64_dec_st* st)
+{
+	register u32 block;
+	size_t count;
+	ASSERT(st->filled + st->pad == 4 || st->pad == 0 && st->filled < 4);
+	block  = st->block[0], block <<= 6;
+	block |= st->block[1], block <<= 6;
+	block |= st->filled > 2 ? st->block[2] : 0, block <<= 6;
+	block |= st->filled > 3 ? st->block[3] : 0;
+	count = st->filled - 1;
+	if (count > 2)
+		dest[2] = (octet)block;
+	block >>= 8;
+	if (count > 1)
+		dest[1] = (octet)block;
+	block >>= 8;
+	dest[0] = (octet)block;
+	block = 0;
+	st->filled = 0;
+	return count;
+}
+
+static err_t b64DecPush(octet* dest, size_t* count, char c, b64_dec_st* st)
+{
+	octet o;
+	// после паддинга допускается только паддинг
+	if (st->done || st->pad && c != '=')
+		return ERR_BAD_FORMAT;
+	// паддинг?
+	if (c == '=')
+	{
+		if (st->filled < 2)
+			return ERR_BAD_FORMAT;
+		++st->pad;
+	}
+	// символ алфавита
+	else
+	{
+		if ((o = b64DecC(c, st->url)) == 0xFF)
+			return ERR_BAD_FORMAT;
+		st->block[st->filled++] = o;
+	}
+	// блок не завершен?
+	if (st->filled + st->pad < 4)
+		return ERR_OK;
+	// проверить незначащие биты последнего блока
+	if (st->pad == 1 && (st->block[2] & 3) ||
+		st->pad == 2 && (st->block[1] & 15))
+		return ERR_BAD_FORMAT;
+	*count += b64DecFlush(dest + *count, st);
+	st->done = st->pad != 0;
+	return ERR_OK;
+}
+
+err_t b64DecStep(void* dest, size_t* count, const char* src, size_t len,
+	void* state)
+{
+	b64_dec_st* st = (b64_dec_st*)state;
+	err_t code;
+	ASSERT(memIsValid(st, sizeof(b64_dec_st)));
+	ASSERT(memIsValid(src, len));
+	ASSERT(memIsValid(count, O_PER_S));
+	ASSERT(memIsValid(dest, 3 * ((len + 3) / 4)));
+	*count = 0;
+	// дополнить неполный блок
+	for (; len && (st->filled || st->pad); ++src, --len)
+	{
+		code = b64DecPush((octet*)dest, count, *src, st);
+		ERR_CALL_CHECK(code);
+	}
+	while (len)
+	{
+#ifdef B64_AVX2
+		// полные блоки
+		if (len >= 32 && !st->done && utilAVX2IsAvail())
+		{
+			size_t n = b64ToAVX2((octet*)dest + *count, src, len, st->url);
+			*count += n / 4 * 3, src += n, len -= n;
+			if (!len)
+				break;
+		}
+#endif
+		// полные блоки
+		for (; len >= 4 && !st->done; src += 4, len -= 4)
+		{
+			register u32 block;
+			octet o0 = b64DecC(src[0], st->url);
+			octet o1 = b64DecC(src[1], st->url);
+			octet o2 = b64DecC(src[2], st->url);
+			octet o3 = b64DecC(src[3], st->url);
+			if ((o0 | o1 | o2 | o3) & 0xC0)
+				break;
+			block = (u32)o0 << 18 | (u32)o1 << 12 | (u32)o2 << 6 | o3;
+			((octet*)dest)[*count + 2] = (octet)block, block >>= 8;
+			((octet*)dest)[*count + 1] = (octet)block, block >>= 8;
+			((octet*)dest)[*count] = (octet)block;
+			*count += 3;
+			block = 0;
+		}
+		if (!len)
+			break;
+		// посимвольная обработка блока
+		do
+		{
+			code = b64DecPush((octet*)dest, count, *src++, st);
+			ERR_CALL_CHECK(code);
+		}
+		while (--len && (st->filled || st->pad));
+	}
+	return ERR_OK;
+}
+
+err_t b64DecStop(void* dest, size_t* count, void* state)
+{
+	b64_dec_st* st = (b64_dec_st*)state;
+	ASSERT(memIsValid(st, sizeof(b64_dec_st)));
+	ASSERT(memIsValid(count, O_PER_S));
+	*count = 0;
+	// неполный блок?
+	if (!st->done && (st->filled || st->pad))
+	{
+		// допускается только base64url без паддинга
+		if (!st->url || st->pad || st->filled == 1 ||
+			st->filled == 3 && (st->block[2] & 3) ||
+			st->filled == 2 && (st->block[1] & 15))
+			return ERR_BAD_FORMAT;
+		ASSERT(memIsValid(dest, st->filled - 1));
+		*count = b64DecFlush((octet*)dest, st);
+	}
+	memWipe(st->block, sizeof(st->block));
+	return ERR_OK;
+}
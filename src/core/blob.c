@@ -4,7 +4,7 @@
 \brief Blobs
 \project bee2 [cryptographic library]
 \created 2012.04.01
-\version 2023.03.23
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -12,18 +12,21 @@
 
 #include "bee2/core/blob.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/util.h"
 
+#ifdef OS_UNIX
+	#include <sys/mman.h>
+#endif
+
 /*
 *******************************************************************************
 Блоб: реализация
 
-В куче выделяется память под указатель ptr. Память выделяется страницами.
-
-Первые sizeof(size_t) октетов по адресу ptr --- размер блоба,
-следующие октеты --- собственно блоб.
+Блоб предваряется заголовком blob_hdr_st. В заголовке указываются размер 
+блоба и арена, в которой блоб размещен (0 для блобов в куче). 
 
-\todo Обеспечить защиту памяти блоба от утечек.
+В куче память под заголовок и блоб выделяется страницами.
 
 \todo Полноценная проверка корректности блоба.
 *******************************************************************************
@@ -32,42 +35,356 @@
 // память для блобов выделяется страницами
 #define BLOB_PAGE_SIZE 1024
 
+// заголовок блоба
+typedef struct
+{
+	size_t prev;		/*< смещение предыдущего блоба арены */
+	size_t size;		/*< размер блоба */
+	size_t tag;			/*< арена | признак закрытия */
+} blob_hdr_st;
+
 // требуется страниц
 #define blobPageCount(size)\
-	(((size) + sizeof(size_t) + BLOB_PAGE_SIZE - 1) / BLOB_PAGE_SIZE)
+	(((size) + sizeof(blob_hdr_st) + BLOB_PAGE_SIZE - 1) / BLOB_PAGE_SIZE)
 
 // требуется памяти на страницах
 #define blobActualSize(size)\
 	(blobPageCount(size) * BLOB_PAGE_SIZE)
 
-// heap-указатель для блоба
-#define blobPtrOf(blob) ((size_t*)blob - 1)
+// заголовок блоба
+#define blobHdrOf(blob) ((blob_hdr_st*)(blob) - 1)
 
 // размер блоба
-#define blobSizeOf(blob) (*blobPtrOf(blob))
+#define blobSizeOf(blob) (blobHdrOf(blob)->size)
 
 // страничный размер блоба
 #define blobActualSizeOf(blob) (blobActualSize(blobSizeOf(blob)))
 
-// блоб для heap-указателя
-#define blobValueOf(ptr) ((blob_t)((size_t*)ptr + 1))
+// блоб для заголовка
+#define blobValueOf(hdr) ((blob_t)((blob_hdr_st*)(hdr) + 1))
+
+/*
+*******************************************************************************
+Арена
+
+Арена -- это заголовок blob_arena_st, за которым следует память под 
+блобы. Блобы размещаются в памяти арены друг за другом. Смещение заголовка 
+последнего блоба хранится в поле top арены, смещение заголовка 
+предпоследнего -- в поле prev заголовка последнего и т.д.
+
+При закрытии блоба в поле tag его заголовка устанавливается младший бит. 
+Если блоб закрывается в потоке-владельце арены, то с вершины арены 
+снимаются все закрытые блобы. Блоб, закрытый в другом потоке, будет снят 
+при очередном закрытии блоба потоком-владельцем.
+
+Поле refs арены -- это число ссылок на нее: одна ссылка потока-владельца
+плюс по одной ссылке каждого незакрытого блоба. Арена освобождается, когда 
+число ссылок становится нулевым.
+
+Арена привязывается к потоку через локальную память потока (pthread_key_t
+в Unix, FLS в Windows). Функция освобождения памяти потока отсоединяет 
+арену при завершении потока.
+*******************************************************************************
+*/
+
+#ifndef BLOB_ARENA_SIZE
+	#define BLOB_ARENA_SIZE 32768
+#endif
+
+#if (BLOB_ARENA_SIZE > 0)
+
+#if (BLOB_ARENA_SIZE < 4096)
+	#error "Too small BLOB_ARENA_SIZE"
+#endif
+
+typedef struct
+{
+	size_t refs;		/*< число ссылок */
+	size_t size;		/*< размер памяти блобов */
+	size_t used;		/*< занято */
+	size_t top;			/*< смещение последнего блоба (SIZE_MAX -- нет) */
+	size_t peak;		/*< наибольшее занятое */
+	size_t arena_count;	/*< число блобов в арене */
+	size_t heap_count;	/*< число блобов в куче */
+	bool_t locked;		/*< память закреплена? */
+} blob_arena_st;
+
+// память блобов арены
+#define blobArenaMem(arena) ((octet*)((blob_arena_st*)(arena) + 1))
+
+// требуется памяти в арене (с выравниванием на 16 октетов)
+#define blobArenaActualSize(size)\
+	(((size) + sizeof(blob_hdr_st) + 15) & ~(size_t)15)
+
+static void blobArenaFree(blob_arena_st* arena)
+{
+	const size_t size = sizeof(blob_arena_st) + arena->size;
+	bool_t locked = arena->locked;
+	memWipe(arena, size);
+#if defined OS_WIN
+	if (locked)
+		VirtualUnlock(arena, size);
+	VirtualFree(arena, 0, MEM_RELEASE);
+#elif defined OS_UNIX
+	if (locked)
+		munlock(arena, size);
+	munmap(arena, size);
+#else
+	memFree(arena);
+#endif
+}
+
+static void blobArenaRelease(blob_arena_st* arena)
+{
+	if (mtAtomicDecr(&arena->refs) == 0)
+		blobArenaFree(arena);
+}
+
+static blob_arena_st* blobArenaAlloc()
+{
+	const size_t size = BLOB_ARENA_SIZE;
+	blob_arena_st* arena;
+	bool_t locked;
+#if defined OS_WIN
+	arena = (blob_arena_st*)VirtualAlloc(0, size, MEM_COMMIT | MEM_RESERVE,
+		PAGE_READWRITE);
+	if (!arena)
+		return 0;
+	locked = VirtualLock(arena, size) != 0;
+#elif defined OS_UNIX
+	arena = (blob_arena_st*)mmap(0, size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (arena == MAP_FAILED)
+		return 0;
+	locked = mlock(arena, size) == 0;
+#ifdef MADV_DONTDUMP
+	madvise(arena, size, MADV_DONTDUMP);
+#endif
+#else
+	arena = (blob_arena_st*)memAlloc(size);
+	if (!arena)
+		return 0;
+	locked = FALSE;
+#endif
+	memSetZero(arena, sizeof(blob_arena_st));
+	arena->refs = 1;
+	arena->size = BLOB_ARENA_SIZE - sizeof(blob_arena_st);
+	arena->top = SIZE_MAX;
+	arena->locked = locked;
+	return arena;
+}
+
+/*
+*******************************************************************************
+Арена: привязка к потоку
+*******************************************************************************
+*/
+
+static size_t _once;
+
+#if defined OS_WIN
+
+static DWORD _key = FLS_OUT_OF_INDEXES;
+
+static void WINAPI blobArenaDtor(void* arena)
+{
+	if (arena)
+		blobArenaRelease((blob_arena_st*)arena);
+}
+
+static void blobArenaKeyCreate()
+{
+	_key = FlsAlloc(blobArenaDtor);
+}
+
+#define blobArenaKeyIsValid() (_key != FLS_OUT_OF_INDEXES)
+#define blobArenaKeyGet() ((blob_arena_st*)FlsGetValue(_key))
+#define blobArenaKeySet(arena) FlsSetValue(_key, arena)
+
+#elif defined OS_UNIX
+
+static pthread_key_t _key;
+static bool_t _key_valid;
+
+static void blobArenaDtor(void* arena)
+{
+	blobArenaRelease((blob_arena_st*)arena);
+}
+
+static void blobArenaKeyCreate()
+{
+	_key_valid = pthread_key_create(&_key, blobArenaDtor) == 0;
+}
+
+#define blobArenaKeyIsValid() (_key_valid)
+#define blobArenaKeyGet() ((blob_arena_st*)pthread_getspecific(_key))
+#define blobArenaKeySet(arena) pthread_setspecific(_key, arena)
+
+#else
+
+static blob_arena_st* _arena;
+
+static void blobArenaKeyCreate()
+{
+}
+
+#define blobArenaKeyIsValid() (TRUE)
+#define blobArenaKeyGet() (_arena)
+#define blobArenaKeySet(arena) (_arena = (arena))
+
+#endif
+
+static blob_arena_st* blobArenaGet()
+{
+	if (_once != 1 && !mtCallOnce(&_once, blobArenaKeyCreate))
+		return 0;
+	if (!blobArenaKeyIsValid())
+		return 0;
+	return blobArenaKeyGet();
+}
+
+static blob_arena_st* blobArenaGetOrCreate()
+{
+	blob_arena_st* arena = blobArenaGet();
+	if (!arena && blobArenaKeyIsValid() && (arena = blobArenaAlloc()))
+		blobArenaKeySet(arena);
+	return arena;
+}
+
+/*
+*******************************************************************************
+Арена: блобы
+*******************************************************************************
+*/
+
+static blob_hdr_st* blobArenaPush(blob_arena_st* arena, size_t size)
+{
+	blob_hdr_st* hdr;
+	size_t actual;
+	if (size > arena->size ||
+		(actual = blobArenaActualSize(size)) > arena->size - arena->used)
+		return 0;
+	hdr = (blob_hdr_st*)(blobArenaMem(arena) + arena->used);
+	hdr->prev = arena->top;
+	hdr->tag = (size_t)arena;
+	arena->top = arena->used;
+	arena->used += actual;
+	if (arena->peak < arena->used)
+		arena->peak = arena->used;
+	++arena->arena_count;
+	mtAtomicIncr(&arena->refs);
+	return hdr;
+}
+
+static void blobArenaPop(blob_arena_st* arena)
+{
+	blob_hdr_st* hdr;
+	while (arena->top != SIZE_MAX)
+	{
+		hdr = (blob_hdr_st*)(blobArenaMem(arena) + arena->top);
+		// блоб не закрыт?
+		if ((mtAtomicCmpSwap(&hdr->tag, 0, 0) & 1) == 0)
+			break;
+		arena->used = arena->top;
+		arena->top = hdr->prev;
+		memWipe(hdr, sizeof(blob_hdr_st));
+	}
+}
+
+static void blobArenaClose1(blob_hdr_st* hdr)
+{
+	blob_arena_st* arena = (blob_arena_st*)hdr->tag;
+	ASSERT((hdr->tag & 1) == 0);
+	memWipe(blobValueOf(hdr), hdr->size);
+	if (arena == blobArenaGet())
+		hdr->tag |= 1, blobArenaPop(arena);
+	else
+		mtAtomicCmpSwap(&hdr->tag, (size_t)arena, (size_t)arena | 1);
+	blobArenaRelease(arena);
+}
+
+void blobStat(blob_stat* stat)
+{
+	blob_arena_st* arena;
+	ASSERT(memIsValid(stat, sizeof(blob_stat)));
+	memSetZero(stat, sizeof(blob_stat));
+	if ((arena = blobArenaGet()))
+	{
+		stat->arena_size = arena->size;
+		stat->arena_used = arena->used;
+		stat->arena_peak = arena->peak;
+		stat->arena_count = arena->arena_count;
+		stat->heap_count = arena->heap_count;
+		stat->locked = arena->locked;
+	}
+}
+
+void blobArenaClose()
+{
+	blob_arena_st* arena = blobArenaGet();
+	if (arena)
+	{
+		blobArenaKeySet(0);
+		blobArenaRelease(arena);
+	}
+}
+
+#else
+
+#define blobArenaGetOrCreate() ((void*)0)
+#define blobArenaPush(arena, size) ((blob_hdr_st*)0)
+#define blobArenaClose1(hdr)
+
+void blobStat(blob_stat* stat)
+{
+	ASSERT(memIsValid(stat, sizeof(blob_stat)));
+	memSetZero(stat, sizeof(blob_stat));
+}
+
+void blobArenaClose()
+{
+}
+
+#endif // BLOB_ARENA_SIZE
+
+/*
+*******************************************************************************
+Управление блобами
+*******************************************************************************
+*/
 
 blob_t blobCreate(size_t size)
 {
-	size_t* ptr;
+#if (BLOB_ARENA_SIZE > 0)
+	blob_arena_st* arena;
+#endif
+	blob_hdr_st* hdr = 0;
 	if (size == 0)
 		return 0;
-	ptr = (size_t*)memAlloc(blobActualSize(size));
-	if (ptr == 0)
-		return 0;
-	*ptr = size;
-	memSetZero(blobValueOf(ptr), size);
-	return blobValueOf(ptr);
+#if (BLOB_ARENA_SIZE > 0)
+	// в арене?
+	if ((arena = blobArenaGetOrCreate()) && 
+		!(hdr = blobArenaPush(arena, size)))
+		++arena->heap_count;
+#endif
+	// в куче?
+	if (!hdr)
+	{
+		hdr = (blob_hdr_st*)memAlloc(blobActualSize(size));
+		if (hdr == 0)
+			return 0;
+		hdr->prev = SIZE_MAX;
+		hdr->tag = 0;
+	}
+	hdr->size = size;
+	memSetZero(blobValueOf(hdr), size);
+	return blobValueOf(hdr);
 }
 
 bool_t blobIsValid(const blob_t blob)
 {
-	return blob == 0 || memIsValid(blobPtrOf(blob), blobActualSizeOf(blob));
+	return blob == 0 || 
+		memIsValid(blobHdrOf(blob), sizeof(blob_hdr_st) + blobSizeOf(blob));
 }
 
 void blobWipe(blob_t blob)
@@ -80,17 +397,21 @@ void blobWipe(blob_t blob)
 void blobClose(blob_t blob)
 {
 	ASSERT(blobIsValid(blob));
-	if (blob)
+	if (blob == 0)
+		return;
+	if (blobHdrOf(blob)->tag)
+		blobArenaClose1(blobHdrOf(blob));
+	else
 	{
-		memWipe(blobPtrOf(blob), blobActualSizeOf(blob));
-		memFree(blobPtrOf(blob));
+		memWipe(blobHdrOf(blob), blobActualSizeOf(blob));
+		memFree(blobHdrOf(blob));
 	}
 }
 
 blob_t blobResize(blob_t blob, size_t size)
 {
 	size_t old_size;
-	size_t* ptr;
+	blob_hdr_st* hdr;
 	// pre
 	ASSERT(blobIsValid(blob));
 	// создать блоб
@@ -104,17 +425,29 @@ blob_t blobResize(blob_t blob, size_t size)
 	}
 	// сохранить размер
 	old_size = blobSizeOf(blob);
+	if (size == old_size)
+		return blob;
+	// блоб в арене: пересоздать
+	if (blobHdrOf(blob)->tag)
+	{
+		blob_t b = blobCreate(size);
+		if (b == 0)
+			return 0;
+		memCopy(b, blob, MIN2(size, old_size));
+		blobClose(blob);
+		return b;
+	}
 	// перераспределить память?
-	ptr = blobPtrOf(blob);
+	hdr = blobHdrOf(blob);
 	if (blobActualSizeOf(blob) != blobActualSize(size))
 	{
-		ptr = (size_t*)memRealloc(ptr, blobActualSize(size));
-		if (ptr == 0)
+		hdr = (blob_hdr_st*)memRealloc(hdr, blobActualSize(size));
+		if (hdr == 0)
 			return 0;
 	}
 	// настроить и возвратить блоб
-	*ptr = size;
-	blob = blobValueOf(ptr);
+	hdr->size = size;
+	blob = blobValueOf(hdr);
 	if (size > old_size)
 		memSetZero((octet*)blob + old_size, size - old_size);
 	return blob;
@@ -4,13 +4,14 @@
 \brief Distinguished Encoding Rules
 \project bee2 [cryptographic library]
 \created 2014.04.21
-\version 2023.09.21
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
 #include "bee2/core/der.h"
+#include "bee2/core/err.h"
 #include "bee2/core/mem.h"
 #include "bee2/core/oid.h"
 #include "bee2/core/str.h"
@@ -121,7 +122,7 @@ static size_t derTDec(u32* tag, const octet der[], size_t count)
 	{
 		// короткий код? лишний октет с нулем?
 		if (count < 2 || (der[1] & 127) == 0)
-			return FALSE;
+			return SIZE_MAX;
 		for (t = 0; t_count < count;)
 		{
 			t <<= 8, t |= der[t_count] & 127;
@@ -1129,3 +1130,264 @@ size_t derTSEQDecStop(const octet der[], const der_anchor_t* anchor)
 	// сравнить длину вложенных данных с сохраненной длиной
 	return (der == val + anchor->len) ? 0 : SIZE_MAX;
 }
+
+/*
+*******************************************************************************
+Потоковое декодирование
+
+Позиции в коде (pos, el_pos, ends[]) отсчитываются от начала потока.
+Окно [fill]buf содержит октеты кода с позиции off. В режиме памяти окном
+является весь исходный буфер (off == 0, fill == count, read == 0).
+
+Позиция pos указывает на начало следующего элемента текущего уровня.
+Значение предыдущего элемента, которое не было просмотрено, пропускается
+лениво: при очередной загрузке окна октеты между окном и pos читаются
+и отбрасываются.
+
+На верхнем уровне потока граница ends[0] равняется SIZE_MAX: элементы
+перебираются до окончания файла.
+
+Окно загружается всегда с начала текущего элемента (а не с начала его
+значения), чтобы после derStreamVal() можно было вызвать derStreamTLV().
+
+Максимальная длина TL-префикса: 4 октета тега (см. derTDec()) плюс
+1 + O_PER_S октетов длины (см. derLDec()). Окно не может быть короче
+DER_STREAM_MIN_BUF.
+*******************************************************************************
+*/
+
+#define DER_STREAM_DEPTH 16
+#define DER_STREAM_MIN_BUF 16
+#define DER_STREAM_TL (4 + 1 + O_PER_S)
+
+typedef struct
+{
+	read_i read;					/*< функция чтения */
+	void* file;						/*< описание файла */
+	const octet* buf;				/*< окно */
+	size_t buf_len;					/*< длина окна */
+	size_t off;						/*< позиция начала окна */
+	size_t fill;					/*< число октетов в окне */
+	bool_t eof;						/*< достигнут конец файла? */
+	size_t pos;						/*< позиция следующего элемента */
+	bool_t cur;						/*< текущий элемент определен? */
+	size_t el_pos;					/*< позиция текущего элемента */
+	size_t tl_len;					/*< длина TL-префикса */
+	size_t len;						/*< длина значения */
+	u32 tag;						/*< тег */
+	size_t depth;					/*< уровень вложенности */
+	size_t ends[DER_STREAM_DEPTH];	/*< границы уровней */
+	octet data[];					/*< [buf_len] окно */
+} der_stream_st;
+
+size_t derStream_keep(size_t buf_len)
+{
+	return sizeof(der_stream_st) + buf_len;
+}
+
+err_t derStreamStart(void* state, size_t buf_len, read_i read, void* file)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	ASSERT(memIsValid(st, derStream_keep(buf_len)));
+	if (buf_len < DER_STREAM_MIN_BUF || !read)
+		return ERR_BAD_INPUT;
+	memSetZero(st, sizeof(der_stream_st));
+	st->read = read;
+	st->file = file;
+	st->buf = st->data;
+	st->buf_len = buf_len;
+	st->ends[0] = SIZE_MAX;
+	return ERR_OK;
+}
+
+err_t derStreamStart2(void* state, const octet der[], size_t count)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	ASSERT(memIsValid(st, derStream_keep(0)));
+	if (!memIsValid(der, count))
+		return ERR_BAD_INPUT;
+	memSetZero(st, sizeof(der_stream_st));
+	st->buf = der;
+	st->buf_len = st->fill = count;
+	st->eof = TRUE;
+	st->ends[0] = count;
+	return ERR_OK;
+}
+
+/*
+	Загрузка окна: в окне должны оказаться октеты с позициями
+	from,..., from + need - 1. Возвращается ERR_OK, если октеты загружены,
+	ERR_MAX, если поток закончился раньше (загружена часть октетов),
+	ERR_OUTOFMEMORY, если need превышает длину окна, ERR_BAD_FORMAT,
+	если поток закончился до позиции from.
+*/
+
+static err_t derStreamLoad(der_stream_st* st, size_t from, size_t need)
+{
+	err_t code;
+	size_t count;
+	ASSERT(from >= st->off);
+	// октеты уже в окне?
+	if (from - st->off <= st->fill && need <= st->fill - (from - st->off))
+		return ERR_OK;
+	// режим памяти?
+	if (!st->read)
+		return ERR_MAX;
+	// не хватает окна?
+	if (need > st->buf_len)
+		return ERR_OUTOFMEMORY;
+	// сдвинуть окно к from
+	if (from - st->off < st->fill)
+	{
+		st->fill -= from - st->off;
+		memMove(st->data, st->data + (from - st->off), st->fill);
+	}
+	// пропустить октеты между окном и from
+	else
+	{
+		size_t skip = from - st->off - st->fill;
+		st->fill = 0;
+		while (skip)
+		{
+			if (st->eof)
+			{
+				st->off = from - skip;
+				return ERR_BAD_FORMAT;
+			}
+			code = st->read(&count, st->data, MIN2(skip, st->buf_len),
+				st->file);
+			if (code == ERR_MAX)
+				st->eof = TRUE;
+			else if (code != ERR_OK)
+			{
+				st->off = from - skip;
+				return code;
+			}
+			ASSERT(count <= skip);
+			skip -= count;
+		}
+	}
+	st->off = from;
+	// дочитать
+	while (st->fill < need && !st->eof)
+	{
+		code = st->read(&count, st->data + st->fill, st->buf_len - st->fill,
+			st->file);
+		if (code == ERR_MAX)
+			st->eof = TRUE;
+		else if (code != ERR_OK)
+			return code;
+		ASSERT(count <= st->buf_len - st->fill);
+		st->fill += count;
+	}
+	return st->fill < need ? ERR_MAX : ERR_OK;
+}
+
+err_t derStreamNext(u32* tag, size_t* len, void* state)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	size_t end;
+	size_t avail;
+	size_t tl_len;
+	size_t l;
+	err_t code;
+	// pre
+	ASSERT(memIsValid(st, sizeof(der_stream_st)));
+	ASSERT(tag == 0 || memIsValid(tag, 4));
+	ASSERT(len == 0 || memIsValid(len, O_PER_S));
+	st->cur = FALSE;
+	// элементы текущего уровня исчерпаны?
+	end = st->ends[st->depth];
+	if (st->pos == end)
+		return ERR_MAX;
+	// загрузить TL-префикс
+	code = derStreamLoad(st, st->pos, MIN2(DER_STREAM_TL, end - st->pos));
+	if (code != ERR_OK && code != ERR_MAX)
+		return code;
+	avail = st->fill - (st->pos - st->off);
+	// поток закончился на границе элементов верхнего уровня?
+	if (avail == 0)
+		return end == SIZE_MAX ? ERR_MAX : ERR_BAD_FORMAT;
+	// декодировать TL-префикс
+	tl_len = derTLDec(&st->tag, &l, st->buf + (st->pos - st->off),
+		MIN2(avail, end - st->pos));
+	if (tl_len == SIZE_MAX || l > end - st->pos - tl_len)
+		return ERR_BAD_FORMAT;
+	// зафиксировать элемент
+	st->cur = TRUE;
+	st->el_pos = st->pos;
+	st->tl_len = tl_len;
+	st->len = l;
+	st->pos += tl_len + l;
+	if (tag)
+		*tag = st->tag;
+	if (len)
+		*len = l;
+	return ERR_OK;
+}
+
+err_t derStreamEnter(void* state)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	ASSERT(memIsValid(st, sizeof(der_stream_st)));
+	// текущий элемент определен?
+	if (!st->cur)
+		return ERR_BAD_LOGIC;
+	// элемент конструктивный?
+	if (!derTIsConstructive(st->tag))
+		return ERR_BAD_FORMAT;
+	// слишком глубокая вложенность?
+	if (st->depth + 1 == DER_STREAM_DEPTH)
+		return ERR_OUTOFRANGE;
+	// войти
+	st->ends[++st->depth] = st->pos;
+	st->pos = st->el_pos + st->tl_len;
+	st->cur = FALSE;
+	return ERR_OK;
+}
+
+err_t derStreamLeave(void* state)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	ASSERT(memIsValid(st, sizeof(der_stream_st)));
+	if (st->depth == 0)
+		return ERR_BAD_LOGIC;
+	st->pos = st->ends[st->depth--];
+	st->cur = FALSE;
+	return ERR_OK;
+}
+
+err_t derStreamVal(const octet** val, void* state)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	err_t code;
+	ASSERT(memIsValid(st, sizeof(der_stream_st)));
+	ASSERT(memIsValid(val, sizeof(const octet*)));
+	if (!st->cur)
+		return ERR_BAD_LOGIC;
+	code = derStreamLoad(st, st->el_pos, st->tl_len + st->len);
+	if (code == ERR_MAX)
+		code = ERR_BAD_FORMAT;
+	ERR_CALL_CHECK(code);
+	*val = st->buf + (st->el_pos + st->tl_len - st->off);
+	return ERR_OK;
+}
+
+err_t derStreamTLV(const octet** der, size_t* count, void* state)
+{
+	der_stream_st* st = (der_stream_st*)state;
+	err_t code;
+	ASSERT(memIsValid(st, sizeof(der_stream_st)));
+	ASSERT(memIsValid(der, sizeof(const octet*)));
+	ASSERT(count == 0 || memIsValid(count, O_PER_S));
+	if (!st->cur)
+		return ERR_BAD_LOGIC;
+	code = derStreamLoad(st, st->el_pos, st->tl_len + st->len);
+	if (code == ERR_MAX)
+		code = ERR_BAD_FORMAT;
+	ERR_CALL_CHECK(code);
+	*der = st->buf + (st->el_pos - st->off);
+	if (count)
+		*count = st->tl_len + st->len;
+	return ERR_OK;
+}
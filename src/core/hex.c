@@ -4,7 +4,7 @@
 \brief Hexadecimal strings
 \project bee2 [cryptographic library]
 \created 2015.10.29
-\version 2016.06.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -169,6 +169,89 @@ bool_t FAST(hexEqRev)(const void* buf, const char* hex)
 	return TRUE;
 }
 
+/*
+*******************************************************************************
+Кодирование и декодирование с помощью AVX2
+
+За один шаг кодируются 32 октета. Октеты разбиваются на старшие и младшие
+полуоктеты, полуоктеты преобразуются в символы инструкцией vpshufb
+(выборка из таблицы hex_upper) и затем перемежаются. Инструкции
+перемежения действуют в пределах 128-битовых половин регистров, поэтому
+результаты собираются из половин инструкцией vperm2i128.
+
+За один шаг декодируются 64 символа. Строка заранее проверена
+(hexIsValid()), поэтому полуоктет символа c определяется без таблиц:
+(c & 15) + 9 * ((c >> 6) & 1). Для цифр бит 6 снят, для букв 'A'-'F'
+и 'a'-'f' установлен, а младшие 4 бита равны 1,..., 6. Пары полуоктетов
+объединяются в октеты инструкциями vpmaddubsw и vpackuswb.
+*******************************************************************************
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__i386__) || defined(__x86_64__))
+	#define HEX_AVX2
+	#define HEX_AVX2_FN __attribute__((target("avx2")))
+	#include <immintrin.h>
+#elif (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64))
+	#define HEX_AVX2
+	#define HEX_AVX2_FN
+	#include <immintrin.h>
+#endif
+
+#ifdef HEX_AVX2
+
+HEX_AVX2_FN static size_t hexFromAVX2(char* dest, const octet* src,
+	size_t count)
+{
+	const __m256i tbl = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i*)hex_upper));
+	const __m256i mask = _mm256_set1_epi8(15);
+	size_t n;
+	for (n = 0; n + 32 <= count; n += 32, src += 32, dest += 64)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i*)src);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), mask);
+		__m256i lo = _mm256_and_si256(x, mask);
+		hi = _mm256_shuffle_epi8(tbl, hi);
+		lo = _mm256_shuffle_epi8(tbl, lo);
+		x = _mm256_unpacklo_epi8(hi, lo);
+		hi = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i*)dest,
+			_mm256_permute2x128_si256(x, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(dest + 32),
+			_mm256_permute2x128_si256(x, hi, 0x31));
+	}
+	return n;
+}
+
+HEX_AVX2_FN static size_t hexToAVX2(octet* dest, const char* src,
+	size_t count)
+{
+	const __m256i mask = _mm256_set1_epi8(15);
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i bit6 = _mm256_set1_epi8(64);
+	const __m256i mul = _mm256_set1_epi16(0x0110);
+	size_t n;
+	for (n = 0; n + 32 <= count; n += 32, src += 64, dest += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i*)src);
+		__m256i y = _mm256_loadu_si256((const __m256i*)(src + 32));
+		// символы -> полуоктеты
+		x = _mm256_add_epi8(_mm256_and_si256(x, mask), _mm256_and_si256(
+			_mm256_cmpeq_epi8(_mm256_and_si256(x, bit6), bit6), nine));
+		y = _mm256_add_epi8(_mm256_and_si256(y, mask), _mm256_and_si256(
+			_mm256_cmpeq_epi8(_mm256_and_si256(y, bit6), bit6), nine));
+		// пары полуоктетов -> октеты
+		x = _mm256_maddubs_epi16(x, mul);
+		y = _mm256_maddubs_epi16(y, mul);
+		x = _mm256_permute4x64_epi64(_mm256_packus_epi16(x, y), 0xD8);
+		_mm256_storeu_si256((__m256i*)dest, x);
+	}
+	return n;
+}
+
+#endif // HEX_AVX2
+
 /*
 *******************************************************************************
 Кодирование
@@ -178,6 +261,13 @@ bool_t FAST(hexEqRev)(const void* buf, const char* hex)
 void hexFrom(char* dest, const void* src, size_t count)
 {
 	ASSERT(memIsDisjoint2(src, count, dest, 2 * count + 1));
+#ifdef HEX_AVX2
+	if (count >= 32 && utilAVX2IsAvail())
+	{
+		size_t n = hexFromAVX2(dest, (const octet*)src, count);
+		dest += 2 * n, src = (const octet*)src + n, count -= n;
+	}
+#endif
 	for (; count--; dest += 2, src = (const octet*)src + 1)
 		hexFromOUpper(dest, *(const octet*)src);
 	*dest = '\0';
@@ -198,6 +288,13 @@ void hexTo(void* dest, const char* src)
 	ASSERT(hexIsValid(src));
 	ASSERT(memIsDisjoint2(src, strLen(src) + 1, dest, strLen(src) / 2));
 	count = strLen(src);
+#ifdef HEX_AVX2
+	if (count >= 64 && utilAVX2IsAvail())
+	{
+		size_t n = hexToAVX2((octet*)dest, src, count / 2);
+		src += 2 * n, dest = (octet*)dest + n, count -= 2 * n;
+	}
+#endif
 	for (; count; count -= 2, src += 2, dest = (octet*)dest + 1)
 		*(octet*)dest = hexToO(src);
 }
@@ -4,7 +4,7 @@
 \brief Memory management
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2019.07.09
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -127,12 +127,210 @@ void memFree(void* buf)
 #endif
 }
 
+/*
+*******************************************************************************
+Векторные ускорители
+
+Функции memXor(), memXor2(), SAFE(memEq)(), SAFE(memIsZero)() обрабатывают 
+длинные буферы векторными инструкциями: SSE2 и AVX2 на платформах x86, 
+NEON на платформах ARM64. Инструкции SSE2 и NEON входят в базовые наборы 
+64-разрядных платформ и используются безусловно. Инструкции AVX2 
+используются, если их поддерживают процессор и операционная система 
+(см. utilAVX2IsAvail()).
+
+Векторные функции обрабатывают начальную часть буфера, длина которой 
+кратна длине вектора, и возвращают длину обработанной части. Остаток 
+обрабатывается регулярными функциями. Векторные функции регулярны: 
+время их выполнения не зависит от содержимого буферов.
+
+Векторные функции применяются к буферам длины не менее MEM_SIMD_MIN. 
+На коротких буферах накладные расходы векторной обработки не окупаются.
+*******************************************************************************
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+	#define MEM_SSE2
+	#define MEM_AVX2
+	#define MEM_AVX2_FN __attribute__((target("avx2")))
+	#include <immintrin.h>
+#elif (_MSC_VER >= 1700) && \
+	(defined(_M_X64) || (defined(_M_IX86) && _M_IX86_FP >= 2))
+	#define MEM_SSE2
+	#define MEM_AVX2
+	#define MEM_AVX2_FN
+	#include <immintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+	defined(__aarch64__) && defined(__ARM_NEON)
+	#define MEM_NEON
+	#include <arm_neon.h>
+#endif
+
+#define MEM_SIMD_MIN 128
+
+#ifdef MEM_AVX2
+
+MEM_AVX2_FN static size_t memXorAVX2(void* dest, const void* src1, 
+	const void* src2, size_t count)
+{
+	size_t i;
+	for (i = 0; i + 32 <= count; i += 32)
+		_mm256_storeu_si256((__m256i*)((octet*)dest + i), _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i*)((const octet*)src1 + i)),
+			_mm256_loadu_si256((const __m256i*)((const octet*)src2 + i))));
+	return i;
+}
+
+MEM_AVX2_FN static size_t memEqAVX2(word* diff, const void* buf1, 
+	const void* buf2, size_t count)
+{
+	__m256i d = _mm256_setzero_si256();
+	__m128i d1;
+	size_t i;
+	for (i = 0; i + 32 <= count; i += 32)
+		d = _mm256_or_si256(d, _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i*)((const octet*)buf1 + i)),
+			_mm256_loadu_si256((const __m256i*)((const octet*)buf2 + i))));
+	d1 = _mm_or_si128(_mm256_castsi256_si128(d), 
+		_mm256_extracti128_si256(d, 1));
+	*diff |= (word)_mm_movemask_epi8(_mm_cmpeq_epi8(d1, _mm_setzero_si128())) 
+		^ 0xFFFF;
+	return i;
+}
+
+MEM_AVX2_FN static size_t memIsZeroAVX2(word* diff, const void* buf, 
+	size_t count)
+{
+	__m256i d = _mm256_setzero_si256();
+	__m128i d1;
+	size_t i;
+	for (i = 0; i + 32 <= count; i += 32)
+		d = _mm256_or_si256(d, 
+			_mm256_loadu_si256((const __m256i*)((const octet*)buf + i)));
+	d1 = _mm_or_si128(_mm256_castsi256_si128(d), 
+		_mm256_extracti128_si256(d, 1));
+	*diff |= (word)_mm_movemask_epi8(_mm_cmpeq_epi8(d1, _mm_setzero_si128())) 
+		^ 0xFFFF;
+	return i;
+}
+
+#endif // MEM_AVX2
+
+#if defined(MEM_SSE2)
+
+static size_t memXorSSE2(void* dest, const void* src1, const void* src2, 
+	size_t count)
+{
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		_mm_storeu_si128((__m128i*)((octet*)dest + i), _mm_xor_si128(
+			_mm_loadu_si128((const __m128i*)((const octet*)src1 + i)),
+			_mm_loadu_si128((const __m128i*)((const octet*)src2 + i))));
+	return i;
+}
+
+static size_t memEqSSE2(word* diff, const void* buf1, const void* buf2, 
+	size_t count)
+{
+	__m128i d = _mm_setzero_si128();
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		d = _mm_or_si128(d, _mm_xor_si128(
+			_mm_loadu_si128((const __m128i*)((const octet*)buf1 + i)),
+			_mm_loadu_si128((const __m128i*)((const octet*)buf2 + i))));
+	*diff |= (word)_mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128())) 
+		^ 0xFFFF;
+	return i;
+}
+
+static size_t memIsZeroSSE2(word* diff, const void* buf, size_t count)
+{
+	__m128i d = _mm_setzero_si128();
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		d = _mm_or_si128(d, 
+			_mm_loadu_si128((const __m128i*)((const octet*)buf + i)));
+	*diff |= (word)_mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128())) 
+		^ 0xFFFF;
+	return i;
+}
+
+static size_t memXorV(void* dest, const void* src1, const void* src2, 
+	size_t count)
+{
+	if (utilAVX2IsAvail())
+		return memXorAVX2(dest, src1, src2, count);
+	return memXorSSE2(dest, src1, src2, count);
+}
+
+static size_t memEqV(word* diff, const void* buf1, const void* buf2, 
+	size_t count)
+{
+	if (utilAVX2IsAvail())
+		return memEqAVX2(diff, buf1, buf2, count);
+	return memEqSSE2(diff, buf1, buf2, count);
+}
+
+static size_t memIsZeroV(word* diff, const void* buf, size_t count)
+{
+	if (utilAVX2IsAvail())
+		return memIsZeroAVX2(diff, buf, count);
+	return memIsZeroSSE2(diff, buf, count);
+}
+
+#elif defined(MEM_NEON)
+
+static size_t memXorV(void* dest, const void* src1, const void* src2, 
+	size_t count)
+{
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		vst1q_u8((octet*)dest + i, veorq_u8(vld1q_u8((const octet*)src1 + i),
+			vld1q_u8((const octet*)src2 + i)));
+	return i;
+}
+
+static size_t memEqV(word* diff, const void* buf1, const void* buf2, 
+	size_t count)
+{
+	uint8x16_t d = vdupq_n_u8(0);
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		d = vorrq_u8(d, veorq_u8(vld1q_u8((const octet*)buf1 + i),
+			vld1q_u8((const octet*)buf2 + i)));
+	*diff |= (word)vmaxvq_u8(d);
+	return i;
+}
+
+static size_t memIsZeroV(word* diff, const void* buf, size_t count)
+{
+	uint8x16_t d = vdupq_n_u8(0);
+	size_t i;
+	for (i = 0; i + 16 <= count; i += 16)
+		d = vorrq_u8(d, vld1q_u8((const octet*)buf + i));
+	*diff |= (word)vmaxvq_u8(d);
+	return i;
+}
+
+#endif
+
+#if defined(MEM_SSE2) || defined(MEM_NEON)
+	#define MEM_SIMD
+#endif
+
 /*
 *******************************************************************************
 Дополнительные функции
 
-\remark Функция memWipe() повторяет функцию OPENSSL_cleanse()
-из библиотеки OpenSSL:
+\remark Реализация memWipe() зависит от компилятора и платформы.
+-#	В компиляторах GCC и Clang память обнуляется функцией memset(), 
+	которая использует векторные инструкции. Отказ от записи 
+	предотвращается ассемблерным барьером, сообщающим компилятору, 
+	что обнуленная память используется (прием из BoringSSL).
+-#	В Windows используется функция SecureZeroMemory(), которая 
+	выполняет гарантированную очистку памяти.
+-#	На других платформах память заполняется псевдослучайными октетами 
+	по схеме функции OPENSSL_cleanse() из библиотеки OpenSSL:
 \code
 	unsigned char cleanse_ctr = 0;
 	void OPENSSL_cleanse(void *ptr, size_t len)
@@ -150,10 +348,7 @@ void memFree(void* buf)
 		cleanse_ctr = (unsigned char)ctr;
 	}
 \endcode
-
-\remark На платформе Windows есть функции SecureZeroMemory()
-и RtlSecureZeroMemory(), которые, как и memWipe(), выполняют
-гарантированную очистку памяти.
+.
 *******************************************************************************
 */
 
@@ -162,6 +357,16 @@ bool_t SAFE(memEq)(const void* buf1, const void* buf2, size_t count)
 	register word diff = 0;
 	ASSERT(memIsValid(buf1, count));
 	ASSERT(memIsValid(buf2, count));
+#ifdef MEM_SIMD
+	if (count >= MEM_SIMD_MIN)
+	{
+		word d = 0;
+		size_t t = memEqV(&d, buf1, buf2, count);
+		buf1 = (const octet*)buf1 + t;
+		buf2 = (const octet*)buf2 + t;
+		count -= t, diff = d;
+	}
+#endif
 	for (; count >= O_PER_W; count -= O_PER_W)
 	{
 		diff |= *(const word*)buf1 ^ *(const word*)buf2;
@@ -278,6 +483,26 @@ int FAST(memCmpRev)(const void* buf1, const void* buf2, size_t count)
 	return 0;
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+
+void memWipe(void* buf, size_t count)
+{
+	ASSERT(memIsValid(buf, count));
+	if (count)
+		memset(buf, 0, count);
+	__asm__ __volatile__("" : : "r"(buf) : "memory");
+}
+
+#elif defined(OS_WIN)
+
+void memWipe(void* buf, size_t count)
+{
+	ASSERT(memIsValid(buf, count));
+	SecureZeroMemory(buf, count);
+}
+
+#else
+
 void memWipe(void* buf, size_t count)
 {
 	static octet wipe_ctr = 0;
@@ -294,10 +519,21 @@ void memWipe(void* buf, size_t count)
 	wipe_ctr = (octet)ctr;
 }
 
+#endif
+
 bool_t SAFE(memIsZero)(const void* buf, size_t count)
 {
 	register word diff = 0;
 	ASSERT(memIsValid(buf, count));
+#ifdef MEM_SIMD
+	if (count >= MEM_SIMD_MIN)
+	{
+		word d = 0;
+		size_t t = memIsZeroV(&d, buf, count);
+		buf = (const octet*)buf + t;
+		count -= t, diff = d;
+	}
+#endif
 	for (; count >= O_PER_W; count -= O_PER_W)
 	{
 		diff |= *(const word*)buf;
@@ -461,6 +697,16 @@ void memXor(void* dest, const void* src1, const void* src2, size_t count)
 {
 	ASSERT(memIsSameOrDisjoint(src1, dest, count));
 	ASSERT(memIsSameOrDisjoint(src2, dest, count));
+#ifdef MEM_SIMD
+	if (count >= MEM_SIMD_MIN)
+	{
+		size_t t = memXorV(dest, src1, src2, count);
+		src1 = (const octet*)src1 + t;
+		src2 = (const octet*)src2 + t;
+		dest = (octet*)dest + t;
+		count -= t;
+	}
+#endif
 	for (; count >= O_PER_W; count -= O_PER_W)
 	{
 		*(word*)dest = *(const word*)src1 ^ *(const word*)src2;
@@ -480,6 +726,15 @@ void memXor(void* dest, const void* src1, const void* src2, size_t count)
 void memXor2(void* dest, const void* src, size_t count)
 {
 	ASSERT(memIsSameOrDisjoint(src, dest, count));
+#ifdef MEM_SIMD
+	if (count >= MEM_SIMD_MIN)
+	{
+		size_t t = memXorV(dest, dest, src, count);
+		src = (const octet*)src + t;
+		dest = (octet*)dest + t;
+		count -= t;
+	}
+#endif
 	for (; count >= O_PER_W; count -= O_PER_W)
 	{
 		*(word*)dest ^= *(const word*)src;
@@ -4,7 +4,7 @@
 \brief Multithreading
 \project bee2 [cryptographic library]
 \created 2014.10.10
-\version 2023.04.13
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -152,6 +152,129 @@ void mtSleep(u32 ms)
 
 #endif // OS
 
+/*
+*******************************************************************************
+Создание потоков
+
+Функция потока mt_thrd_i не совпадает по сигнатуре с функциями потоков 
+WinAPI и pthreads. Поэтому поток запускается через функцию-переходник 
+mtThrdMain(), которая получает указатель на блок с fn и arg. Блок 
+освобождается в переходнике.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	mt_thrd_i fn;		/*< функция потока */
+	void* arg;			/*< аргумент */
+} mt_thrd_st;
+
+#ifdef OS_WIN
+
+static DWORD WINAPI mtThrdMain(LPVOID arg)
+{
+	mt_thrd_st st;
+	memCopy(&st, arg, sizeof(mt_thrd_st));
+	memFree(arg);
+	st.fn(st.arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	mt_thrd_st* st;
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(fn != 0);
+	st = (mt_thrd_st*)memAlloc(sizeof(mt_thrd_st));
+	if (st == 0)
+		return FALSE;
+	st->fn = fn, st->arg = arg;
+	*thrd = CreateThread(0, 0, mtThrdMain, st, 0, 0);
+	if (*thrd == 0)
+	{
+		memFree(st);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	WaitForSingleObject(*thrd, INFINITE);
+	CloseHandle(*thrd);
+}
+
+size_t mtThrdHWCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors ? (size_t)info.dwNumberOfProcessors : 1;
+}
+
+#elif defined OS_UNIX
+
+#include <unistd.h>
+
+static void* mtThrdMain(void* arg)
+{
+	mt_thrd_st st;
+	memCopy(&st, arg, sizeof(mt_thrd_st));
+	memFree(arg);
+	st.fn(st.arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	mt_thrd_st* st;
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(fn != 0);
+	st = (mt_thrd_st*)memAlloc(sizeof(mt_thrd_st));
+	if (st == 0)
+		return FALSE;
+	st->fn = fn, st->arg = arg;
+	if (pthread_create(thrd, 0, mtThrdMain, st) != 0)
+	{
+		memFree(st);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	pthread_join(*thrd, 0);
+}
+
+size_t mtThrdHWCount()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (size_t)count : 1;
+}
+
+#else
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i fn, void* arg)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(fn != 0);
+	return FALSE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+}
+
+size_t mtThrdHWCount()
+{
+	return 1;
+}
+
+#endif // OS
+
 bool_t mtCallOnce(size_t* once, void (*fn)())
 {
 	size_t t;
@@ -309,3 +432,441 @@ size_t mtAtomicCmpSwap(size_t* ctr, size_t cmp, size_t swap)
 }
 
 #endif // OS
+
+/*
+*******************************************************************************
+Условные переменные
+
+Условные переменные используются только в пуле потоков и поэтому
+не экспортируются. Если операционная система не распознана, то пул
+не содержит рабочих потоков и ожидание на условной переменной
+не требуется.
+*******************************************************************************
+*/
+
+#ifdef OS_WIN
+
+typedef CONDITION_VARIABLE mt_cv_t;
+
+static bool_t mtCvCreate(mt_cv_t* cv)
+{
+	InitializeConditionVariable(cv);
+	return TRUE;
+}
+
+static void mtCvWait(mt_cv_t* cv, mt_mtx_t* mtx)
+{
+	SleepConditionVariableCS(cv, mtx, INFINITE);
+}
+
+static void mtCvBroadcast(mt_cv_t* cv)
+{
+	WakeAllConditionVariable(cv);
+}
+
+static void mtCvClose(mt_cv_t* cv)
+{
+}
+
+#elif defined OS_UNIX
+
+typedef pthread_cond_t mt_cv_t;
+
+static bool_t mtCvCreate(mt_cv_t* cv)
+{
+	return pthread_cond_init(cv, 0) == 0;
+}
+
+static void mtCvWait(mt_cv_t* cv, mt_mtx_t* mtx)
+{
+	pthread_cond_wait(cv, mtx);
+}
+
+static void mtCvBroadcast(mt_cv_t* cv)
+{
+	pthread_cond_broadcast(cv);
+}
+
+static void mtCvClose(mt_cv_t* cv)
+{
+	pthread_cond_destroy(cv);
+}
+
+#else
+
+typedef bool_t mt_cv_t;
+
+static bool_t mtCvCreate(mt_cv_t* cv)
+{
+	return TRUE;
+}
+
+static void mtCvWait(mt_cv_t* cv, mt_mtx_t* mtx)
+{
+}
+
+static void mtCvBroadcast(mt_cv_t* cv)
+{
+}
+
+static void mtCvClose(mt_cv_t* cv)
+{
+}
+
+#endif // OS
+
+/*
+*******************************************************************************
+Пул потоков
+
+Задание -- это интервал индексов [begin, end), для которых выполняется
+задача fn. Очередь потока -- кольцевой буфер заданий емкости MT_POOL_QUEUE.
+В очереди находятся задания с номерами [head, tail). Владелец очереди
+извлекает задания с конца (tail), другие потоки -- с начала (head).
+Очередь защищается собственным мьютексом.
+
+Общий мьютекс пула защищает счетчик невыполненных индексов pending,
+счетчик событий epoch и признак остановки stop. Счетчик событий
+увеличивается при добавлении заданий, при завершении всех задач и при
+остановке пула. Поток, который не нашел заданий, засыпает на условной
+переменной до изменения счетчика событий. Счетчик читается до поиска
+заданий, поэтому события, которые произошли во время поиска, не теряются.
+
+Порог дробления интервала выбирается так, чтобы на каждый поток
+приходилось около MT_POOL_SPLIT заданий.
+
+Слот 0 (очередь и стек) принадлежит вызывающему потоку, слоты
+[1, running] -- рабочим потокам. Если часть рабочих потоков создать
+не удалось, то оставшиеся слоты не используются. Похищение заданий
+выполняется из всех слотов, так как неиспользуемые очереди пусты.
+*******************************************************************************
+*/
+
+#define MT_POOL_MAX		64		/*< максимальное число потоков */
+#define MT_POOL_QUEUE	256		/*< емкость очереди потока */
+#define MT_POOL_SPLIT	8		/*< число заданий на поток */
+
+typedef struct
+{
+	mt_task_i fn;		/*< задача */
+	void* arg;			/*< аргумент задачи */
+	size_t begin;		/*< начало интервала индексов */
+	size_t end;			/*< конец интервала индексов */
+	size_t grain;		/*< порог дробления */
+} mt_job_st;
+
+typedef struct
+{
+	mt_mtx_t mtx[1];				/*< мьютекс очереди */
+	size_t head;					/*< начало очереди */
+	size_t tail;					/*< конец очереди */
+	mt_job_st jobs[MT_POOL_QUEUE];	/*< очередь заданий */
+	mt_thrd_t thrd;					/*< поток */
+	void* pool;						/*< пул */
+	size_t slot;					/*< номер слота */
+	octet* stack;					/*< стек задач */
+} mt_worker_st;
+
+typedef struct
+{
+	size_t threads;			/*< число слотов */
+	size_t running;			/*< число рабочих потоков */
+	size_t deep;			/*< глубина стека задачи */
+	size_t pending;			/*< число невыполненных индексов */
+	size_t epoch;			/*< счетчик событий */
+	size_t next;			/*< слот для следующей задачи */
+	bool_t stop;			/*< признак остановки */
+	mt_mtx_t mtx[1];		/*< мьютекс пула */
+	mt_cv_t cv[1];			/*< условная переменная пула */
+	mt_worker_st* workers;	/*< [threads] слоты */
+} mt_pool_st;
+
+static size_t mtPoolCount(size_t threads)
+{
+	if (threads == 0)
+		threads = mtThrdHWCount();
+	return MIN2(threads, MT_POOL_MAX);
+}
+
+size_t mtPool_keep(size_t threads, size_t deep)
+{
+	threads = mtPoolCount(threads);
+	return O_OF_W(W_OF_O(sizeof(mt_pool_st))) +
+		O_OF_W(W_OF_O(threads * sizeof(mt_worker_st))) +
+		threads * O_OF_W(W_OF_O(deep));
+}
+
+static void mtPoolNotify(mt_pool_st* pool)
+{
+	++pool->epoch;
+	mtCvBroadcast(pool->cv);
+}
+
+static bool_t mtPoolPush(mt_pool_st* pool, size_t slot, const mt_job_st* job)
+{
+	mt_worker_st* w = pool->workers + slot;
+	// поставить задание в очередь слота
+	mtMtxLock(w->mtx);
+	if (w->tail - w->head == MT_POOL_QUEUE)
+	{
+		mtMtxUnlock(w->mtx);
+		return FALSE;
+	}
+	memCopy(w->jobs + w->tail % MT_POOL_QUEUE, job, sizeof(mt_job_st));
+	++w->tail;
+	mtMtxUnlock(w->mtx);
+	// разбудить потоки
+	mtMtxLock(pool->mtx);
+	mtPoolNotify(pool);
+	mtMtxUnlock(pool->mtx);
+	return TRUE;
+}
+
+static bool_t mtPoolTake(mt_job_st* job, mt_pool_st* pool, size_t slot)
+{
+	mt_worker_st* w = pool->workers + slot;
+	size_t k;
+	// собственная очередь: с конца
+	mtMtxLock(w->mtx);
+	if (w->head != w->tail)
+	{
+		--w->tail;
+		memCopy(job, w->jobs + w->tail % MT_POOL_QUEUE, sizeof(mt_job_st));
+		mtMtxUnlock(w->mtx);
+		return TRUE;
+	}
+	mtMtxUnlock(w->mtx);
+	// чужие очереди: с начала
+	for (k = 1; k < pool->threads; ++k)
+	{
+		w = pool->workers + (slot + k) % pool->threads;
+		mtMtxLock(w->mtx);
+		if (w->head != w->tail)
+		{
+			memCopy(job, w->jobs + w->head % MT_POOL_QUEUE, sizeof(mt_job_st));
+			++w->head;
+			mtMtxUnlock(w->mtx);
+			return TRUE;
+		}
+		mtMtxUnlock(w->mtx);
+	}
+	return FALSE;
+}
+
+static void mtPoolExec(mt_job_st* job, mt_pool_st* pool, size_t slot)
+{
+	mt_job_st half[1];
+	size_t i;
+	// раздробить задание
+	while (job->end - job->begin > job->grain)
+	{
+		memCopy(half, job, sizeof(mt_job_st));
+		half->begin = job->begin + (job->end - job->begin) / 2;
+		if (!mtPoolPush(pool, slot, half))
+			break;
+		job->end = half->begin;
+	}
+	// выполнить задачи
+	for (i = job->begin; i < job->end; ++i)
+		job->fn(i, job->arg, pool->workers[slot].stack);
+	// учесть выполнение
+	mtMtxLock(pool->mtx);
+	ASSERT(pool->pending >= job->end - job->begin);
+	pool->pending -= job->end - job->begin;
+	if (pool->pending == 0)
+		mtPoolNotify(pool);
+	mtMtxUnlock(pool->mtx);
+}
+
+static void mtPoolMain(void* arg)
+{
+	mt_worker_st* w = (mt_worker_st*)arg;
+	mt_pool_st* pool = (mt_pool_st*)w->pool;
+	mt_job_st job[1];
+	size_t epoch;
+	while (1)
+	{
+		// зафиксировать событие
+		mtMtxLock(pool->mtx);
+		if (pool->stop)
+		{
+			mtMtxUnlock(pool->mtx);
+			break;
+		}
+		epoch = pool->epoch;
+		mtMtxUnlock(pool->mtx);
+		// выполнить задание
+		if (mtPoolTake(job, pool, w->slot))
+		{
+			mtPoolExec(job, pool, w->slot);
+			continue;
+		}
+		// ждать следующего события
+		mtMtxLock(pool->mtx);
+		while (!pool->stop && pool->epoch == epoch)
+			mtCvWait(pool->cv, pool->mtx);
+		mtMtxUnlock(pool->mtx);
+	}
+}
+
+bool_t mtPoolStart(void* state, size_t threads, size_t deep)
+{
+	mt_pool_st* pool = (mt_pool_st*)state;
+	octet* stack;
+	size_t i;
+	// pre
+	ASSERT(memIsValid(state, mtPool_keep(threads, deep)));
+	// подготовить пул
+	threads = mtPoolCount(threads);
+	memSetZero(pool, sizeof(mt_pool_st));
+	pool->threads = threads;
+	pool->deep = O_OF_W(W_OF_O(deep));
+	pool->workers = (mt_worker_st*)((octet*)pool +
+		O_OF_W(W_OF_O(sizeof(mt_pool_st))));
+	stack = (octet*)pool->workers +
+		O_OF_W(W_OF_O(threads * sizeof(mt_worker_st)));
+	if (!mtMtxCreate(pool->mtx))
+		return FALSE;
+	if (!mtCvCreate(pool->cv))
+	{
+		mtMtxClose(pool->mtx);
+		return FALSE;
+	}
+	// подготовить слоты
+	for (i = 0; i < threads; ++i)
+	{
+		mt_worker_st* w = pool->workers + i;
+		memSetZero(w, sizeof(mt_worker_st));
+		if (!mtMtxCreate(w->mtx))
+		{
+			while (i--)
+				mtMtxClose(pool->workers[i].mtx);
+			mtCvClose(pool->cv);
+			mtMtxClose(pool->mtx);
+			return FALSE;
+		}
+		w->pool = pool;
+		w->slot = i;
+		w->stack = stack + i * pool->deep;
+	}
+	// запустить рабочие потоки
+	for (i = 1; i < threads; ++i)
+	{
+		if (!mtThrdCreate(&pool->workers[i].thrd, mtPoolMain,
+			pool->workers + i))
+			break;
+		++pool->running;
+	}
+	return TRUE;
+}
+
+size_t mtPoolThreads(const void* state)
+{
+	const mt_pool_st* pool = (const mt_pool_st*)state;
+	ASSERT(memIsValid(pool, sizeof(mt_pool_st)));
+	return pool->running + 1;
+}
+
+void mtPoolFor(void* state, size_t count, mt_task_i fn, void* arg)
+{
+	mt_pool_st* pool = (mt_pool_st*)state;
+	mt_job_st job[1];
+	ASSERT(memIsValid(pool, sizeof(mt_pool_st)));
+	ASSERT(fn != 0);
+	if (count == 0)
+		return;
+	// подготовить задание
+	job->fn = fn, job->arg = arg;
+	job->begin = 0, job->end = count;
+	job->grain = count / ((pool->running + 1) * MT_POOL_SPLIT);
+	job->grain = MAX2(job->grain, 1);
+	mtMtxLock(pool->mtx);
+	pool->pending += count;
+	mtMtxUnlock(pool->mtx);
+	// выполнить
+	if (!mtPoolPush(pool, 0, job))
+		mtPoolExec(job, pool, 0);
+	mtPoolWait(pool);
+}
+
+void mtPoolRun(void* state, mt_task_i fn, size_t i, void* arg)
+{
+	mt_pool_st* pool = (mt_pool_st*)state;
+	mt_job_st job[1];
+	size_t k;
+	ASSERT(memIsValid(pool, sizeof(mt_pool_st)));
+	ASSERT(fn != 0);
+	// подготовить задание
+	job->fn = fn, job->arg = arg;
+	job->begin = i, job->end = i + 1;
+	job->grain = 1;
+	mtMtxLock(pool->mtx);
+	++pool->pending;
+	mtMtxUnlock(pool->mtx);
+	// распределить по кругу
+	for (k = 0; k <= pool->running; ++k)
+	{
+		size_t slot = (pool->next + k) % (pool->running + 1);
+		if (mtPoolPush(pool, slot, job))
+		{
+			pool->next = slot + 1;
+			return;
+		}
+	}
+	// очереди переполнены: выполнить в вызывающем потоке
+	mtPoolExec(job, pool, 0);
+}
+
+void mtPoolWait(void* state)
+{
+	mt_pool_st* pool = (mt_pool_st*)state;
+	mt_job_st job[1];
+	size_t epoch;
+	ASSERT(memIsValid(pool, sizeof(mt_pool_st)));
+	while (1)
+	{
+		// зафиксировать событие
+		mtMtxLock(pool->mtx);
+		if (pool->pending == 0)
+		{
+			mtMtxUnlock(pool->mtx);
+			break;
+		}
+		epoch = pool->epoch;
+		mtMtxUnlock(pool->mtx);
+		// выполнить задание
+		if (mtPoolTake(job, pool, 0))
+		{
+			mtPoolExec(job, pool, 0);
+			continue;
+		}
+		// ждать следующего события
+		mtMtxLock(pool->mtx);
+		while (pool->pending && pool->epoch == epoch)
+			mtCvWait(pool->cv, pool->mtx);
+		mtMtxUnlock(pool->mtx);
+	}
+}
+
+void mtPoolClose(void* state)
+{
+	mt_pool_st* pool = (mt_pool_st*)state;
+	size_t i;
+	ASSERT(memIsValid(pool, sizeof(mt_pool_st)));
+	// дождаться задач
+	mtPoolWait(pool);
+	// остановить рабочие потоки
+	mtMtxLock(pool->mtx);
+	pool->stop = TRUE;
+	mtPoolNotify(pool);
+	mtMtxUnlock(pool->mtx);
+	for (i = 1; i <= pool->running; ++i)
+		mtThrdJoin(&pool->workers[i].thrd);
+	// освободить ресурсы
+	for (i = 0; i < pool->threads; ++i)
+		mtMtxClose(pool->workers[i].mtx);
+	mtCvClose(pool->cv);
+	mtMtxClose(pool->mtx);
+	// очистить стеки
+	memWipe(pool->workers[0].stack, pool->threads * pool->deep);
+}
@@ -4,7 +4,7 @@
 \brief Entropy sources and random number generators
 \project bee2 [cryptographic library]
 \created 2014.10.13
-\version 2023.12.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -677,6 +677,13 @@ static bool_t _inited;			/*< мьютекс создан? */
 static size_t _ctr;				/*< счетчик обращений */
 static rng_state_st* _state;	/*< состояние */
 
+#define RNG_POOL_SIZE (4 * 2500)
+
+static octet* _pool;			/*< пул [RNG_POOL_SIZE + 2500] */
+static mt_thrd_t _pool_thrd;	/*< фоновый поток */
+static bool_t _pool_stop;		/*< запрос на останов потока */
+static rng_pool_stat _pool_stat[1];	/*< статистика пула */
+
 size_t rngCreate_keep()
 {
 	return sizeof(rng_state_st) + MAX2(beltHash_keep(), brngCTR_keep());
@@ -684,6 +691,8 @@ size_t rngCreate_keep()
 
 static void rngDestroy()
 {
+	// остановить фоновый поток (могли забыть)
+	rngPoolStop();
 	// закрыть состояние (могли забыть)
 	mtMtxLock(_mtx);
 	blobClose(_state), _state = 0, _ctr = 0;
@@ -782,12 +791,16 @@ bool_t rngIsValid()
 
 void rngClose()
 {
+	bool_t closed;
 	ASSERT(_inited);
 	mtMtxLock(_mtx);
 	ASSERT(rngIsValid_internal());
-	if (--_ctr == 0)
+	if (closed = (--_ctr == 0))
 		blobClose(_state), _state = 0;
 	mtMtxUnlock(_mtx);
+	// остановить фоновый поток
+	if (closed)
+		rngPoolStop();
 }
 
 /*
@@ -802,7 +815,8 @@ void rngClose()
 	A lock is held while waiting for a long running or blocking operation 
 	to complete (CWE-667)".
 Проблема в том, что в источнике timer многократно вызывается функция
-mtSleep(0).
+mtSleep(0). Проблема снимается, если запущен фоновый сбор энтропии
+(rngPoolStart()): тогда источники опрашиваются вне блокировки.
 *******************************************************************************
 */
 
@@ -822,8 +836,21 @@ void rngStepR(void* buf, size_t count, void* state)
 	// блокировать мьютекс
 	ASSERT(_inited);
 	mtMtxLock(_mtx);
+	// забрать данные из пула
+	if (_pool_stat->active)
+	{
+		read = MIN2(count, _pool_stat->level);
+		_pool_stat->level -= read;
+		memCopy(buf, _pool + _pool_stat->level, read);
+		memWipe(_pool + _pool_stat->level, read);
+		_pool_stat->served += read;
+		if (read < count)
+			++_pool_stat->misses;
+		pos = COUNT_OF(sources);
+	}
 	// опросить источники
-	read = pos = 0;
+	else
+		read = pos = 0;
 	while (read < count && pos < COUNT_OF(sources))
 	{
 		if (rngESRead(&r, (octet*)buf + read, count - read,
@@ -853,3 +880,151 @@ void rngRekey()
 	// снять блокировку
 	mtMtxUnlock(_mtx);
 }
+
+/*
+*******************************************************************************
+Фоновый сбор энтропии
+
+Пул энтропии -- это буфер _pool из RNG_POOL_SIZE октетов, за которым
+следует рабочий блок фонового потока (2500 октетов). Данные от источников
+читаются в рабочий блок и тестируются вне блокировки, под блокировкой
+только копируются в пул. Данные забираются из пула с конца.
+
+Поток проверяет запрос на останов перед каждым опросом источников.
+Если пул заполнен или подходящий блок получить не удалось, поток
+приостанавливается на RNG_POOL_SLEEP мс.
+*******************************************************************************
+*/
+
+#define RNG_POOL_SLEEP 10
+
+static bool_t rngPoolRead(octet block[2500], size_t* rejected)
+{
+	const char* sources[] = {"trng", "trng2", "sys", "sys2", "timer"};
+	size_t read, pos;
+	for (pos = 0; pos < COUNT_OF(sources); ++pos)
+	{
+		if (rngESRead(&read, block, 2500, sources[pos]) != ERR_OK ||
+			read != 2500)
+			continue;
+		if (rngTestFIPS1(block) && rngTestFIPS2(block) &&
+			rngTestFIPS3(block) && rngTestFIPS4(block))
+			return TRUE;
+		++*rejected;
+	}
+	return FALSE;
+}
+
+static void rngPoolMain(void* arg)
+{
+	octet* block = (octet*)arg;
+	size_t rejected;
+	bool_t full, ok;
+	while (1)
+	{
+		// остановиться? пул заполнен?
+		mtMtxLock(_mtx);
+		if (_pool_stop)
+		{
+			mtMtxUnlock(_mtx);
+			break;
+		}
+		full = _pool_stat->level + 2500 > RNG_POOL_SIZE;
+		mtMtxUnlock(_mtx);
+		if (full)
+		{
+			mtSleep(RNG_POOL_SLEEP);
+			continue;
+		}
+		// опросить источники
+		rejected = 0;
+		ok = rngPoolRead(block, &rejected);
+		// пополнить пул
+		mtMtxLock(_mtx);
+		_pool_stat->rejected += rejected;
+		if (ok)
+		{
+			memCopy(_pool + _pool_stat->level, block, 2500);
+			_pool_stat->level += 2500;
+			++_pool_stat->blocks;
+		}
+		mtMtxUnlock(_mtx);
+		memWipe(block, 2500);
+		if (!ok)
+			mtSleep(RNG_POOL_SLEEP);
+	}
+}
+
+err_t rngPoolStart()
+{
+	ASSERT(_inited);
+	mtMtxLock(_mtx);
+	ASSERT(rngIsValid_internal());
+	// поток уже запущен?
+	if (_pool_stat->active)
+	{
+		mtMtxUnlock(_mtx);
+		return _pool_stop ? ERR_BAD_LOGIC : ERR_OK;
+	}
+	// создать пул
+	_pool = (octet*)blobCreate(RNG_POOL_SIZE + 2500);
+	if (!_pool)
+	{
+		mtMtxUnlock(_mtx);
+		return ERR_OUTOFMEMORY;
+	}
+	memSetZero(_pool_stat, sizeof(rng_pool_stat));
+	_pool_stat->size = RNG_POOL_SIZE;
+	// запустить поток
+	if (!mtThrdCreate(&_pool_thrd, rngPoolMain, _pool + RNG_POOL_SIZE))
+	{
+		blobClose(_pool), _pool = 0;
+		mtMtxUnlock(_mtx);
+		return ERR_NOT_IMPLEMENTED;
+	}
+	_pool_stat->active = TRUE;
+	mtMtxUnlock(_mtx);
+	return ERR_OK;
+}
+
+void rngPoolStop()
+{
+	mt_thrd_t thrd;
+	if (!_inited)
+		return;
+	// запросить останов
+	mtMtxLock(_mtx);
+	if (!_pool_stat->active || _pool_stop)
+	{
+		mtMtxUnlock(_mtx);
+		return;
+	}
+	_pool_stop = TRUE;
+	thrd = _pool_thrd;
+	mtMtxUnlock(_mtx);
+	// дождаться завершения потока
+	mtThrdJoin(&thrd);
+	// очистить пул
+	mtMtxLock(_mtx);
+	blobClose(_pool), _pool = 0;
+	_pool_stat->level = 0;
+	_pool_stat->active = FALSE;
+	_pool_stop = FALSE;
+	mtMtxUnlock(_mtx);
+}
+
+void rngPoolStat(rng_pool_stat* stat)
+{
+	ASSERT(memIsValid(stat, sizeof(rng_pool_stat)));
+	if (!_inited)
+	{
+		memSetZero(stat, sizeof(rng_pool_stat));
+		stat->size = RNG_POOL_SIZE;
+		return;
+	}
+	mtMtxLock(_mtx);
+	memCopy(stat, _pool_stat, sizeof(rng_pool_stat));
+	if (!stat->size)
+		stat->size = RNG_POOL_SIZE;
+	mtMtxUnlock(_mtx);
+}
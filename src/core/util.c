@@ -4,7 +4,7 @@
 \brief Utilities
 \project bee2 [cryptographic library]
 \created 2012.05.10
-\version 2021.05.18
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -270,3 +270,99 @@ u32 utilNonce32()
 	// еще?
 	return state;
 }
+
+/*
+*******************************************************************************
+Поддержка AVX2 и PCLMULQDQ
+
+Для AVX2 проверяются признаки OSXSAVE и AVX (CPUID.1:ECX), сохранение 
+регистров XMM и YMM операционной системой (XGETBV, XCR0) и признак AVX2 
+(CPUID.7:EBX). Для PCLMULQDQ проверяется признак CPUID.1:ECX[1].
+
+Результат проверки кэшируется в переменной _avx2 (_clmul): 0 -- проверка 
+не выполнялась, 1 -- инструкции не поддерживаются, 2 -- поддерживаются. 
+Одновременные проверки в разных потоках дают одинаковый результат, 
+поэтому синхронизация не нужна.
+*******************************************************************************
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__i386__) || defined(__x86_64__))
+
+#include <cpuid.h>
+
+#define utilCPUID(info, id) \
+	__cpuid_count(id, 0, info[0], info[1], info[2], info[3])
+
+static u32 utilXCR0()
+{
+	u32 a, d;
+	__asm__ __volatile__ (".byte 0x0F, 0x01, 0xD0" : "=a" (a), "=d" (d) 
+		: "c" (0));
+	return a;
+}
+
+#define UTIL_X86
+
+#elif (_MSC_VER >= 1600) && (defined(_M_IX86) || defined(_M_X64))
+
+#include <intrin.h>
+
+#define utilCPUID(info, id) __cpuidex((int*)info, id, 0)
+#define utilXCR0() ((u32)_xgetbv(0))
+
+#define UTIL_X86
+
+#endif
+
+#ifdef UTIL_X86
+
+static size_t _avx2;
+static size_t _clmul;
+
+bool_t utilAVX2IsAvail()
+{
+	u32 info[4];
+	size_t avx2 = 1;
+	if (_avx2)
+		return _avx2 == 2;
+	utilCPUID(info, 0);
+	if (info[0] >= 7)
+	{
+		// OSXSAVE и AVX? ОС сохраняет регистры XMM и YMM? AVX2?
+		utilCPUID(info, 1);
+		if ((info[2] & 0x18000000) == 0x18000000 &&
+			(utilXCR0() & 6) == 6)
+		{
+			utilCPUID(info, 7);
+			if (info[1] & 0x00000020)
+				avx2 = 2;
+		}
+	}
+	_avx2 = avx2;
+	return _avx2 == 2;
+}
+
+bool_t utilCLMULIsAvail()
+{
+	u32 info[4];
+	if (_clmul)
+		return _clmul == 2;
+	utilCPUID(info, 1);
+	_clmul = (info[2] & 0x00000002) ? 2 : 1;
+	return _clmul == 2;
+}
+
+#else
+
+bool_t utilAVX2IsAvail()
+{
+	return FALSE;
+}
+
+bool_t utilCLMULIsAvail()
+{
+	return FALSE;
+}
+
+#endif
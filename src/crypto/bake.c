@@ -4,7 +4,7 @@
 \brief STB 34.101.66 (bake): authenticated key establishment (AKE) protocols
 \project bee2 [cryptographic library]
 \created 2014.04.14
-\version 2023.09.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,6 +13,7 @@
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/obj.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/bake.h"
@@ -37,34 +38,41 @@
 
 err_t bakeKDF(octet key[32], const octet secret[], size_t secret_len, 
 	const octet iv[], size_t iv_len, size_t num)
+{
+	return bakeKDF2(key, secret, secret_len, iv, iv_len, num, 1);
+}
+
+err_t bakeKDF2(octet keys[], const octet secret[], size_t secret_len, 
+	const octet iv[], size_t iv_len, size_t num, size_t count)
 {
 	void* state;
 	octet* block;
 	// проверить входные данные
-	if (!memIsValid(secret, secret_len) ||
+	if (count == 0 || count > SIZE_MAX / 32 ||
+		!memIsValid(secret, secret_len) ||
 		!memIsValid(iv, iv_len) ||
-		!memIsValid(key, 32))
+		!memIsValid(keys, 32 * count))
 		return ERR_BAD_INPUT;
 	// создать состояние
 	state = blobCreate(utilMax(2, beltHash_keep(), beltKRP_keep() + 16));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	block = (octet*)state + beltKRP_keep();
-	// key <- beltHash(secret || iv)
+	// keys[0] <- beltHash(secret || iv)
 	beltHashStart(state);
 	beltHashStepH(secret, secret_len, state);
 	beltHashStepH(iv, iv_len, state);
-	beltHashStepG(key, state);
-	// key <- beltKRP(Y, 1^96, num)
+	beltHashStepG(keys, state);
+	// keys[i] <- beltKRP(Y, 1^96, num + i)
 	memSet(block, 0xFF, 12);
-	beltKRPStart(state, key, 32, block);
+	beltKRPStart(state, keys, 32, block);
 	CASSERT(B_PER_S <= 128);
 	memCopy(block, &num, sizeof(size_t));
 #if (OCTET_ORDER == BIG_ENDIAN)
 	memRev(block, sizeof(size_t));
 #endif
 	memSetZero(block + sizeof(size_t), 16 - sizeof(size_t));
-	beltKRPStepG(key, 32, block, state);
+	beltKRPStepGN(keys, 32, block, count, state);
 	// завершить
 	blobClose(state);
 	return ERR_OK;
@@ -141,6 +149,228 @@ err_t bakeSWU(octet pt[], const bign_params* params, const octet msg[])
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Контекст долговременного ключа
+
+Контекст хранит данные, которые не меняются от сеанса к сеансу: описание 
+кривой, личный ключ, проверенный собственный сертификат и таблицу 
+предвычислений для кратных базовой точки G (см. ecPreSCombA()). Одноразовые
+личные ключи u секретны, поэтому кратные u G вычисляются регулярным 
+гребенчатым методом (ecMulSCombA()).
+
+Кроме этого, в контексте размещается кэш проверенных сертификатов другой 
+стороны. Элемент кэша -- открытый ключ Q в форме аффинной точки и хэш-значение
+сертификата (beltHash). Кэш заполняется по кругу: новый элемент 
+замещает самый старый. Обращения к кэшу синхронизируются мьютексом.
+
+Состояния протоколов, созданные по контексту, не копируют таблицу 
+предвычислений и кэш, а ссылаются на них через поле resp. Поле не входит 
+в таблицу указателей и не настраивается при копировании состояний.
+*******************************************************************************
+*/
+
+#define BAKE_RESP_W		5		/*< ширина гребенки */
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< описание эллиптической кривой */
+	word* d;					/*< [ec->f->n] долговременный личный ключ */
+	word* pre;					/*< [2^w * 2 * ec->f->n] кратные G */
+	octet* cache;				/*< [count * (O_OF_W(2n) + 32)] кэш */
+// }
+	bign_params params[1];		/*< параметры */
+	bake_cert cert[1];			/*< сертификат */
+	size_t count;				/*< емкость кэша */
+	size_t used;				/*< число заполненных элементов кэша */
+	size_t next;				/*< номер замещаемого элемента кэша */
+	mt_mtx_t mtx[1];			/*< мьютекс кэша */
+	octet data[];				/*< данные */
+} bake_resp_o;
+
+#define bakeRespPreCount()\
+	(SIZE_1 << BAKE_RESP_W)
+
+#define bakeRespEntry_keep(n)\
+	(O_OF_W(2 * (n)) + 32)
+
+static size_t bakeResp_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) +
+		utilMax(3,
+			f_deep,
+			ecpIsOnA_deep(n, f_deep),
+			ecPreSCombA_deep(n, ec_d, ec_deep));
+}
+
+size_t bakeResp_keep(size_t l, size_t count)
+{
+	const size_t n = W_OF_B(2 * l);
+	return sizeof(bake_resp_o) +
+		bignStart_keep(l, bakeResp_deep) +
+		O_OF_W(n + bakeRespPreCount() * 2 * n) +
+		count * bakeRespEntry_keep(n);
+}
+
+err_t bakeRespStart(void* resp, const bign_params* params,
+	const octet privkey[], const bake_cert* cert, size_t count)
+{
+	err_t code;
+	bake_resp_o* r = (bake_resp_o*)resp;
+	size_t n, no;
+	// стек
+	word* Q;
+	void* stack;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (!bignIsOperable(params))
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(privkey, params->l / 4) ||
+		!memIsValid(cert, sizeof(bake_cert)) ||
+		!memIsValid(cert->data, cert->len) ||
+		cert->val == 0)
+		return ERR_BAD_INPUT;
+	// объект неработоспособен до завершения настройки
+	memSetZero(r, sizeof(bake_resp_o));
+	// загрузить параметры
+	code = bignStart(r->data, params);
+	ERR_CALL_CHECK(code);
+	r->ec = (ec_o*)r->data;
+	n = r->ec->f->n, no = r->ec->f->no;
+	memCopy(r->params, params, sizeof(bign_params));
+	// настроить указатели
+	r->d = objEnd(r->ec, word);
+	r->pre = r->d + n;
+	r->cache = (octet*)(r->pre + bakeRespPreCount() * 2 * n);
+	// загрузить личный ключ
+	wwFrom(r->d, privkey, no);
+	// раскладка стека
+	Q = (word*)(r->cache + count * bakeRespEntry_keep(n));
+	stack = Q + 2 * n;
+	// проверить сертификат и его открытый ключ
+	code = cert->val((octet*)Q, params, cert->data, cert->len);
+	if (code == ERR_OK && (
+		!qrFrom(ecX(Q), (octet*)Q, r->ec->f, stack) ||
+		!qrFrom(ecY(Q, n), (octet*)Q + no, r->ec->f, stack) ||
+		!ecpIsOnA(Q, r->ec, stack)))
+		code = ERR_BAD_CERT;
+	// рассчитать кратные G
+	if (code == ERR_OK &&
+		!ecPreSCombA(r->pre, r->ec->base, r->ec, BAKE_RESP_W, n, stack))
+		code = ERR_BAD_PARAMS;
+	// создать мьютекс кэша
+	if (code == ERR_OK && !mtMtxCreate(r->mtx))
+		code = ERR_SYS;
+	// ошибка: стереть личный ключ, оставить объект неработоспособным
+	if (code != ERR_OK)
+	{
+		memWipe(r->d, O_OF_W(n));
+		memSetZero(r, sizeof(bake_resp_o));
+		return code;
+	}
+	// подготовить кэш
+	memCopy(r->cert, cert, sizeof(bake_cert));
+	r->count = count, r->used = r->next = 0;
+	// настроить заголовок
+	r->hdr.keep = sizeof(bake_resp_o) + objKeep(r->ec) +
+		O_OF_W(n + bakeRespPreCount() * 2 * n) + count * bakeRespEntry_keep(n);
+	r->hdr.p_count = 4;
+	r->hdr.o_count = 1;
+	// все нормально
+	return ERR_OK;
+}
+
+void bakeRespClose(void* resp)
+{
+	bake_resp_o* r = (bake_resp_o*)resp;
+	if (objIsOperable(r))
+	{
+		mtMtxClose(r->mtx);
+		memWipe(r, objKeep(r));
+	}
+}
+
+/*
+*******************************************************************************
+Проверка сертификата
+
+Открытый ключ из сертификата [len]data проверяется функцией val 
+и сохраняется в аффинной точке [2n]Q. Если задан контекст r с непустым 
+кэшем, то сначала выполняется поиск в кэше и, в случае неудачи, 
+проверенный ключ добавляется в кэш.
+
+\remark Кэширование корректно, если результат val зависит только 
+от params и data.
+*******************************************************************************
+*/
+
+static err_t bakeCertVal(word Q[], const ec_o* ec, const bign_params* params,
+	bake_resp_o* r, bake_certval_i val, const octet data[], size_t len,
+	void* stack)
+{
+	err_t code;
+	const size_t n = ec->f->n;
+	const size_t no = ec->f->no;
+	size_t i;
+	octet* h = 0;
+	// искать в кэше
+	if (r && r->count)
+	{
+		h = (octet*)stack;
+		stack = h + 32;
+		beltHashStart(stack);
+		beltHashStepH(data, len, stack);
+		beltHashStepG(h, stack);
+		mtMtxLock(r->mtx);
+		for (i = 0; i < r->used; ++i)
+		{
+			octet* entry = r->cache + i * bakeRespEntry_keep(n);
+			if (memEq(entry + O_OF_W(2 * n), h, 32))
+			{
+				wwCopy(Q, (word*)entry, 2 * n);
+				mtMtxUnlock(r->mtx);
+				return ERR_OK;
+			}
+		}
+		mtMtxUnlock(r->mtx);
+	}
+	// проверить сертификат
+	code = val((octet*)Q, params, data, len);
+	ERR_CALL_CHECK(code);
+	if (!qrFrom(ecX(Q), (octet*)Q, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), (octet*)Q + no, ec->f, stack) ||
+		!ecpIsOnA(Q, ec, stack))
+		return ERR_BAD_CERT;
+	// сохранить в кэше
+	if (h)
+	{
+		octet* entry;
+		mtMtxLock(r->mtx);
+		entry = r->cache + r->next * bakeRespEntry_keep(n);
+		wwCopy((word*)entry, Q, 2 * n);
+		memCopy(entry + O_OF_W(2 * n), h, 32);
+		if (r->used < r->count)
+			r->used++;
+		if (++r->next == r->count)
+			r->next = 0;
+		mtMtxUnlock(r->mtx);
+	}
+	return ERR_OK;
+}
+
+static size_t bakeCertVal_deep(size_t n, size_t f_deep)
+{
+	return 32 +
+		utilMax(3,
+			beltHash_keep(),
+			f_deep,
+			ecpIsOnA_deep(n, f_deep));
+}
+
 /*
 *******************************************************************************
 Шаги протокола BMQV
@@ -165,8 +395,8 @@ typedef struct
 	bign_params params[1];		/*< параметры */
 	bake_settings settings[1];	/*< настройки */
 	bake_cert cert[1];			/*< сертификат */
-	octet K0[32];				/*< ключ K0 */
-	octet K1[32];				/*< ключ K1 */
+	bake_resp_o* resp;			/*< контекст долговременного ключа */
+	octet K[2][32];				/*< ключи K0, K1 */
 	octet data[];				/*< данные */
 } bake_bmqv_o;
 
@@ -237,10 +467,47 @@ err_t bakeBMQVStart(void* state, const bign_params* params,
 		return ERR_BAD_CERT;
 	// сохранить сертификат
 	memCopy(s->cert, cert, sizeof(bake_cert));
+	s->resp = 0;
 	// все нормально
 	return code;
 }
 
+err_t bakeBMQVStart2(void* state, const bake_settings* settings, void* resp)
+{
+	bake_bmqv_o* s = (bake_bmqv_o*)state;
+	bake_resp_o* r = (bake_resp_o*)resp;
+	size_t n, no;
+	// проверить входные данные
+	if (!memIsValid(settings, sizeof(bake_settings)) ||
+		!memIsNullOrValid(settings->helloa, settings->helloa_len) ||
+		!memIsNullOrValid(settings->hellob, settings->hellob_len) ||
+		!objIsOperable(r))
+		return ERR_BAD_INPUT;
+	if (settings->rng == 0)
+		return ERR_BAD_RNG;
+	// загрузить параметры
+	objCopy(s->data, r->ec);
+	s->ec = (ec_o*)s->data;
+	n = s->ec->f->n, no = s->ec->f->no;
+	memCopy(s->params, r->params, sizeof(bign_params));
+	// сохранить настройки
+	memCopy(s->settings, settings, sizeof(bake_settings));
+	// настроить указатели
+	s->d = objEnd(s->ec, word);
+	s->u = s->d + n;
+	s->Vb = (octet*)(s->u + n);
+	// настроить заголовок
+	s->hdr.keep = sizeof(bake_bmqv_o) + objKeep(s->ec) + O_OF_W(2 * n) + no;
+	s->hdr.p_count = 4;
+	s->hdr.o_count = 1;
+	// загрузить личный ключ и сертификат
+	wwCopy(s->d, r->d, n);
+	memCopy(s->cert, r->cert, sizeof(bake_cert));
+	s->resp = r;
+	// все нормально
+	return ERR_OK;
+}
+
 static size_t bakeBMQVStart_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
@@ -272,7 +539,9 @@ err_t bakeBMQVStep2(octet out[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Vb <- ub G
-	if (!ecMulA(Vb, s->ec->base, s->ec, s->u, n, stack))
+	if (s->resp ?
+		!ecMulSCombA(Vb, s->resp->pre, s->ec, BAKE_RESP_W, s->u, n, stack) :
+		!ecMulA(Vb, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	// out <- <Vb>
 	qrTo(out, ecX(Vb), s->ec->f, stack);
@@ -287,9 +556,10 @@ static size_t bakeBMQVStep2_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(2 * n) +
-		utilMax(2,
+		utilMax(3,
 			f_deep,
-			ecMulA_deep(n, ec_d, ec_deep, n));
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, n));
 }
 
 err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
@@ -332,12 +602,9 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 	block1 = block0 + 16;
 	ASSERT(block1 + 16 <= (octet*)stack);
 	// проверить certb
-	code = certb->val((octet*)Qb, s->params, certb->data, certb->len);
+	code = bakeCertVal(Qb, s->ec, s->params, s->resp, certb->val,
+		certb->data, certb->len, stack);
 	ERR_CALL_CHECK(code);
-	if (!qrFrom(ecX(Qb), (octet*)Qb, s->ec->f, stack) ||
-		!qrFrom(ecY(Qb, n), (octet*)Qb + no, s->ec->f, stack) ||
-		!ecpIsOnA(Qb, s->ec, stack))
-		return ERR_BAD_CERT;
 	// Vb <- in, Vb \in E*?
 	if (!qrFrom(ecX(Vb), in, s->ec->f, stack) ||
 		!qrFrom(ecY(Vb, n), in + no, s->ec->f, stack) ||
@@ -348,7 +615,9 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Va <- ua G
-	if (!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
+	if (s->resp ?
+		!ecMulSCombA(Va, s->resp->pre, s->ec, BAKE_RESP_W, s->u, n, stack) :
+		!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)Va, ecX(Va), s->ec->f, stack);
 	qrTo((octet*)Va + no, ecY(Va, n), s->ec->f, stack);
@@ -387,22 +656,17 @@ err_t bakeBMQVStep3(octet out[], const octet in[], const bake_cert* certb,
 	if (s->settings->hellob)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	beltHashStepG(K, stack);
-	// K0 <- beltKRP(K, 1^96, 0)
+	// K0 <- beltKRP(K, 1^96, 0), K1 <- beltKRP(K, 1^96, 1)
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, K, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(K, 1^96, 1)
-	if (s->settings->kca || s->settings->kcb)
-	{
-		block0[0] = 1;
-		beltKRPStepG(s->K1, 32, block0, stack);
-	}
+	beltKRPStepGN(s->K[0], 32, block0, 
+		(s->settings->kca || s->settings->kcb) ? 2 : 1, stack);
 	// Ta <- beltMAC(0^128, K1), ...|| out <- Ta
 	if (s->settings->kca)
 	{
 		block0[0] = 0;
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block0, 16, stack);
 		beltMACStepG(out + 2 * no, stack);
 	}
@@ -414,10 +678,12 @@ static size_t bakeBMQVStep3_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(8 * n + 2) +
-		utilMax(9,
+		utilMax(11,
 			f_deep,
+			bakeCertVal_deep(n, f_deep),
 			ecpIsOnA_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
 			zzMul_deep(n / 2, n),
 			zzMod_deep(n + n / 2 + 1, n),
@@ -463,12 +729,9 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 	block1 = block0 + 16;
 	ASSERT(block1 + 16 <= (octet*)stack);
 	// проверить certa
-	code = certa->val((octet*)Qa, s->params, certa->data, certa->len);
+	code = bakeCertVal(Qa, s->ec, s->params, s->resp, certa->val,
+		certa->data, certa->len, stack);
 	ERR_CALL_CHECK(code);
-	if (!qrFrom(ecX(Qa), (octet*)Qa, s->ec->f, stack) ||
-		!qrFrom(ecY(Qa, n), (octet*)Qa + no, s->ec->f, stack) ||
-		!ecpIsOnA(Qa, s->ec, stack))
-		return ERR_BAD_CERT;
 	// Va <- in, Va \in E*?
 	if (!qrFrom(ecX(Va), in, s->ec->f, stack) ||
 		!qrFrom(ecY(Va, n), in + no, s->ec->f, stack) ||
@@ -507,22 +770,17 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 	if (s->settings->hellob)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	beltHashStepG(K, stack);
-	// K0 <- beltKRP(K, 1^96, 0)
+	// K0 <- beltKRP(K, 1^96, 0), K1 <- beltKRP(K, 1^96, 1)
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, K, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(K, 1^96, 1)
-	if (s->settings->kca || s->settings->kcb)
-	{
-		block0[0] = 1;
-		beltKRPStepG(s->K1, 32, block0, stack);
-	}
+	beltKRPStepGN(s->K[0], 32, block0, 
+		(s->settings->kca || s->settings->kcb) ? 2 : 1, stack);
 	// Ta == beltMAC(0^128, K1)?
 	if (s->settings->kca)
 	{
 		block0[0] = 0;
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block0, 16, stack);
 		if (!beltMACStepV(in + 2 * no, stack))
 			return ERR_AUTH;
@@ -530,7 +788,7 @@ err_t bakeBMQVStep4(octet out[], const octet in[], const bake_cert* certa,
 	// Tb <- beltMAC(1^128, K1)?
 	if (s->settings->kcb)
 	{
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block1, 16, stack);
 		beltMACStepG(out, stack);
 	}
@@ -542,8 +800,9 @@ static size_t bakeBMQVStep4_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(6 * n + 2) +
-		utilMax(9,
+		utilMax(10,
 			f_deep,
+			bakeCertVal_deep(n, f_deep),
 			ecpIsOnA_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
@@ -572,7 +831,7 @@ err_t bakeBMQVStep5(const octet in[8], void* state)
 	stack = block1 + 16;
 	// Tb == beltMAC(1^128, K1)?
 	memSet(block1, 0xFF, 16);
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(block1, 16, stack);
 	if (!beltMACStepV(in, stack))
 		return ERR_AUTH;
@@ -594,7 +853,7 @@ err_t bakeBMQVStepG(octet key[32], void* state)
 		!memIsValid(key, 32))
 		return ERR_BAD_INPUT;
 	// key <- K0
-	memCopy(key, s->K0, 32);
+	memCopy(key, s->K[0], 32);
 	// все нормально
 	return ERR_OK;
 }
@@ -733,9 +992,8 @@ typedef struct
 	bign_params params[1];		/*< параметры */
 	bake_settings settings[1];	/*< настройки */
 	bake_cert cert[1];			/*< сертификат */
-	octet K0[32];				/*< ключ K0 */
-	octet K1[32];				/*< ключ K1 */
-	octet K2[32];				/*< ключ K2 */
+	bake_resp_o* resp;			/*< контекст долговременного ключа */
+	octet K[3][32];				/*< ключи K0, K1, K2 */
 	octet data[];				/*< данные */
 } bake_bsts_o;
 
@@ -807,10 +1065,49 @@ err_t bakeBSTSStart(void* state, const bign_params* params,
 		return ERR_BAD_CERT;
 	// сохранить сертификат
 	memCopy(s->cert, cert, sizeof(bake_cert));
+	s->resp = 0;
 	// все нормально
 	return code;
 }
 
+err_t bakeBSTSStart2(void* state, const bake_settings* settings, void* resp)
+{
+	bake_bsts_o* s = (bake_bsts_o*)state;
+	bake_resp_o* r = (bake_resp_o*)resp;
+	size_t n;
+	// проверить входные данные
+	if (!memIsValid(settings, sizeof(bake_settings)) ||
+		settings->kca != TRUE || settings->kcb != TRUE ||
+		!memIsNullOrValid(settings->helloa, settings->helloa_len) ||
+		!memIsNullOrValid(settings->hellob, settings->hellob_len) ||
+		!objIsOperable(r))
+		return ERR_BAD_INPUT;
+	if (settings->rng == 0)
+		return ERR_BAD_RNG;
+	// загрузить параметры
+	objCopy(s->data, r->ec);
+	s->ec = (ec_o*)s->data;
+	n = s->ec->f->n;
+	memCopy(s->params, r->params, sizeof(bign_params));
+	// сохранить настройки
+	memCopy(s->settings, settings, sizeof(bake_settings));
+	// настроить указатели
+	s->d = objEnd(s->ec, word);
+	s->u = s->d + n;
+	s->t = s->u;
+	s->Vb = s->u + n;
+	// настроить заголовок
+	s->hdr.keep = sizeof(bake_bsts_o) + objKeep(s->ec) + O_OF_W(4 * n);
+	s->hdr.p_count = 5;
+	s->hdr.o_count = 1;
+	// загрузить личный ключ и сертификат
+	wwCopy(s->d, r->d, n);
+	memCopy(s->cert, r->cert, sizeof(bake_cert));
+	s->resp = r;
+	// все нормально
+	return ERR_OK;
+}
+
 static size_t bakeBSTSStart_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
@@ -838,7 +1135,10 @@ err_t bakeBSTSStep2(octet out[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Vb <- ub G
-	if (!ecMulA(s->Vb, s->ec->base, s->ec, s->u, n, stack))
+	if (s->resp ?
+		!ecMulSCombA(s->Vb, s->resp->pre, s->ec, BAKE_RESP_W, s->u, n,
+			stack) :
+		!ecMulA(s->Vb, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	// out <- <Vb>
 	qrTo(out, ecX(s->Vb), s->ec->f, stack);
@@ -850,9 +1150,10 @@ err_t bakeBSTSStep2(octet out[], void* state)
 static size_t bakeBSTSStep2_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return utilMax(2,
+	return utilMax(3,
 			f_deep,
-			ecMulA_deep(n, ec_d, ec_deep, n));
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, n));
 }
 
 err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
@@ -893,7 +1194,9 @@ err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
 		s->settings->rng_state))
 		return ERR_BAD_RNG;
 	// Va <- ua G
-	if (!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
+	if (s->resp ?
+		!ecMulSCombA(Va, s->resp->pre, s->ec, BAKE_RESP_W, s->u, n, stack) :
+		!ecMulA(Va, s->ec->base, s->ec, s->u, n, stack))
 		return ERR_BAD_PARAMS;
 	qrTo((octet*)Va, ecX(Va), s->ec->f, stack);
 	qrTo((octet*)Va + no, ecY(Va, n), s->ec->f, stack);
@@ -924,23 +1227,17 @@ err_t bakeBSTSStep3(octet out[], const octet in[], void* state)
 	if (s->settings->hellob)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	beltHashStepG(K, stack);
-	// K0 <- beltKRP(K, 1^96, 0)
+	// K0, K1, K2 <- beltKRP(K, 1^96, 0), beltKRP(K, 1^96, 1), ...
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, K, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(K, 1^96, 1)
-	block0[0] = 1;
-	beltKRPStepG(s->K1, 32, block0, stack);
-	// K2 <- beltKRP(K, 1^96, 2)
-	block0[0] = 2;
-	beltKRPStepG(s->K2, 32, block0, stack);
+	beltKRPStepGN(s->K[0], 32, block0, 3, stack);
 	// ..|| out ||.. <- beltCFBEncr(sa || certa)
 	block0[0] = 0;
-	beltCFBStart(stack, s->K2, 32, block0);
+	beltCFBStart(stack, s->K[2], 32, block0);
 	beltCFBStepE(out + 2 * no, no + s->cert->len, stack);
 	// ..|| out <- beltMAC(beltCFBEncr(sa || certa) || 0^128)
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(out + 2 * no, no + s->cert->len, stack);
 	beltMACStepA(block0, 16, stack);
 	beltMACStepG(out + 3 * no + s->cert->len, stack);
@@ -955,10 +1252,11 @@ static size_t bakeBSTSStep3_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(4 * n + 2) + 32 +
-		utilMax(9,
+		utilMax(10,
 			f_deep,
 			ecpIsOnA_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
 			zzMul_deep(n / 2, n),
 			zzMod_deep(n + n / 2 + 1, n),
@@ -1018,20 +1316,14 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 	if (s->settings->hellob)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	beltHashStepG(K, stack);
-	// K0 <- beltKRP(K, 1^96, 0)
+	// K0, K1, K2 <- beltKRP(K, 1^96, 0), beltKRP(K, 1^96, 1), ...
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, K, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(K, 1^96, 1)
-	block0[0] = 1;
-	beltKRPStepG(s->K1, 32, block0, stack);
-	// K2 <- beltKRP(K, 1^96, 2)
-	block0[0] = 2;
-	beltKRPStepG(s->K2, 32, block0, stack);
+	beltKRPStepGN(s->K[0], 32, block0, 3, stack);
 	// Ta == beltMAC(Ya || 0^128, K1)?
 	block0[0] = 0;
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(in + 2 * no, in_len - 2 * no - 8, stack);
 	beltMACStepA(block0, 16, stack);
 	if (!beltMACStepV(in + in_len - 8, stack))
@@ -1044,7 +1336,7 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 		if ((Ya = blobCreate(in_len)) == 0)
 			return ERR_OUTOFMEMORY;
 		memCopy(Ya, in + 2 * no, in_len);
-		beltCFBStart(stack, s->K2, 32, block0);
+		beltCFBStart(stack, s->K[2], 32, block0);
 		beltCFBStepD(Ya, in_len, stack);
 		// sa \in {0, 1,..., q - 1}?
 		wwFrom(sa, Ya, no);
@@ -1054,12 +1346,8 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 			return ERR_AUTH;
 		}
 		// проверить certa
-		code = vala((octet*)Qa, s->params, (octet*)Ya + no, in_len - no);
-		ERR_CALL_HANDLE(code, blobClose(Ya));
-		if (!qrFrom(ecX(Qa), (octet*)Qa, s->ec->f, stack) ||
-			!qrFrom(ecY(Qa, n), (octet*)Qa + no, s->ec->f, stack) ||
-			!ecpIsOnA(Qa, s->ec, stack))
-			code = ERR_BAD_CERT;
+		code = bakeCertVal(Qa, s->ec, s->params, s->resp, vala,
+			(octet*)Ya + no, in_len - no, stack);
 		blobClose(Ya);
 		ERR_CALL_CHECK(code);
 	}
@@ -1084,10 +1372,10 @@ err_t bakeBSTSStep4(octet out[], const octet in[], size_t in_len,
 	// out ||.. <- beltCFBEncr(sb || certb)
 	wwTo(out, no, sb);
 	memCopy(out + no, s->cert->data, s->cert->len);
-	beltCFBStart(stack, s->K2, 32, block1);
+	beltCFBStart(stack, s->K[2], 32, block1);
 	beltCFBStepE(out, no + s->cert->len, stack);
 	// .. || out <- beltMAC(beltCFBEncr(sb || certb) || 1^128)
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(out, no + s->cert->len, stack);
 	beltMACStepA(block1, 16, stack);
 	beltMACStepG(out + no + s->cert->len, stack);
@@ -1099,8 +1387,9 @@ static size_t bakeBSTSStep4_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(6 * n + 2) + 32 +
-		utilMax(10,
+		utilMax(11,
 			f_deep,
+			bakeCertVal_deep(n, f_deep),
 			ecpIsOnA_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n),
 			beltHash_keep(),
@@ -1138,7 +1427,7 @@ err_t bakeBSTSStep5(const octet in[], size_t in_len, bake_certval_i valb,
 	block1 = (octet*)Qb;
 	// Tb == beltMAC(Yb || 1^128, K1)?
 	memSet(block1, 0xFF, 16);
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(in, in_len - 8, stack);
 	beltMACStepA(block1, 16, stack);
 	if (!beltMACStepV(in + in_len - 8, stack))
@@ -1151,7 +1440,7 @@ err_t bakeBSTSStep5(const octet in[], size_t in_len, bake_certval_i valb,
 		if ((Yb = blobCreate(in_len)) == 0)
 			return ERR_OUTOFMEMORY;
 		memCopy(Yb, in, in_len);
-		beltCFBStart(stack, s->K2, 32, block1);
+		beltCFBStart(stack, s->K[2], 32, block1);
 		beltCFBStepD(Yb, in_len, stack);
 		// sb \in {0, 1,..., q - 1}?
 		wwFrom(sb, Yb, no);
@@ -1200,7 +1489,7 @@ err_t bakeBSTSStepG(octet key[32], void* state)
 		!memIsValid(key, 32))
 		return ERR_BAD_INPUT;
 	// key <- K0
-	memCopy(key, s->K0, 32);
+	memCopy(key, s->K[0], 32);
 	// все нормально
 	return ERR_OK;
 }
@@ -1415,9 +1704,7 @@ typedef struct
 	word* u;					/*< [ec->f->n] ua или ub */
 // }
 	bake_settings settings[1];	/*< настройки */
-	octet K0[32];				/*< ключ K0 */
-	octet K1[32];				/*< ключ K1 */
-	octet K2[32];				/*< ключ K2 */
+	octet K[3][32];				/*< ключи K0, K1, K2 */
 	octet data[];				/*< данные */
 } bake_bpace_o;
 
@@ -1467,7 +1754,7 @@ err_t bakeBPACEStart(void* state, const bign_params* params,
 	// K2 <- beltHash(pwd)
 	beltHashStart(objEnd(s, void));
 	beltHashStepH(pwd, pwd_len, objEnd(s, void));
-	beltHashStepG(s->K2, objEnd(s, void));
+	beltHashStepG(s->K[2], objEnd(s, void));
 	// все нормально
 	return code;
 }
@@ -1496,7 +1783,7 @@ err_t bakeBPACEStep2(octet out[], void* state)
 	s->settings->rng(out, no / 2, s->settings->rng_state);
 	memCopy(s->R + no / 2, out, no / 2);
 	// out <- beltECB(Rb, K2)
-	beltECBStart(stack, s->K2, 32);
+	beltECBStart(stack, s->K[2], 32);
 	beltECBStepE(out, no / 2, stack);
 	// все нормально
 	return ERR_OK;
@@ -1528,13 +1815,13 @@ err_t bakeBPACEStep3(octet out[], const octet in[], void* state)
 	stack = Va + 2 * n;
 	// Rb <- beltECBDecr(Yb, K2)
 	memCopy(s->R + no / 2, in, no / 2);
-	beltECBStart(stack, s->K2, 32);
+	beltECBStart(stack, s->K[2], 32);
 	beltECBStepD(s->R + no / 2, no / 2, stack);
 	// Ra <-R {0, 1}^l
 	s->settings->rng(out, no / 2, s->settings->rng_state);
 	memCopy(s->R, out, no / 2);
 	// out ||... <- beltECBEncr(Ra, K2)
-	beltECBStart(stack, s->K2, 32);
+	beltECBStart(stack, s->K[2], 32);
 	beltECBStepE(out, no / 2, stack);
 	// W <- bakeSWU(Ra || Rb)
 	bakeSWU2(s->W, s->ec, s->R, stack);
@@ -1601,7 +1888,7 @@ err_t bakeBPACEStep4(octet out[], const octet in[], void* state)
 		return ERR_BAD_POINT;
 	// Ra <- beltECBDecr(in ||..., K2)
 	memCopy(s->R, in, no / 2);
-	beltECBStart(stack, s->K2, 32);
+	beltECBStart(stack, s->K[2], 32);
 	beltECBStepD(s->R, no / 2, stack);
 	// W <- bakeSWU(Ra || Rb)
 	bakeSWU2(s->W, s->ec, s->R, stack);
@@ -1631,21 +1918,16 @@ err_t bakeBPACEStep4(octet out[], const octet in[], void* state)
 	// out ||... <- <Vb>
 	memCopy(out, ecX(Vb), no);
 	memCopy(out + no, ecY(Vb, n), no);
-	// K0 <- beltKRP(Y, 1^96, 0)
+	// K0 <- beltKRP(Y, 1^96, 0), K1 <- beltKRP(Y, 1^96, 1)
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, Y, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(Y, 1^96, 1)
-	if (s->settings->kca || s->settings->kcb)
-	{
-		block0[0] = 1;
-		beltKRPStepG(s->K1, 32, block0, stack);
-	}
+	beltKRPStepGN(s->K[0], 32, block0, 
+		(s->settings->kca || s->settings->kcb) ? 2 : 1, stack);
 	// Tb <- beltMAC(1^128, K1), ...|| out <- Tb
 	if (s->settings->kcb)
 	{
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block1, 16, stack);
 		beltMACStepG(out + 2 * no, stack);
 	}
@@ -1715,21 +1997,16 @@ err_t bakeBPACEStep5(octet out[], const octet in[], void* state)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	ASSERT(no >= 32);
 	beltHashStepG(Y, stack);
-	// K0 <- beltKRP(Y, 1^96, 0)
+	// K0 <- beltKRP(Y, 1^96, 0), K1 <- beltKRP(Y, 1^96, 1)
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, Y, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	// K1 <- beltKRP(Y, 1^96, 1)
-	if (s->settings->kca || s->settings->kcb)
-	{
-		block0[0] = 1;
-		beltKRPStepG(s->K1, 32, block0, stack);
-	}
+	beltKRPStepGN(s->K[0], 32, block0, 
+		(s->settings->kca || s->settings->kcb) ? 2 : 1, stack);
 	// Tb == beltMAC(1^128, K1)?
 	if (s->settings->kcb)
 	{
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block1, 16, stack);
 		if (!beltMACStepV(in + 2 * no, stack))
 			return ERR_AUTH;
@@ -1738,7 +2015,7 @@ err_t bakeBPACEStep5(octet out[], const octet in[], void* state)
 	if (s->settings->kca)
 	{
 		block0[0] = 0;
-		beltMACStart(stack, s->K1, 32);
+		beltMACStart(stack, s->K[1], 32);
 		beltMACStepA(block0, 16, stack);
 		beltMACStepG(out, stack);
 	}
@@ -1776,7 +2053,7 @@ err_t bakeBPACEStep6(const octet in[8], void* state)
 	stack = block0 + 16;
 	// Ta == beltMAC(0^128, K1)?
 	memSetZero(block0, 16);
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(block0, 16, stack);
 	if (!beltMACStepV(in, stack))
 		return ERR_AUTH;
@@ -1798,7 +2075,7 @@ err_t bakeBPACEStepG(octet key[32], void* state)
 		!memIsValid(key, 32))
 		return ERR_BAD_INPUT;
 	// key <- K0
-	memCopy(key, s->K0, 32);
+	memCopy(key, s->K[0], 32);
 	// все нормально
 	return ERR_OK;
 }
@@ -1923,3 +2200,278 @@ err_t bakeBPACERunA(octet key[32], const bign_params* params,
 	blobClose(blob);
 	return code;
 }
+
+/*
+*******************************************************************************
+Многосеансовый сервер
+
+Состояние сервера (bake_srv_st) содержит пул из count ячеек одинаковой 
+длины slot_keep. Ячейка начинается с заголовка типа bake_srv_slot, за 
+которым следует состояние протокола BMQV или BPACE (сторона B). Ячейки 
+размещаются при инициализации сервера и не перемещаются, поэтому 
+внутренние указатели состояний протоколов остаются корректными.
+
+Свободные ячейки связаны в список через поле next. Занятие и освобождение 
+ячейки выполняются за постоянное время. При освобождении ячейка очищается.
+
+Поле step ячейки содержит номер шага, который будет выполнен при получении 
+очередного сообщения от стороны A. Нулевое значение step означает, что 
+протокол завершен и можно извлекать общий ключ.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t next;				/*< следующая свободная ячейка */
+	u32 proto;					/*< протокол (0, если ячейка свободна) */
+	u32 step;					/*< ожидаемый шаг */
+} bake_srv_slot;
+
+typedef struct
+{
+	size_t l;					/*< уровень стойкости */
+	size_t count;				/*< число ячеек */
+	size_t slot_keep;			/*< длина ячейки */
+	size_t free;				/*< первая свободная ячейка */
+	size_t active;				/*< число занятых ячеек */
+	word data[];				/*< ячейки */
+} bake_srv_st;
+
+static size_t bakeSrvSlot_keep(size_t l)
+{
+	const size_t keep = sizeof(bake_srv_slot) + 
+		utilMax(2, bakeBMQV_keep(l), bakeBPACE_keep(l));
+	return O_OF_W(W_OF_O(keep));
+}
+
+#define bakeSrvSlot(s, sid)\
+	((bake_srv_slot*)((octet*)(s)->data + (sid) * (s)->slot_keep))
+
+#define bakeSrvSlotState(slot)\
+	((void*)((octet*)(slot) + O_OF_W(W_OF_O(sizeof(bake_srv_slot)))))
+
+size_t bakeSrv_keep(size_t l, size_t count)
+{
+	ASSERT(l == 128 || l == 192 || l == 256);
+	return sizeof(bake_srv_st) + count * bakeSrvSlot_keep(l);
+}
+
+err_t bakeSrvStart(void* state, size_t l, size_t count)
+{
+	bake_srv_st* s = (bake_srv_st*)state;
+	size_t sid;
+	// проверить входные данные
+	if (l != 128 && l != 192 && l != 256)
+		return ERR_BAD_PARAMS;
+	if (count == 0 || 
+		!memIsValid(state, bakeSrv_keep(l, count)))
+		return ERR_BAD_INPUT;
+	// настроить пул
+	s->l = l;
+	s->count = count;
+	s->slot_keep = bakeSrvSlot_keep(l);
+	s->free = 0;
+	s->active = 0;
+	for (sid = 0; sid < count; ++sid)
+	{
+		bake_srv_slot* slot = bakeSrvSlot(s, sid);
+		slot->next = sid + 1;
+		slot->proto = slot->step = 0;
+	}
+	// все нормально
+	return ERR_OK;
+}
+
+static bake_srv_slot* bakeSrvAlloc(size_t* sid, bake_srv_st* s)
+{
+	bake_srv_slot* slot;
+	if (s->free >= s->count)
+		return 0;
+	*sid = s->free;
+	slot = bakeSrvSlot(s, *sid);
+	ASSERT(slot->proto == 0);
+	s->free = slot->next;
+	++s->active;
+	return slot;
+}
+
+void bakeSrvClose(size_t sid, void* state)
+{
+	bake_srv_st* s = (bake_srv_st*)state;
+	bake_srv_slot* slot;
+	ASSERT(memIsValid(s, sizeof(bake_srv_st)));
+	if (sid >= s->count)
+		return;
+	slot = bakeSrvSlot(s, sid);
+	if (slot->proto == 0)
+		return;
+	memWipe(slot, s->slot_keep);
+	// memWipe() не обязательно обнуляет ячейку
+	slot->proto = slot->step = 0;
+	slot->next = s->free;
+	s->free = sid;
+	--s->active;
+}
+
+size_t bakeSrvActive(const void* state)
+{
+	const bake_srv_st* s = (const bake_srv_st*)state;
+	ASSERT(memIsValid(s, sizeof(bake_srv_st)));
+	return s->active;
+}
+
+err_t bakeSrvOpenBMQV(size_t* sid, octet out[], void* state,
+	const bign_params* params, const bake_settings* settings, 
+	const octet privkeyb[], const bake_cert* certb)
+{
+	err_t code;
+	bake_srv_st* s = (bake_srv_st*)state;
+	bake_srv_slot* slot;
+	// проверить входные данные
+	if (!memIsValid(s, sizeof(bake_srv_st)) ||
+		!memIsValid(sid, sizeof(size_t)) ||
+		!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != s->l)
+		return ERR_BAD_PARAMS;
+	// занять ячейку
+	if (!(slot = bakeSrvAlloc(sid, s)))
+		return ERR_OUTOFMEMORY;
+	slot->proto = BAKE_SRV_BMQV;
+	// старт и шаг 2
+	code = bakeBMQVStart(bakeSrvSlotState(slot), params, settings, 
+		privkeyb, certb);
+	if (code == ERR_OK)
+		code = bakeBMQVStep2(out, bakeSrvSlotState(slot));
+	ERR_CALL_HANDLE(code, bakeSrvClose(*sid, state));
+	slot->step = 4;
+	return ERR_OK;
+}
+
+err_t bakeSrvOpenBPACE(size_t* sid, octet out[], void* state,
+	const bign_params* params, const bake_settings* settings, 
+	const octet pwd[], size_t pwd_len)
+{
+	err_t code;
+	bake_srv_st* s = (bake_srv_st*)state;
+	bake_srv_slot* slot;
+	// проверить входные данные
+	if (!memIsValid(s, sizeof(bake_srv_st)) ||
+		!memIsValid(sid, sizeof(size_t)) ||
+		!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != s->l)
+		return ERR_BAD_PARAMS;
+	// занять ячейку
+	if (!(slot = bakeSrvAlloc(sid, s)))
+		return ERR_OUTOFMEMORY;
+	slot->proto = BAKE_SRV_BPACE;
+	// старт и шаг 2
+	code = bakeBPACEStart(bakeSrvSlotState(slot), params, settings, 
+		pwd, pwd_len);
+	if (code == ERR_OK)
+		code = bakeBPACEStep2(out, bakeSrvSlotState(slot));
+	ERR_CALL_HANDLE(code, bakeSrvClose(*sid, state));
+	slot->step = 4;
+	return ERR_OK;
+}
+
+err_t bakeSrvStep(octet out[], size_t* out_len, size_t sid, 
+	const octet in[], size_t in_len, const bake_cert* certa, void* state)
+{
+	err_t code;
+	bake_srv_st* s = (bake_srv_st*)state;
+	bake_srv_slot* slot;
+	bake_settings* settings;
+	size_t no;
+	// проверить входные данные
+	if (!memIsValid(s, sizeof(bake_srv_st)) ||
+		!memIsValid(out_len, sizeof(size_t)) ||
+		sid >= s->count)
+		return ERR_BAD_INPUT;
+	no = s->l / 4;
+	slot = bakeSrvSlot(s, sid);
+	if (slot->proto == 0)
+		return ERR_BAD_INPUT;
+	if (slot->step == 0)
+		return ERR_BAD_LOGIC;
+	// BMQV: шаг 4
+	if (slot->proto == BAKE_SRV_BMQV)
+	{
+		bake_bmqv_o* st = (bake_bmqv_o*)bakeSrvSlotState(slot);
+		settings = st->settings;
+		if (in_len != 2 * no + (settings->kca ? 8u : 0))
+			code = ERR_BAD_INPUT;
+		else
+			code = bakeBMQVStep4(out, in, certa, st);
+		*out_len = settings->kcb ? 8u : 0;
+		slot->step = 0;
+	}
+	// BPACE: шаг 4
+	else if (slot->step == 4)
+	{
+		bake_bpace_o* st = (bake_bpace_o*)bakeSrvSlotState(slot);
+		ASSERT(slot->proto == BAKE_SRV_BPACE);
+		settings = st->settings;
+		if (in_len != 5 * no / 2)
+			code = ERR_BAD_INPUT;
+		else
+			code = bakeBPACEStep4(out, in, st);
+		*out_len = 2 * no + (settings->kcb ? 8u : 0);
+		slot->step = settings->kca ? 6 : 0;
+	}
+	// BPACE: шаг 6
+	else
+	{
+		ASSERT(slot->proto == BAKE_SRV_BPACE && slot->step == 6);
+		if (in_len != 8)
+			code = ERR_BAD_INPUT;
+		else
+			code = bakeBPACEStep6(in, bakeSrvSlotState(slot));
+		*out_len = 0;
+		slot->step = 0;
+	}
+	// при ошибке закрыть сеанс
+	if (code != ERR_OK)
+		*out_len = 0, bakeSrvClose(sid, state);
+	return code;
+}
+
+void bakeSrvStepBatch(bake_srv_event ev[], size_t count, void* state)
+{
+	ASSERT(memIsValid(state, sizeof(bake_srv_st)));
+	ASSERT(memIsValid(ev, count * sizeof(bake_srv_event)));
+	for (; count--; ++ev)
+		ev->code = bakeSrvStep(ev->out, &ev->out_len, ev->sid, ev->in, 
+			ev->in_len, ev->certa, state);
+}
+
+bool_t bakeSrvIsDone(size_t sid, const void* state)
+{
+	const bake_srv_st* s = (const bake_srv_st*)state;
+	const bake_srv_slot* slot;
+	ASSERT(memIsValid(s, sizeof(bake_srv_st)));
+	if (sid >= s->count)
+		return FALSE;
+	slot = (const bake_srv_slot*)((const octet*)s->data + sid * s->slot_keep);
+	return slot->proto != 0 && slot->step == 0;
+}
+
+err_t bakeSrvStepG(octet key[32], size_t sid, void* state)
+{
+	bake_srv_st* s = (bake_srv_st*)state;
+	bake_srv_slot* slot;
+	// проверить входные данные
+	if (!memIsValid(s, sizeof(bake_srv_st)) ||
+		sid >= s->count)
+		return ERR_BAD_INPUT;
+	slot = bakeSrvSlot(s, sid);
+	if (slot->proto == 0)
+		return ERR_BAD_INPUT;
+	if (slot->step != 0)
+		return ERR_BAD_LOGIC;
+	// извлечь ключ
+	if (slot->proto == BAKE_SRV_BMQV)
+		return bakeBMQVStepG(key, bakeSrvSlotState(slot));
+	return bakeBPACEStepG(key, bakeSrvSlotState(slot));
+}
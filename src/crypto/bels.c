@@ -4,7 +4,7 @@
 \brief STB 34.101.60 (bels): secret sharing algorithms
 \project bee2 [cryptographic library]
 \created 2013.05.14
-\version 2021.04.15
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -672,3 +672,329 @@ err_t belsRecover2(octet s[], size_t count, size_t len, const octet si[])
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Контекст
+
+Контекст строится для общего открытого ключа m0 и фиксированного набора 
+открытых ключей пользователей m1, m2,..., m_count. Через fi(x) = x^l + mi(x) 
+обозначаются многочлены, которые соответствуют ключам, через G(x) -- 
+произведение f1(x) f2(x)... f_count(x), через Gi(x) -- G(x) / fi(x).
+
+Умножение по модулю fi(x) выполняется с приведением по Барретту: 
+в контексте хранятся младшие коэффициенты многочленов 
+	mui(x) = x^{2l} \div fi(x) = x^l + mui'(x),
+и частное от деления произведения c(x) = ch(x) x^l + cl(x) на fi(x) 
+определяется как ch(x) + (ch(x) mui'(x)) \div x^l. Поскольку x^l \equiv mi(x) 
+\mod fi(x), остаток от деления c(x) на fi(x) равняется cl(x) + (q(x) mi(x)) 
+\mod x^l, где q(x) -- частное. Таким образом, умножение по модулю сводится 
+к трем умножениям многочленов из n слов (без делений).
+
+При разделении секрета многочлен c(x) = (x^l + m0(x))k(x) + s(x) (см. 
+belsShare()) приводится по модулю fi(x) следующим образом:
+	si(x) = s(x) + (\sum_j kj(x) qij(x)) \mod fi(x),
+где kj(x) -- j-й блок k(x) из l коэффициентов, 
+	qij(x) = (x^l + m0(x)) x^{jl} \mod fi(x), j = 0, 1,..., count - 2.
+Многочлены qij(x) рассчитываются при запуске контекста (qi0(x) = 
+m0(x) + mi(x), qij(x) = qi(j-1)(x) mi(x) \mod fi(x)). Сумма произведений 
+накапливается без приведения, приведение по модулю fi(x) выполняется 
+однократно.
+
+При восстановлении секрета используется китайская теорема об остатках:
+	s(x) = \sum_i ((si(x) ai(x)) \mod fi(x)) bi(x) \mod f0(x),
+где 
+	ai(x) = Gi(x)^{-1} \mod fi(x) = \prod_{j != i} (mj(x) + mi(x))^{-1}, 
+	bi(x) = Gi(x) \mod f0(x) = \prod_{j != i} (mj(x) + m0(x)).
+Действительно, многочлен c(x) = \sum_i ((si(x) ai(x)) \mod fi(x)) Gi(x) 
+имеет степень меньше deg G(x) и c(x) \equiv si(x) \mod fi(x). Значит, c(x)
+совпадает с многочленом, который восстанавливается в belsRecover() до 
+финального приведения по модулю f0(x).
+
+Многочлены ai(x) и bi(x) рассчитываются при запуске контекста, 
+восстановление выполняется без алгоритма Евклида и без деления 
+многочленов большой длины.
+
+Раскладка data (по n слов на каждый многочлен):
+	m0, m1,..., m_count, mu0', mu1',..., mu_count', 
+	a1,..., a_count, b1,..., b_count, 
+	q10,..., q1(count-2),..., q_count0,..., q_count(count-2).
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t len;					/*< длина ключей и секретов в октетах */
+	size_t count;				/*< число пользователей */
+	word data[];				/*< многочлены */
+} bels_ctx_st;
+
+#define belsCtxM(ctx, i) ((ctx)->data + (i) * W_OF_O((ctx)->len))
+#define belsCtxMu(ctx, i) belsCtxM(ctx, (ctx)->count + 1 + (i))
+#define belsCtxA(ctx, i) belsCtxMu(ctx, (ctx)->count + (i))
+#define belsCtxB(ctx, i) belsCtxA(ctx, (ctx)->count + (i))
+#define belsCtxQ(ctx, i, j)\
+	belsCtxB(ctx, (ctx)->count + 1 + ((i) - 1) * ((ctx)->count - 1) + (j))
+
+size_t belsCtx_keep(size_t count, size_t len)
+{
+	ASSERT(len == 16 || len == 24 || len == 32);
+	return sizeof(bels_ctx_st) + 
+		O_OF_W((count * count + 3 * count + 2) * W_OF_O(len));
+}
+
+/*	[n]c <- [2n]c mod (x^l + [n]m) */
+static void belsRed(word c[], const word m[], const word mu[], size_t n,
+	void* stack)
+{
+	word* t = (word*)stack;
+	stack = t + 2 * n;
+	// q <- ch + (ch mu') div x^l
+	ppMul(t, c + n, n, mu, n, stack);
+	wwXor2(c + n, t + n, n);
+	// c <- cl + (q m) mod x^l
+	ppMul(t, c + n, n, m, n, stack);
+	wwXor2(c, t, n);
+}
+
+static size_t belsRed_deep(size_t n)
+{
+	return O_OF_W(2 * n) + ppMul_deep(n, n);
+}
+
+/*	[n]c <- [n]a * [n]b mod (x^l + [n]m) */
+static void belsMulMod(word c[], const word a[], const word b[], 
+	const word m[], const word mu[], size_t n, void* stack)
+{
+	word* prod = (word*)stack;
+	stack = prod + 2 * n;
+	ppMul(prod, a, n, b, n, stack);
+	belsRed(prod, m, mu, n, stack);
+	wwCopy(c, prod, n);
+}
+
+static size_t belsMulMod_deep(size_t n)
+{
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			ppMul_deep(n, n),
+			belsRed_deep(n));
+}
+
+static size_t belsCtxStart_deep(size_t n)
+{
+	return O_OF_W(5 * n + 3) + 
+		utilMax(4,
+			ppDiv_deep(2 * n + 1, n + 1),
+			ppIsIrred_deep(n + 1),
+			belsMulMod_deep(n),
+			ppInvMod_deep(n + 1));
+}
+
+err_t belsCtxStart(void* ctx, size_t count, size_t len, const octet m0[],
+	const octet mi[])
+{
+	bels_ctx_st* c = (bels_ctx_st*)ctx;
+	size_t n, i, j;
+	void* state;
+	word* f;
+	word* q;
+	word* r;
+	word* t;
+	void* stack;
+	// проверить входные данные
+	if ((len != 16 && len != 24 && len != 32) || count == 0 ||
+		!memIsValid(m0, len) || !memIsValid(mi, len * count) ||
+		!memIsValid(ctx, belsCtx_keep(count, len)))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	n = W_OF_O(len);
+	state = blobCreate(belsCtxStart_deep(n));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	f = (word*)state;
+	q = f + n + 1;
+	r = q + n + 1;
+	t = r + 2 * n + 1;
+	stack = t + n;
+	// загрузить ключи
+	c->len = len, c->count = count;
+	for (i = 0; i <= count; ++i)
+	{
+		word* m = belsCtxM(c, i);
+		wwFrom(m, i == 0 ? m0 : mi + (i - 1) * len, len);
+		// mi(x) == m0(x)?
+		if (i > 0 && wwEq(m, belsCtxM(c, 0), n))
+		{
+			blobClose(state);
+			return ERR_BAD_PUBKEY;
+		}
+		// f(x) <- x^l + mi(x) неприводим?
+		wwCopy(f, m, n), f[n] = 1;
+		if (!ppIsIrred(f, n + 1, stack))
+		{
+			blobClose(state);
+			return ERR_BAD_PUBKEY;
+		}
+		// mui'(x) <- (x^{2l} \div f(x)) mod x^l
+		wwSetZero(r, 2 * n + 1), r[2 * n] = 1;
+		ppDiv(q, r, r, 2 * n + 1, f, n + 1, stack);
+		ASSERT(q[n] == 1);
+		wwCopy(belsCtxMu(c, i), q, n);
+	}
+	// ai(x), bi(x)
+	for (i = 1; i <= count; ++i)
+	{
+		word* a = belsCtxA(c, i);
+		word* b = belsCtxB(c, i);
+		wwSetW(a, n, 1);
+		wwSetW(b, n, 1);
+		for (j = 1; j <= count; ++j)
+		{
+			if (j == i)
+				continue;
+			// a <- a (mj + mi) mod fi
+			wwXor(t, belsCtxM(c, j), belsCtxM(c, i), n);
+			belsMulMod(a, a, t, belsCtxM(c, i), belsCtxMu(c, i), n, stack);
+			// b <- b (mj + m0) mod f0
+			wwXor(t, belsCtxM(c, j), belsCtxM(c, 0), n);
+			belsMulMod(b, b, t, belsCtxM(c, 0), belsCtxMu(c, 0), n, stack);
+		}
+		// qij <- (m0 + mi) mi^j mod fi
+		if (count > 1)
+			wwXor(belsCtxQ(c, i, 0), belsCtxM(c, 0), belsCtxM(c, i), n);
+		for (j = 1; j + 1 < count; ++j)
+			belsMulMod(belsCtxQ(c, i, j), belsCtxQ(c, i, j - 1), 
+				belsCtxM(c, i), belsCtxM(c, i), belsCtxMu(c, i), n, stack);
+		// a <- a^{-1} mod fi
+		wwCopy(f, belsCtxM(c, i), n), f[n] = 1;
+		wwCopy(q, a, n), q[n] = 0;
+		ppInvMod(r, q, f, n + 1, stack);
+		// совпадающие ключи?
+		if (wwIsZero(r, n + 1))
+		{
+			blobClose(state);
+			return ERR_BAD_PUBKEY;
+		}
+		ASSERT(r[n] == 0);
+		wwCopy(a, r, n);
+	}
+	// завершение
+	blobClose(state);
+	return ERR_OK;
+}
+
+err_t belsCtxShare(octet si[], size_t num, size_t threshold, 
+	const octet s[], gen_i rng, void* rng_state, const void* ctx)
+{
+	const bels_ctx_st* c = (const bels_ctx_st*)ctx;
+	size_t n, len, i, j, b;
+	void* state;
+	word* k;
+	word* acc;
+	word* t;
+	void* stack;
+	// проверить генератор
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// проверить входные данные
+	if (!memIsValid(c, sizeof(bels_ctx_st)) ||
+		!memIsValid(c, belsCtx_keep(c->count, c->len)))
+		return ERR_BAD_INPUT;
+	len = c->len, n = W_OF_O(len);
+	if (threshold == 0 || c->count < threshold ||
+		!memIsValid(s, num * len) || 
+		!memIsValid(si, num * c->count * len))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(O_OF_W(threshold * n + 3 * n) +
+		utilMax(2,
+			ppMul_deep(n, n),
+			belsRed_deep(n)));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	k = (word*)state;
+	acc = k + threshold * n - n;
+	t = acc + 2 * n;
+	stack = t + 2 * n;
+	// цикл по секретам
+	for (j = 0; j < num; ++j, s += len)
+	{
+		// сгенерировать k
+		rng(k, threshold * len - len, rng_state);
+		wwFrom(k, k, threshold * len - len);
+		// цикл по пользователям
+		for (i = 1; i <= c->count; ++i, si += len)
+		{
+			// acc(x) <- \sum_b kb(x) qib(x)
+			wwSetZero(acc, 2 * n);
+			for (b = 0; b + 1 < threshold; ++b)
+			{
+				ppMul(t, k + b * n, n, belsCtxQ(c, i, b), n, stack);
+				wwXor2(acc, t, 2 * n);
+			}
+			// si(x) <- s(x) + acc(x) mod fi(x)
+			belsRed(acc, belsCtxM(c, i), belsCtxMu(c, i), n, stack);
+			wwFrom(t, s, len);
+			wwXor2(acc, t, n);
+			wwTo(si, len, acc);
+		}
+	}
+	// завершение
+	blobClose(state);
+	return ERR_OK;
+}
+
+err_t belsCtxRecover(octet s[], size_t num, const octet si[], 
+	const void* ctx)
+{
+	const bels_ctx_st* c = (const bels_ctx_st*)ctx;
+	size_t n, len, i, j;
+	void* state;
+	word* u;
+	word* acc;
+	word* t;
+	void* stack;
+	// проверить входные данные
+	if (!memIsValid(c, sizeof(bels_ctx_st)) ||
+		!memIsValid(c, belsCtx_keep(c->count, c->len)))
+		return ERR_BAD_INPUT;
+	len = c->len, n = W_OF_O(len);
+	if (!memIsValid(si, num * c->count * len) || !memIsValid(s, num * len))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(O_OF_W(5 * n) + 
+		utilMax(3,
+			ppMul_deep(n, n),
+			belsMulMod_deep(n),
+			belsRed_deep(n)));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	u = (word*)state;
+	acc = u + n;
+	t = acc + 2 * n;
+	stack = t + 2 * n;
+	// цикл по секретам
+	for (j = 0; j < num; ++j, s += len)
+	{
+		// acc(x) <- \sum_i ((si(x) ai(x)) mod fi(x)) bi(x)
+		wwSetZero(acc, 2 * n);
+		for (i = 1; i <= c->count; ++i, si += len)
+		{
+			wwFrom(u, si, len);
+			belsMulMod(u, u, belsCtxA(c, i), belsCtxM(c, i), 
+				belsCtxMu(c, i), n, stack);
+			ppMul(t, u, n, belsCtxB(c, i), n, stack);
+			wwXor2(acc, t, 2 * n);
+		}
+		// s(x) <- acc(x) mod f0(x)
+		belsRed(acc, belsCtxM(c, 0), belsCtxMu(c, 0), n, stack);
+		wwTo(s, len, acc);
+	}
+	// завершение
+	blobClose(state);
+	return ERR_OK;
+}
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): BDE (Blockwise Disk Encryption)
 \project bee2 [cryptographic library]
 \created 2018.06.28
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -28,6 +28,7 @@ typedef struct
 	u32 key[8];			/*< форматированный ключ */
 	u32 s[4];			/*< переменная s */
 	octet block[16];	/*< вспомогательный блок */
+	octet blocks[128];	/*< вспомогательные блоки для групп */
 } belt_bde_st;
 
 size_t beltBDE_keep()
@@ -50,6 +51,21 @@ void beltBDEStepE(void* buf, size_t count, void* state)
 	belt_bde_st* st = (belt_bde_st*)state;
 	ASSERT(count % 16 == 0);
 	ASSERT(memIsDisjoint2(buf, count, state, beltBDE_keep()));
+	// цикл по группам из 8 блоков
+	while (count >= 128)
+	{
+		size_t i;
+		for (i = 0; i < 128; i += 16)
+		{
+			beltBlockMulC(st->s);
+			u32To(st->blocks + i, 16, st->s);
+		}
+		memXor2(buf, st->blocks, 128);
+		beltBlockEncrN(buf, 8, st->key);
+		memXor2(buf, st->blocks, 128);
+		buf = (octet*)buf + 128;
+		count -= 128;
+	}
 	// цикл по блокам
 	while(count >= 16)
 	{
@@ -68,6 +84,21 @@ void beltBDEStepD(void* buf, size_t count, void* state)
 	belt_bde_st* st = (belt_bde_st*)state;
 	ASSERT(count % 16 == 0);
 	ASSERT(memIsDisjoint2(buf, count, state, beltBDE_keep()));
+	// цикл по группам из 8 блоков
+	while (count >= 128)
+	{
+		size_t i;
+		for (i = 0; i < 128; i += 16)
+		{
+			beltBlockMulC(st->s);
+			u32To(st->blocks + i, 16, st->s);
+		}
+		memXor2(buf, st->blocks, 128);
+		beltBlockDecrN(buf, 8, st->key);
+		memXor2(buf, st->blocks, 128);
+		buf = (octet*)buf + 128;
+		count -= 128;
+	}
 	// цикл по блокам
 	while(count >= 16)
 	{
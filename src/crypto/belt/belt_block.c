@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): block encryption
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2024.02.26
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -108,6 +108,26 @@ void beltKeyExpand2(u32 key_[8], const octet key[], size_t len)
 	}
 }
 
+/*
+*******************************************************************************
+Разделяемый ключ
+*******************************************************************************
+*/
+
+size_t beltKey_keep()
+{
+	return sizeof(belt_key_st);
+}
+
+void beltKeyStart(void* state, const octet key[], size_t len)
+{
+	belt_key_st* st = (belt_key_st*)state;
+	ASSERT(memIsValid(state, beltKey_keep()));
+	beltKeyExpand2(st->key, key, st->len = len);
+	beltBlockSetZero(st->r);
+	beltBlockEncr2(st->r, st->key);
+}
+
 /*
 *******************************************************************************
 Расширенные H-блоки
@@ -323,6 +343,62 @@ void beltBlockEncr3(u32* a, u32* b, u32* c, u32* d, const u32 key[8])
 	E(a, b, c, d, key);
 }
 
+/*
+*******************************************************************************
+Зашифрование пары блоков
+
+Два блока зашифровываются на разных ключах. Такты зашифрования блоков 
+чередуются: вычисления по разным блокам независимы, и процессор выполняет 
+их параллельно.
+*******************************************************************************
+*/
+#define R2(a, b, c, d, K, a1, b1, c1, d1, K1, i)\
+	*b ^= G5(*a + subkey_e(K, i, 0));\
+	*b1 ^= G5(*a1 + subkey_e(K1, i, 0));\
+	*c ^= G21(*d + subkey_e(K, i, 1));\
+	*c1 ^= G21(*d1 + subkey_e(K1, i, 1));\
+	*a -= G13(*b + subkey_e(K, i, 2));\
+	*a1 -= G13(*b1 + subkey_e(K1, i, 2));\
+	*c += *b;\
+	*c1 += *b1;\
+	*b += G21(*c + subkey_e(K, i, 3)) ^ i;\
+	*b1 += G21(*c1 + subkey_e(K1, i, 3)) ^ i;\
+	*c -= *b;\
+	*c1 -= *b1;\
+	*d += G13(*c + subkey_e(K, i, 4));\
+	*d1 += G13(*c1 + subkey_e(K1, i, 4));\
+	*b ^= G21(*a + subkey_e(K, i, 5));\
+	*b1 ^= G21(*a1 + subkey_e(K1, i, 5));\
+	*c ^= G5(*d + subkey_e(K, i, 6));\
+	*c1 ^= G5(*d1 + subkey_e(K1, i, 6));\
+
+#define E2(a, b, c, d, K, a1, b1, c1, d1, K1)\
+	R2(a, b, c, d, K, a1, b1, c1, d1, K1, 1);\
+	R2(b, d, a, c, K, b1, d1, a1, c1, K1, 2);\
+	R2(d, c, b, a, K, d1, c1, b1, a1, K1, 3);\
+	R2(c, a, d, b, K, c1, a1, d1, b1, K1, 4);\
+	R2(a, b, c, d, K, a1, b1, c1, d1, K1, 5);\
+	R2(b, d, a, c, K, b1, d1, a1, c1, K1, 6);\
+	R2(d, c, b, a, K, d1, c1, b1, a1, K1, 7);\
+	R2(c, a, d, b, K, c1, a1, d1, b1, K1, 8);\
+	*a ^= *b, *b ^= *a, *a ^= *b;\
+	*c ^= *d, *d ^= *c, *c ^= *d;\
+	*b ^= *c, *c ^= *b, *b ^= *c;\
+	*a1 ^= *b1, *b1 ^= *a1, *a1 ^= *b1;\
+	*c1 ^= *d1, *d1 ^= *c1, *c1 ^= *d1;\
+	*b1 ^= *c1, *c1 ^= *b1, *b1 ^= *c1;\
+
+void beltBlockEncrPair(u32 block[4], const u32 key[8], u32 block1[4], 
+	const u32 key1[8])
+{
+	u32 a = block[0], b = block[1], c = block[2], d = block[3];
+	u32 a1 = block1[0], b1 = block1[1], c1 = block1[2], d1 = block1[3];
+	E2((&a), (&b), (&c), (&d), key, (&a1), (&b1), (&c1), (&d1), key1);
+	block[0] = a, block[1] = b, block[2] = c, block[3] = d;
+	block1[0] = a1, block1[1] = b1, block1[2] = c1, block1[3] = d1;
+	a = b = c = d = a1 = b1 = c1 = d1 = 0;
+}
+
 /*
 *******************************************************************************
 Расшифрование блока
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): CHE (Ctr-Hash-Encrypt) authenticated encryption
 \project bee2 [cryptographic library]
 \created 2020.03.20
-\version 2020.07.31
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -65,6 +65,29 @@ void beltCHEStart(void* state, const octet key[], size_t len,
 	st->filled = 0;
 }
 
+void beltCHEStart2(void* state, const void* key_state, const octet iv[16])
+{
+	belt_che_st* st = (belt_che_st*)state;
+	const belt_key_st* key = (const belt_key_st*)key_state;
+	ASSERT(memIsDisjoint2(iv, 16, state, beltCHE_keep()));
+	ASSERT(memIsDisjoint2(key_state, beltKey_keep(), state, beltCHE_keep()));
+	// разобрать key и iv
+	beltBlockCopy(st->key, key->key);
+	beltBlockCopy(st->key + 4, key->key + 4);
+	beltBlockCopy(st->r, iv);
+	beltBlockEncr((octet*)st->r, st->key);
+	u32From(st->s, st->r, 16);
+#if (OCTET_ORDER == BIG_ENDIAN)
+	beltBlockRevW(st->r);
+#endif
+	// подготовить t
+	wwFrom(st->t, beltH(), 16);
+	// обнулить счетчики
+	memSetZero(st->len, sizeof(st->len));
+	st->reserved = 0;
+	st->filled = 0;
+}
+
 void beltCHEStepE(void* buf, size_t count, void* state)
 {
 	belt_che_st* st = (belt_che_st*)state;
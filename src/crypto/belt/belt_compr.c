@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): compression
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2019.06.26
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -22,43 +22,44 @@
 
 h и X разбиваются на половинки:
 	[8]h = [4]h0 || [4]h1, [8]X = [4]X0 || [4]X1.
+
+Зашифрования X0 и X1 на ключах K1 = buf0 || h1 и K2 = ~buf0 || h0 
+независимы и выполняются одновременно (beltBlockEncrPair()). Для этого 
+ключи размещаются в разных частях стека.
 *******************************************************************************
 */
 
 void beltCompr(u32 h[8], const u32 X[8], void* stack)
 {
-	// [12]buf = [4]buf0 || [4]buf1 || [4]buf2
+	// [16]buf = [4]buf0 || [4]buf1 || [4]buf2 || [4]buf3
 	u32* buf = (u32*)stack;
 	// буферы не пересекаются?
-	ASSERT(memIsDisjoint3(h, 32, X, 32, buf, 48));
+	ASSERT(memIsDisjoint3(h, 32, X, 32, buf, 64));
 	// buf0, buf1 <- h0 + h1
 	beltBlockXor(buf, h, h + 4);
 	beltBlockCopy(buf + 4, buf);
 	// buf0 <- beltBlock(buf0, X) + buf1
 	beltBlockEncr2(buf, X);
 	beltBlockXor2(buf, buf + 4);
-	// buf2 <- h0
-	beltBlockCopy(buf + 8, h);
+	// buf2 <- ~buf0, buf3 <- h0 [buf23 == K2]
+	beltBlockNeg(buf + 8, buf);
+	beltBlockCopy(buf + 12, h);
 	// buf1 <- h1 [buf01 == K1]
 	beltBlockCopy(buf + 4, h + 4);
-	// h0 <- beltBlock(X0, buf01) + X0
+	// h0 <- beltBlock(X0, buf01) + X0, h1 <- beltBlock(X1, buf23) + X1
 	beltBlockCopy(h, X);
-	beltBlockEncr2(h, buf);
-	beltBlockXor2(h, X);
-	// buf1 <- ~buf0 [buf12 == K2]
-	beltBlockNeg(buf + 4, buf);
-	// h1 <- beltBlock(X1, buf12) + X1
 	beltBlockCopy(h + 4, X + 4);
-	beltBlockEncr2(h + 4, buf + 4);
+	beltBlockEncrPair(h, buf, h + 4, buf + 8);
+	beltBlockXor2(h, X);
 	beltBlockXor2(h + 4, X + 4);
 }
 
 void beltCompr2(u32 s[4], u32 h[8], const u32 X[8], void* stack)
 {
-	// [12]buf = [4]buf0 || [4]buf1 || [4]buf2
+	// [16]buf = [4]buf0 || [4]buf1 || [4]buf2 || [4]buf3
 	u32* buf = (u32*)stack;
 	// буферы не пересекаются?
-	ASSERT(memIsDisjoint4(s, 16, h, 32, X, 32, buf, 48));
+	ASSERT(memIsDisjoint4(s, 16, h, 32, X, 32, buf, 64));
 	// buf0, buf1 <- h0 + h1
 	beltBlockXor(buf, h, h + 4);
 	beltBlockCopy(buf + 4, buf);
@@ -67,23 +68,96 @@ void beltCompr2(u32 s[4], u32 h[8], const u32 X[8], void* stack)
 	beltBlockXor2(buf, buf + 4);
 	// s <- s ^ buf0
 	beltBlockXor2(s, buf);
-	// buf2 <- h0
-	beltBlockCopy(buf + 8, h);
+	// buf2 <- ~buf0, buf3 <- h0 [buf23 == K2]
+	beltBlockNeg(buf + 8, buf);
+	beltBlockCopy(buf + 12, h);
 	// buf1 <- h1 [buf01 == K1]
 	beltBlockCopy(buf + 4, h + 4);
-	// h0 <- beltBlock(X0, buf01) + X0
+	// h0 <- beltBlock(X0, buf01) + X0, h1 <- beltBlock(X1, buf23) + X1
 	beltBlockCopy(h, X);
-	beltBlockEncr2(h, buf);
+	beltBlockCopy(h + 4, X + 4);
+	beltBlockEncrPair(h, buf, h + 4, buf + 8);
 	beltBlockXor2(h, X);
-	// buf1 <- ~buf0 [buf12 == K2]
-	beltBlockNeg(buf + 4, buf);
-	// h1 <- beltBlock(X1, buf12) + X1
+	beltBlockXor2(h + 4, X + 4);
+}
+
+/*
+*******************************************************************************
+Сжатие пар форматированных данных
+
+Две независимые строки h || X и h1 || X1 сжимаются одновременно. Первые 
+зашифрования двух сжатий выполняются одним вызовом beltBlockEncrPair(), 
+вторые пары зашифрований -- еще двумя вызовами. Данные первого сжатия 
+размещаются в первой половине стека, второго -- во второй.
+*******************************************************************************
+*/
+
+static void beltComprPair_internal(u32 s[4], u32 h[8], const u32 X[8], 
+	u32 s1[4], u32 h1[8], const u32 X1[8], void* stack)
+{
+	// [16]buf = [4]buf0 || [4]buf1 || [4]buf2 || [4]buf3, [16]buf' -- копия
+	u32* buf = (u32*)stack;
+	u32* buf1 = buf + 16;
+	// буферы не пересекаются?
+	ASSERT(memIsDisjoint4(h, 32, X, 32, h1, 32, X1, 32));
+	ASSERT(memIsDisjoint3(h, 32, h1, 32, buf, 128));
+	// buf0, buf1 <- h0 + h1
+	beltBlockXor(buf, h, h + 4);
+	beltBlockCopy(buf + 4, buf);
+	beltBlockXor(buf1, h1, h1 + 4);
+	beltBlockCopy(buf1 + 4, buf1);
+	// buf0 <- beltBlock(buf0, X) + buf1
+	beltBlockEncrPair(buf, X, buf1, X1);
+	beltBlockXor2(buf, buf + 4);
+	beltBlockXor2(buf1, buf1 + 4);
+	// s <- s ^ buf0
+	if (s)
+	{
+		ASSERT(s1);
+		beltBlockXor2(s, buf);
+		beltBlockXor2(s1, buf1);
+	}
+	// buf2 <- ~buf0, buf3 <- h0 [buf23 == K2]
+	beltBlockNeg(buf + 8, buf);
+	beltBlockCopy(buf + 12, h);
+	beltBlockNeg(buf1 + 8, buf1);
+	beltBlockCopy(buf1 + 12, h1);
+	// buf1 <- h1 [buf01 == K1]
+	beltBlockCopy(buf + 4, h + 4);
+	beltBlockCopy(buf1 + 4, h1 + 4);
+	// h0 <- beltBlock(X0, buf01) + X0, h1 <- beltBlock(X1, buf23) + X1
+	beltBlockCopy(h, X);
 	beltBlockCopy(h + 4, X + 4);
-	beltBlockEncr2(h + 4, buf + 4);
+	beltBlockCopy(h1, X1);
+	beltBlockCopy(h1 + 4, X1 + 4);
+	beltBlockEncrPair(h, buf, h + 4, buf + 8);
+	beltBlockEncrPair(h1, buf1, h1 + 4, buf1 + 8);
+	beltBlockXor2(h, X);
 	beltBlockXor2(h + 4, X + 4);
+	beltBlockXor2(h1, X1);
+	beltBlockXor2(h1 + 4, X1 + 4);
+}
+
+void beltComprPair(u32 h[8], const u32 X[8], u32 h1[8], const u32 X1[8],
+	void* stack)
+{
+	beltComprPair_internal(0, h, X, 0, h1, X1, stack);
+}
+
+void beltCompr2Pair(u32 s[4], u32 h[8], const u32 X[8], u32 s1[4], 
+	u32 h1[8], const u32 X1[8], void* stack)
+{
+	ASSERT(memIsDisjoint4(s, 16, h, 32, X, 32, s1, 16));
+	ASSERT(memIsDisjoint3(s1, 16, h1, 32, X1, 32));
+	beltComprPair_internal(s, h, X, s1, h1, X1, stack);
 }
 
 size_t beltCompr_deep()
 {
-	return 12 * 4;
+	return 16 * 4;
+}
+
+size_t beltComprPair_deep()
+{
+	return 2 * beltCompr_deep();
 }
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): CTR encryption
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -27,6 +27,10 @@
 не используется реверс октетов  даже на платформах BIG_ENDIAN.
 Реверс применяется только перед использованием зашифрованного счетчика
 в качестве гаммы.
+
+Длинные сообщения обрабатываются группами по 8 блоков: значения счетчика
+записываются в st->blocks и зашифровываются функцией beltBlockEncrN(),
+которая может обрабатывать несколько блоков одновременно.
 *******************************************************************************
 */
 
@@ -46,6 +50,19 @@ void beltCTRStart(void* state, const octet key[], size_t len,
 	st->reserved = 0;
 }
 
+void beltCTRStart2(void* state, const void* key_state, const octet iv[16])
+{
+	belt_ctr_st* st = (belt_ctr_st*)state;
+	const belt_key_st* key = (const belt_key_st*)key_state;
+	ASSERT(memIsDisjoint2(iv, 16, state, beltCTR_keep()));
+	ASSERT(memIsDisjoint2(key_state, beltKey_keep(), state, beltCTR_keep()));
+	beltBlockCopy(st->key, key->key);
+	beltBlockCopy(st->key + 4, key->key + 4);
+	u32From(st->ctr, iv, 16);
+	beltBlockEncr2(st->ctr, st->key);
+	st->reserved = 0;
+}
+
 void beltCTRStepE(void* buf, size_t count, void* state)
 {
 	belt_ctr_st* st = (belt_ctr_st*)state;
@@ -64,6 +81,20 @@ void beltCTRStepE(void* buf, size_t count, void* state)
 		buf = (octet*)buf + st->reserved;
 		st->reserved = 0;
 	}
+	// цикл по группам из 8 блоков
+	while (count >= 128)
+	{
+		size_t i;
+		for (i = 0; i < 128; i += 16)
+		{
+			beltBlockIncU32(st->ctr);
+			u32To(st->blocks + i, 16, st->ctr);
+		}
+		beltBlockEncrN(st->blocks, 8, st->key);
+		memXor2(buf, st->blocks, 128);
+		buf = (octet*)buf + 128;
+		count -= 128;
+	}
 	// цикл по полным блокам
 	while (count >= 16)
 	{
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): DWP (datawrap = data encryption + authentication)
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -61,6 +61,25 @@ void beltDWPStart(void* state, const octet key[], size_t len,
 	st->filled = 0;
 }
 
+void beltDWPStart2(void* state, const void* key_state, const octet iv[16])
+{
+	belt_dwp_st* st = (belt_dwp_st*)state;
+	ASSERT(memIsDisjoint2(iv, 16, state, beltDWP_keep()));
+	// настроить CTR
+	beltCTRStart2(st->ctr, key_state, iv);
+	// установить r, s
+	beltBlockCopy(st->r, st->ctr->ctr);
+	beltBlockEncr2((u32*)st->r, st->ctr->key);
+#if (OCTET_ORDER == BIG_ENDIAN && B_PER_W != 32)
+	beltBlockRevU32(st->r);
+	beltBlockRevW(st->r);
+#endif
+	wwFrom(st->t, beltH(), 16);
+	// обнулить счетчики
+	memSetZero(st->len, sizeof(st->len));
+	st->filled = 0;
+}
+
 void beltDWPStepE(void* buf, size_t count, void* state)
 {
 	beltCTRStepE(buf, count, state);
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): ECB encryption
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -15,6 +15,7 @@
 #include "bee2/core/mem.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/belt.h"
+#include "belt_lcl.h"
 
 /*
 *******************************************************************************
@@ -43,13 +44,10 @@ void beltECBStepE(void* buf, size_t count, void* state)
 	belt_ecb_st* st = (belt_ecb_st*)state;
 	ASSERT(count >= 16);
 	ASSERT(memIsDisjoint2(buf, count, state, beltECB_keep()));
-	// цикл по полным блокам
-	while(count >= 16)
-	{
-		beltBlockEncr(buf, st->key);
-		buf = (octet*)buf + 16;
-		count -= 16;
-	}
+	// полные блоки
+	beltBlockEncrN(buf, count / 16, st->key);
+	buf = (octet*)buf + count / 16 * 16;
+	count %= 16;
 	// неполный блок? кража блока
 	if (count)
 	{
@@ -63,13 +61,10 @@ void beltECBStepD(void* buf, size_t count, void* state)
 	belt_ecb_st* st = (belt_ecb_st*)state;
 	ASSERT(count >= 16);
 	ASSERT(memIsDisjoint2(buf, count, state, beltECB_keep()));
-	// цикл по полным блокам
-	while(count >= 16)
-	{
-		beltBlockDecr(buf, st->key);
-		buf = (octet*)buf + 16;
-		count -= 16;
-	}
+	// полные блоки
+	beltBlockDecrN(buf, count / 16, st->key);
+	buf = (octet*)buf + count / 16 * 16;
+	count %= 16;
 	// неполный блок? кража блока
 	if (count)
 	{
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): FMT (format preserving encryption)
 \project bee2 [cryptographic library]
 \created 2017.09.28
-\version 2021.01.21
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -174,14 +174,35 @@ static void belt32BlockEncr(octet block[24], const u32 key[8])
 /*
 *******************************************************************************
 Конвертации
+
+Строки в алфавите {0, 1,..., mod - 1} конвертируются в числа и обратно 
+группами по k символов, где k -- максимальное число, при котором 
+mk = mod^k укладывается в машинное слово. Группа символов конвертируется 
+в слово (или слово в группу) без многократной точности, а число 
+многократной точности умножается (делится) на mk один раз на группу, 
+а не на каждый символ. Кроме этого, остаток и частное от деления 
+на mk определяются за один вызов zzDivW().
+
+Параметры k и mk рассчитываются в функции beltFMTCalcK() и сохраняются 
+в состоянии FMT.
 *******************************************************************************
 */
 
-static void beltStr2Bin(octet bin[], size_t b, u32 mod, 
+static size_t beltFMTCalcK(word* mk, u32 mod)
+{
+	size_t k = 1;
+	ASSERT(2 <= mod && mod < 65536);
+	for (*mk = (word)mod; *mk <= WORD_MAX / mod; *mk *= mod, ++k);
+	return k;
+}
+
+static void beltStr2Bin(octet bin[], size_t b, u32 mod, size_t k, word mk,
 	const u16 str[], size_t count)
 {
+	register word w;
 	word* a;
 	size_t m;
+	size_t i;
 	// подготовить память
 	memSetZero(bin, 8 * b);
 	// особый случай: mod может не уложиться в word
@@ -193,26 +214,44 @@ static void beltStr2Bin(octet bin[], size_t b, u32 mod,
 	// конвертировать
 	ASSERT(2 <= mod && mod < 65536);
 	ASSERT(count >= 1);
-	--count;
-	EXPECT(str[count] < mod);
 	a = (word*)bin;
 	m = W_OF_O(8 * b);
-	a[0] = (word)str[count];
-	while (count--)
+	// старшая (неполная) группа символов
+	i = count % k;
+	if (i == 0)
+		i = k;
+	for (w = 0; i--;)
 	{
-		zzMulW(a, a, m, mod);
+		--count;
 		EXPECT(str[count] < mod);
-		zzAddW2(a, m, (word)str[count]);
+		w = w * mod + str[count];
+	}
+	a[0] = w;
+	// остальные группы
+	while (count)
+	{
+		ASSERT(count % k == 0);
+		for (w = 0, i = k; i--;)
+		{
+			--count;
+			EXPECT(str[count] < mod);
+			w = w * mod + str[count];
+		}
+		zzMulW(a, a, m, mk);
+		zzAddW2(a, m, w);
 	}
+	w = 0;
 	wwTo(bin, 8 * b, a);
 }
 
-static void beltBin2StrAdd(u32 mod, u16 str[], size_t count, 
-	octet bin[], size_t b)
+static void beltBin2StrAdd(u32 mod, size_t k, word mk, u16 str[], 
+	size_t count, octet bin[], size_t b)
 {
+	register word w;
 	register u32 t;
 	word* a;
 	size_t m;
+	size_t i;
 	// особый случай: mod может не уложиться в word
 	if (mod == 65536)
 	{
@@ -228,22 +267,27 @@ static void beltBin2StrAdd(u32 mod, u16 str[], size_t count,
 	wwFrom(a, bin, 8 * b);
 	// конвертировать и сложить
 	ASSERT(2 <= mod && mod < 65536);
-	while (count--)
+	while (count)
 	{
-		t = (u32)zzModW(a, m, mod);
-		t += str[0], t %= mod;
-		str[0] = (u16)t, ++str;
-		zzDivW(a, a, m, mod);
+		w = zzDivW(a, a, m, mk);
+		for (i = MIN2(k, count), count -= i; i--; w /= mod)
+		{
+			t = (u32)(w % mod);
+			t += str[0], t %= mod;
+			str[0] = (u16)t, ++str;
+		}
 	}
-	t = 0;
+	w = 0, t = 0;
 }
 
-static void beltBin2StrSub(word mod, u16 str[], size_t count, 
-	octet bin[], size_t b)
+static void beltBin2StrSub(u32 mod, size_t k, word mk, u16 str[], 
+	size_t count, octet bin[], size_t b)
 {
+	register word w;
 	register u32 t;
 	word* a;
 	size_t m;
+	size_t i;
 	// особый случай: mod может не уложиться в word
 	if (mod == 65536)
 	{
@@ -258,15 +302,18 @@ static void beltBin2StrSub(word mod, u16 str[], size_t count,
 	a = (word*)bin;
 	wwFrom(a, bin, 8 * b);
 	// конвертировать и вычесть
-	ASSERT(2 <= mod && mod <= 65536);
-	while (count--)
+	ASSERT(2 <= mod && mod < 65536);
+	while (count)
 	{
-		t = (u32)zzModW(a, m, mod);
-		t = str[0] + mod - t, t %= mod;
-		str[0] = (u16)t, ++str;
-		zzDivW(a, a, m, mod);
+		w = zzDivW(a, a, m, mk);
+		for (i = MIN2(k, count), count -= i; i--; w /= mod)
+		{
+			t = (u32)(w % mod);
+			t = str[0] + mod - t, t %= mod;
+			str[0] = (u16)t, ++str;
+		}
 	}
-	t = 0;
+	w = 0, t = 0;
 }
 
 /*
@@ -286,6 +333,8 @@ typedef struct
 {
 	belt_wbl_st wbl[1];		/*< состояние механизма WBL */
 	u32 mod;				/*< модуль */
+	size_t k;				/*< число символов в группе */
+	word mk;				/*< mod^k */
 	size_t n1;				/*< длина левой половинки */
 	size_t n2;				/*< длина правой половинки */
 	size_t b1;				/*< число блоков для обработки левой половинки */
@@ -311,6 +360,10 @@ void beltFMTStart(void* state, u32 mod, size_t count, const octet key[],
 	// инициализировать состояние
 	beltWBLStart(st->wbl, key, len);
 	st->mod = mod;
+	if (mod == 65536)
+		st->k = 1, st->mk = 0;
+	else
+		st->k = beltFMTCalcK(&st->mk, mod);
 	st->n1 = (count + 1) / 2;
 	st->n2 = count / 2;
 	st->b1 = beltFMTCalcB(mod, st->n1);
@@ -325,10 +378,73 @@ void beltFMTStart(void* state, u32 mod, size_t count, const octet key[],
 	memCopy(st->iv + 20, st->iv, 4);
 }
 
+/*
+*******************************************************************************
+Такты FMT
+
+Функция beltFMTRound() зашифровывает st->buf, дополненный половинкой
+синхропосылки, на ключе st->wbl->key. Если число блоков невелико, то 
+вместо механизма WBL используются прямые обращения к belt-block и 
+belt-32block.
+
+Функции beltFMTStepE_internal() и beltFMTStepD_internal() обрабатывают 
+одну строку при уже подготовленной синхропосылке st->iv.
+*******************************************************************************
+*/
+
+static void beltFMTRound(size_t b, size_t r, belt_fmt_st* st)
+{
+	memCopy(st->buf + b * 8, beltH() + 4 * r, 4);
+	memCopy(st->buf + b * 8 + 4, st->iv + 4 * r, 4);
+	if (b == 1)
+		beltBlockEncr(st->buf, st->wbl->key);
+	else if (b == 2)
+		belt32BlockEncr(st->buf, st->wbl->key);
+	else
+		beltWBLStepE(st->buf, 8 * b + 8, st->wbl);
+}
+
+static void beltFMTStepE_internal(u16 buf[], belt_fmt_st* st)
+{
+	size_t i;
+	for (i = 0; i < 3; ++i)
+	{
+		// первая половинка
+		beltStr2Bin(st->buf, st->b2, st->mod, st->k, st->mk, 
+			buf + st->n1, st->n2);
+		beltFMTRound(st->b2, 2 * i, st);
+		beltBin2StrAdd(st->mod, st->k, st->mk, buf, st->n1, 
+			st->buf, st->b2 + 1);
+		// вторая половинка
+		beltStr2Bin(st->buf, st->b1, st->mod, st->k, st->mk, buf, st->n1);
+		beltFMTRound(st->b1, 2 * i + 1, st);
+		beltBin2StrAdd(st->mod, st->k, st->mk, buf + st->n1, st->n2, 
+			st->buf, st->b1 + 1);
+	}
+}
+
+static void beltFMTStepD_internal(u16 buf[], belt_fmt_st* st)
+{
+	size_t i;
+	for (i = 3; i--;)
+	{
+		// вторая половинка
+		beltStr2Bin(st->buf, st->b1, st->mod, st->k, st->mk, buf, st->n1);
+		beltFMTRound(st->b1, 2 * i + 1, st);
+		beltBin2StrSub(st->mod, st->k, st->mk, buf + st->n1, st->n2, 
+			st->buf, st->b1 + 1);
+		// первая половинка
+		beltStr2Bin(st->buf, st->b2, st->mod, st->k, st->mk, 
+			buf + st->n1, st->n2);
+		beltFMTRound(st->b2, 2 * i, st);
+		beltBin2StrSub(st->mod, st->k, st->mk, buf, st->n1, 
+			st->buf, st->b2 + 1);
+	}
+}
+
 void beltFMTStepE(u16 buf[], const octet iv[16], void* state)
 {
 	belt_fmt_st* st = (belt_fmt_st*)state;
-	size_t i;
 	ASSERT(memIsValid(state, sizeof(belt_fmt_st)));
 	ASSERT(memIsValid(state, beltFMT_keep(st->mod, st->n1 + st->n2)));
 	ASSERT(memIsNullOrValid(iv, 16));
@@ -338,38 +454,13 @@ void beltFMTStepE(u16 buf[], const octet iv[16], void* state)
 		memCopy(st->iv + 4, iv, 16);
 	else
 		memSetZero(st->iv + 4, 16);
-	// такты
-	for (i = 0; i < 3; ++i)
-	{
-		// первая половинка
-		beltStr2Bin(st->buf, st->b2, st->mod, buf + st->n1, st->n2);
-		memCopy(st->buf + st->b2 * 8, beltH() + 8 * i, 4);
-		memCopy(st->buf + st->b2 * 8 + 4, st->iv + 8 * i, 4);
-		if (st->b2 == 1)
-			beltBlockEncr(st->buf, st->wbl->key);
-		else if (st->b2 == 2)
-			belt32BlockEncr(st->buf, st->wbl->key);
-		else
-			beltWBLStepE(st->buf, 8 * st->b2 + 8, st->wbl);
-		beltBin2StrAdd(st->mod, buf, st->n1, st->buf, st->b2 + 1);
-		// вторая половинка
-		beltStr2Bin(st->buf, st->b1, st->mod, buf, st->n1);
-		memCopy(st->buf + st->b1 * 8, beltH() + 8 * i + 4, 4);
-		memCopy(st->buf + st->b1 * 8 + 4, st->iv + 8 * i + 4, 4);
-		if (st->b1 == 1)
-			beltBlockEncr(st->buf, st->wbl->key);
-		else if (st->b1 == 2)
-			belt32BlockEncr(st->buf, st->wbl->key);
-		else
-			beltWBLStepE(st->buf, 8 * st->b1 + 8, st->wbl);
-		beltBin2StrAdd(st->mod, buf + st->n1, st->n2, st->buf, st->b1 + 1);
-	}
+	// зашифровать
+	beltFMTStepE_internal(buf, st);
 }
 
 void beltFMTStepD(u16 buf[], const octet iv[16], void* state)
 {
 	belt_fmt_st* st = (belt_fmt_st*)state;
-	size_t i;
 	ASSERT(memIsValid(state, sizeof(belt_fmt_st)));
 	ASSERT(memIsValid(state, beltFMT_keep(st->mod, st->n1 + st->n2)));
 	ASSERT(memIsNullOrValid(iv, 16));
@@ -379,32 +470,8 @@ void beltFMTStepD(u16 buf[], const octet iv[16], void* state)
 		memCopy(st->iv + 4, iv, 16);
 	else
 		memSetZero(st->iv + 4, 16);
-	// такты
-	for (i = 3; i--;)
-	{
-		// вторая половинка
-		beltStr2Bin(st->buf, st->b1, st->mod, buf, st->n1);
-		memCopy(st->buf + st->b1 * 8, beltH() + 8 * i + 4, 4);
-		memCopy(st->buf + st->b1 * 8 + 4, st->iv + 8 * i + 4, 4);
-		if (st->b1 == 1)
-			beltBlockEncr(st->buf, st->wbl->key);
-		else if (st->b1 == 2)
-			belt32BlockEncr(st->buf, st->wbl->key);
-		else
-			beltWBLStepE(st->buf, 8 * st->b1 + 8, st->wbl);
-		beltBin2StrSub(st->mod, buf + st->n1, st->n2, st->buf, st->b1 + 1);
-		// первая половинка
-		beltStr2Bin(st->buf, st->b2, st->mod, buf + st->n1, st->n2);
-		memCopy(st->buf + st->b2 * 8, beltH() + 8 * i, 4);
-		memCopy(st->buf + st->b2 * 8 + 4, st->iv + 8 * i, 4);
-		if (st->b2 == 1)
-			beltBlockEncr(st->buf, st->wbl->key);
-		else if (st->b2 == 2)
-			belt32BlockEncr(st->buf, st->wbl->key);
-		else
-			beltWBLStepE(st->buf, 8 * st->b2 + 8, st->wbl);
-		beltBin2StrSub(st->mod, buf, st->n1, st->buf, st->b2 + 1);
-	}	
+	// расшифровать
+	beltFMTStepD_internal(buf, st);
 }
 
 err_t beltFMTEncr(u16 dest[], u32 mod, const u16 src[], size_t count,
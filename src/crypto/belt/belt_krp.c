@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): KRP (keyrep = key diversification + meshing)
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -48,25 +48,52 @@ void beltKRPStart(void* state, const octet key[], size_t len,
 	beltKeyExpand2(st->key, key, st->len = len);
 }
 
+void beltKRPStart2(void* state, const void* key_state, const octet level[12])
+{
+	belt_krp_st* st = (belt_krp_st*)state;
+	const belt_key_st* key = (const belt_key_st*)key_state;
+	ASSERT(memIsDisjoint2(level, 12, state, beltKRP_keep()));
+	ASSERT(memIsDisjoint2(key_state, beltKey_keep(), state, beltKRP_keep()));
+	// block <- ... || level || ...
+	u32From(st->block + 1, level, 12);
+	// сохранить ключ
+	beltBlockCopy(st->key, key->key);
+	beltBlockCopy(st->key + 4, key->key + 4);
+	st->len = key->len;
+}
+
 void beltKRPStepG(octet key_[], size_t key_len, const octet header[16],
 	void* state)
+{
+	beltKRPStepGN(key_, key_len, header, 1, state);
+}
+
+void beltKRPStepGN(octet keys[], size_t key_len, const octet header[16],
+	size_t count, void* state)
 {
 	belt_krp_st* st = (belt_krp_st*)state;
+	size_t i;
 	// pre
 	ASSERT(memIsValid(state, beltKRP_keep()));
 	ASSERT(key_len == 16 || key_len == 24 || key_len == 32);
 	ASSERT(key_len <= st->len);
-	ASSERT(memIsDisjoint2(key_, key_len, state, beltKRP_keep()));
+	ASSERT(memIsDisjoint2(keys, key_len * count, state, beltKRP_keep()));
 	ASSERT(memIsDisjoint2(header, 16, state, beltKRP_keep()));
 	// полностью определить st->block
 	u32From(st->block, beltH() + 4 * (st->len - 16) + 2 * (key_len - 16), 4);
 	u32From(st->block + 4, header, 16);
-	// применить belt-compr2
-	beltBlockCopy(st->key_new, st->key);
-	beltBlockCopy(st->key_new + 4, st->key + 4);
-	beltCompr(st->key_new, st->block, st->stack);
-	// выгрузить ключ
-	u32To(key_, key_len, st->key_new);
+	// цикл по заголовкам
+	for (; count--; keys += key_len)
+	{
+		// применить belt-compr2
+		beltBlockCopy(st->key_new, st->key);
+		beltBlockCopy(st->key_new + 4, st->key + 4);
+		beltCompr(st->key_new, st->block, st->stack);
+		// выгрузить ключ
+		u32To(keys, key_len, st->key_new);
+		// header <- header + 1
+		for (i = 4; i < 8 && ++st->block[i] == 0; ++i);
+	}
 }
 
 err_t beltKRP(octet dest[], size_t m, const octet src[], size_t n,
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): local definitions
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.20
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -199,6 +199,19 @@ extern "C" {
 		(((u32*)(block))[2] += 1) == 0)\
 		((u32*)(block))[3] += 1\
 
+/*
+*******************************************************************************
+Разделяемый ключ
+*******************************************************************************
+*/
+
+typedef struct
+{
+	u32 key[8];			/*< форматированный ключ */
+	u32 r[4];			/*< зашифрованный нулевой блок (MAC) */
+	size_t len;			/*< длина первоначального ключа */
+} belt_key_st;
+
 /*
 *******************************************************************************
 Состояния CTR и WBL (используются в DWP, KWP и FMT)
@@ -211,6 +224,7 @@ typedef struct
 	u32 ctr[4];			/*< счетчик */
 	octet block[16];	/*< блок гаммы */
 	size_t reserved;	/*< резерв октетов гаммы */
+	octet blocks[128];	/*< гамма для 8 блоков */
 } belt_ctr_st;
 
 typedef struct
@@ -232,6 +246,10 @@ void beltHalfBlockAddBitSizeW(word block[W_OF_B(64)], size_t count);
 void beltPolyMul(word c[], const word a[], const word b[], void* stack);
 size_t beltPolyMul_deep();
 void beltBlockMulC(u32 block[4]);
+void beltBlockEncrPair(u32 block[4], const u32 key[8], u32 block1[4],
+	const u32 key1[8]);
+void beltBlockEncrN(octet blocks[], size_t count, const u32 key[8]);
+void beltBlockDecrN(octet blocks[], size_t count, const u32 key[8]);
 
 
 
@@ -4,7 +4,7 @@
 \brief STB 34.101.31 (belt): MAC (message authentication)
 \project bee2 [cryptographic library]
 \created 2012.12.18
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -55,6 +55,18 @@ void beltMACStart(void* state, const octet key[], size_t len)
 	st->filled = 0;
 }
 
+void beltMACStart2(void* state, const void* key_state)
+{
+	belt_mac_st* st = (belt_mac_st*)state;
+	const belt_key_st* key = (const belt_key_st*)key_state;
+	ASSERT(memIsDisjoint2(key_state, beltKey_keep(), state, beltMAC_keep()));
+	beltBlockCopy(st->key, key->key);
+	beltBlockCopy(st->key + 4, key->key + 4);
+	beltBlockSetZero(st->s);
+	beltBlockCopy(st->r, key->r);
+	st->filled = 0;
+}
+
 void beltMACStepA(const void* buf, size_t count, void* state)
 {
 	belt_mac_st* st = (belt_mac_st*)state;
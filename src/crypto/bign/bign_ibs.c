@@ -4,7 +4,7 @@
 \brief STB 34.101.45 (bign): identity-based signature
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.20
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -384,19 +384,177 @@ err_t bignIdSign2(octet id_sig[], const bign_params* params,
 /*
 *******************************************************************************
 Проверка идентификационной ЭЦП
+
+Функция bignIdVerifyItem() проверяет одну подпись. Описание кривой ec,
+открытый ключ доверенной стороны Q и состояние хэширования hash_state0,
+в котором уже обработан oid_der, подготавливаются вызывающей функцией.
+
+Если переданы таблицы предвычислений preG и preQ (см. ecPreCombA()), 
+то точка V = s1 G + (s0 + 2^l) R + t1 Q определяется функцией 
+bignIdVerifyMulComb(): кратные фиксированных точек G и Q вычисляются 
+гребенчатым методом с общей цепочкой удвоений (ceil(l / w) удвоений 
+вместо l), к ним добавляется кратное R (s0 + 2^l имеет длину l / 2 + 1 
+битов). Иначе используется ecAddMulA().
 *******************************************************************************
 */
 
-static size_t bignIdVerify_deep(size_t n, size_t f_deep, size_t ec_d,
+#define BIGN_BATCH_W 5
+#define BIGN_BATCH_MIN 4
+
+static bool_t bignIdVerifyMulComb(word V[], const ec_o* ec,
+	const word preG[], const word s1[], const word preQ[], const word t1[],
+	const word R[], const word s0[], void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t e = (B_OF_W(n) + BIGN_BATCH_W - 1) / BIGN_BATCH_W;
+	register size_t kG, kQ;
+	size_t i, j;
+	bool_t started = FALSE;
+	// переменные в stack
+	word* t;			/* [ec->d * n] сумма кратных */
+	word* W;			/* [2 * n] кратное R */
+	// раскладка stack
+	t = (word*)stack;
+	W = t + ec->d * n;
+	stack = W + 2 * n;
+	// t <- s1 G + t1 Q
+	for (i = e; i--;)
+	{
+		if (started)
+			ecDbl(t, t, ec, stack);
+		for (kG = kQ = 0, j = BIGN_BATCH_W; j--;)
+		{
+			kG <<= 1, kQ <<= 1;
+			if (i + j * e < B_OF_W(n))
+				kG |= wwTestBit(s1, i + j * e),
+				kQ |= wwTestBit(t1, i + j * e);
+		}
+		if (kG)
+		{
+			if (started)
+				ecAddA(t, t, preG + (kG - 1) * 2 * n, ec, stack);
+			else
+				ecFromA(t, preG + (kG - 1) * 2 * n, ec, stack), started = TRUE;
+		}
+		if (kQ)
+		{
+			if (started)
+				ecAddA(t, t, preQ + (kQ - 1) * 2 * n, ec, stack);
+			else
+				ecFromA(t, preQ + (kQ - 1) * 2 * n, ec, stack), started = TRUE;
+		}
+	}
+	// t <- t + (s0 + 2^l) R
+	if (ecMulA(W, R, ec, s0, n / 2 + 1, stack))
+	{
+		if (started)
+			ecAddA(t, t, W, ec, stack);
+		else
+			ecFromA(t, W, ec, stack), started = TRUE;
+	}
+	// V <- t
+	return started && ecToA(V, t, ec, stack);
+}
+
+static size_t bignIdVerifyMulComb_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W(ec_d * n + 2 * n) +
+		utilMax(2,
+			ec_deep,
+			ecMulA_deep(n, ec_d, ec_deep, n / 2 + 1));
+}
+
+static err_t bignIdVerifyItem(const ec_o* ec, const octet hash_state0[],
+	const word Q[], const word preG[], const word preQ[],
+	const octet id_hash[], const octet hash[], const octet id_sig[],
+	const octet id_pubkey[], void* stack)
+{
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	// переменные в stack (буферы R и V совпадают)
+	word* R;			/* [2n] открытый ключ R */
+	word* V;			/* [2n] точка V (V == R) */
+	word* s0;			/* [n / 2 + 1] первая часть подписи */
+	word* s1;			/* [n] вторая часть подписи */
+	word* t;			/* [n / 2] переменная t */
+	word* t1;			/* [n + 1] произведение (s0 + 2^l)(t + 2^l) */
+	octet* hash_state;	/* [beltHash_keep] состояние хэширования */
+	ASSERT(n % 2 == 0);
+	// раскладка stack
+	R = V = (word*)stack;
+	s0 = R + 2 * n;
+	s1 = s0 + n / 2 + 1;
+	t = s1 + n;
+	t1 = t + n / 2;
+	hash_state = (octet*)(t1 + n + 1);
+	stack = hash_state + beltHash_keep();
+	// загрузить R
+	if (!qrFrom(ecX(R), id_pubkey, ec->f, stack) ||
+		!qrFrom(ecY(R, n), id_pubkey + no, ec->f, stack) ||
+		!ecpIsOnA(R, ec, stack))
+		return ERR_BAD_PUBKEY;
+	// загрузить и проверить s1
+	wwFrom(s1, id_sig + no / 2, no);
+	if (wwCmp(s1, ec->order, n) >= 0)
+		return ERR_BAD_SIG;
+	// s1 <- (s1 + H) mod q
+	wwFrom(t, hash, no);
+	if (wwCmp(t, ec->order, n) >= 0)
+	{
+		zzSub2(t, ec->order, n);
+		// 2^{l - 1} < q < 2^l, H < 2^l => H - q < q
+		ASSERT(wwCmp(t, ec->order, n) < 0);
+	}
+	zzAddMod(s1, s1, t, ec->order, n);
+	// загрузить s0
+	wwFrom(s0, id_sig, no / 2);
+	s0[n / 2] = 1;
+	// t <- belt-hash(oid || R || H0) mod 2^l
+	memCopy(hash_state, hash_state0, beltHash_keep());
+	beltHashStepH(id_pubkey, no, hash_state);
+	beltHashStepH(id_hash, no, hash_state);
+	beltHashStepG2((octet*)t, no / 2, hash_state);
+	wwFrom(t, t, no / 2);
+	// t1 <- -(t + 2^l)(s0 + 2^l) mod q
+	zzMul(t1, t, n / 2, s0, n / 2, stack);
+	t1[n] = zzAdd2(t1 + n / 2, t, n / 2);
+	t1[n] += zzAdd2(t1 + n / 2, s0, n / 2);
+	++t1[n];
+	zzMod(t1, t1, n + 1, ec->order, n, stack);
+	zzNegMod(t1, t1, ec->order, n);
+	// V <- s1 G + (s0 + 2^l) R + t Q
+	if (preG ?
+		!bignIdVerifyMulComb(V, ec, preG, s1, preQ, t1, R, s0, stack) :
+		!ecAddMulA(V, ec, stack,
+			3, ec->base, s1, n, R, s0, n / 2 + 1, Q, t1, n))
+		return ERR_BAD_SIG;
+	qrTo((octet*)V, ecX(V), ec->f, stack);
+	// s0 == belt-hash(oid || V || H0 || H) mod 2^l?
+	memCopy(hash_state, hash_state0, beltHash_keep());
+	beltHashStepH(V, no, hash_state);
+	beltHashStepH(id_hash, no, hash_state);
+	beltHashStepH(hash, no, hash_state);
+	return beltHashStepV2(id_sig, no / 2, hash_state) ? ERR_OK : ERR_BAD_SIG;
+}
+
+static size_t bignIdVerifyItem_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
-	return O_OF_W(7 * n + 2) + beltHash_keep() +
-		utilMax(5,
+	return O_OF_W(5 * n + 2) + beltHash_keep() +
+		utilMax(6,
 			beltHash_keep(),
 			ecpIsOnA_deep(n, f_deep),
 			zzMul_deep(n / 2, n / 2),
 			zzMod_deep(n + 1, n),
-			ecAddMulA_deep(n, ec_d, ec_deep, 3, n, n / 2 + 1, n));
+			ecAddMulA_deep(n, ec_d, ec_deep, 3, n, n / 2 + 1, n),
+			bignIdVerifyMulComb_deep(n, ec_d, ec_deep));
+}
+
+static size_t bignIdVerify_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) + beltHash_keep() +
+		bignIdVerifyItem_deep(n, f_deep, ec_d, ec_deep);
 }
 
 err_t bignIdVerify(const bign_params* params, const octet oid_der[], 
@@ -405,16 +563,10 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 {
 	err_t code;
 	size_t no, n;
-	// состояние (буферы R и V совпадают)
+	// состояние
 	void* state;
 	ec_o* ec;			/* описание эллиптической кривой */	
-	word* R;			/* [2n] открытый ключ R */
 	word* Q;			/* [2n] открытый ключ Q */
-	word* V;			/* [2n] точка V (V == R) */
-	word* s0;			/* [n / 2 + 1] первая часть подписи */
-	word* s1;			/* [n] вторая часть подписи */
-	word* t;			/* [n / 2] переменная t */
-	word* t1;			/* [n + 1] произведение (s0 + 2^l)(t + 2^l) */
 	octet* hash_state;	/* [beltHash_keep] состояние хэширования */
 	octet* stack;
 	// проверить params
@@ -448,22 +600,104 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 		return ERR_BAD_INPUT;
 	}
 	// раскладка состояния
-	R = V = objEnd(ec, word);
-	Q = R + 2 * n;
-	s0 = Q + 2 * n;
-	s1 = s0 + n / 2 + 1;
-	t = s1 + n;
-	t1 = t + n / 2;
-	hash_state = (octet*)(t1 + n + 1);
+	Q = objEnd(ec, word);
+	hash_state = (octet*)(Q + 2 * n);
 	stack = hash_state + beltHash_keep();
-	// загрузить R
-	if (!qrFrom(ecX(R), id_pubkey, ec->f, stack) ||
-		!qrFrom(ecY(R, n), id_pubkey + no, ec->f, stack) ||
-		!ecpIsOnA(R, ec, stack))
+	// загрузить Q
+	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
+		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
+	// belt-hash(oid...)
+	beltHashStart(hash_state);
+	beltHashStepH(oid_der, oid_len, hash_state);
+	// проверить подпись
+	code = bignIdVerifyItem(ec, hash_state, Q, 0, 0, id_hash, hash, id_sig,
+		id_pubkey, stack);
+	// завершение
+	blobClose(state);
+	return code;
+}
+
+/*
+*******************************************************************************
+Пакетная проверка идентификационных ЭЦП
+
+Описание кривой, открытый ключ Q и хэширование oid_der подготавливаются
+один раз. Если в пакете не меньше BIGN_BATCH_MIN подписей, то для точек
+G и Q строятся таблицы гребенчатого метода (см. bignIdVerifyMulComb()).
+Каждая подпись проверяется отдельно: в схеме bign-ibs проверяется
+хэш-значение от точки V, и проверочные соотношения разных подписей
+нельзя объединить случайной линейной комбинацией.
+*******************************************************************************
+*/
+
+static size_t bignIdVerifyBatch_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n + 2 * ((SIZE_1 << BIGN_BATCH_W) - 1) * 2 * n) +
+		beltHash_keep() +
+		utilMax(2,
+			ecPreCombA_deep(n, ec_d, ec_deep),
+			bignIdVerifyItem_deep(n, f_deep, ec_d, ec_deep));
+}
+
+err_t bignIdVerifyBatch(err_t codes[], const bign_params* params,
+	const octet oid_der[], size_t oid_len, size_t count,
+	const octet id_hashes[], const octet hashes[], const octet id_sigs[],
+	const octet id_pubkeys[], const octet pubkey[])
+{
+	err_t code;
+	size_t no, n, i;
+	// состояние
+	void* state;
+	ec_o* ec;			/* описание эллиптической кривой */	
+	word* Q;			/* [2n] открытый ключ Q */
+	word* preG;			/* [(2^w - 1) 2n] предвычисления для G */
+	word* preQ;			/* [(2^w - 1) 2n] предвычисления для Q */
+	octet* hash_state;	/* [beltHash_keep] состояние хэширования */
+	octet* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (!bignIsOperable(params))
+		return ERR_BAD_PARAMS;
+	// проверить oid_der
+	if (oid_len == SIZE_MAX || oidFromDER(0, oid_der, oid_len)  == SIZE_MAX)
+		return ERR_BAD_OID;
+	// проверить codes
+	if (!memIsNullOrValid(codes, count * sizeof(err_t)))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignIdVerifyBatch_deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	ASSERT(n % 2 == 0);
+	// проверить входные указатели
+	if (!memIsValid(id_hashes, count * no) ||
+		!memIsValid(hashes, count * no) ||
+		!memIsValid(id_sigs, count * (no + no / 2)) ||
+		!memIsValid(id_pubkeys, count * 2 * no) ||
+		!memIsValid(pubkey, 2 * no))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	Q = objEnd(ec, word);
+	preG = Q + 2 * n;
+	preQ = preG + ((SIZE_1 << BIGN_BATCH_W) - 1) * 2 * n;
+	hash_state = (octet*)(preQ + ((SIZE_1 << BIGN_BATCH_W) - 1) * 2 * n);
+	stack = hash_state + beltHash_keep();
 	// загрузить Q
 	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
 		!qrFrom(ecY(Q, n), pubkey + no, ec->f, stack))
@@ -471,54 +705,34 @@ err_t bignIdVerify(const bign_params* params, const octet oid_der[],
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
-	// загрузить и проверить s1
-	wwFrom(s1, id_sig + no / 2, no);
-	if (wwCmp(s1, ec->order, n) >= 0)
+	// предвычисления
+	if (count < BIGN_BATCH_MIN)
+		preG = preQ = 0;
+	else if (!ecPreCombA(preG, ec->base, ec, BIGN_BATCH_W, n, stack) ||
+		!ecPreCombA(preQ, Q, ec, BIGN_BATCH_W, n, stack))
 	{
+		// Q -- точка малого порядка
 		blobClose(state);
-		return ERR_BAD_SIG;
-	}
-	// s1 <- (s1 + H) mod q
-	wwFrom(t, hash, no);
-	if (wwCmp(t, ec->order, n) >= 0)
-	{
-		zzSub2(t, ec->order, n);
-		// 2^{l - 1} < q < 2^l, H < 2^l => H - q < q
-		ASSERT(wwCmp(t, ec->order, n) < 0);
+		return ERR_BAD_PUBKEY;
 	}
-	zzAddMod(s1, s1, t, ec->order, n);
-	// загрузить s0
-	wwFrom(s0, id_sig, no / 2);
-	s0[n / 2] = 1;
 	// belt-hash(oid...)
 	beltHashStart(hash_state);
 	beltHashStepH(oid_der, oid_len, hash_state);
-	// t <- belt-hash(oid || R || H0) mod 2^l
-	memCopy(stack, hash_state, beltHash_keep());
-	beltHashStepH(id_pubkey, no, stack);
-	beltHashStepH(id_hash, no, stack);
-	beltHashStepG2((octet*)t, no / 2, stack);
-	wwFrom(t, t, no / 2);
-	// t1 <- -(t + 2^l)(s0 + 2^l) mod q
-	zzMul(t1, t, n / 2, s0, n / 2, stack);
-	t1[n] = zzAdd2(t1 + n / 2, t, n / 2);
-	t1[n] += zzAdd2(t1 + n / 2, s0, n / 2);
-	++t1[n];
-	zzMod(t1, t1, n + 1, ec->order, n, stack);
-	zzNegMod(t1, t1, ec->order, n);
-	// V <- s1 G + (s0 + 2^l) R + t Q
-	if (!ecAddMulA(V, ec, stack,
-		3, ec->base, s1, n, R, s0, n / 2 + 1, Q, t1, n))
+	// проверить подписи
+	for (i = 0, code = ERR_OK; i < count; ++i)
 	{
-		blobClose(state);
-		return ERR_BAD_SIG;
+		err_t c = bignIdVerifyItem(ec, hash_state, Q, preG, preQ,
+			id_hashes + i * no, hashes + i * no, 
+			id_sigs + i * (no + no / 2), id_pubkeys + i * 2 * no, stack);
+		if (codes)
+			codes[i] = c;
+		if (c != ERR_OK && code == ERR_OK)
+		{
+			code = c;
+			if (!codes)
+				break;
+		}
 	}
-	qrTo((octet*)V, ecX(V), ec->f, stack);
-	// s0 == belt-hash(oid || V || H0 || H) mod 2^l?
-	beltHashStepH(V, no, hash_state);
-	beltHashStepH(id_hash, no, hash_state);
-	beltHashStepH(hash, no, hash_state);
-	code = beltHashStepV2(id_sig, no / 2, hash_state) ? ERR_OK : ERR_BAD_SIG;
 	// завершение
 	blobClose(state);
 	return code;
@@ -4,7 +4,7 @@
 \brief STB 34.101.45 (bign): key transport
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.20
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,6 +13,8 @@
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
+#include "bee2/core/obj.h"
 #include "bee2/core/util.h"
 #include "bee2/crypto/belt.h"
 #include "bee2/crypto/bign.h"
@@ -131,6 +133,285 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Контекст кривой
+
+Контекст содержит описание эллиптической кривой, построенное функцией
+bignStart(), и таблицу pre кратных базовой точки для регулярного
+гребенчатого метода (ecMulSCombA()) с шириной гребенки BIGN_CTX_W.
+
+Контекст не содержит секретных данных и после построения только читается.
+Поэтому его можно использовать одновременно в нескольких потоках.
+*******************************************************************************
+*/
+
+#define BIGN_CTX_W		5		/*< ширина гребенки */
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< описание эллиптической кривой */
+	word* pre;					/*< [2^w * 2 * ec->f->n] кратные G */
+// }
+	size_t l;					/*< уровень стойкости */
+	octet data[];				/*< данные */
+} bign_ctx_o;
+
+#define bignCtxPreCount()\
+	(SIZE_1 << BIGN_CTX_W)
+
+#define bignCtxIsOperable(c)\
+	(objIsOperable(c) && (c)->hdr.p_count == 2 && (c)->hdr.o_count == 1 &&\
+		((c)->l == 128 || (c)->l == 192 || (c)->l == 256) &&\
+		ecIsOperable((c)->ec))
+
+static size_t bignCtx_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(bignCtxPreCount() * 2 * n) +
+		ecPreSCombA_deep(n, ec_d, ec_deep);
+}
+
+size_t bignCtx_keep(size_t l)
+{
+	return sizeof(bign_ctx_o) + bignStart_keep(l, bignCtx_deep);
+}
+
+err_t bignCtxStart(void* ctx, const bign_params* params)
+{
+	err_t code;
+	bign_ctx_o* c = (bign_ctx_o*)ctx;
+	size_t n;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (!bignIsOperable(params))
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(ctx, bignCtx_keep(params->l)))
+		return ERR_BAD_INPUT;
+	// контекст неработоспособен до завершения построения
+	memSetZero(c, sizeof(bign_ctx_o));
+	// создать кривую
+	code = bignStart(c->data, params);
+	ERR_CALL_CHECK(code);
+	c->ec = (ec_o*)c->data;
+	n = c->ec->f->n;
+	// настроить указатели
+	c->pre = objEnd(c->ec, word);
+	// рассчитать кратные G
+	if (!ecPreSCombA(c->pre, c->ec->base, c->ec, BIGN_CTX_W, n,
+		c->pre + bignCtxPreCount() * 2 * n))
+	{
+		memSetZero(c, sizeof(bign_ctx_o));
+		return ERR_BAD_PARAMS;
+	}
+	// настроить заголовок
+	c->hdr.keep = sizeof(bign_ctx_o) + objKeep(c->ec) +
+		O_OF_W(bignCtxPreCount() * 2 * n);
+	c->hdr.p_count = 2;
+	c->hdr.o_count = 1;
+	c->l = params->l;
+	// все нормально
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Создание токенов для нескольких получателей
+
+Одноразовые ключи k получателей вырабатываются заранее в вызывающем потоке,
+поэтому генератор rng не обязан быть потокобезопасным, а токены совпадают 
+с токенами, которые были бы созданы последовательными вызовами 
+bignKeyWrap() с тем же генератором.
+
+Токены создаются рабочими функциями bignKeyWrapWorker(), которые выполняются 
+в нескольких потоках. Рабочие функции выбирают получателей по порядку 
+с помощью атомарного счетчика next. Кратная k G вычисляется регулярным
+гребенчатым методом по таблице контекста, кратная k Q -- функцией ecMulA().
+
+Потоки запускаются, если получателей не меньше BIGN_MT_MIN. Число потоков 
+не превосходит BIGN_MT_MAX и числа процессоров. Если потоки создать 
+не удается, то токены создаются в вызывающем потоке.
+*******************************************************************************
+*/
+
+#define BIGN_MT_MAX		8		/*< максимальное число потоков */
+#define BIGN_MT_MIN		4		/*< минимальное число получателей */
+
+typedef struct
+{
+	const bign_ctx_o* c;	/*< контекст */
+	octet* tokens;			/*< [count * (no + len + 16)] токены */
+	const octet* key;		/*< [len] транспортируемый ключ */
+	size_t len;				/*< длина ключа */
+	const octet* header;	/*< [16] заголовок (или 0) */
+	const octet* pubkeys;	/*< [count * 2 * no] открытые ключи */
+	const word* ks;			/*< [count * n] одноразовые личные ключи */
+	size_t count;			/*< число получателей */
+	octet* stacks;			/*< стеки рабочих функций */
+	size_t deep;			/*< глубина стека рабочей функции */
+	size_t slot;			/*< номер следующего стека */
+	size_t next;			/*< номер следующего получателя */
+	size_t failed;			/*< признак ошибки */
+} bign_wrap_st;
+
+static size_t bignKeyWrapWorker_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) + 32 +
+		utilMax(3,
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, n),
+			beltKWP_keep());
+}
+
+static void bignKeyWrapWorker(void* arg)
+{
+	bign_wrap_st* w = (bign_wrap_st*)arg;
+	const ec_o* ec = w->c->ec;
+	const size_t no = ec->f->no;
+	const size_t n = ec->f->n;
+	size_t i;
+	// переменные в stack
+	word* R;				/* [2n] точка R */
+	octet* theta;			/* [32] ключ защиты */
+	void* stack;
+	// раскладка stack
+	R = (word*)(w->stacks + (mtAtomicIncr(&w->slot) - 1) * w->deep);
+	theta = (octet*)(R + 2 * n);
+	stack = theta + 32;
+	// цикл по получателям
+	while (1)
+	{
+		const word* k;
+		octet* token;
+		i = mtAtomicIncr(&w->next) - 1;
+		if (i >= w->count || mtAtomicCmpSwap(&w->failed, 0, 0))
+			break;
+		k = w->ks + i * n;
+		token = w->tokens + i * (no + w->len + 16);
+		// R <- k Q
+		qrFrom(ecX(R), w->pubkeys + i * 2 * no, ec->f, stack);
+		qrFrom(ecY(R, n), w->pubkeys + i * 2 * no + no, ec->f, stack);
+		if (!ecMulA(R, R, ec, k, n, stack))
+		{
+			mtAtomicCmpSwap(&w->failed, 0, 1);
+			break;
+		}
+		// theta <- <R>_{256}
+		qrTo(theta, ecX(R), ec->f, stack);
+		// R <- k G
+		if (!ecMulSCombA(R, w->c->pre, ec, BIGN_CTX_W, k, n, stack))
+		{
+			mtAtomicCmpSwap(&w->failed, 0, 1);
+			break;
+		}
+		qrTo(token, ecX(R), ec->f, stack);
+		// сформировать блок и зашифровать
+		memCopy(token + no, w->key, w->len);
+		if (w->header)
+			memCopy(token + no + w->len, w->header, 16);
+		else
+			memSetZero(token + no + w->len, 16);
+		beltKWPStart(stack, theta, 32);
+		beltKWPStepE(token + no, w->len + 16, stack);
+	}
+}
+
+err_t bignKeyWrapBatch(octet tokens[], const void* ctx, const octet key[],
+	size_t len, const octet header[16], size_t count, const octet pubkeys[],
+	gen_i rng, void* rng_state)
+{
+	const bign_ctx_o* c = (const bign_ctx_o*)ctx;
+	size_t no, n, threads, started, i;
+	mt_thrd_t thrds[BIGN_MT_MAX];
+	bign_wrap_st w[1];
+	// состояние
+	void* state;
+	word* ks;				/* [count * n] одноразовые личные ключи */
+	word* t;				/* [n] координата */
+	octet* stack;
+	// проверить входные данные
+	if (!bignCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// размерности
+	no = c->ec->f->no;
+	n = c->ec->f->n;
+	// проверить входные указатели
+	if (len < 16 ||
+		!memIsValid(key, len) ||
+		!memIsNullOrValid(header, 16) ||
+		!memIsValid(pubkeys, count * 2 * no) ||
+		!memIsValid(tokens, count * (no + len + 16)))
+		return ERR_BAD_INPUT;
+	if (!memIsDisjoint2(tokens, count * (no + len + 16), key, len) ||
+		(header && !memIsDisjoint2(tokens, count * (no + len + 16), 
+			header, 16)))
+		return ERR_BAD_INPUT;
+	// число потоков
+	if (count < BIGN_MT_MIN)
+		threads = 1;
+	else
+	{
+		threads = mtThrdHWCount();
+		threads = MIN2(threads, BIGN_MT_MAX);
+		threads = MIN2(threads, count);
+	}
+	// создать состояние
+	w->deep = bignKeyWrapWorker_deep(n, c->ec->f->deep, c->ec->d, 
+		c->ec->deep);
+	state = blobCreate(O_OF_W(count * n + n) + 
+		utilMax(2, threads * w->deep, c->ec->f->deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	ks = (word*)state;
+	t = ks + count * n;
+	stack = (octet*)(t + n);
+	// проверить открытые ключи
+	for (i = 0; i < count; ++i)
+		if (!qrFrom(t, pubkeys + i * 2 * no, c->ec->f, stack) ||
+			!qrFrom(t, pubkeys + i * 2 * no + no, c->ec->f, stack))
+		{
+			blobClose(state);
+			return ERR_BAD_PUBKEY;
+		}
+	// сгенерировать одноразовые ключи
+	for (i = 0; i < count; ++i)
+		if (!zzRandNZMod(ks + i * n, c->ec->order, n, rng, rng_state))
+		{
+			blobClose(state);
+			return ERR_BAD_RNG;
+		}
+	// подготовить задание
+	w->c = c;
+	w->tokens = tokens;
+	w->key = key;
+	w->len = len;
+	w->header = header;
+	w->pubkeys = pubkeys;
+	w->ks = ks;
+	w->count = count;
+	w->stacks = stack;
+	w->slot = w->next = w->failed = 0;
+	// запустить потоки
+	for (started = 0; started + 1 < threads; ++started)
+		if (!mtThrdCreate(thrds + started, bignKeyWrapWorker, w))
+			break;
+	// участвовать в обработке
+	bignKeyWrapWorker(w);
+	// дождаться завершения
+	for (i = 0; i < started; ++i)
+		mtThrdJoin(thrds + i);
+	// завершение
+	blobClose(state);
+	return w->failed ? ERR_BAD_PARAMS : ERR_OK;
+}
+
 /*
 *******************************************************************************
 Разбор токена
@@ -4,7 +4,7 @@
 \brief STB 34.101.47/botp: OTP algorithms
 \project bee2 [cryptographic library]
 \created 2015.11.02
-\version 2020.03.24
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -58,13 +58,12 @@ static const u32 powers_of_10[10] = {
 	1000000000u,
 };
 
-void botpDT(char* otp, size_t digit, const octet mac[], size_t mac_len)
+static u32 botpDTU32(size_t digit, const octet mac[], size_t mac_len)
 {
 	register u32 pwd;
 	register size_t offset;
 	ASSERT(mac_len >= 20);
 	ASSERT(4 <= digit && digit <= 9);
-	ASSERT(memIsValid(otp, digit + 1));
 	ASSERT(memIsValid(mac, mac_len));
 	offset = mac[mac_len - 1] & 15;
 	pwd = mac[offset], pwd <<= 8;
@@ -73,11 +72,28 @@ void botpDT(char* otp, size_t digit, const octet mac[], size_t mac_len)
 	pwd ^= mac[offset + 3];
 	pwd &= 0x7FFFFFFF;
 	pwd %= powers_of_10[digit];
-	decFromU32(otp, digit, pwd);
 	offset = 0;
+	return pwd;
+}
+
+void botpDT(char* otp, size_t digit, const octet mac[], size_t mac_len)
+{
+	register u32 pwd;
+	ASSERT(memIsValid(otp, digit + 1));
+	pwd = botpDTU32(digit, mac, mac_len);
+	decFromU32(otp, digit, pwd);
 	pwd = 0;
 }
 
+static bool_t botpOTPToU32(u32* pwd, const char* otp, size_t digit)
+{
+	ASSERT(strIsValid(otp));
+	if (strLen(otp) != digit || !decIsValid(otp))
+		return FALSE;
+	*pwd = decToU32(otp);
+	return TRUE;
+}
+
 static void botpTimeToCtr(octet ctr[8], tm_time_t t)
 {
 	ASSERT(sizeof(t) <= 8);
@@ -103,6 +119,138 @@ void botpCtrNext(octet ctr[8])
 	carry = 0;
 }
 
+/*
+*******************************************************************************
+Ключезависимое хэширование счетчиков
+
+В режимах HOTP и TOTP имитовставка вычисляется от 8-октетного счетчика на
+одном и том же ключе. Поэтому переменные (h, s) внутреннего и внешнего
+хэширования после обработки блоков key ^ ipad и key ^ opad вычисляются один
+раз в botpHMACStart() и затем только копируются. Вычисление имитовставки
+сводится к двум сжатиям во внутреннем хэшировании (блок счетчика и блок длины
+320 = 256 + 64 битов) и двум сжатиям во внешнем (блок h и блок длины
+512 битов).
+
+Функция botpHMACStepPair() вычисляет имитовставки двух счетчиков, выполняя
+сжатия обоих вычислений парами (beltCompr2Pair(), beltComprPair()).
+Этим пользуются функции проверки паролей в окне.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	u32 h_in[8];		/*< переменная h внутреннего хэширования */
+	u32 s_in[4];		/*< переменная s внутреннего хэширования */
+	u32 h_out[8];		/*< переменная h внешнего хэширования */
+	u32 s_out[4];		/*< переменная s внешнего хэширования */
+} botp_hmac_st;
+
+static size_t botpHMAC_deep()
+{
+	return utilMax(2,
+		32 + utilMax(2, beltHash_keep(), beltCompr_deep()),
+		6 * 32 + beltComprPair_deep());
+}
+
+static void botpHMACStart(botp_hmac_st* hm, const octet key[],
+	size_t key_len, void* stack)
+{
+	u32* k = (u32*)stack;
+	size_t i;
+	stack = k + 8;
+	// k <- key || 0
+	if (key_len <= 32)
+	{
+		memCopy(k, key, key_len);
+		memSetZero((octet*)k + key_len, 32 - key_len);
+	}
+	// k <- beltHash(key)
+	else
+	{
+		beltHashStart(stack);
+		beltHashStepH(key, key_len, stack);
+		beltHashStepG((octet*)k, stack);
+	}
+	u32From(k, k, 32);
+	// начать внутреннее хэширование [key ^ ipad]
+	for (i = 0; i < 8; ++i)
+		k[i] ^= 0x36363636;
+	u32From(hm->h_in, beltH(), 32);
+	memSetZero(hm->s_in, sizeof(hm->s_in));
+	beltCompr2(hm->s_in, hm->h_in, k, stack);
+	// начать внешнее хэширование [key ^ opad, 0x36 ^ 0x5C == 0x6A]
+	for (i = 0; i < 8; ++i)
+		k[i] ^= 0x6A6A6A6A;
+	u32From(hm->h_out, beltH(), 32);
+	memSetZero(hm->s_out, sizeof(hm->s_out));
+	beltCompr2(hm->s_out, hm->h_out, k, stack);
+	// очистить ключ
+	memWipe(k, 32);
+}
+
+static void botpHMACStep(octet mac[32], const octet ctr[8],
+	const botp_hmac_st* hm, void* stack)
+{
+	u32* ls = (u32*)stack;
+	u32* h = ls + 8;
+	u32* x = h + 8;
+	stack = x + 8;
+	// внутреннее хэширование: блок ctr || 0, блок [4]len || [4]s
+	u32From(x, ctr, 8);
+	memSetZero(x + 2, 24);
+	memSetZero(ls, 16), ls[0] = 320;
+	memCopy(ls + 4, hm->s_in, 16);
+	memCopy(h, hm->h_in, 32);
+	beltCompr2(ls + 4, h, x, stack);
+	beltCompr(h, ls, stack);
+	// внешнее хэширование: блок h, блок [4]len || [4]s
+	memCopy(x, h, 32);
+	ls[0] = 512;
+	memCopy(ls + 4, hm->s_out, 16);
+	memCopy(h, hm->h_out, 32);
+	beltCompr2(ls + 4, h, x, stack);
+	beltCompr(h, ls, stack);
+	// возврат
+	u32To(mac, 32, h);
+}
+
+static void botpHMACStepPair(octet mac[32], const octet ctr[8],
+	octet mac1[32], const octet ctr1[8], const botp_hmac_st* hm, void* stack)
+{
+	u32* ls = (u32*)stack;
+	u32* h = ls + 8;
+	u32* x = h + 8;
+	u32* ls1 = x + 8;
+	u32* h1 = ls1 + 8;
+	u32* x1 = h1 + 8;
+	stack = x1 + 8;
+	// внутреннее хэширование
+	u32From(x, ctr, 8);
+	memSetZero(x + 2, 24);
+	u32From(x1, ctr1, 8);
+	memSetZero(x1 + 2, 24);
+	memSetZero(ls, 16), ls[0] = 320;
+	memCopy(ls + 4, hm->s_in, 16);
+	memCopy(ls1, ls, 32);
+	memCopy(h, hm->h_in, 32);
+	memCopy(h1, hm->h_in, 32);
+	beltCompr2Pair(ls + 4, h, x, ls1 + 4, h1, x1, stack);
+	beltComprPair(h, ls, h1, ls1, stack);
+	// внешнее хэширование
+	memCopy(x, h, 32);
+	memCopy(x1, h1, 32);
+	ls[0] = 512;
+	memCopy(ls + 4, hm->s_out, 16);
+	memCopy(ls1, ls, 32);
+	memCopy(h, hm->h_out, 32);
+	memCopy(h1, hm->h_out, 32);
+	beltCompr2Pair(ls + 4, h, x, ls1 + 4, h1, x1, stack);
+	beltComprPair(h, ls, h1, ls1, stack);
+	// возврат
+	u32To(mac, 32, h);
+	u32To(mac1, 32, h1);
+}
+
 /*
 *******************************************************************************
 Режим HOTP
@@ -114,14 +262,17 @@ typedef struct
 	size_t digit;		/*< число цифр в пароле */
 	octet ctr[8];		/*< счетчик */
 	octet ctr1[8];		/*< копия счетчика */
+	octet ctr2[8];		/*< счетчик второго вычисления пары */
+	botp_hmac_st hm;	/*< переменные хэширования */
 	octet mac[32];		/*< имитовставка */
+	octet mac1[32];		/*< имитовставка второго вычисления пары */
 	char otp[10];		/*< текущий пароль */
-	octet stack[];		/*< [2 * beltHMAC_deep()] */
+	octet stack[];		/*< [botpHMAC_deep()] */
 } botp_hotp_st;
 
 size_t botpHOTP_keep()
 {
-	return sizeof(botp_hotp_st) + 2 * beltHMAC_keep();
+	return sizeof(botp_hotp_st) + botpHMAC_deep();
 }
 
 void botpHOTPStart(void* state, size_t digit, const octet key[], 
@@ -131,7 +282,7 @@ void botpHOTPStart(void* state, size_t digit, const octet key[],
 	ASSERT(6 <= digit && digit <= 8);
 	ASSERT(memIsDisjoint2(key, key_len, state, botpHOTP_keep()));
 	st->digit = digit;
-	beltHMACStart(st->stack + beltHMAC_keep(), key, key_len);
+	botpHMACStart(&st->hm, key, key_len, st->stack);
 }
 
 void botpHOTPStepS(void* state, const octet ctr[8])
@@ -148,9 +299,7 @@ void botpHOTPStepR(char* otp, void* state)
 	ASSERT(memIsDisjoint2(otp, st->digit + 1, state, botpHOTP_keep()) || 
 		otp == st->otp);
 	// вычислить имитовставку
-	memCopy(st->stack, st->stack + beltHMAC_keep(), beltHMAC_keep());
-	beltHMACStepA(st->ctr, 8, st->stack);
-	beltHMACStepG(st->mac, st->stack);
+	botpHMACStep(st->mac, st->ctr, &st->hm, st->stack);
 	// построить пароль
 	botpDT(otp, st->digit, st->mac, 32);
 	// инкремент счетчика
@@ -174,6 +323,52 @@ bool_t botpHOTPStepV(const char* otp, void* state)
 	return FALSE;
 }
 
+bool_t botpHOTPStepVW(const char* otp, size_t window, void* state)
+{
+	botp_hotp_st* st = (botp_hotp_st*)state;
+	size_t found = SIZE_MAX;
+	size_t i;
+	u32 pwd;
+	// pre
+	ASSERT(strIsValid(otp));
+	ASSERT(memIsDisjoint2(otp, strLen(otp) + 1, state, botpHOTP_keep()));
+	// некорректный пароль?
+	if (!botpOTPToU32(&pwd, otp, st->digit))
+		return FALSE;
+	// сохранить счетчик
+	memCopy(st->ctr1, st->ctr, 8);
+	// просмотреть окно парами счетчиков до первой пары с совпадением
+	for (i = 0; i + 1 < window && found == SIZE_MAX; i += 2)
+	{
+		memCopy(st->ctr2, st->ctr, 8);
+		botpCtrNext(st->ctr2);
+		botpHMACStepPair(st->mac, st->ctr, st->mac1, st->ctr2, &st->hm,
+			st->stack);
+		if (botpDTU32(st->digit, st->mac, 32) == pwd && found == SIZE_MAX)
+			found = i;
+		if (botpDTU32(st->digit, st->mac1, 32) == pwd && found == SIZE_MAX)
+			found = i + 1;
+		memCopy(st->ctr, st->ctr2, 8);
+		botpCtrNext(st->ctr);
+	}
+	// последний непарный счетчик
+	if (i < window && found == SIZE_MAX)
+	{
+		botpHMACStep(st->mac, st->ctr, &st->hm, st->stack);
+		if (botpDTU32(st->digit, st->mac, 32) == pwd && found == SIZE_MAX)
+			found = i;
+	}
+	pwd = 0;
+	// вернуться к первоначальному счетчику
+	memCopy(st->ctr, st->ctr1, 8);
+	if (found == SIZE_MAX)
+		return FALSE;
+	// перейти к счетчику, следующему за подошедшим
+	for (++found; found--;)
+		botpCtrNext(st->ctr);
+	return TRUE;
+}
+
 void botpHOTPStepG(octet ctr[8], const void* state)
 {
 	const botp_hotp_st* st = (const botp_hotp_st*)state;
@@ -231,21 +426,63 @@ err_t botpHOTPVerify(const char* otp, const octet key[], size_t key_len,
 /*
 *******************************************************************************
 Режим TOTP
+
+Отметки окна перебираются в порядке t, t - 1, t + 1, t - 2, t + 2,... и
+проверяются парами: отметка откладывается до появления следующей, после
+чего для обеих вычисляется botpHMACStepPair(). После пары с совпадением
+перебор прекращается.
+
+Отметка t +- i строится в botpTimeShift() только тогда, когда сдвиг
+представим в tm_time_t и результат не выходит за пределы
+[0, BOTP_TIME_MAX] (назад) или [t, BOTP_TIME_MAX] (вперед). Проверки
+выполняются до сложения / вычитания, так что переполнение знакового
+tm_time_t не возникает. Значение TIME_ERR в качестве отметки исключается.
 *******************************************************************************
 */
 
+#define BOTP_TIME_MAX\
+	(TIME_ERR < TIME_0 ?\
+		((TIME_1 << (8 * sizeof(tm_time_t) - 2)) - TIME_1) * 2 + TIME_1 :\
+		TIME_ERR - TIME_1)
+
+static bool_t botpTimeShift(tm_time_t* t1, tm_time_t t, size_t i, bool_t fwd)
+{
+	tm_time_t d = (tm_time_t)i;
+	// сдвиг не представим?
+	if (d < TIME_0 || (size_t)d != i)
+		return FALSE;
+	// t + d
+	if (fwd)
+	{
+		if (t > BOTP_TIME_MAX - d)
+			return FALSE;
+		*t1 = t + d;
+	}
+	// t - d
+	else
+	{
+		if (d > t)
+			return FALSE;
+		*t1 = t - d;
+	}
+	return *t1 != TIME_ERR;
+}
+
 typedef struct
 {
 	size_t digit;		/*< число цифр в пароле */
 	octet t[8];			/*< округленная отметка времени */
+	octet t1[8];		/*< отметка второго вычисления пары */
+	botp_hmac_st hm;	/*< переменные хэширования */
 	octet mac[32];		/*< имитовставка */
+	octet mac1[32];		/*< имитовставка второго вычисления пары */
 	char otp[10];		/*< текущий пароль */
-	octet stack[];		/*< [2 * beltHMAC_deep()] */
+	octet stack[];		/*< [botpHMAC_deep()] */
 } botp_totp_st;
 
 size_t botpTOTP_keep()
 {
-	return sizeof(botp_totp_st) + 2 * beltHMAC_keep();
+	return sizeof(botp_totp_st) + botpHMAC_deep();
 }
 
 void botpTOTPStart(void* state, size_t digit, const octet key[], 
@@ -255,7 +492,7 @@ void botpTOTPStart(void* state, size_t digit, const octet key[],
 	ASSERT(6 <= digit && digit <= 8);
 	ASSERT(memIsDisjoint2(key, key_len, state, botpTOTP_keep()));
 	st->digit = digit;
-	beltHMACStart(st->stack + beltHMAC_keep(), key, key_len);
+	botpHMACStart(&st->hm, key, key_len, st->stack);
 }
 
 void botpTOTPStepR(char* otp, tm_time_t t, void* state)
@@ -263,13 +500,11 @@ void botpTOTPStepR(char* otp, tm_time_t t, void* state)
 	botp_totp_st* st = (botp_totp_st*)state;
 	// pre
 	ASSERT(t != TIME_ERR);
-	ASSERT(memIsDisjoint2(otp, st->digit + 1, state, botpHOTP_keep()) || 
+	ASSERT(memIsDisjoint2(otp, st->digit + 1, state, botpTOTP_keep()) ||
 		otp == st->otp);
 	// вычислить имитовставку
-	memCopy(st->stack, st->stack + beltHMAC_keep(), beltHMAC_keep());
 	botpTimeToCtr(st->t, t);
-	beltHMACStepA(st->t, 8, st->stack);
-	beltHMACStepG(st->mac, st->stack);
+	botpHMACStep(st->mac, st->t, &st->hm, st->stack);
 	// построить пароль
 	botpDT(otp, st->digit, st->mac, 32);
 }
@@ -286,6 +521,82 @@ bool_t botpTOTPStepV(const char* otp, tm_time_t t, void* state)
 	return strEq(st->otp, otp);
 }
 
+static void botpTOTPStepW(tm_time_t* found, tm_time_t* tp, tm_time_t t1,
+	u32 pwd, botp_totp_st* st)
+{
+	// совпадение уже найдено?
+	if (*found != TIME_ERR)
+		return;
+	// отложить отметку?
+	if (*tp == TIME_ERR && t1 != TIME_ERR)
+	{
+		*tp = t1;
+		return;
+	}
+	// одиночная отложенная отметка?
+	if (t1 == TIME_ERR)
+	{
+		ASSERT(*tp != TIME_ERR);
+		botpTimeToCtr(st->t, *tp);
+		botpHMACStep(st->mac, st->t, &st->hm, st->stack);
+		if (botpDTU32(st->digit, st->mac, 32) == pwd && *found == TIME_ERR)
+			*found = *tp;
+	}
+	// пара отметок
+	else
+	{
+		botpTimeToCtr(st->t, *tp);
+		botpTimeToCtr(st->t1, t1);
+		botpHMACStepPair(st->mac, st->t, st->mac1, st->t1, &st->hm,
+			st->stack);
+		if (botpDTU32(st->digit, st->mac, 32) == pwd && *found == TIME_ERR)
+			*found = *tp;
+		if (botpDTU32(st->digit, st->mac1, 32) == pwd && *found == TIME_ERR)
+			*found = t1;
+	}
+	*tp = TIME_ERR;
+}
+
+bool_t botpTOTPStepVW(tm_time_t* ts, const char* otp, tm_time_t t, 
+	size_t back, size_t fwd, void* state)
+{
+	botp_totp_st* st = (botp_totp_st*)state;
+	tm_time_t found = TIME_ERR;
+	tm_time_t tp = TIME_ERR;
+	tm_time_t t1;
+	size_t i;
+	u32 pwd;
+	// pre
+	ASSERT(strIsValid(otp));
+	ASSERT(t != TIME_ERR);
+	ASSERT(memIsDisjoint2(otp, strLen(otp) + 1, state, botpTOTP_keep()));
+	ASSERT(memIsNullOrValid(ts, sizeof(tm_time_t)));
+	// некорректный пароль?
+	if (!botpOTPToU32(&pwd, otp, st->digit))
+		return FALSE;
+	// просмотреть окно t, t - 1, t + 1,... до первой пары с совпадением
+	for (i = 0; i <= MAX2(back, fwd) && found == TIME_ERR; ++i)
+	{
+		// шаг назад
+		if (i <= back && botpTimeShift(&t1, t, i, FALSE))
+			botpTOTPStepW(&found, &tp, t1, pwd, st);
+		// шаг вперед
+		if (0 < i && i <= fwd && botpTimeShift(&t1, t, i, TRUE))
+			botpTOTPStepW(&found, &tp, t1, pwd, st);
+		// окно исчерпано?
+		if (i == SIZE_MAX)
+			break;
+	}
+	// последняя непарная отметка
+	if (tp != TIME_ERR)
+		botpTOTPStepW(&found, &tp, TIME_ERR, pwd, st);
+	pwd = 0;
+	// возврат
+	if (ts)
+		*ts = found;
+	return found != TIME_ERR;
+}
+
 err_t botpTOTPRand(char* otp, size_t digit, const octet key[], size_t key_len, 
 	tm_time_t t)
 {
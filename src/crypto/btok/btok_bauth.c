@@ -4,7 +4,7 @@
 \brief STB 34.101.79 (btok): BAUTH protocol
 \project bee2 [cryptographic library]
 \created 2022.02.22
-\version 2023.09.20
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -77,9 +77,7 @@ typedef struct
 	bign_params params[1];		/*< параметры */
 	bake_settings settings[1];	/*< настройки */
 	bake_cert cert[1];			/*< сертификат */
-	octet K0[32];				/*< ключ K0 */
-	octet K1[32];				/*< ключ K1 */
-	octet K2[32];				/*< ключ K2 */
+	octet K[3][32];				/*< ключи K0, K1, K2 */
 	octet data[];				/*< данные */
 } bake_bauth_t_o;
 
@@ -401,23 +399,14 @@ err_t btokBAuthTStep3(octet out[], const octet in[], void* state)
 		beltHashStepH(s->settings->hellob, s->settings->hellob_len, stack);
 	ASSERT(no >= 32);
 	beltHashStepG(Y, stack);
-	// K0 <- beltKRP(Y, 1^96, 0)
+	// K0, K1 <- beltKRP(Y, 1^96, 0), beltKRP(Y, 1^96, 1)
+	// K2 <- beltKRP(Y, 1^96, 2)
 	memSetZero(block0, 16);
 	memSet(block1, 0xFF, 16);
 	beltKRPStart(stack, Y, 32, block1);
-	beltKRPStepG(s->K0, 32, block0, stack);
-	if (s->settings->kcb)
-	{
-	    // K2 <- beltKRP(Y, 1^96, 2)
-		block0[0] = 2;
-		beltKRPStepG(s->K2, 32, block0, stack);
-	}
-	// K1 <- beltKRP(Y, 1^96, 1)
-	block0[0] = 1;
-	beltKRPStepG(s->K1, 32, block0, stack);
+	beltKRPStepGN(s->K[0], 32, block0, s->settings->kcb ? 3 : 2, stack);
 	// Tt <- beltMAC(0^128, K1)
-	block0[0] = 0;
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(block0, 16, stack);
 	// out <- Tt
 	beltMACStepG(out, stack);
@@ -574,7 +563,7 @@ err_t btokBAuthTStep5(const octet in[], size_t in_len, bake_certval_i val_ct,
 	t = (word*)V;
 	stack = V + no;
 	// Tct == beltMAC(Zct, K1)?
-	beltMACStart(stack, s->K1, 32);
+	beltMACStart(stack, s->K[1], 32);
 	beltMACStepA(in, in_len - 8, stack);
 	beltMACStepG(mac, stack);
 	if (!beltMACStepV(in + in_len - 8, stack))
@@ -588,7 +577,7 @@ err_t btokBAuthTStep5(const octet in[], size_t in_len, bake_certval_i val_ct,
 			return ERR_OUTOFMEMORY;
 		memCopy(Zct, in, in_len);
 		memSet(block0, 0, 16);
-		beltCFBStart(stack, s->K2, 32, block0);
+		beltCFBStart(stack, s->K[2], 32, block0);
 		beltCFBStepD(Zct, in_len, stack);
 		// sct \in {0, 1,..., q - 1}?
 		wwFrom(sct, Zct, no);
@@ -683,7 +672,7 @@ err_t btokBAuthTStepG(octet key[32], void* state)
 		!memIsValid(key, 32))
 		return ERR_BAD_INPUT;
 	// key <- K0
-	memCopy(key, s->K0, 32);
+	memCopy(key, s->K[0], 32);
 	// все нормально
 	return ERR_OK;
 }
@@ -4,7 +4,7 @@
 \brief STB 34.101.79 (btok): Secure Messaging
 \project bee2 [cryptographic library]
 \created 2022.10.31
-\version 2023.06.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -27,20 +27,30 @@
   key1 <- belt-keyrep(key, 0, <1>, 256)
   key2 <- belt-keyrep(key, 0, <2>, 256)
   ctr <- 0
+
+Ключи не хранятся в исходном виде. Вместо key1 хранится состояние belt-mac
+непосредственно после beltMACStart(key1), вместо key2 -- форматированный 
+ключ belt-block. При обработке очередного APDU состояние belt-mac копируется
+в стек, а шифрование belt-cfb выполняется напрямую с помощью beltBlockEncr().
+Тем самым ключи не разбираются заново при обработке каждого APDU.
 *******************************************************************************
 */
 
 typedef struct {
-	octet key1[32];		/*!< ключ belt-mac */
-	octet key2[32];		/*!< ключ belt-cfb */
+	u32 key2[8];		/*!< форматированный ключ belt-cfb */
 	octet ctr[16];		/*!< счетчик */
-	octet stack[];		/*!< стек */
+	octet block[16];	/*!< гамма belt-cfb */
+	size_t reserved;	/*!< использовано октетов гаммы */
+	octet stack[];		/*!< [beltMAC_keep()] belt-mac(key1) || стек */
 } btok_sm_st;
 
+#define btokSMMac0(st) ((st)->stack)
+#define btokSMStack(st) ((st)->stack + beltMAC_keep())
+
 size_t btokSM_keep()
 {
-	return sizeof(btok_sm_st) + utilMax(3,
-		beltKRP_keep(), beltMAC_keep(), beltCFB_keep());
+	return sizeof(btok_sm_st) + beltMAC_keep() + 
+		utilMax(2, beltKRP_keep(), beltMAC_keep());
 }
 
 void btokSMStart(void* state, const octet key[32])
@@ -50,11 +60,16 @@ void btokSMStart(void* state, const octet key[32])
 	ASSERT(memIsDisjoint2(key, 32, state, btokSM_keep()));
 	// key_i <- belt-keyrep(key, 0, <i>, 32);
 	memSetZero(st->ctr, 16);
-	beltKRPStart(st->stack, key, 32, st->ctr);
+	beltKRPStart(btokSMStack(st), key, 32, st->ctr);
+	// belt-mac(key1)
 	st->ctr[0] = 1;
-	beltKRPStepG(st->key1, 32, st->ctr, st->stack);
+	beltKRPStepG((octet*)st->key2, 32, st->ctr, btokSMStack(st));
+	beltMACStart(btokSMMac0(st), (octet*)st->key2, 32);
+	// belt-block(key2)
 	st->ctr[0] = 2;
-	beltKRPStepG(st->key2, 32, st->ctr, st->stack);
+	beltKRPStepG((octet*)st->key2, 32, st->ctr, btokSMStack(st));
+	beltKeyExpand2(st->key2, (octet*)st->key2, 32);
+	memWipe(btokSMStack(st), beltKRP_keep());
 	// ctr <- 0
 	st->ctr[0] = 0;
 }
@@ -74,30 +89,62 @@ void btokSMCtrInc(void* state)
 
 /*
 *******************************************************************************
-APDU
+Шифрование belt-cfb
+
+Данные зашифровываются (расшифровываются) фрагментами. Гамма и число 
+использованных октетов гаммы сохраняются в состоянии между фрагментами. 
+Синхропосылкой служит счетчик.
+
+При зашифровании фрагмента имитовставка вычисляется в том же проходе: 
+очередная порция шифртекста, пока она находится в кэше, сразу же 
+обрабатывается функцией beltMACStepA().
 *******************************************************************************
 */
 
-static size_t apduCmdCDFLenLen(const apdu_cmd_t* cmd)
+#define BTOK_SM_PORTION 256
+
+static void btokSMCFBStart(btok_sm_st* st)
 {
-	ASSERT(apduCmdIsValid(cmd));
-	if (cmd->cdf_len == 0)
-		return 0;
-	if (cmd->cdf_len < 256 && cmd->rdf_len <= 256)
-		return 1;
-	return 3;
+	memCopy(st->block, st->ctr, 16);
+	st->reserved = 16;
 }
 
-static size_t apduCmdRDFLenLen(const apdu_cmd_t* cmd)
+static void btokSMCFBStepX(octet dest[], const octet src[], size_t count,
+	btok_sm_st* st, bool_t encr)
 {
-	ASSERT(apduCmdIsValid(cmd));
-	if (cmd->rdf_len == 0)
-		return 0;
-	if (cmd->cdf_len < 256 && cmd->rdf_len <= 256)
-		return 1;
-	if (cmd->cdf_len != 0)
-		return 2;
-	return 3;
+	size_t c;
+	while (count)
+	{
+		if (st->reserved == 16)
+		{
+			beltBlockEncr(st->block, st->key2);
+			st->reserved = 0;
+		}
+		c = MIN2(16 - st->reserved, count);
+		if (encr)
+		{
+			memXor(dest, src, st->block + st->reserved, c);
+			memCopy(st->block + st->reserved, dest, c);
+		}
+		else
+		{
+			memXor(dest, src, st->block + st->reserved, c);
+			memXor2(st->block + st->reserved, dest, c);
+		}
+		st->reserved += c, dest += c, src += c, count -= c;
+	}
+}
+
+static void btokSMCFBStepEA(octet dest[], const octet src[], size_t count,
+	btok_sm_st* st, void* mac_state)
+{
+	size_t c;
+	for (; count; dest += c, src += c, count -= c)
+	{
+		c = MIN2(count, BTOK_SM_PORTION);
+		btokSMCFBStepX(dest, src, c, st, TRUE);
+		beltMACStepA(dest, c, mac_state);
+	}
 }
 
 /*
@@ -132,47 +179,56 @@ len(CDF*) < 256. Форма кодирования len(CDF*) повышаетс
 
 #define apduCmdSizeof(cmd) (sizeof(apdu_cmd_t) + (cmd)->cdf_len)
 
-err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
-	void* state)
+static err_t btokSMCmdWrapInternal(octet apdu[], size_t* count,
+	const octet hdr[4], size_t rdf_len, const btok_sm_frag cdf[], size_t n,
+	btok_sm_st* st)
 {
+	size_t len;
 	size_t cdf_len;
 	size_t cdf_len_len;
 	size_t rdf_len_len;
+	size_t rdf_len_len0;
 	size_t offset;
 	size_t c;
-	btok_sm_st* st;
+	size_t i;
+	void* stack;
 	// pre
-	ASSERT(memIsNullOrValid(state, btokSM_keep()));
+	ASSERT(memIsValid(st, btokSM_keep()));
+	ASSERT(memIsValid(hdr, 4));
+	ASSERT(n == 0 || memIsValid(cdf, n * sizeof(btok_sm_frag)));
 	ASSERT(memIsNullOrValid(count, O_PER_S));
-	// некорректная команда? команду нужно защитить, а она уже защищена?
-	if (!apduCmdIsValid(cmd) || state && (cmd->cla & 0x04))
-		return ERR_BAD_APDU;
-	// кодировать без защиты
-	offset = apduCmdEnc(apdu, cmd);
-	if (offset == SIZE_MAX)
+	// команда уже защищена? некорректная длина rdf?
+	if ((hdr[0] & 0x04) || rdf_len > 65536)
 		return ERR_BAD_APDU;
-	// состояние не задано, т.е. защита не нужна?
-	if (!state)
+	// длина cdf
+	for (len = i = 0; i < n; ++i)
 	{
-		if (count)
-		{
-			ASSERT(memIsDisjoint2(count, O_PER_S, cmd, apduCmdSizeof(cmd)));
-			*count = offset;
-		}
-		return ERR_OK;
+		if (!memIsValid(cdf[i].buf, cdf[i].len) || cdf[i].len >= 65536)
+			return ERR_BAD_APDU;
+		len += cdf[i].len;
+		if (len >= 65536)
+			return ERR_BAD_APDU;
 	}
-	ASSERT(memIsDisjoint2(state, btokSM_keep(), cmd, apduCmdSizeof(cmd)));
+	// длина длины rdf в незащищенной команде
+	if (rdf_len == 0)
+		rdf_len_len0 = 0;
+	else if (len < 256 && rdf_len <= 256)
+		rdf_len_len0 = 1;
+	else if (len != 0)
+		rdf_len_len0 = 2;
+	else
+		rdf_len_len0 = 3;
 	// новая длина cdf
-	cdf_len = cmd->cdf_len;
-	if (cmd->cdf_len)
+	cdf_len = len;
+	if (len)
 	{
-		c = derTLEnc(0, 0x87, cmd->cdf_len + 1);
+		c = derTLEnc(0, 0x87, len + 1);
 		ASSERT(c != SIZE_MAX);
 		cdf_len += c + 1;
 	}
-	if (cmd->rdf_len)
+	if (rdf_len)
 	{
-		c = derEnc(0, 0x97, 0, apduCmdRDFLenLen(cmd));
+		c = derEnc(0, 0x97, 0, rdf_len_len0);
 		ASSERT(c != SIZE_MAX);
 		cdf_len += c;
 	}
@@ -180,9 +236,9 @@ err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
 	ASSERT(c != SIZE_MAX);
 	cdf_len += c;
 	// новые длины длин cdf и rdf
-	if (cmd->rdf_len == 0)
+	if (rdf_len == 0)
 		cdf_len_len = cdf_len < 256 ? 1 : 3, rdf_len_len = 0;
-	else if (cmd->rdf_len <= 256 && cdf_len < 256)
+	else if (rdf_len <= 256 && cdf_len < 256)
 		cdf_len_len = rdf_len_len = 1;
 	else
 		cdf_len_len = 3, rdf_len_len = 2;
@@ -193,44 +249,20 @@ err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
 	{
 		if (count)
 		{
-			ASSERT(memIsDisjoint2(count, O_PER_S, state, btokSM_keep()));
-			ASSERT(memIsDisjoint2(count, O_PER_S, cmd, apduCmdSizeof(cmd)));
+			ASSERT(memIsDisjoint2(count, O_PER_S, st, btokSM_keep()));
 			*count = offset;
 		}
 		return ERR_OK;
 	}
-	ASSERT(memIsDisjoint2(apdu, offset, state, btokSM_keep()));
-	ASSERT(memIsDisjoint2(apdu, offset, cmd, apduCmdSizeof(cmd)));
+	ASSERT(memIsDisjoint2(apdu, offset, st, btokSM_keep()));
+	ASSERT(memIsDisjoint2(apdu, offset, hdr, 4));
 	// проверить счетчик
-	st = (btok_sm_st*)state;
 	if (st->ctr[0] % 2 != 1)
 		return ERR_BAD_LOGIC;
-	// уточнить заголовок
-	offset = 0;
+	// кодировать заголовок
+	memCopy(apdu, hdr, 4);
 	apdu[0] |= 0x04;
-	offset += 4;
-	// перейти к cdf
-	offset += cdf_len_len;
-	// обработать cdf
-	if (cmd->cdf_len)
-	{
-		c = derTLEnc(0, 0x87, cmd->cdf_len + 1);
-		ASSERT(c != SIZE_MAX);
-		// подготовить значение
-		memMove(apdu + offset + c + 1,
-			apdu + 4 + apduCmdCDFLenLen(cmd), cmd->cdf_len);
-		apdu[offset + c] = 0x02;
-		// кодировать TL
-		c = derTLEnc(apdu + offset, 0x87, cmd->cdf_len + 1);
-		ASSERT(c != SIZE_MAX);
-		offset += c + 1;
-		// зашифровать
-		beltCFBStart(st->stack, st->key2, 32, st->ctr);
-		beltCFBStepE(apdu + offset, cmd->cdf_len, st->stack);
-		// дальше
-		offset += cmd->cdf_len;
-	}
-	// теперь можно перекодировать Lc
+	// кодировать Lc
 	ASSERT(cdf_len_len == 1 || cdf_len_len == 3);
 	if (cdf_len_len == 1)
 		apdu[4] = (octet)cdf_len;
@@ -240,41 +272,59 @@ err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
 		apdu[5] = (octet)(cdf_len / 256);
 		apdu[6] = (octet)cdf_len;
 	}
+	offset = 4 + cdf_len_len;
+	// начать вычисление имитовставки
+	stack = btokSMStack(st);
+	memCopy(stack, btokSMMac0(st), beltMAC_keep());
+	beltMACStepA(apdu, 4, stack);
+	// обработать cdf: зашифровать и вычислить имитовставку за один проход
+	if (len)
+	{
+		c = derTLEnc(apdu + offset, 0x87, len + 1);
+		ASSERT(c != SIZE_MAX);
+		apdu[offset + c] = 0x02;
+		beltMACStepA(apdu + offset, c + 1, stack);
+		offset += c + 1;
+		btokSMCFBStart(st);
+		for (i = 0; i < n; ++i)
+		{
+			ASSERT(memIsDisjoint2(apdu + offset, cdf[i].len,
+				cdf[i].buf, cdf[i].len));
+			btokSMCFBStepEA(apdu + offset, cdf[i].buf, cdf[i].len, st, stack);
+			offset += cdf[i].len;
+		}
+	}
 	// обработать длину rdf
-	if (cmd->rdf_len)
+	if (rdf_len)
 	{
-		size_t l = apduCmdRDFLenLen(cmd);
+		size_t pos = offset;
 		// кодировать TL
-		c = derTLEnc(apdu + offset, 0x97, l);
+		c = derTLEnc(apdu + offset, 0x97, rdf_len_len0);
 		ASSERT(c != SIZE_MAX);
 		offset += c;
 		// кодировать значение
-		ASSERT(1 <= l && l <= 3);
-		if (l == 1)
-			apdu[offset] = (octet)(cmd->rdf_len);
-		else if (l == 2)
+		ASSERT(1 <= rdf_len_len0 && rdf_len_len0 <= 3);
+		if (rdf_len_len0 == 1)
+			apdu[offset] = (octet)rdf_len;
+		else if (rdf_len_len0 == 2)
 		{
-			apdu[offset] = (octet)(cmd->rdf_len / 256);
-			apdu[offset + 1] = (octet)cmd->rdf_len;
+			apdu[offset] = (octet)(rdf_len / 256);
+			apdu[offset + 1] = (octet)rdf_len;
 		}
 		else
 		{
 			apdu[offset] = 0;
-			apdu[offset + 1] = (octet)(cmd->rdf_len / 256);
-			apdu[offset + 2] = (octet)cmd->rdf_len;
+			apdu[offset + 1] = (octet)(rdf_len / 256);
+			apdu[offset + 2] = (octet)rdf_len;
 		}
-		// дальше
-		offset += l;
+		offset += rdf_len_len0;
+		beltMACStepA(apdu + pos, offset - pos, stack);
 	}
-	// вычислить имитовставку
-	beltMACStart(st->stack, st->key1, 32);
-	beltMACStepA(apdu, 4, st->stack);
-	ASSERT(offset >= 4 + cdf_len_len);
-	beltMACStepA(apdu + 4 + cdf_len_len, offset - 4 - cdf_len_len, st->stack);
+	// завершить вычисление имитовставки
 	c = derTLEnc(apdu + offset, 0x8E, 8);
 	ASSERT(c != SIZE_MAX);
 	offset += c;
-	beltMACStepG(apdu + offset, st->stack);
+	beltMACStepG(apdu + offset, stack);
 	offset += 8;
 	// кодировать новую длину rdf
 	memSetZero(apdu + offset, rdf_len_len);
@@ -282,8 +332,7 @@ err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
 	// возвратить длину
 	if (count)
 	{
-		ASSERT(memIsDisjoint2(count, O_PER_S, state, btokSM_keep()));
-		ASSERT(memIsDisjoint2(count, O_PER_S, cmd, apduCmdSizeof(cmd)));
+		ASSERT(memIsDisjoint2(count, O_PER_S, st, btokSM_keep()));
 		ASSERT(memIsDisjoint2(count, O_PER_S, apdu, offset));
 		*count = offset;
 	}
@@ -291,6 +340,52 @@ err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
 	return ERR_OK;
 }
 
+err_t btokSMCmdWrap(octet apdu[], size_t* count, const apdu_cmd_t* cmd,
+	void* state)
+{
+	size_t offset;
+	btok_sm_frag cdf[1];
+	octet hdr[4];
+	// pre
+	ASSERT(memIsNullOrValid(state, btokSM_keep()));
+	ASSERT(memIsNullOrValid(count, O_PER_S));
+	// некорректная команда? команду нужно защитить, а она уже защищена?
+	if (!apduCmdIsValid(cmd) || state && (cmd->cla & 0x04))
+		return ERR_BAD_APDU;
+	// состояние не задано, т.е. защита не нужна?
+	if (!state)
+	{
+		offset = apduCmdEnc(apdu, cmd);
+		if (offset == SIZE_MAX)
+			return ERR_BAD_APDU;
+		if (count)
+		{
+			ASSERT(memIsDisjoint2(count, O_PER_S, cmd, apduCmdSizeof(cmd)));
+			*count = offset;
+		}
+		return ERR_OK;
+	}
+	ASSERT(memIsDisjoint2(state, btokSM_keep(), cmd, apduCmdSizeof(cmd)));
+	// защитить
+	hdr[0] = cmd->cla, hdr[1] = cmd->ins, hdr[2] = cmd->p1, hdr[3] = cmd->p2;
+	cdf->buf = cmd->cdf, cdf->len = cmd->cdf_len;
+	return btokSMCmdWrapInternal(apdu, count, hdr, cmd->rdf_len, cdf, 1,
+		(btok_sm_st*)state);
+}
+
+err_t btokSMCmdWrap2(octet apdu[], size_t* count, const octet hdr[4],
+	size_t rdf_len, const btok_sm_frag cdf[], size_t n, void* state)
+{
+	// проверить входные данные
+	if (!memIsValid(state, btokSM_keep()) ||
+		!memIsValid(hdr, 4) ||
+		!memIsValid(cdf, n * sizeof(btok_sm_frag)))
+		return ERR_BAD_INPUT;
+	// защитить
+	return btokSMCmdWrapInternal(apdu, count, hdr, rdf_len, cdf, n,
+		(btok_sm_st*)state);
+}
+
 err_t btokSMCmdUnwrap(apdu_cmd_t* cmd, size_t* size, const octet apdu[],
 	size_t count, void* state)
 {
@@ -422,10 +517,10 @@ err_t btokSMCmdUnwrap(apdu_cmd_t* cmd, size_t* size, const octet apdu[],
 	if (st->ctr[0] % 2 != 1)
 		return ERR_BAD_LOGIC;
 	// проверить имитовставку
-	beltMACStart(st->stack, st->key1, 32);
-	beltMACStepA(apdu, 4, st->stack);
-	beltMACStepA(apdu + offset, c1 + c2, st->stack);
-	if (!beltMACStepV(mac, st->stack))
+	memCopy(btokSMStack(st), btokSMMac0(st), beltMAC_keep());
+	beltMACStepA(apdu, 4, btokSMStack(st));
+	beltMACStepA(apdu + offset, c1 + c2, btokSMStack(st));
+	if (!beltMACStepV(mac, btokSMStack(st)))
 		return ERR_BAD_MAC;
 	// заполнить поля команды
 	memSetZero(cmd, sizeof(apdu_cmd_t));
@@ -433,15 +528,11 @@ err_t btokSMCmdUnwrap(apdu_cmd_t* cmd, size_t* size, const octet apdu[],
 	cmd->ins = apdu[1], cmd->p1 = apdu[2], cmd->p2 = apdu[3];
 	cmd->rdf_len = rdf_len;
 	cmd->cdf_len = cdf_len;
-	memCopy(cmd->cdf, cdf, cdf_len);
 	ASSERT(memIsDisjoint2(cmd, apduCmdSizeof(cmd), state, btokSM_keep()));
 	ASSERT(memIsDisjoint2(cmd, apduCmdSizeof(cmd), apdu, count));
 	// расшифровать cdf
-	if (cdf_len)
-	{
-		beltCFBStart(st->stack, st->key2, 32, st->ctr);
-		beltCFBStepD(cmd->cdf, cdf_len, st->stack);
-	}
+	btokSMCFBStart(st);
+	btokSMCFBStepX(cmd->cdf, cdf, cdf_len, st, FALSE);
 	// возвратить размер
 	if (size)
 	{
@@ -471,100 +562,88 @@ err_t btokSMCmdUnwrap(apdu_cmd_t* cmd, size_t* size, const octet apdu[],
 
 #define apduRespSizeof(resp) (sizeof(apdu_resp_t) + (resp)->rdf_len)
 
-err_t btokSMRespWrap(octet apdu[], size_t* count, const apdu_resp_t* resp,
-	void* state)
+static err_t btokSMRespWrapInternal(octet apdu[], size_t* count,
+	const btok_sm_frag rdf[], size_t n, const octet sw[2], btok_sm_st* st)
 {
-	size_t rdf_len;
+	size_t len;
 	size_t offset;
 	size_t c;
-	btok_sm_st* st;
+	size_t i;
+	void* stack;
 	// pre
-	ASSERT(memIsNullOrValid(state, btokSM_keep()));
+	ASSERT(memIsValid(st, btokSM_keep()));
+	ASSERT(memIsValid(sw, 2));
+	ASSERT(n == 0 || memIsValid(rdf, n * sizeof(btok_sm_frag)));
 	ASSERT(memIsNullOrValid(count, O_PER_S));
-	// корректный ответ?
-	if (!apduRespIsValid(resp))
-		return ERR_BAD_APDU;
-	// кодировать без защиты
-	offset = apduRespEnc(apdu, resp);
-	if (offset == SIZE_MAX)
-		return ERR_BAD_APDU;
-	// состояние не задано, т.е. защита не нужна?
-	if (!state)
+	// длина rdf
+	for (len = i = 0; i < n; ++i)
 	{
-		if (count)
-		{
-			ASSERT(memIsDisjoint2(count, O_PER_S, resp, apduRespSizeof(resp)));
-			*count = offset;
-		}
-		return ERR_OK;
+		if (!memIsValid(rdf[i].buf, rdf[i].len) || rdf[i].len > 65536)
+			return ERR_BAD_APDU;
+		len += rdf[i].len;
+		if (len > 65536)
+			return ERR_BAD_APDU;
 	}
-	ASSERT(memIsDisjoint2(state, btokSM_keep(), resp, apduRespSizeof(resp)));
-	// новая длина rdf
-	rdf_len = resp->rdf_len;
-	if (resp->rdf_len)
+	// общая длина
+	offset = len;
+	if (len)
 	{
-		c = derTLEnc(0, 0x87, resp->rdf_len + 1);
+		c = derTLEnc(0, 0x87, len + 1);
 		ASSERT(c != SIZE_MAX);
-		rdf_len += c + 1;
+		offset += c + 1;
 	}
 	c = derEnc(0, 0x8E, 0, 8);
 	ASSERT(c != SIZE_MAX);
-	rdf_len += c;
-	// общая длина
-	offset = rdf_len + 2;
+	offset += c + 2;
 	// не задан выходной буфер, т.е. нужно определить только его длину?
 	if (!apdu)
 	{
 		if (count)
 		{
-			ASSERT(memIsDisjoint2(count, O_PER_S, state, btokSM_keep()));
-			ASSERT(memIsDisjoint2(count, O_PER_S, resp, apduRespSizeof(resp)));
+			ASSERT(memIsDisjoint2(count, O_PER_S, st, btokSM_keep()));
 			*count = offset;
 		}
 		return ERR_OK;
 	}
-	ASSERT(memIsDisjoint2(apdu, offset, state, btokSM_keep()));
-	ASSERT(memIsDisjoint2(apdu, offset, resp, apduRespSizeof(resp)));
+	ASSERT(memIsDisjoint2(apdu, offset, st, btokSM_keep()));
+	ASSERT(memIsDisjoint2(apdu, offset, sw, 2));
 	// проверить счетчик
-	st = (btok_sm_st*)state;
 	if (st->ctr[0] % 2 != 0)
 		return ERR_BAD_LOGIC;
-	// обработать rdf
+	// начать вычисление имитовставки
+	stack = btokSMStack(st);
+	memCopy(stack, btokSMMac0(st), beltMAC_keep());
+	// обработать rdf: зашифровать и вычислить имитовставку за один проход
 	offset = 0;
-	if (resp->rdf_len)
+	if (len)
 	{
-		c = derTLEnc(0, 0x87, resp->rdf_len + 1);
+		c = derTLEnc(apdu, 0x87, len + 1);
 		ASSERT(c != SIZE_MAX);
-		// подготовить значение
-		memMove(apdu + c + 1, apdu, resp->rdf_len);
 		apdu[c] = 0x02;
-		// кодировать TL
-		c = derTLEnc(apdu, 0x87, resp->rdf_len + 1);
-		ASSERT(c != SIZE_MAX);
+		beltMACStepA(apdu, c + 1, stack);
 		offset += c + 1;
-		// зашифровать
-		beltCFBStart(st->stack, st->key2, 32, st->ctr);
-		beltCFBStepE(apdu + offset, resp->rdf_len, st->stack);
-		// дальше
-		offset += resp->rdf_len;
+		btokSMCFBStart(st);
+		for (i = 0; i < n; ++i)
+		{
+			ASSERT(memIsDisjoint2(apdu + offset, rdf[i].len,
+				rdf[i].buf, rdf[i].len));
+			btokSMCFBStepEA(apdu + offset, rdf[i].buf, rdf[i].len, st, stack);
+			offset += rdf[i].len;
+		}
 	}
-	// вычислить имитовставку
-	beltMACStart(st->stack, st->key1, 32);
-	beltMACStepA(apdu, offset, st->stack);
-	beltMACStepA(&resp->sw1, 1, st->stack);
-	beltMACStepA(&resp->sw2, 1, st->stack);
+	// завершить вычисление имитовставки
+	beltMACStepA(sw, 2, stack);
 	c = derTLEnc(apdu + offset, 0x8E, 8);
 	ASSERT(c != SIZE_MAX);
 	offset += c;
-	beltMACStepG(apdu + offset, st->stack);
+	beltMACStepG(apdu + offset, stack);
 	offset += 8;
 	// кодировать статусы
-	apdu[offset++] = resp->sw1, apdu[offset++] = resp->sw2;
+	apdu[offset++] = sw[0], apdu[offset++] = sw[1];
 	// возвратить длину
 	if (count)
 	{
-		ASSERT(memIsDisjoint2(count, O_PER_S, state, btokSM_keep()));
-		ASSERT(memIsDisjoint2(count, O_PER_S, resp, apduRespSizeof(resp)));
+		ASSERT(memIsDisjoint2(count, O_PER_S, st, btokSM_keep()));
 		ASSERT(memIsDisjoint2(count, O_PER_S, apdu, offset));
 		*count = offset;
 	}
@@ -572,6 +651,52 @@ err_t btokSMRespWrap(octet apdu[], size_t* count, const apdu_resp_t* resp,
 	return ERR_OK;
 }
 
+err_t btokSMRespWrap(octet apdu[], size_t* count, const apdu_resp_t* resp,
+	void* state)
+{
+	size_t offset;
+	btok_sm_frag rdf[1];
+	octet sw[2];
+	// pre
+	ASSERT(memIsNullOrValid(state, btokSM_keep()));
+	ASSERT(memIsNullOrValid(count, O_PER_S));
+	// корректный ответ?
+	if (!apduRespIsValid(resp))
+		return ERR_BAD_APDU;
+	// состояние не задано, т.е. защита не нужна?
+	if (!state)
+	{
+		offset = apduRespEnc(apdu, resp);
+		if (offset == SIZE_MAX)
+			return ERR_BAD_APDU;
+		if (count)
+		{
+			ASSERT(memIsDisjoint2(count, O_PER_S, resp, apduRespSizeof(resp)));
+			*count = offset;
+		}
+		return ERR_OK;
+	}
+	ASSERT(memIsDisjoint2(state, btokSM_keep(), resp, apduRespSizeof(resp)));
+	// защитить
+	rdf->buf = resp->rdf, rdf->len = resp->rdf_len;
+	sw[0] = resp->sw1, sw[1] = resp->sw2;
+	return btokSMRespWrapInternal(apdu, count, rdf, 1, sw, 
+		(btok_sm_st*)state);
+}
+
+err_t btokSMRespWrap2(octet apdu[], size_t* count, const btok_sm_frag rdf[],
+	size_t n, const octet sw[2], void* state)
+{
+	// проверить входные данные
+	if (!memIsValid(state, btokSM_keep()) ||
+		!memIsValid(rdf, n * sizeof(btok_sm_frag)) ||
+		!memIsValid(sw, 2))
+		return ERR_BAD_INPUT;
+	// защитить
+	return btokSMRespWrapInternal(apdu, count, rdf, n, sw,
+		(btok_sm_st*)state);
+}
+
 err_t btokSMRespUnwrap(apdu_resp_t* resp, size_t* size, const octet apdu[],
 	size_t count, void* state)
 {
@@ -632,24 +757,20 @@ err_t btokSMRespUnwrap(apdu_resp_t* resp, size_t* size, const octet apdu[],
 	if (st->ctr[0] % 2 != 0)
 		return ERR_BAD_LOGIC;
 	// проверить имитовставку
-	beltMACStart(st->stack, st->key1, 32);
-	beltMACStepA(apdu, c1, st->stack);
-	beltMACStepA(apdu + count - 2, 2, st->stack);
-	if (!beltMACStepV(mac, st->stack))
+	memCopy(btokSMStack(st), btokSMMac0(st), beltMAC_keep());
+	beltMACStepA(apdu, c1, btokSMStack(st));
+	beltMACStepA(apdu + count - 2, 2, btokSMStack(st));
+	if (!beltMACStepV(mac, btokSMStack(st)))
 		return ERR_BAD_MAC;
 	// заполнить поля ответа
 	memSetZero(resp, sizeof(apdu_resp_t));
 	resp->sw1 = apdu[count - 2], resp->sw2 = apdu[count - 1];
 	resp->rdf_len = rdf_len;
-	memCopy(resp->rdf, rdf, rdf_len);
 	ASSERT(memIsDisjoint2(resp, apduRespSizeof(resp), state, btokSM_keep()));
 	ASSERT(memIsDisjoint2(resp, apduRespSizeof(resp), apdu, count));
 	// расшифровать rdf
-	if (rdf_len)
-	{
-		beltCFBStart(st->stack, st->key2, 32, st->ctr);
-		beltCFBStepD(resp->rdf, rdf_len, st->stack);
-	}
+	btokSMCFBStart(st);
+	btokSMCFBStepX(resp->rdf, rdf, rdf_len, st, FALSE);
 	// возвратить размер
 	if (size)
 	{
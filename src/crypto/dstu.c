@@ -4,7 +4,7 @@
 \brief DSTU 4145-2002 (Ukraine): digital signature algorithms
 \project bee2 [cryptographic library]
 \created 2012.04.27
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -411,77 +411,73 @@ err_t dstuParamsStd(dstu_params* params, const char* name)
 *******************************************************************************
 Создание описания эллиптической кривой
 
-По долговременным параметрам params формируется описание pec эллиптической
-кривой. Указатель *pec является одновременно началом фрагмента памяти, 
-в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
-потребностей deep и размерностей dims.
-\pre Указатель pec корректен.
+По долговременным параметрам params в памяти state формируется описание
+эллиптической кривой. Длина памяти определяется функцией dstuStart_keep()
+с учетом потребностей deep.
+\pre 160 <= params->p[0] <= 509.
 \return ERR_OK, если описание успешно создано, и код ошибки в противном 
 случае.
-\remark Запрошенная память начинается по адресу objEnd(*pec, void).
+\remark Описание кривой начинается по адресу state. Память для
+потребностей deep начинается по адресу objEnd(state, void).
 \remark Проводится минимальная проверка параметров, обеспечивающая 
 работоспособность высокоуровневых функций.
 *******************************************************************************
 */
 
-static err_t dstuEcCreate(
-	ec_o** pec,						/* [out] описание эллиптической кривой */
-	const dstu_params* params,		/* [in] долговременные параметры */
+static size_t dstuStart_keep(
+	size_t m,						/* [in] степень расширения поля */
 	dstu_deep_i deep				/* [in] потребности в стековой памяти */
 )
 {
 	// размерности
-	size_t m;
+	const size_t n = W_OF_B(m);
+	const size_t f_keep = gf2Create_keep(m);
+	const size_t f_deep = gf2Create_deep(m);
+	const size_t ec_d = 3;
+	const size_t ec_keep = ec2CreateLD_keep(n);
+	const size_t ec_deep = ec2CreateLD_deep(n, f_deep);
+	// расчет
+	return f_keep + ec_keep +
+		utilMax(4,
+			4 * sizeof(size_t) + f_deep,
+			O_OF_B(m) + ec_deep,
+			ecCreateGroup_deep(f_deep),
+			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
+}
+
+static err_t dstuStart(
+	void* state,					/* [out] описание кривой */
+	const dstu_params* params		/* [in] долговременные параметры */
+)
+{
+	// размерности
 	size_t n;
-	size_t f_keep;
-	size_t f_deep;
-	size_t ec_d;
 	size_t ec_keep;
-	size_t ec_deep;
 	// состояние
-	void* state;	
 	size_t* p;			/* описание многочлена */
 	qr_o* f;			/* поле */
 	octet* A;			/* коэффициент A */
 	ec_o* ec;			/* кривая */
 	void* stack;
 	// pre
-	ASSERT(memIsValid(pec, sizeof(*pec)));
+	ASSERT(memIsValid(params, sizeof(dstu_params)));
+	ASSERT(160 <= params->p[0] && params->p[0] <= 509);
 	// минимальная проверка входных данных
-	if (!memIsValid(params, sizeof(dstu_params)) ||
-		(m = params->p[0]) < 160 || m > 509 || 
-		params->A > 1)
+	if (params->A > 1)
 		return ERR_BAD_PARAMS;
 	// определить размерности
-	n = W_OF_B(m);
-	f_keep = gf2Create_keep(m);
-	f_deep = gf2Create_deep(m);
-	ec_d = 3;
+	n = W_OF_B(params->p[0]);
 	ec_keep = ec2CreateLD_keep(n);
-	ec_deep = ec2CreateLD_deep(n, f_deep);
-	// создать состояние
-	state = blobCreate(
-		f_keep + ec_keep +
-		utilMax(4,
-			4 * sizeof(size_t) + f_deep,
-			O_OF_B(m) + ec_deep,
-			ecCreateGroup_deep(f_deep),
-			deep(n, f_deep, ec_d, ec_deep)));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
 	// создать поле
 	f = (qr_o*)((octet*)state + ec_keep);
-	p = (size_t*)((octet*)f + f_keep);
+	p = (size_t*)((octet*)f + gf2Create_keep(params->p[0]));
 	p[0] = params->p[0];
 	p[1] = params->p[1];
 	p[2] = params->p[2];
 	p[3] = params->p[3];
 	stack = p + 4;
 	if (!gf2Create(f, p, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// создать кривую и группу
 	ec = (ec_o*)state;
 	A = (octet*)p;
@@ -491,14 +487,55 @@ static err_t dstuEcCreate(
 	if (!ec2CreateLD(ec, f, A, params->B, stack) ||
 		!ecCreateGroup(ec, params->P, params->P + ec->f->no, params->n, 
 			ec->f->no, params->c, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// присоединить f к ec
 	objAppend(ec, f, 0);
 	// все нормально
-	*pec = ec;
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Создание описания эллиптической кривой в куче
+
+По долговременным параметрам params формируется описание pec эллиптической
+кривой. Указатель *pec является одновременно началом фрагмента памяти, 
+в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
+потребностей deep.
+\pre Указатель pec корректен.
+\return ERR_OK, если описание успешно создано, и код ошибки в противном 
+случае.
+\remark Запрошенная память начинается по адресу objEnd(*pec, void).
+*******************************************************************************
+*/
+
+static err_t dstuEcCreate(
+	ec_o** pec,						/* [out] описание эллиптической кривой */
+	const dstu_params* params,		/* [in] долговременные параметры */
+	dstu_deep_i deep				/* [in] потребности в стековой памяти */
+)
+{
+	err_t code;
+	void* state;	
+	// pre
+	ASSERT(memIsValid(pec, sizeof(*pec)));
+	// минимальная проверка входных данных
+	if (!memIsValid(params, sizeof(dstu_params)) ||
+		params->p[0] < 160 || params->p[0] > 509)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(dstuStart_keep(params->p[0], deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// создать кривую
+	code = dstuStart(state, params);
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		return code;
+	}
+	// все нормально
+	*pec = (ec_o*)state;
 	return ERR_OK;
 }
 
@@ -524,7 +561,7 @@ void dstuEcClose(ec_o* ec)
 4) order >= 4(\floor{\sqrt{2^m}} + 1),
 5) кривая является безопасной с MOV-порогом 32.
 
-Условие 1) проверяется в функции dstuEcCreate().
+Условие 1) проверяется в функции dstuStart().
 Условие 2) проверяется в функции ec2IsValid().
 Условие 3) проверяется непосредственно.
 Условие 4) следует из границы Хассе
@@ -821,6 +858,135 @@ err_t dstuPointRecover(octet point[], const dstu_params* params,
 	return code;
 }
 
+/*
+*******************************************************************************
+Контекст кривой
+
+Контекст содержит описание эллиптической кривой, построенное функцией
+dstuStart(), и таблицу pre кратных базовой точки для регулярного
+гребенчатого метода (ecMulSCombA()) с шириной гребенки DSTU_CTX_W.
+Таблица строится для кратностей, длина которых совпадает с длиной порядка
+базовой точки.
+
+Высокоуровневые функции реализованы в двух вариантах: с описанием кривой,
+которое строится при каждом вызове, и с контекстом. Общие действия
+выполняются внутренними функциями dstuXXXEc(), которые получают описание
+кривой ec, таблицу pre (или 0, если таблицы нет) и стек, длина которого
+определяется функцией dstuXXX_deep(). При pre == 0 кратные базовой точки
+вычисляются с помощью лестницы Монтгомери (ec2MulLadderA()).
+
+Контекст не содержит секретных данных и после построения только читается.
+Поэтому его можно использовать одновременно в нескольких потоках.
+*******************************************************************************
+*/
+
+#define DSTU_CTX_W		5		/*< ширина гребенки */
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< описание эллиптической кривой */
+	word* pre;					/*< [2^w * 2 * ec->f->n] кратные P */
+// }
+	octet data[];				/*< данные */
+} dstu_ctx_o;
+
+#define dstuCtxPreCount()\
+	(SIZE_1 << DSTU_CTX_W)
+
+static size_t dstuCtx_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return O_OF_W(dstuCtxPreCount() * 2 * n) +
+		ecPreSCombA_deep(n, ec_d, ec_deep);
+}
+
+size_t dstuCtx_keep(size_t m)
+{
+	return sizeof(dstu_ctx_o) + dstuStart_keep(m, dstuCtx_deep);
+}
+
+err_t dstuCtxStart(void* ctx, const dstu_params* params)
+{
+	err_t code;
+	dstu_ctx_o* c = (dstu_ctx_o*)ctx;
+	size_t n;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(dstu_params)))
+		return ERR_BAD_INPUT;
+	if (params->p[0] < 160 || params->p[0] > 509)
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(ctx, dstuCtx_keep(params->p[0])))
+		return ERR_BAD_INPUT;
+	// контекст неработоспособен до завершения построения
+	memSetZero(c, sizeof(dstu_ctx_o));
+	// создать кривую
+	code = dstuStart(c->data, params);
+	ERR_CALL_CHECK(code);
+	c->ec = (ec_o*)c->data;
+	n = c->ec->f->n;
+	// настроить указатели
+	c->pre = objEnd(c->ec, word);
+	// рассчитать кратные P
+	if (!ecPreSCombA(c->pre, c->ec->base, c->ec, DSTU_CTX_W,
+		W_OF_B(wwBitSize(c->ec->order, n)), 
+		c->pre + dstuCtxPreCount() * 2 * n))
+	{
+		memSetZero(c, sizeof(dstu_ctx_o));
+		return ERR_BAD_PARAMS;
+	}
+	// настроить заголовок
+	c->hdr.keep = sizeof(dstu_ctx_o) + objKeep(c->ec) +
+		O_OF_W(dstuCtxPreCount() * 2 * n);
+	c->hdr.p_count = 2;
+	c->hdr.o_count = 1;
+	// все нормально
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Проверка контекста и создание стека для функций dstuXXX2()
+*******************************************************************************
+*/
+
+#define dstuCtxIsOperable(c)\
+	(objIsOperable(c) && (c)->hdr.p_count == 2 && (c)->hdr.o_count == 1 &&\
+		ecIsOperable((c)->ec))
+
+static void* dstuCtxStack(const dstu_ctx_o* c, dstu_deep_i deep)
+{
+	ASSERT(dstuCtxIsOperable(c));
+	return blobCreate(deep(c->ec->f->n, c->ec->f->deep, c->ec->d,
+		c->ec->deep));
+}
+
+/*
+*******************************************************************************
+Кратная базовой точки
+
+Если задана таблица pre, то используется регулярный гребенчатый метод,
+в противном случае -- лестница Монтгомери. Оба метода выполняют
+фиксированную последовательность операций, не зависящую от кратности.
+*******************************************************************************
+*/
+
+static bool_t dstuMulBase(word b[], const ec_o* ec, const word pre[], 
+	const word d[], size_t m, void* stack)
+{
+	return pre ? ecMulSCombA(b, pre, ec, DSTU_CTX_W, d, m, stack) :
+		ec2MulLadderA(b, ec->base, ec, d, m, stack);
+}
+
+static size_t dstuMulBase_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return utilMax(2,
+		ec2MulLadderA_deep(n, f_deep),
+		ecMulSCombA_deep(n, ec_d, ec_deep, n + 1));
+}
+
 /*
 *******************************************************************************
 Управление ключами
@@ -831,26 +997,18 @@ static size_t dstuKeypairGen_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(3 * n) + 
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		dstuMulBase_deep(n, f_deep, ec_d, ec_deep);
 }
 
-err_t dstuKeypairGen(octet privkey[], octet pubkey[], 
-	const dstu_params* params, gen_i rng, void* rng_state)
+static err_t dstuKeypairGenEc(octet privkey[], octet pubkey[], 
+	const ec_o* ec, const word pre[], gen_i rng, void* rng_state, 
+	void* stack)
 {
-	err_t code;
 	size_t order_n, order_no, order_nb;
 	// состояние
-	ec_o* ec = 0;
 	word* d;
 	word* x;
 	word* y;
-	void* stack;
-	// проверить rng
-	if (rng == 0)
-		return ERR_BAD_RNG;
-	// старт
-	code = dstuEcCreate(&ec, params, dstuKeypairGen_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
 	order_nb = wwBitSize(ec->order, ec->f->n);
 	order_no = O_OF_B(order_nb);
@@ -858,12 +1016,9 @@ err_t dstuKeypairGen(octet privkey[], octet pubkey[],
 	// проверить входные указатели
 	if (!memIsValid(privkey, order_no) || 
 		!memIsValid(pubkey, 2 * ec->f->no))
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	d = objEnd(ec, word);
+	d = (word*)stack;
 	x = d + ec->f->n;
 	y = x + ec->f->n;
 	stack = y + ec->f->n;
@@ -881,12 +1036,9 @@ err_t dstuKeypairGen(octet privkey[], octet pubkey[],
 			break;
 	}
 	// Q <- d G
-	if (!ecMulA(x, ec->base, ec, d, order_n, stack))
-	{
+	if (!dstuMulBase(x, ec, pre, d, order_n, stack))
 		// если params корректны, то этого быть не должно
-		dstuEcClose(ec);
 		return ERR_BAD_PARAMS;
-	}
 	// Q <- -Q
 	ec2NegA(x, x, ec);
 	// выгрузить ключи
@@ -894,10 +1046,52 @@ err_t dstuKeypairGen(octet privkey[], octet pubkey[],
 	qrTo(pubkey, x, ec->f, stack);
 	qrTo(pubkey + ec->f->no, y, ec->f, stack);
 	// все нормально
+	return ERR_OK;
+}
+
+err_t dstuKeypairGen(octet privkey[], octet pubkey[], 
+	const dstu_params* params, gen_i rng, void* rng_state)
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// старт
+	code = dstuEcCreate(&ec, params, dstuKeypairGen_deep);
+	ERR_CALL_CHECK(code);
+	// генерация
+	code = dstuKeypairGenEc(privkey, pubkey, ec, 0, rng, rng_state,
+		objEnd(ec, void));
+	// завершение
 	dstuEcClose(ec);
 	return code;
 }
 
+err_t dstuKeypairGen2(octet privkey[], octet pubkey[], const void* ctx,
+	gen_i rng, void* rng_state)
+{
+	err_t code;
+	const dstu_ctx_o* c = (const dstu_ctx_o*)ctx;
+	void* stack;
+	// проверить входные данные
+	if (!dstuCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать стек
+	stack = dstuCtxStack(c, dstuKeypairGen_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// генерация
+	code = dstuKeypairGenEc(privkey, pubkey, c->ec, c->pre, rng, rng_state,
+		stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
+
 /*
 *******************************************************************************
 ЭЦП
@@ -909,31 +1103,22 @@ static size_t dstuSign_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	return O_OF_W(6 * n) + 
 		utilMax(2,
-			ecMulA_deep(n, ec_d, ec_deep, n),
+			dstuMulBase_deep(n, f_deep, ec_d, ec_deep),
 			zzMulMod_deep(n));
 }
 
-err_t dstuSign(octet sig[], const dstu_params* params, size_t ld, 
-	const octet hash[], size_t hash_len, const octet privkey[], 
-	gen_i rng, void* rng_state)
+static err_t dstuSignEc(octet sig[], const ec_o* ec, const word pre[],
+	size_t ld, const octet hash[], size_t hash_len, const octet privkey[], 
+	gen_i rng, void* rng_state, void* stack)
 {
-	err_t code;
 	size_t order_n, order_no, order_nb;
 	// состояние
-	ec_o* ec = 0;
 	word* e;		/* эфемерный лк */
 	word* h;		/* хэш-значение как элемент поля */
 	word* x;		/* х-координата эфемерного ок */
 	word* y;		/* y-координата эфемерного ок */
 	word* r;		/* первая часть ЭЦП */
 	word* s;		/* вторая часть ЭЦП */
-	void* stack;
-	// проверить rng
-	if (rng == 0)
-		return ERR_BAD_RNG;
-	// старт
-	code = dstuEcCreate(&ec, params, dstuSign_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
 	order_nb = wwBitSize(ec->order, ec->f->n);
 	order_no = O_OF_B(order_nb);
@@ -945,12 +1130,9 @@ err_t dstuSign(octet sig[], const dstu_params* params, size_t ld,
 		ld % 16 != 0 || ld < 16 * order_no ||
 		!memIsValid(hash, hash_len) ||
 		!memIsValid(sig, O_OF_B(ld)))
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	e = objEnd(ec, word);
+	e = (word*)stack;
 	h = e + ec->f->n;
 	x = h + ec->f->n;
 	y = x + ec->f->n;
@@ -988,12 +1170,9 @@ step8:
 			break;
 	}
 	// шаг 8: (x, y) <- e G
-	if (!ecMulA(x, ec->base, ec, e, order_n, stack))
-	{
+	if (!dstuMulBase(x, ec, pre, e, order_n, stack))
 		// если params корректны, то этого быть не должно
-		dstuEcClose(ec);
 		return ERR_BAD_PARAMS;
-	}
 	// шаг 8: если x == 0, то повторить генерацию
 	if (qrIsZero(x, ec->f))
 		goto step8;
@@ -1020,10 +1199,54 @@ step8:
 	wwTo(sig, order_no, r);
 	wwTo(sig + ld / 16, order_no, s);
 	// все нормально
+	return ERR_OK;
+}
+
+err_t dstuSign(octet sig[], const dstu_params* params, size_t ld, 
+	const octet hash[], size_t hash_len, const octet privkey[], 
+	gen_i rng, void* rng_state)
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// старт
+	code = dstuEcCreate(&ec, params, dstuSign_deep);
+	ERR_CALL_CHECK(code);
+	// выработка ЭЦП
+	code = dstuSignEc(sig, ec, 0, ld, hash, hash_len, privkey, rng, 
+		rng_state, objEnd(ec, void));
+	// завершение
 	dstuEcClose(ec);
 	return code;
 }
 
+err_t dstuSign2(octet sig[], const void* ctx, size_t ld, 
+	const octet hash[], size_t hash_len, const octet privkey[], 
+	gen_i rng, void* rng_state)
+{
+	err_t code;
+	const dstu_ctx_o* c = (const dstu_ctx_o*)ctx;
+	void* stack;
+	// проверить входные данные
+	if (!dstuCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать стек
+	stack = dstuCtxStack(c, dstuSign_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// выработка ЭЦП
+	code = dstuSignEc(sig, c->ec, c->pre, ld, hash, hash_len, privkey, rng,
+		rng_state, stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
+
 static size_t dstuVerify_deep(size_t n, size_t f_deep, size_t ec_d, 
 	size_t ec_deep)
 {
@@ -1031,22 +1254,16 @@ static size_t dstuVerify_deep(size_t n, size_t f_deep, size_t ec_d,
 		ecAddMulA_deep(n, ec_d, ec_deep, 2, n, n);
 }
 
-err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[], 
-	size_t hash_len, const octet sig[], const octet pubkey[])
+static err_t dstuVerifyEc(const ec_o* ec, size_t ld, const octet hash[], 
+	size_t hash_len, const octet sig[], const octet pubkey[], void* stack)
 {
-	err_t code;
 	size_t order_n, order_no, order_nb, i;
 	// состояние
-	ec_o* ec = 0;
 	word* h;		/* хэш-значение как элемент поля */
 	word* x;		/* х-координата эфемерного ок */
 	word* y;		/* y-координата эфемерного ок */
 	word* r;		/* первая часть ЭЦП */
 	word* s;		/* вторая часть ЭЦП */
-	void* stack;
-	// старт
-	code = dstuEcCreate(&ec, params, dstuVerify_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
 	order_nb = wwBitSize(ec->order, ec->f->n);
 	order_no = O_OF_B(order_nb);
@@ -1057,12 +1274,9 @@ err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[],
 	if (!memIsValid(pubkey, 2 * ec->f->no) || 
 		ld % 16 != 0 || ld < 16 * order_no ||
 		!memIsValid(hash, hash_len))
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	h = objEnd(ec, word);
+	h = (word*)stack;
 	x = h + ec->f->n;
 	y = x + ec->f->n;
 	r = y + ec->f->n;
@@ -1073,10 +1287,7 @@ err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[],
 	// [минимальная проверка принадлежности координат базовому полю]
 	if (!qrFrom(x, pubkey, ec->f, stack) || 
 		!qrFrom(y, pubkey + ec->f->no, ec->f, stack))
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_PUBKEY;
-	}
 	// шаги 6, 7: хэширование
 	// шаг 8: перевести hash в элемент основного поля h
 	// [алгоритм из раздела 5.9 ДСТУ]
@@ -1100,25 +1311,16 @@ err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[],
 	wwFrom(s, sig + ld / 16, order_no);
 	for (i = order_no; i < ld / 16; ++i)
 		if (sig[i] || sig[i + ld / 16])
-		{
-			dstuEcClose(ec);
 			return ERR_BAD_SIG;
-		}
 	// шаги 10, 11: проверить r и s
 	if (wwIsZero(r, order_n) ||
 		wwIsZero(s, order_n) ||
 		wwCmp(r, ec->order, order_n) >= 0 ||
 		wwCmp(s, ec->order, order_n) >= 0)
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_SIG;
-	}
 	// шаг 12: R <- sP + rQ
 	if (!ecAddMulA(x, ec, stack, 2, ec->base, s, order_n, x, r, order_n))
-	{
-		dstuEcClose(ec);
 		return ERR_BAD_SIG;
-	}
 	// шаг 13: y <- h * x
 	qrMul(y, x, h, ec->f, stack);
 	// шаг 14: r' <- \bar{y}
@@ -1127,9 +1329,42 @@ err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[],
 	wwFrom(s, s, order_no);
 	wwTrimHi(s, order_n, order_nb - 1);
 	// шаг 15:
-	if (!wwEq(r, s, order_n))
-		code = ERR_BAD_SIG;
-	// все нормально
+	return wwEq(r, s, order_n) ? ERR_OK : ERR_BAD_SIG;
+}
+
+err_t dstuVerify(const dstu_params* params, size_t ld, const octet hash[], 
+	size_t hash_len, const octet sig[], const octet pubkey[])
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// старт
+	code = dstuEcCreate(&ec, params, dstuVerify_deep);
+	ERR_CALL_CHECK(code);
+	// проверка ЭЦП
+	code = dstuVerifyEc(ec, ld, hash, hash_len, sig, pubkey, 
+		objEnd(ec, void));
+	// завершение
 	dstuEcClose(ec);
 	return code;
 }
+
+err_t dstuVerify2(const void* ctx, size_t ld, const octet hash[], 
+	size_t hash_len, const octet sig[], const octet pubkey[])
+{
+	err_t code;
+	const dstu_ctx_o* c = (const dstu_ctx_o*)ctx;
+	void* stack;
+	// проверить контекст
+	if (!dstuCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	// создать стек
+	stack = dstuCtxStack(c, dstuVerify_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// проверка ЭЦП
+	code = dstuVerifyEc(c->ec, ld, hash, hash_len, sig, pubkey, stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
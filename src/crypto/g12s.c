@@ -4,7 +4,7 @@
 \brief GOST R 34.10-94 (Russia): digital signature algorithms
 \project bee2 [cryptographic library]
 \created 2012.07.09
-\version 2023.11.08
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -567,14 +567,14 @@ err_t g12sParamsStd(g12s_params* params, const char* name)
 *******************************************************************************
 Создание описания эллиптической кривой
 
-По долговременным параметрам params формируется описание pec эллиптической
-кривой. Указатель *pec является одновременно началом фрагмента памяти, 
-в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
-потребностей deep и размерностей dims.
-\pre Указатель pec корректен.
+По долговременным параметрам params в памяти state формируется описание
+эллиптической кривой. Длина памяти определяется функцией g12sStart_keep()
+с учетом потребностей deep.
+\pre params->l == 256 || params->l == 512.
 \return ERR_OK, если описание успешно создано, и код ошибки в противном 
 случае.
-\remark Запрошенная память начинается по адресу objEnd(*pec, void).
+\remark Описание кривой начинается по адресу state. Память для
+потребностей deep начинается по адресу objEnd(state, void).
 \remark Проводится минимальная проверка параметров, обеспечивающая 
 работоспособность высокоуровневых функций.
 \remark Диапазоны для q:
@@ -591,86 +591,119 @@ err_t g12sParamsStd(g12s_params* params, const char* name)
 *******************************************************************************
 */
 
-static err_t g12sEcCreate(
-	ec_o** pec,						/* [out] описание эллиптической кривой */
-	const g12s_params* params,		/* [in] долговременные параметры */
+static size_t g12sStart_keep(
+	size_t l,						/* [in] уровень стойкости */
 	g12s_deep_i deep				/* [in] потребности в стековой памяти */
 )
+{
+	// размерности
+	const size_t no = O_OF_B(l);
+	const size_t n = W_OF_B(l);
+	const size_t f_keep = gfpCreate_keep(no);
+	const size_t f_deep = gfpCreate_deep(no);
+	const size_t ec_d = 3;
+	const size_t ec_keep = ecpCreateJ_keep(no);
+	const size_t ec_deep = ecpCreateJ_deep(no, f_deep);
+	// расчет
+	return f_keep + ec_keep +
+		utilMax(3,
+			ec_deep,
+			ecCreateGroup_deep(f_deep),
+			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
+}
+
+static err_t g12sStart(
+	void* state,					/* [out] описание кривой */
+	const g12s_params* params		/* [in] долговременные параметры */
+)
 {
 	// размерности
 	size_t n, no, nb;
 	size_t f_keep;
-	size_t f_deep;
-	size_t ec_d;
 	size_t ec_keep;
-	size_t ec_deep;
 	// состояние
-	void* state;	
 	qr_o* f;			/* базовое поле */
 	ec_o* ec;			/* кривая */
 	void* stack;
 	// pre
-	ASSERT(memIsValid(pec, sizeof(*pec)));
-	// минимальная проверка входных данных
-	if (!memIsValid(params, sizeof(g12s_params)) ||
-		params->l != 256 && params->l != 512)
-		return ERR_BAD_PARAMS;
+	ASSERT(memIsValid(params, sizeof(g12s_params)));
+	ASSERT(params->l == 256 || params->l == 512);
 	// определить размерности
 	no = memNonZeroSize(params->p, sizeof(params->p) * params->l / 512);
 	n = W_OF_O(no);
 	f_keep = gfpCreate_keep(no);
-	f_deep = gfpCreate_deep(no);
-	ec_d = 3;
 	ec_keep = ecpCreateJ_keep(no);
-	ec_deep = ecpCreateJ_deep(no, f_deep);
-	// создать состояние
-	state = blobCreate(
-		f_keep + ec_keep +
-		utilMax(3,
-			ec_deep,
-			ecCreateGroup_deep(f_deep),
-			deep(n, f_deep, ec_d, ec_deep)));
-	if (state == 0)
-		return ERR_OUTOFMEMORY;
 	// создать поле
 	f = (qr_o*)((octet*)state + ec_keep);
 	stack = (octet*)f + f_keep;
 	if (!gfpCreate(f, params->p, no, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// проверить длину p
 	nb = wwBitSize(f->mod, n);
 	if (params->l == 256 && nb <= 253 ||
 		params->l == 512 && nb <= 507)
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// создать кривую и группу
 	ec = (ec_o*)state;
 	if (!ecpCreateJ(ec, f, params->a, params->b, stack) ||
 		!ecCreateGroup(ec, params->xP, params->yP, params->q, 
 			params->l / 8, params->n, stack))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// проверить q
 	n = W_OF_B(params->l);
 	nb = wwBitSize(ec->order, n);
 	if (params->l == 256 && nb <= 254 ||
 		params->l == 512 && nb <= 508 ||
 		zzIsEven(ec->order, n))
-	{
-		blobClose(state);
 		return ERR_BAD_PARAMS;
-	}
 	// присоединить f к ec
 	objAppend(ec, f, 0);
 	// все нормально
-	*pec = ec;
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Создание описания эллиптической кривой в куче
+
+По долговременным параметрам params формируется описание pec эллиптической
+кривой. Указатель *pec является одновременно началом фрагмента памяти, 
+в котором размещается состояние и стек. Длина фрагмента определяется с учетом 
+потребностей deep.
+\pre Указатель pec корректен.
+\return ERR_OK, если описание успешно создано, и код ошибки в противном 
+случае.
+\remark Запрошенная память начинается по адресу objEnd(*pec, void).
+*******************************************************************************
+*/
+
+static err_t g12sEcCreate(
+	ec_o** pec,						/* [out] описание эллиптической кривой */
+	const g12s_params* params,		/* [in] долговременные параметры */
+	g12s_deep_i deep				/* [in] потребности в стековой памяти */
+)
+{
+	err_t code;
+	void* state;	
+	// pre
+	ASSERT(memIsValid(pec, sizeof(*pec)));
+	// минимальная проверка входных данных
+	if (!memIsValid(params, sizeof(g12s_params)) ||
+		params->l != 256 && params->l != 512)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(g12sStart_keep(params->l, deep));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// создать кривую
+	code = g12sStart(state, params);
+	if (code != ERR_OK)
+	{
+		blobClose(state);
+		return code;
+	}
+	// все нормально
+	*pec = (ec_o*)state;
 	return ERR_OK;
 }
 
@@ -690,12 +723,12 @@ void g12sEcClose(ec_o* ec)
 Проверка параметров
 
 -#	l \in {256, 512} (g12sEcCreate)
--#	2^254 < q < 2^256 или 2^508 < q < 2^512 (g12sEcCreate)
+-#	2^254 < q < 2^256 или 2^508 < q < 2^512 (g12sStart)
 -#	p -- простое (ecpIsValid)
 -#	q -- простое (ecpIsSafeGroup)
 -#	q != p (ecpIsSafeGroup)
 -#	p^m \not\equiv 1 (mod q), m = 1, 2,..., 31 или 131 (ecpIsSafeGroup)
--#	a, b < p (ecpCreateJ in g12sEcCreate)
+-#	a, b < p (ecpCreateJ in g12sStart)
 -#	J(E) \notin {0, 1728} <=> a, b != 0 (g12sParamsVal)
 -#	4a^3 + 27b^2 \not\equiv 0 (\mod p) (ecpIsValid)
 -#	P \in E (ecpSeemsValidGroup)
@@ -738,6 +771,109 @@ err_t g12sParamsVal(const g12s_params* params)
 	return code;
 }
 
+/*
+*******************************************************************************
+Контекст кривой
+
+Контекст содержит описание эллиптической кривой, построенное функцией
+g12sStart(), и таблицу pre кратных базовой точки для регулярного
+гребенчатого метода (ecMulSCombA()) с шириной гребенки G12S_CTX_W.
+Таблица строится для кратностей длины W_OF_B(l) машинных слов.
+
+Высокоуровневые функции реализованы в двух вариантах: с описанием кривой,
+которое строится при каждом вызове, и с контекстом. Общие действия
+выполняются внутренними функциями g12sXXXEc(), которые получают описание
+кривой ec, таблицу pre (или 0, если таблицы нет) и стек, длина которого
+определяется функцией g12sXXX_deep().
+
+Контекст не содержит секретных данных и после построения только читается.
+Поэтому его можно использовать одновременно в нескольких потоках.
+*******************************************************************************
+*/
+
+#define G12S_CTX_W		5		/*< ширина гребенки */
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	ec_o* ec;					/*< описание эллиптической кривой */
+	word* pre;					/*< [2^w * 2 * ec->f->n] кратные P */
+// }
+	size_t l;					/*< уровень стойкости */
+	octet data[];				/*< данные */
+} g12s_ctx_o;
+
+#define g12sCtxPreCount()\
+	(SIZE_1 << G12S_CTX_W)
+
+static size_t g12sCtx_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(g12sCtxPreCount() * 2 * n) +
+		ecPreSCombA_deep(n, ec_d, ec_deep);
+}
+
+size_t g12sCtx_keep(size_t l)
+{
+	return sizeof(g12s_ctx_o) + g12sStart_keep(l, g12sCtx_deep);
+}
+
+err_t g12sCtxStart(void* ctx, const g12s_params* params)
+{
+	err_t code;
+	g12s_ctx_o* c = (g12s_ctx_o*)ctx;
+	size_t n;
+	// проверить входные данные
+	if (!memIsValid(params, sizeof(g12s_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 256 && params->l != 512)
+		return ERR_BAD_PARAMS;
+	if (!memIsValid(ctx, g12sCtx_keep(params->l)))
+		return ERR_BAD_INPUT;
+	// контекст неработоспособен до завершения построения
+	memSetZero(c, sizeof(g12s_ctx_o));
+	// создать кривую
+	code = g12sStart(c->data, params);
+	ERR_CALL_CHECK(code);
+	c->ec = (ec_o*)c->data;
+	n = c->ec->f->n;
+	// настроить указатели
+	c->pre = objEnd(c->ec, word);
+	// рассчитать кратные P
+	if (!ecPreSCombA(c->pre, c->ec->base, c->ec, G12S_CTX_W,
+		W_OF_B(params->l), c->pre + g12sCtxPreCount() * 2 * n))
+	{
+		memSetZero(c, sizeof(g12s_ctx_o));
+		return ERR_BAD_PARAMS;
+	}
+	// настроить заголовок
+	c->hdr.keep = sizeof(g12s_ctx_o) + objKeep(c->ec) +
+		O_OF_W(g12sCtxPreCount() * 2 * n);
+	c->hdr.p_count = 2;
+	c->hdr.o_count = 1;
+	c->l = params->l;
+	// все нормально
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Проверка контекста и создание стека для функций g12sXXX2()
+*******************************************************************************
+*/
+
+static void* g12sCtxStack(const g12s_ctx_o* c, g12s_deep_i deep)
+{
+	ASSERT(objIsOperable(c));
+	return blobCreate(deep(c->ec->f->n, c->ec->f->deep, c->ec->d,
+		c->ec->deep));
+}
+
+#define g12sCtxIsOperable(c)\
+	(objIsOperable(c) && (c)->hdr.p_count == 2 && (c)->hdr.o_count == 1 &&\
+		((c)->l == 256 || (c)->l == 512) && ecIsOperable((c)->ec))
+
 /*
 *******************************************************************************
 Управление ключами
@@ -749,60 +885,88 @@ static size_t g12sKeypairGen_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	const size_t m = n;
 	return O_OF_W(m + 2 * n) + 
-		ecMulA_deep(n, ec_d, ec_deep, n);
+		utilMax(2,
+			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, m));
 }
 
-err_t g12sKeypairGen(octet privkey[], octet pubkey[],
-	const g12s_params* params, gen_i rng, void* rng_stack)
+static err_t g12sKeypairGenEc(octet privkey[], octet pubkey[],
+	const ec_o* ec, const word pre[], size_t l, gen_i rng, void* rng_stack,
+	void* stack)
 {
-	err_t code;
 	size_t m, mo;
 	// состояние
-	ec_o* ec = 0;
 	word* d;				/* [m] личный ключ */
 	word* Q;				/* [2n] открытый ключ */	
-	void* stack;
-	// проверить rng
-	if (rng == 0)
-		return ERR_BAD_RNG;
-	// старт
-	code = g12sEcCreate(&ec, params, g12sKeypairGen_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
-	m = W_OF_B(params->l);
-	mo = O_OF_B(params->l);
+	m = W_OF_B(l);
+	mo = O_OF_B(l);
 	// проверить входные указатели
 	if (!memIsValid(privkey, mo) || 
 		!memIsValid(pubkey, 2 * ec->f->no))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	d = objEnd(ec, word);
+	d = (word*)stack;
 	Q = d + m;
 	stack = Q + 2 * ec->f->n;
 	// d <-R {1,2,..., q - 1}
 	if (!zzRandNZMod(d, ec->order, m, rng, rng_stack))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_RNG;
-	}
 	// Q <- d P
-	if (!ecMulA(Q, ec->base, ec, d, m, stack))
-	{
-		g12sEcClose(ec);
+	if (pre ? !ecMulSCombA(Q, pre, ec, G12S_CTX_W, d, m, stack) :
+		!ecMulA(Q, ec->base, ec, d, m, stack))
 		return ERR_BAD_PARAMS;
-	}
 	// выгрузить ключи
 	wwTo(privkey, mo, d);
 	qrTo(pubkey, ecX(Q), ec->f, stack);
 	qrTo(pubkey + ec->f->no, ecY(Q, ec->f->n), ec->f, stack);
 	// все нормально
-	g12sEcClose(ec);
 	return ERR_OK;
 }
 
+err_t g12sKeypairGen(octet privkey[], octet pubkey[],
+	const g12s_params* params, gen_i rng, void* rng_stack)
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// старт
+	code = g12sEcCreate(&ec, params, g12sKeypairGen_deep);
+	ERR_CALL_CHECK(code);
+	// генерация
+	code = g12sKeypairGenEc(privkey, pubkey, ec, 0, params->l, rng,
+		rng_stack, objEnd(ec, void));
+	// завершение
+	g12sEcClose(ec);
+	return code;
+}
+
+err_t g12sKeypairGen2(octet privkey[], octet pubkey[], const void* ctx,
+	gen_i rng, void* rng_stack)
+{
+	err_t code;
+	const g12s_ctx_o* c = (const g12s_ctx_o*)ctx;
+	void* stack;
+	// проверить входные данные
+	if (!g12sCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать стек
+	stack = g12sCtxStack(c, g12sKeypairGen_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// генерация
+	code = g12sKeypairGenEc(privkey, pubkey, c->ec, c->pre, c->l, rng,
+		rng_stack, stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
+
 /*
 *******************************************************************************
 Выработка ЭЦП
@@ -814,45 +978,35 @@ static size_t g12sSign_deep(size_t n, size_t f_deep, size_t ec_d,
 {
 	const size_t m = n;
 	return 	O_OF_W(3 * m + 2 * n) +
-		utilMax(3,
+		utilMax(4,
 			zzMod_deep(m, m),
 			ecMulA_deep(n, ec_d, ec_deep, n),
+			ecMulSCombA_deep(n, ec_d, ec_deep, m),
 			zzMulMod_deep(m));
 }
 
-err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
-	const octet privkey[], gen_i rng, void* rng_stack)
+static err_t g12sSignEc(octet sig[], const ec_o* ec, const word pre[],
+	size_t l, const octet hash[], const octet privkey[], gen_i rng,
+	void* rng_stack, void* stack)
 {
-	err_t code;
 	size_t m, mo;
 	// состояние
-	ec_o* ec = 0;
 	word* d;		/* [m] личный ключ */
 	word* e;		/* [m] обработанное хэш-значение */
 	word* k;		/* [m] одноразовый ключ */
 	word* C;		/* [2n] вспомогательная точка */
 	word* r;		/* [m] первая (старшая) часть подписи */
 	word* s;		/* [m] вторая часть подписи */
-	void* stack;
-	// проверить rng
-	if (rng == 0)
-		return ERR_BAD_RNG;
-	// старт
-	code = g12sEcCreate(&ec, params, g12sSign_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
-	m = W_OF_B(params->l);
-	mo = O_OF_B(params->l);
+	m = W_OF_B(l);
+	mo = O_OF_B(l);
 	// проверить входные указатели
 	if (!memIsValid(hash, mo) ||
 		!memIsValid(privkey, mo) ||
 		!memIsValid(sig, 2 * mo))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	d = objEnd(ec, word);
+	d = (word*)stack;
 	e = d + m;
 	k = e + m;
 	C = k + m;
@@ -863,10 +1017,7 @@ err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
 	wwFrom(d, privkey, mo);
 	if (wwIsZero(d, m) || 
 		wwCmp(d, ec->order, m) >= 0)
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_PRIVKEY;
-	}
 	// e <- hash \mod q
 	memCopy(e, hash, mo);
 	memRev(e, mo);
@@ -878,17 +1029,12 @@ err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
 	// k <-R {1,2,..., q - 1}
 gen_k:
 	if (!zzRandNZMod(k, ec->order, m, rng, rng_stack))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_RNG;
-	}
 	// C <- k P
-	if (!ecMulA(C, ec->base, ec, k, m, stack))
-	{
+	if (pre ? !ecMulSCombA(C, pre, ec, G12S_CTX_W, k, m, stack) :
+		!ecMulA(C, ec->base, ec, k, m, stack))
 		// если params корректны, то этого быть не должно
-		g12sEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// r <- x_C \mod q
 	qrTo((octet*)C, ecX(C), ec->f, stack);
 	wwFrom(r, C, ec->f->no);
@@ -905,10 +1051,52 @@ gen_k:
 	wwTo(sig + mo, mo, r);
 	memRev(sig, 2 * mo);
 	// все нормально
-	g12sEcClose(ec);
 	return ERR_OK;
 }
 
+err_t g12sSign(octet sig[], const g12s_params* params, const octet hash[],
+	const octet privkey[], gen_i rng, void* rng_stack)
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// проверить rng
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// старт
+	code = g12sEcCreate(&ec, params, g12sSign_deep);
+	ERR_CALL_CHECK(code);
+	// выработка ЭЦП
+	code = g12sSignEc(sig, ec, 0, params->l, hash, privkey, rng, rng_stack,
+		objEnd(ec, void));
+	// завершение
+	g12sEcClose(ec);
+	return code;
+}
+
+err_t g12sSign2(octet sig[], const void* ctx, const octet hash[],
+	const octet privkey[], gen_i rng, void* rng_stack)
+{
+	err_t code;
+	const g12s_ctx_o* c = (const g12s_ctx_o*)ctx;
+	void* stack;
+	// проверить входные данные
+	if (!g12sCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	if (rng == 0)
+		return ERR_BAD_RNG;
+	// создать стек
+	stack = g12sCtxStack(c, g12sSign_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// выработка ЭЦП
+	code = g12sSignEc(sig, c->ec, c->pre, c->l, hash, privkey, rng,
+		rng_stack, stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
+
 /*
 *******************************************************************************
 Проверка ЭЦП
@@ -927,34 +1115,25 @@ static size_t g12sVerify_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecAddMulA_deep(n, ec_d, ec_deep, 2, m, m));
 }
 
-err_t g12sVerify(const g12s_params* params, const octet hash[], 
-	const octet sig[], const octet pubkey[])
+static err_t g12sVerifyEc(const ec_o* ec, size_t l, const octet hash[],
+	const octet sig[], const octet pubkey[], void* stack)
 {
-	err_t code;
 	size_t m, mo;
 	// состояние
-	ec_o* ec = 0;
 	word* Q;		/* [2n] открытый ключ / точка R */
 	word* r;		/* [m] первая (старшая) часть подписи */
 	word* s;		/* [m] вторая часть подписи */
 	word* e;		/* [m] обработанное хэш-значение, v */
-	void* stack;
-	// старт
-	code = g12sEcCreate(&ec, params, g12sVerify_deep);
-	ERR_CALL_CHECK(code);
 	// размерности order
-	m = W_OF_B(params->l);
-	mo = O_OF_B(params->l);
+	m = W_OF_B(l);
+	mo = O_OF_B(l);
 	// проверить входные указатели
 	if (!memIsValid(hash, mo) ||
 		!memIsValid(sig, 2 * mo) ||
 		!memIsValid(pubkey, 2 * ec->f->no))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_INPUT;
-	}
 	// раскладка состояния
-	Q = objEnd(ec, word);
+	Q = (word*)stack;
 	r = Q + 2 * ec->f->n;
 	s = r + m;
 	e = s + m;
@@ -962,10 +1141,7 @@ err_t g12sVerify(const g12s_params* params, const octet hash[],
 	// загрузить Q
 	if (!qrFrom(ecX(Q), pubkey, ec->f, stack) ||
 		!qrFrom(ecY(Q, ec->f->n), pubkey + ec->f->no, ec->f, stack))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_PUBKEY;
-	}
 	// загрузить r и s
 	memCopy(s, sig + mo, mo);
 	memRev(s, mo);
@@ -977,10 +1153,7 @@ err_t g12sVerify(const g12s_params* params, const octet hash[],
 		wwIsZero(r, m) || 
 		wwCmp(s, ec->order, m) >= 0 ||
 		wwCmp(r, ec->order, m) >= 0)
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_SIG;
-	}
 	// e <- hash \mod q
 	memCopy(e, hash, mo);
 	memRev(e, mo);
@@ -998,17 +1171,47 @@ err_t g12sVerify(const g12s_params* params, const octet hash[],
 	zzNegMod(e, e, ec->order, m);
 	// Q <- s P + e Q [z1 P + z2 Q = R]
 	if (!ecAddMulA(Q, ec, stack, 2, ec->base, s, m, Q, e, m))
-	{
-		g12sEcClose(ec);
 		return ERR_BAD_PARAMS;
-	}
 	// s <- x_Q \mod q [x_R \mod q]
 	qrTo((octet*)Q, ecX(Q), ec->f, stack);
 	wwFrom(Q, Q, ec->f->no);
 	zzMod(s, Q, ec->f->n, ec->order, m, stack);
 	// s == r?
-	code = wwEq(r, s, m) ? ERR_OK : ERR_BAD_SIG;
+	return wwEq(r, s, m) ? ERR_OK : ERR_BAD_SIG;
+}
+
+err_t g12sVerify(const g12s_params* params, const octet hash[], 
+	const octet sig[], const octet pubkey[])
+{
+	err_t code;
+	// состояние
+	ec_o* ec = 0;
+	// старт
+	code = g12sEcCreate(&ec, params, g12sVerify_deep);
+	ERR_CALL_CHECK(code);
+	// проверка ЭЦП
+	code = g12sVerifyEc(ec, params->l, hash, sig, pubkey, objEnd(ec, void));
 	// завершение
 	g12sEcClose(ec);
 	return code;
 }
+
+err_t g12sVerify2(const void* ctx, const octet hash[], const octet sig[],
+	const octet pubkey[])
+{
+	err_t code;
+	const g12s_ctx_o* c = (const g12s_ctx_o*)ctx;
+	void* stack;
+	// проверить контекст
+	if (!g12sCtxIsOperable(c))
+		return ERR_BAD_INPUT;
+	// создать стек
+	stack = g12sCtxStack(c, g12sVerify_deep);
+	if (stack == 0)
+		return ERR_OUTOFMEMORY;
+	// проверка ЭЦП
+	code = g12sVerifyEc(c->ec, c->l, hash, sig, pubkey, stack);
+	// завершение
+	blobClose(stack);
+	return code;
+}
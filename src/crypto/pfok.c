@@ -4,7 +4,7 @@
 \brief Draft of RD_RB: key establishment protocols in finite fields
 \project bee2 [cryptographic library]
 \created 2014.07.01
-\version 2024.03.04
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,9 +13,11 @@
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/obj.h"
 #include "bee2/core/prng.h"
 #include "bee2/core/str.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/crypto/pfok.h"
 #include "bee2/math/pri.h"
 #include "bee2/math/zm.h"
@@ -779,6 +781,58 @@ err_t pfokParamsVal(const pfok_params* params)
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Возведение в степень в B_p
+
+Группа Монтгомери B_p определяется по R' = 2^{l + 2}, а функции 
+zzPowerMont(), zzPowerMontComb() используют R = B^n, n = W_OF_B(l). 
+Пусть k = B_OF_W(n) - l - 2 и phi(u) = u 2^k \bmod p. Тогда 
+	phi(u \circ' v) = phi(u) \circ phi(v),
+где \circ' -- умножение в B_p, \circ -- умножение Монтгомери с R = B^n. 
+Поэтому 
+	u^(v) = phi^{-1}(phi(u)^(v)), 
+где степень в правой части вычисляется с помощью zzPowerMont().
+
+Отображение phi реализуется k удвоениями по модулю p, phi^{-1} -- 
+k делениями пополам. При стандартных l число k равняется 0 или 32 
+(B_PER_W == 64) и 0 или 16 (B_PER_W == 32). Преобразования выполняются 
+один раз на возведение в степень, а не при каждом умножении, как 
+в кольце zmMontCreate(qr, p, no, l + 2, stack).
+*******************************************************************************
+*/
+
+static void pfokPhi(word u[], const word p[], size_t n, size_t l)
+{
+	size_t k;
+	ASSERT(B_OF_W(n) >= l + 2);
+	for (k = B_OF_W(n) - l - 2; k--;)
+		zzDoubleMod(u, u, p, n);
+}
+
+static void pfokPhiInv(word u[], const word p[], size_t n, size_t l)
+{
+	size_t k;
+	ASSERT(B_OF_W(n) >= l + 2);
+	for (k = B_OF_W(n) - l - 2; k--;)
+		zzHalfMod(u, u, p, n);
+}
+
+static void pfokPower(word y[], const word u[], const word x[], size_t r,
+	const word p[], size_t n, size_t l, void* stack)
+{
+	ASSERT(wwIsSameOrDisjoint(y, u, n));
+	wwCopy(y, u, n);
+	pfokPhi(y, p, n, l);
+	zzPowerMont(y, y, x, r, p, n, wordNegInv(p[0]), stack);
+	pfokPhiInv(y, p, n, l);
+}
+
+static size_t pfokPower_deep(size_t n, size_t r)
+{
+	return zzPowerMont_deep(n, r);
+}
+
 /*
 *******************************************************************************
 Управление ключами
@@ -794,7 +848,7 @@ err_t pfokKeypairGen(octet privkey[], octet pubkey[],
 	void* state;
 	word* x;				/* [m] личный ключ */
 	word* y;				/* [n] открытый ключ */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	word* p;				/* [n] модуль */
 	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(pfok_params)))
@@ -810,29 +864,26 @@ err_t pfokKeypairGen(octet privkey[], octet pubkey[],
 		return ERR_BAD_INPUT;
 	// создать состояние
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(2 * n) + O_OF_W(m) + pfokPower_deep(n, params->r));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	p = y + n;
+	stack = p + n;
+	// загрузить модуль
+	wwFrom(p, params->p, no);
 	// x <-R {0, 1,..., 2^r - 1}
 	rng(x, mo, rng_state);
 	wwFrom(x, x, mo);
 	wwTrimHi(x, m, params->r);
 	// y <- g^(x)
 	wwFrom(y, params->g, no);
-	qrPower(y, y, x, m, qr, stack);
+	pfokPower(y, y, x, params->r, p, n, params->l, stack);
 	// выгрузить ключи
 	wwTo(privkey, mo, x);
-	qrTo(pubkey, y, qr, stack);
+	wwTo(pubkey, no, y);
 	// все нормально
 	blobClose(state);
 	return ERR_OK;
@@ -868,7 +919,7 @@ err_t pfokPubkeyCalc(octet pubkey[], const pfok_params* params,
 	void* state;
 	word* x;				/* [m] личный ключ */
 	word* y;				/* [n] открытый ключ */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	word* p;				/* [n] модуль */
 	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(pfok_params)))
@@ -884,19 +935,16 @@ err_t pfokPubkeyCalc(octet pubkey[], const pfok_params* params,
 		return ERR_BAD_INPUT;
 	// создать состояние
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(2 * n) + O_OF_W(m) + pfokPower_deep(n, params->r));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	p = y + n;
+	stack = p + n;
+	// загрузить модуль
+	wwFrom(p, params->p, no);
 	// x <- privkey
 	wwFrom(x, privkey, mo);
 	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0)
@@ -906,9 +954,9 @@ err_t pfokPubkeyCalc(octet pubkey[], const pfok_params* params,
 	}
 	// y <- g^(x)
 	wwFrom(y, params->g, no);
-	qrPower(y, y, x, m, qr, stack);
+	pfokPower(y, y, x, params->r, p, n, params->l, stack);
 	// выгрузить открытый ключ
-	qrTo(pubkey, y, qr, stack);
+	wwTo(pubkey, no, y);
 	// все нормально
 	blobClose(state);
 	return ERR_OK;
@@ -929,7 +977,7 @@ err_t pfokDH(octet sharekey[], const pfok_params* params,
 	void* state;
 	word* x;				/* [m] личный ключ */
 	word* y;				/* [n] открытый ключ визави */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	word* p;				/* [n] модуль */
 	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(pfok_params)))
@@ -947,19 +995,16 @@ err_t pfokDH(octet sharekey[], const pfok_params* params,
 		return ERR_BAD_INPUT;
 	// создать состояние
 	state = blobCreate(
-		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(2 * n) + O_OF_W(m) + pfokPower_deep(n, params->r));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
 	x = (word*)state;
 	y = x + m;
-	qr = (qr_o*)(y + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	p = y + n;
+	stack = p + n;
+	// загрузить модуль
+	wwFrom(p, params->p, no);
 	// x <- privkey
 	wwFrom(x, privkey, mo);
 	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0)
@@ -969,14 +1014,14 @@ err_t pfokDH(octet sharekey[], const pfok_params* params,
 	}
 	// y <- pubkey
 	wwFrom(y, pubkey, no);
-	if (wwIsZero(y, n) || wwCmp(y, qr->mod, n) >= 0)
+	if (wwIsZero(y, n) || wwCmp(y, p, n) >= 0)
 	{
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
-	qrPower(y, y, x, m, qr, stack);
+	pfokPower(y, y, x, params->r, p, n, params->l, stack);
 	// выгрузить открытый ключ
-	qrTo((octet*)y, y, qr, stack);
+	wwTo(y, no, y);
 	memCopy(sharekey, y, O_OF_B(params->n));
 	if (params->n % 8)
 		sharekey[params->n / 8] &= (octet)255 >> (8 - params->n % 8);
@@ -997,7 +1042,7 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	word* u;				/* [m] одноразовый личный ключ */
 	word* y;				/* [n] открытый ключ визави */
 	word* v;				/* [n] одноразовый открытый ключ визави */
-	qr_o* qr;				/* описание кольца Монтгомери */
+	word* p;				/* [n] модуль */
 	void* stack;
 	// проверить params
 	if (!memIsValid(params, sizeof(pfok_params)))
@@ -1017,10 +1062,7 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 		return ERR_BAD_INPUT;
 	// создать состояние
 	state = blobCreate(
-		2 * O_OF_W(n) + 2 * O_OF_W(m) + zmMontCreate_keep(no) +  
-		utilMax(2,
-			zmMontCreate_deep(no),
-			qrPower_deep(n, n, zmMontCreate_deep(no))));
+		O_OF_W(3 * n) + 2 * O_OF_W(m) + pfokPower_deep(n, params->r));
 	if (state == 0)
 		return ERR_OUTOFMEMORY;
 	// раскладка состояния
@@ -1028,10 +1070,10 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	u = x + m;
 	y = u + m;
 	v = y + n;
-	qr = (qr_o*)(v + n);
-	stack = (octet*)qr + zmMontCreate_keep(no);
-	// построить кольцо Монтгомери
-	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	p = v + n;
+	stack = p + n;
+	// загрузить модуль
+	wwFrom(p, params->p, no);
 	// x <- privkey, u <- privkey1
 	wwFrom(x, privkey, mo);
 	wwFrom(u, privkey1, mo);
@@ -1044,18 +1086,18 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	// y <- pubkey, v <- pubkey1
 	wwFrom(y, pubkey, no);
 	wwFrom(v, pubkey1, no);
-	if (wwIsZero(y, n) || wwCmp(y, qr->mod, n) >= 0 ||
-		wwIsZero(v, n) || wwCmp(v, qr->mod, n) >= 0)
+	if (wwIsZero(y, n) || wwCmp(y, p, n) >= 0 ||
+		wwIsZero(v, n) || wwCmp(v, p, n) >= 0)
 	{
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
 	// y <- y^u, v <- v^x
-	qrPower(y, y, u, m, qr, stack);
-	qrPower(v, v, x, m, qr, stack);
+	pfokPower(y, y, u, params->r, p, n, params->l, stack);
+	pfokPower(v, v, x, params->r, p, n, params->l, stack);
 	// выгрузить открытый ключ
-	qrTo((octet*)y, y, qr, stack);
-	qrTo((octet*)v, v, qr, stack);
+	wwTo(y, no, y);
+	wwTo(v, no, v);
 	memCopy(sharekey, y, O_OF_B(params->n));
 	memXor2(sharekey, v, O_OF_B(params->n));
 	if (params->n % 8)
@@ -1064,3 +1106,188 @@ err_t pfokMTI(octet sharekey[], const pfok_params* params,
 	blobClose(state);
 	return ERR_OK;
 }
+
+/*
+*******************************************************************************
+Контекст фиксированного основания
+
+Контекст содержит модуль p и таблицу гребенки 
+	pre[k] = \prod_{i: k_i = 1} phi(g)^(2^{id}), 0 <= k < 2^w, 
+d = ceil(r / w), которая строится функцией zzPowerMontPre(). Степени 
+g^(x) вычисляются функцией zzPowerMontComb(): d возведений в квадрат 
+и d умножений вместо r возведений в квадрат и примерно r / 6 умножений 
+в zzPowerMont().
+
+Контекст не содержит секретных данных и после построения только читается. 
+Поэтому его можно использовать одновременно в нескольких потоках.
+*******************************************************************************
+*/
+
+#define PFOK_CTX_W		5		/*< ширина гребенки */
+
+typedef struct
+{
+	obj_hdr_t hdr;				/*< заголовок */
+// ptr_table {
+	word* p;					/*< [n] модуль */
+	word* pre;					/*< [n * 2^w] таблица гребенки */
+// }
+	pfok_params params[1];		/*< параметры */
+	octet data[];				/*< данные */
+} pfok_ctx_o;
+
+size_t pfokCtx_keep(size_t l)
+{
+	const size_t n = W_OF_B(l);
+	return sizeof(pfok_ctx_o) + O_OF_W(n + (n << PFOK_CTX_W));
+}
+
+err_t pfokCtxStart(void* ctx, const pfok_params* params)
+{
+	pfok_ctx_o* c = (pfok_ctx_o*)ctx;
+	size_t n, no;
+	// состояние
+	void* state;
+	word* g;				/* [n] phi(g) */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(pfok_params)))
+		return ERR_BAD_INPUT;
+	// работоспособные параметры?
+	if (!pfokParamsIsOperable(params))
+		return ERR_BAD_PARAMS;
+	// размерности
+	n = W_OF_B(params->l), no = O_OF_B(params->l);
+	// проверить остальные входные данные
+	if (!memIsValid(ctx, pfokCtx_keep(params->l)))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(O_OF_W(n) + zzPowerMontPre_deep(n));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	g = (word*)state;
+	stack = g + n;
+	// настроить контекст
+	memCopy(c->params, params, sizeof(pfok_params));
+	c->p = (word*)c->data;
+	c->pre = c->p + n;
+	c->hdr.keep = pfokCtx_keep(params->l);
+	c->hdr.p_count = 2;
+	c->hdr.o_count = 0;
+	// загрузить модуль
+	wwFrom(c->p, params->p, no);
+	// g <- phi(g)
+	wwFrom(g, params->g, no);
+	if (wwIsZero(g, n) || wwCmp(g, c->p, n) >= 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PARAMS;
+	}
+	pfokPhi(g, c->p, n, params->l);
+	// построить таблицу
+	zzPowerMontPre(c->pre, PFOK_CTX_W, g, params->r, c->p, n, 
+		wordNegInv(c->p[0]), stack);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+static void pfokCtxPower(word y[], const pfok_ctx_o* c, const word x[], 
+	void* stack)
+{
+	const size_t n = W_OF_B(c->params->l);
+	zzPowerMontComb(y, c->pre, PFOK_CTX_W, x, c->params->r, c->p, n, 
+		wordNegInv(c->p[0]), stack);
+	pfokPhiInv(y, c->p, n, c->params->l);
+}
+
+static size_t pfokCtxPower_deep(size_t n)
+{
+	return zzPowerMontComb_deep(n);
+}
+
+err_t pfokKeypairGen2(octet privkey[], octet pubkey[], const void* ctx, 
+	gen_i rng, void* rng_state)
+{
+	const pfok_ctx_o* c = (const pfok_ctx_o*)ctx;
+	size_t n, no;
+	size_t m, mo;
+	// состояние
+	void* state;
+	word* x;				/* [m] личный ключ */
+	word* y;				/* [n] открытый ключ */
+	void* stack;
+	// проверить контекст
+	if (!objIsOperable(c) || c->hdr.p_count != 2)
+		return ERR_BAD_INPUT;
+	// размерности
+	n = W_OF_B(c->params->l), no = O_OF_B(c->params->l);
+	m = W_OF_B(c->params->r), mo = O_OF_B(c->params->r);
+	// проверить остальные входные данные
+	if (!memIsValid(privkey, mo) || !memIsValid(pubkey, no) || rng == 0)
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(O_OF_W(n) + O_OF_W(m) + pfokCtxPower_deep(n));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	x = (word*)state;
+	y = x + m;
+	stack = y + n;
+	// x <-R {0, 1,..., 2^r - 1}
+	rng(x, mo, rng_state);
+	wwFrom(x, x, mo);
+	wwTrimHi(x, m, c->params->r);
+	// y <- g^(x)
+	pfokCtxPower(y, c, x, stack);
+	// выгрузить ключи
+	wwTo(privkey, mo, x);
+	wwTo(pubkey, no, y);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+err_t pfokPubkeyCalc2(octet pubkey[], const void* ctx, const octet privkey[])
+{
+	const pfok_ctx_o* c = (const pfok_ctx_o*)ctx;
+	size_t n, no;
+	size_t m, mo;
+	// состояние
+	void* state;
+	word* x;				/* [m] личный ключ */
+	word* y;				/* [n] открытый ключ */
+	void* stack;
+	// проверить контекст
+	if (!objIsOperable(c) || c->hdr.p_count != 2)
+		return ERR_BAD_INPUT;
+	// размерности
+	n = W_OF_B(c->params->l), no = O_OF_B(c->params->l);
+	m = W_OF_B(c->params->r), mo = O_OF_B(c->params->r);
+	// проверить остальные входные данные
+	if (!memIsValid(privkey, mo) || !memIsValid(pubkey, no))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(O_OF_W(n) + O_OF_W(m) + pfokCtxPower_deep(n));
+	if (state == 0)
+		return ERR_OUTOFMEMORY;
+	// раскладка состояния
+	x = (word*)state;
+	y = x + m;
+	stack = y + n;
+	// x <- privkey
+	wwFrom(x, privkey, mo);
+	if (wwGetBits(x, c->params->r, B_OF_W(m) - c->params->r) != 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// y <- g^(x)
+	pfokCtxPower(y, c, x, stack);
+	// выгрузить открытый ключ
+	wwTo(pubkey, no, y);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
@@ -4,7 +4,7 @@
 \brief Elliptic curves
 \project bee2 [cryptographic library]
 \created 2014.03.04
-\version 2015.11.09
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -245,6 +245,302 @@ size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
 		ec_deep;
 }
 
+/*
+*******************************************************************************
+Кратная точка: фиксированная база
+
+Для многократного вычисления кратных одной и той же точки a используется 
+гребенчатый метод (fixed-base comb) с шириной гребенки w (алгоритм 3.44 из 
+[Hankerson D., Menezes A., Vanstone S. Guide to Elliptic Curve Cryptography, 
+Springer, 2004]).
+
+Кратность d длины m машинных слов разбивается на w строк по e = ceil(l / w)
+битов, l = B_OF_W(m). Предварительно рассчитываются аффинные точки 
+	pre[k - 1] = \sum_{j: k_j = 1} 2^{je} a, k = 1, 2,..., 2^w - 1,
+где k_j -- j-й бит k. При вычислении кратной точки выполняется e удвоений 
+и не более e сложений с точками из pre, а не l удвоений и около l / (w + 1)
+сложений, как в функции ecMulA().
+
+Если одна из точек pre окажется равной O (вероятность этого пренебрежимо 
+мала), то предвычисление завершается с ошибкой.
+*******************************************************************************
+*/
+
+bool_t ecPreCombA(word pre[], const word a[], const ec_o* ec, size_t w,
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t e = (B_OF_W(m) + w - 1) / w;
+	size_t j, k, i;
+	// переменные в stack
+	word* t;			/* [ec->d * n] вспомогательная точка */
+	word* u;			/* [ec->d * n] вспомогательная точка */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(1 <= w && w <= 8);
+	ASSERT(wwIsValid(pre, ((SIZE_1 << w) - 1) * 2 * n));
+	// раскладка stack
+	t = (word*)stack;
+	u = t + ec->d * n;
+	stack = u + ec->d * n;
+	// pre[2^j - 1] <- 2^{je} a
+	wwCopy(pre, a, 2 * n);
+	for (j = 1; j < w; ++j)
+	{
+		ecFromA(t, pre + ((SIZE_1 << (j - 1)) - 1) * 2 * n, ec, stack);
+		for (i = 0; i < e; ++i)
+			ecDbl(t, t, ec, stack);
+		if (!ecToA(pre + ((SIZE_1 << j) - 1) * 2 * n, t, ec, stack))
+			return FALSE;
+	}
+	// pre[k - 1] <- pre[k - 2^j - 1] + pre[2^j - 1], 2^j < k < 2^{j + 1}
+	for (j = 1; j < w; ++j)
+		for (k = (SIZE_1 << j) + 1; k < (SIZE_1 << (j + 1)); ++k)
+		{
+			ecFromA(u, pre + (k - (SIZE_1 << j) - 1) * 2 * n, ec, stack);
+			ecAddA(u, u, pre + ((SIZE_1 << j) - 1) * 2 * n, ec, stack);
+			if (!ecToA(pre + (k - 1) * 2 * n, u, ec, stack))
+				return FALSE;
+		}
+	return TRUE;
+}
+
+size_t ecPreCombA_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W(2 * ec_d * n) + ec_deep;
+}
+
+bool_t ecMulCombA(word b[], const word pre[], const ec_o* ec, size_t w,
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t e = (B_OF_W(m) + w - 1) / w;
+	register size_t k;
+	size_t i, j;
+	bool_t started = FALSE;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + ec->d * n;
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(1 <= w && w <= 8);
+	ASSERT(wwIsValid(pre, ((SIZE_1 << w) - 1) * 2 * n));
+	ASSERT(wwIsValid(d, m));
+	// цикл по столбцам гребенки
+	for (i = e; i--;)
+	{
+		if (started)
+			ecDbl(t, t, ec, stack);
+		// k <- (d_{i + (w - 1)e} ... d_{i + e} d_i)_2
+		for (k = 0, j = w; j--;)
+		{
+			k <<= 1;
+			if (i + j * e < B_OF_W(m))
+				k |= wwTestBit(d, i + j * e);
+		}
+		if (k == 0)
+			continue;
+		// t <- t + pre[k - 1]
+		if (started)
+			ecAddA(t, t, pre + (k - 1) * 2 * n, ec, stack);
+		else
+			ecFromA(t, pre + (k - 1) * 2 * n, ec, stack), started = TRUE;
+	}
+	// d == 0 => b <- O
+	if (!started)
+		return FALSE;
+	// к аффинным координатам
+	return ecToA(b, t, ec, stack);
+}
+
+size_t ecMulCombA_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W(ec_d * n) + ec_deep;
+}
+
+/*
+*******************************************************************************
+Кратная точка: фиксированная база, регулярный гребенчатый метод
+
+Функция ecMulCombA() пропускает нулевые столбцы гребенки и выбирает точки
+из таблицы по значениям столбцов. Поэтому время ее выполнения и обращения
+к памяти зависят от кратности. Для секретных кратностей используется
+регулярный (знаковый) вариант гребенчатого метода [Hamburg M. Fast and
+compact elliptic-curve cryptography, 2012].
+
+Пусть L = ew, e = ceil(l / w), l = B_OF_W(m), и d' -- нечетное число
+меньше 2^L. Положим d'' = (d' >> 1) | 2^{L - 1} и s_i = 2 d''_i - 1
+(s_i = \pm 1), где d''_i -- i-й бит d''. Тогда
+	\sum_{i = 0}^{L - 1} s_i 2^i = 2 d'' - (2^L - 1) = d'.
+Таким образом, столбцы гребенки принимают значения
+	V_i = \sum_{j = 0}^{w - 1} s_{i + je} 2^{je} a,
+среди которых нет нулевых. Если s_i = -1, то V_i = -T[k], где
+	T[k] = a + \sum_{j = 1}^{w - 1} (2k_{j - 1} - 1) 2^{je} a,
+	k = 0, 1,..., 2^{w - 1} - 1,
+k_j -- j-й бит k. Предварительно рассчитываются аффинные точки
+	pre[k] = T[k], pre[2^{w - 1} + k] = -T[k].
+При вычислении кратной точки выполняется ровно e - 1 удвоений и e - 1
+сложений, нужная точка pre извлекается просмотром всей таблицы с маскированием.
+
+Кратность d приводится к нечетной: если d четно, то используется
+d' = order - d и результат обращается. Выбор d' и обращение результата
+выполняются по маскам.
+
+\remark Сложение точек в ecAddA() обрабатывает особые случаи (слагаемые
+совпадают или противоположны) ветвлениями. При 0 < d < order такие
+случаи возникают с пренебрежимо малой вероятностью.
+*******************************************************************************
+*/
+
+bool_t ecPreSCombA(word pre[], const word a[], const ec_o* ec, size_t w,
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t e = (B_OF_W(m) + w - 1) / w;
+	const size_t h = SIZE_1 << (w - 1);
+	size_t i, j, k;
+	// переменные в stack
+	word* t;			/* [ec->d * n] вспомогательная точка */
+	word* u;			/* [ec->d * n] вспомогательная точка */
+	word* q;			/* [(w - 1) * 2 * n] кратные 2^{je} a */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(1 <= w && w <= 8);
+	ASSERT(wwIsValid(pre, 2 * h * 2 * n));
+	// раскладка stack
+	t = (word*)stack;
+	u = t + ec->d * n;
+	q = u + ec->d * n;
+	stack = q + (w - 1) * 2 * n;
+	// q[j - 1] <- 2^{je} a, t <- a - \sum_j q[j - 1]
+	ecFromA(t, a, ec, stack);
+	ecFromA(u, a, ec, stack);
+	for (j = 1; j < w; ++j)
+	{
+		for (i = 0; i < e; ++i)
+			ecDbl(u, u, ec, stack);
+		if (!ecToA(q + (j - 1) * 2 * n, u, ec, stack))
+			return FALSE;
+		ecSubA(t, t, q + (j - 1) * 2 * n, ec, stack);
+	}
+	// pre[0] <- t
+	if (!ecToA(pre, t, ec, stack))
+		return FALSE;
+	// pre[k + 2^{j - 1}] <- pre[k] + 2 q[j - 1], k < 2^{j - 1}
+	for (j = 1; j < w; ++j)
+		for (k = 0; k < (SIZE_1 << (j - 1)); ++k)
+		{
+			ecFromA(t, pre + k * 2 * n, ec, stack);
+			ecAddA(t, t, q + (j - 1) * 2 * n, ec, stack);
+			ecAddA(t, t, q + (j - 1) * 2 * n, ec, stack);
+			if (!ecToA(pre + (k + (SIZE_1 << (j - 1))) * 2 * n, t, ec, 
+				stack))
+				return FALSE;
+		}
+	// pre[h + k] <- -pre[k]
+	for (k = 0; k < h; ++k)
+	{
+		ecFromA(t, pre + k * 2 * n, ec, stack);
+		ecNeg(t, t, ec, stack);
+		VERIFY(ecToA(pre + (h + k) * 2 * n, t, ec, stack));
+	}
+	return TRUE;
+}
+
+size_t ecPreSCombA_deep(size_t n, size_t ec_d, size_t ec_deep)
+{
+	return O_OF_W(2 * ec_d * n + 7 * 2 * n) + ec_deep;
+}
+
+static void ecSCombSelect(word a[], const word pre[], size_t count, size_t k,
+	size_t len)
+{
+	register word mask;
+	size_t i, l;
+	wwSetZero(a, len);
+	for (i = 0; i < count; ++i)
+	{
+		mask = wordEq0M((word)i, (word)k);
+		for (l = 0; l < len; ++l)
+			a[l] |= pre[i * len + l] & mask;
+	}
+	mask = 0;
+}
+
+bool_t ecMulSCombA(word b[], const word pre[], const ec_o* ec, size_t w,
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t e = (B_OF_W(m) + w - 1) / w;
+	const size_t h = SIZE_1 << (w - 1);
+	const size_t mm = W_OF_B(e * w);
+	register word mask;
+	register size_t k;
+	size_t i, j;
+	// переменные в stack
+	word* t;			/* [ec->d * n] вспомогательная точка */
+	word* u;			/* [ec->d * n] вспомогательная точка */
+	word* a;			/* [2 * n] точка таблицы */
+	word* dd;			/* [mm] кратность d'' */
+	// pre
+	ASSERT(ecIsOperable(ec));
+	ASSERT(1 <= w && w <= 8);
+	ASSERT(wwIsValid(pre, 2 * h * 2 * n));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(zzIsOdd(ec->order, n + 1));
+	ASSERT(wwWordSize(ec->order, n + 1) <= m && m <= n + 1);
+	ASSERT(wwCmp2(d, m, ec->order, n + 1) < 0);
+	// раскладка stack
+	t = (word*)stack;
+	u = t + ec->d * n;
+	a = u + ec->d * n;
+	dd = a + 2 * n;
+	stack = dd + mm;
+	// dd <- d, если d нечетно, и order - d в противном случае
+	wwSetZero(dd, mm);
+	zzSub(dd, ec->order, d, m);
+	mask = WORD_0 - (d[0] & WORD_1);
+	for (i = 0; i < m; ++i)
+		dd[i] = (d[i] & mask) | (dd[i] & ~mask);
+	// dd <- (dd >> 1) | 2^{ew - 1}
+	wwShLo(dd, mm, 1);
+	wwSetBit(dd, e * w - 1, 1);
+	// цикл по столбцам гребенки
+	for (i = e; i--;)
+	{
+		// k <- (d_{i + (w - 1)e} ... d_{i + e})_2
+		for (k = 0, j = w; --j;)
+			k = k << 1 | (size_t)wwTestBit(dd, i + j * e);
+		// d_i == 0 => k <- h + (k ^ (h - 1)) [V_i = -T[k]]
+		k ^= ((size_t)wwTestBit(dd, i) - 1) & (2 * h - 1);
+		// a <- pre[k]
+		ecSCombSelect(a, pre, 2 * h, k, 2 * n);
+		// t <- 2 t + a
+		if (i + 1 == e)
+			ecFromA(t, a, ec, stack);
+		else
+		{
+			ecDbl(t, t, ec, stack);
+			ecAddA(t, t, a, ec, stack);
+		}
+	}
+	// d четно => t <- -t
+	ecNeg(u, t, ec, stack);
+	mask = ~mask;
+	for (i = 0; i < ec->d * n; ++i)
+		t[i] = (t[i] & ~mask) | (u[i] & mask);
+	// очистка
+	mask = 0;
+	k = 0;
+	// к аффинным координатам
+	return ecToA(b, t, ec, stack);
+}
+
+size_t ecMulSCombA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
+{
+	return O_OF_W(2 * ec_d * n + 2 * n + m + 1) + ec_deep;
+}
+
 /*
 *******************************************************************************
 Имеет порядок?
@@ -4,7 +4,7 @@
 \brief Elliptic curves over binary fields
 \project bee2 [cryptographic library]
 \created 2012.06.26
-\version 2014.07.15
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,6 +13,7 @@
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/ec2.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/pri.h"
@@ -858,3 +859,172 @@ size_t ec2SubAA_deep(size_t n, size_t f_deep)
 {
 	return O_OF_W(2 * n) + ec2AddAA_deep(n, f_deep);
 }
+
+/*
+*******************************************************************************
+Лестница Монтгомери
+
+Реализован алгоритм Лопеса -- Дахаба [Lopez J., Dahab R. Fast 
+multiplication on elliptic curves over GF(2^m) without precomputation, 
+CHES 1999] (см. также [Hankerson D., Menezes A., Vanstone S. Guide to 
+Elliptic Curve Cryptography, Springer, 2004, алгоритм 3.40]).
+
+Поддерживаются пары проективных точек R0 = (X0 : Z0) = k P и 
+R1 = (X1 : Z1) = (k + 1) P, x = X / Z. На каждом шаге обрабатывается 
+очередной бит d (начиная со старшего): 
+	бит 0: R1 <- R0 + R1, R0 <- 2 R0;
+	бит 1: R0 <- R0 + R1, R1 <- 2 R1.
+Шаги выполняются единообразно: точки R0 и R1 условно меняются местами
+(маскированием без ветвлений), после чего R1 <- R0 + R1, R0 <- 2 R0.
+
+Сложение (разность слагаемых известна и равняется P = (x, y)):
+	T1 <- X0 Z1, T2 <- X1 Z0,
+	Z1 <- (T1 + T2)^2, X1 <- x Z1 + T1 T2.
+Сложность: 3M + 1S.
+
+Удвоение:
+	T <- X0^2, U <- Z0^2,
+	Z0 <- T U, X0 <- T^2 + B U^2 = (T + \sqrt{B} U)^2.
+Сложность: 2M + 3S. На кривых Коблица (B = 1) умножение на \sqrt{B}
+не выполняется: 1M + 3S.
+
+Коэффициент A в формулах не участвует. Итоговая сложность --
+5M + 4S (4M + 4S для кривых Коблица) на бит против приблизительно 
+5M + 4S на удвоение и 9M + 5S на сложение в ecMulA().
+
+Начальные значения: R0 = O = (1 : 0), R1 = P = (x : 1). Формулы 
+остаются корректными при R0 = O, поэтому можно обрабатывать 
+фиксированное число битов, равное битовой длине ec->order (если d 
+длиннее -- то битовой длине d). Время обработки d < ec->order
+не зависит от d.
+
+По завершении восстанавливается y-координата d P [Lopez, Dahab]:
+	x3 = X0 / Z0,
+	y3 = (x3 + x)[(X0 + x Z0)(X1 + x Z1) + (x^2 + y) Z0 Z1] / (x Z0 Z1) + y.
+Выполняется одно обращение в поле. Особые случаи:
+	Z0 = 0 => d P = O;
+	Z1 = 0 => d P = -P = (x, x + y);
+	x = 0 => P имеет порядок 2, d P = O или P в зависимости от четности d.
+*******************************************************************************
+*/
+
+static void ec2CSwap(word a[], word b[], size_t n, word mask)
+{
+	register word t;
+	while (n--)
+		t = (a[n] ^ b[n]) & mask, a[n] ^= t, b[n] ^= t;
+	t = 0;
+}
+
+bool_t ec2MulLadderA(word b[], const word a[], const ec_o* ec, 
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	register size_t i;
+	register word bit, prev;
+	bool_t koblitz;
+	// переменные в stack
+	word* x0 = (word*)stack;
+	word* z0 = x0 + n;
+	word* x1 = z0 + n;
+	word* z1 = x1 + n;
+	word* sb = z1 + n;
+	word* t1 = sb + n;
+	word* t2 = t1 + n;
+	stack = t2 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ecIsOperableGroup(ec));
+	ASSERT(ec2SeemsOnA(a, ec));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(wwIsSameOrDisjoint(a, b, 2 * n));
+	// x == 0? => P имеет порядок 2
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		if (!wwTestBit(d, 0))
+			return FALSE;
+		wwCopy(b, a, 2 * n);
+		return TRUE;
+	}
+	// sb <- \sqrt{B} = B^{2^{m - 1}}
+	koblitz = qrIsUnity(ec->B, ec->f);
+	if (!koblitz)
+	{
+		qrCopy(sb, ec->B, ec->f);
+		for (i = 1; i < gf2Deg(ec->f); ++i)
+			qrSqr(sb, sb, ec->f, stack);
+	}
+	// R0 <- O, R1 <- P
+	qrSetUnity(x0, ec->f), qrSetZero(z0, ec->f);
+	qrCopy(x1, ecX(a), ec->f), qrSetUnity(z1, ec->f);
+	// цикл по битам d
+	i = MAX2(wwBitSize(d, m), wwBitSize(ec->order, n + 1));
+	prev = 0;
+	while (i--)
+	{
+		bit = i < B_OF_W(m) ? WORD_0 - (word)wwTestBit(d, i) : 0;
+		ec2CSwap(x0, x1, 2 * n, bit ^ prev);
+		prev = bit;
+		// R1 <- R0 + R1
+		qrMul(t1, x0, z1, ec->f, stack);
+		qrMul(t2, x1, z0, ec->f, stack);
+		gf2Add(z1, t1, t2, ec->f);
+		qrSqr(z1, z1, ec->f, stack);
+		qrMul(t1, t1, t2, ec->f, stack);
+		qrMul(x1, ecX(a), z1, ec->f, stack);
+		gf2Add2(x1, t1, ec->f);
+		// R0 <- 2 R0
+		qrSqr(t1, x0, ec->f, stack);
+		qrSqr(t2, z0, ec->f, stack);
+		qrMul(z0, t1, t2, ec->f, stack);
+		if (!koblitz)
+			qrMul(t2, sb, t2, ec->f, stack);
+		gf2Add2(t1, t2, ec->f);
+		qrSqr(x0, t1, ec->f, stack);
+	}
+	ec2CSwap(x0, x1, 2 * n, prev);
+	bit = prev = 0;
+	// d P == O?
+	if (qrIsZero(z0, ec->f))
+		return FALSE;
+	// (d + 1) P == O? => d P <- -P
+	if (qrIsZero(z1, ec->f))
+	{
+		wwCopy(b, a, 2 * n);
+		gf2Add2(ecY(b, n), ecX(b), ec->f);
+		return TRUE;
+	}
+	// sb <- x Z0 Z1
+	qrMul(t2, z0, z1, ec->f, stack);
+	qrMul(sb, ecX(a), t2, ec->f, stack);
+	// t1 <- (X0 + x Z0)(X1 + x Z1) + (x^2 + y) Z0 Z1
+	qrMul(t1, ecX(a), z0, ec->f, stack);
+	gf2Add2(t1, x0, ec->f);
+	qrMul(z0, ecX(a), z1, ec->f, stack);
+	gf2Add2(z0, x1, ec->f);
+	qrMul(t1, t1, z0, ec->f, stack);
+	qrSqr(z0, ecX(a), ec->f, stack);
+	gf2Add2(z0, ecY(a, n), ec->f);
+	qrMul(t2, t2, z0, ec->f, stack);
+	gf2Add2(t1, t2, ec->f);
+	// sb <- (x Z0 Z1)^{-1}
+	qrInv(sb, sb, ec->f, stack);
+	// x0 <- X0 / Z0 = X0 x Z1 / (x Z0 Z1)
+	qrMul(x0, x0, z1, ec->f, stack);
+	qrMul(x0, x0, ecX(a), ec->f, stack);
+	qrMul(x0, x0, sb, ec->f, stack);
+	// y0 <- (x0 + x) t1 / (x Z0 Z1) + y
+	gf2Add(t2, x0, ecX(a), ec->f);
+	qrMul(t1, t1, t2, ec->f, stack);
+	qrMul(t1, t1, sb, ec->f, stack);
+	gf2Add2(t1, ecY(a, n), ec->f);
+	// b <- (x0, y0)
+	qrCopy(ecX(b), x0, ec->f);
+	qrCopy(ecY(b, n), t1, ec->f);
+	return TRUE;
+}
+
+size_t ec2MulLadderA_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(7 * n) + f_deep;
+}
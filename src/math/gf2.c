@@ -4,7 +4,7 @@
 \brief Binary fields
 \project bee2 [cryptographic library]
 \created 2012.04.17
-\version 2023.03.20
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -244,7 +244,7 @@ static void gf2MulTrinomial0(word c[], const word a[], const word b[],
 
 static size_t gf2MulTrinomial0_deep(size_t n)
 {
-	return ppMul_deep(n, n);
+	return O_OF_W(2 * n) + ppMul_deep(n, n);
 }
 
 static void gf2MulTrinomial1(word c[], const word a[], const word b[], 
@@ -262,7 +262,7 @@ static void gf2MulTrinomial1(word c[], const word a[], const word b[],
 
 static size_t gf2MulTrinomial1_deep(size_t n)
 {
-	return ppMul_deep(n, n);
+	return O_OF_W(2 * n) + ppMul_deep(n, n);
 }
 
 static void gf2MulPentanomial(word c[], const word a[], const word b[], 
@@ -280,7 +280,7 @@ static void gf2MulPentanomial(word c[], const word a[], const word b[],
 
 static size_t gf2MulPentanomial_deep(size_t n)
 {
-	return ppMul_deep(n, n);
+	return O_OF_W(2 * n) + ppMul_deep(n, n);
 }
 
 static void gf2SqrTrinomial0(word b[], const word a[], const qr_o* f, 
@@ -297,7 +297,7 @@ static void gf2SqrTrinomial0(word b[], const word a[], const qr_o* f,
 
 static size_t gf2SqrTrinomial0_deep(size_t n)
 {
-	return ppSqr_deep(n);
+	return O_OF_W(2 * n) + ppSqr_deep(n);
 }
 
 static void gf2SqrTrinomial1(word b[], const word a[], const qr_o* f, 
@@ -314,7 +314,7 @@ static void gf2SqrTrinomial1(word b[], const word a[], const qr_o* f,
 
 static size_t gf2SqrTrinomial1_deep(size_t n)
 {
-	return ppSqr_deep(n);
+	return O_OF_W(2 * n) + ppSqr_deep(n);
 }
 
 static void gf2SqrPentanomial(word b[], const word a[], const qr_o* f, 
@@ -331,9 +331,168 @@ static void gf2SqrPentanomial(word b[], const word a[], const qr_o* f,
 
 static size_t gf2SqrPentanomial_deep(size_t n)
 {
-	return ppSqr_deep(n);
+	return O_OF_W(2 * n) + ppSqr_deep(n);
 }
 
+/*
+*******************************************************************************
+Умножение многочленов с помощью PCLMULQDQ
+
+Инструкция PCLMULQDQ умножает 64-битовые двоичные многочлены без переносов
+и возвращает 128-битовое произведение. Функция gf2ClMul() умножает
+многочлены из n 64-битовых слов школьным методом: произведения слов
+a[i] b[j] с одинаковой суммой i + j = k накапливаются в 128-битовом
+регистре, который затем складывается с предыдущим регистром со сдвигом
+на 64 бита.
+
+Функция gf2ClSqr() возводит многочлен в квадрат. Квадрат многочлена 
+получается чередованием его битов с нулями, которое для слова a[i] 
+выполняется одной инструкцией PCLMULQDQ(a[i], a[i]).
+
+Функции используются, если слово состоит из 64 битов, процессор
+поддерживает PCLMULQDQ (utilCLMULIsAvail()) и n <= GF2_CL_MAX.
+Выбор выполняется в функции gf2Create().
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64) && (defined(__GNUC__) || defined(__clang__)) && \
+	defined(__x86_64__)
+	#define GF2_CL
+	#define GF2_CL_FN __attribute__((target("pclmul,sse2")))
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+#elif (B_PER_W == 64) && (_MSC_VER >= 1600) && defined(_M_X64)
+	#define GF2_CL
+	#define GF2_CL_FN
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+#endif
+
+#define GF2_CL_MAX 9
+
+#ifdef GF2_CL
+
+GF2_CL_FN static void gf2ClMul(word c[], const word a[], const word b[],
+	size_t n)
+{
+	__m128i aw[GF2_CL_MAX];
+	__m128i bw[GF2_CL_MAX];
+	__m128i r, t;
+	size_t i, k;
+	ASSERT(0 < n && n <= GF2_CL_MAX);
+	ASSERT(wwIsDisjoint2(a, n, c, 2 * n));
+	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
+	for (i = 0; i < n; ++i)
+	{
+		aw[i] = _mm_cvtsi64_si128((long long)a[i]);
+		bw[i] = _mm_cvtsi64_si128((long long)b[i]);
+	}
+	// цикл по k = i + j
+	t = _mm_setzero_si128();
+	for (k = 0; k < 2 * n - 1; ++k)
+	{
+		// r <- sum_{i + j = k} a[i] b[j]
+		i = k < n ? 0 : k - n + 1;
+		r = _mm_clmulepi64_si128(aw[i], bw[k - i], 0x00);
+		for (++i; i < n && i <= k; ++i)
+			r = _mm_xor_si128(r, _mm_clmulepi64_si128(aw[i], bw[k - i], 0x00));
+		// c[k] <- lo(r) + hi(r_{k - 1})
+		c[k] = (word)_mm_cvtsi128_si64(_mm_xor_si128(r, t));
+		t = _mm_srli_si128(r, 8);
+	}
+	c[k] = (word)_mm_cvtsi128_si64(t);
+	r = t = _mm_setzero_si128();
+}
+
+GF2_CL_FN static void gf2ClSqr(word b[], const word a[], size_t n)
+{
+	__m128i aw;
+	ASSERT(0 < n && n <= GF2_CL_MAX);
+	ASSERT(wwIsDisjoint2(a, n, b, 2 * n));
+	while (n--)
+	{
+		aw = _mm_cvtsi64_si128((long long)a[n]);
+		_mm_storeu_si128((__m128i*)(b + 2 * n),
+			_mm_clmulepi64_si128(aw, aw, 0x00));
+	}
+}
+
+static void gf2MulTrinomial0Cl(word c[], const word a[], const word b[], 
+	const qr_o* f, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	ASSERT(gf2IsIn(b, f));
+	gf2ClMul(prod, a, b, f->n);
+	gf2RedTrinomial0(prod, f->n, (const gf2_trinom_st*)f->params);
+	wwCopy(c, prod, f->n);
+}
+
+static void gf2MulTrinomial1Cl(word c[], const word a[], const word b[], 
+	const qr_o* f, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	ASSERT(gf2IsIn(b, f));
+	gf2ClMul(prod, a, b, f->n);
+	gf2RedTrinomial1(prod, f->n, (const gf2_trinom_st*)f->params);
+	wwCopy(c, prod, f->n);
+}
+
+static void gf2MulPentanomialCl(word c[], const word a[], const word b[], 
+	const qr_o* f, void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	ASSERT(gf2IsIn(b, f));
+	gf2ClMul(prod, a, b, f->n);
+	gf2RedPentanomial(prod, f->n, (const gf2_pentanom_st*)f->params);
+	wwCopy(c, prod, f->n);
+}
+
+static void gf2SqrTrinomial0Cl(word b[], const word a[], const qr_o* f, 
+	void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	gf2ClSqr(prod, a, f->n);
+	gf2RedTrinomial0(prod, f->n, (const gf2_trinom_st*)f->params);
+	wwCopy(b, prod, f->n);
+}
+
+static void gf2SqrTrinomial1Cl(word b[], const word a[], const qr_o* f, 
+	void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	gf2ClSqr(prod, a, f->n);
+	gf2RedTrinomial1(prod, f->n, (const gf2_trinom_st*)f->params);
+	wwCopy(b, prod, f->n);
+}
+
+static void gf2SqrPentanomialCl(word b[], const word a[], const qr_o* f, 
+	void* stack)
+{
+	word* prod = (word*)stack;
+	ASSERT(gf2IsOperable(f));
+	ASSERT(gf2IsIn(a, f));
+	gf2ClSqr(prod, a, f->n);
+	gf2RedPentanomial(prod, f->n, (const gf2_pentanom_st*)f->params);
+	wwCopy(b, prod, f->n);
+}
+
+static bool_t gf2ClIsAvail(size_t n)
+{
+	return n <= GF2_CL_MAX && utilCLMULIsAvail();
+}
+
+#endif // GF2_CL
+
 static void gf2Inv(word b[], const word a[], const qr_o* f, void* stack)
 {
 	ASSERT(gf2IsOperable(f));
@@ -436,6 +595,13 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->neg = gf2Neg2;
 		f->mul = t->bk == 0 ? gf2MulTrinomial0 : gf2MulTrinomial1;
 		f->sqr = t->bk == 0 ? gf2SqrTrinomial0 : gf2SqrTrinomial1;
+#ifdef GF2_CL
+		if (gf2ClIsAvail(f->n))
+		{
+			f->mul = t->bk == 0 ? gf2MulTrinomial0Cl : gf2MulTrinomial1Cl;
+			f->sqr = t->bk == 0 ? gf2SqrTrinomial0Cl : gf2SqrTrinomial1Cl;
+		}
+#endif
 		f->inv = gf2Inv;
 		f->div = gf2Div;
 		// заголовок
@@ -506,6 +672,13 @@ bool_t gf2Create(qr_o* f, const size_t p[4], void* stack)
 		f->neg = gf2Neg2;
 		f->mul = gf2MulPentanomial;
 		f->sqr = gf2SqrPentanomial;
+#ifdef GF2_CL
+		if (gf2ClIsAvail(f->n))
+		{
+			f->mul = gf2MulPentanomialCl;
+			f->sqr = gf2SqrPentanomialCl;
+		}
+#endif
 		f->inv = gf2Inv;
 		f->div = gf2Div;
 		// заголовок
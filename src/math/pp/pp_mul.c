@@ -4,7 +4,7 @@
 \brief Binary polynomials: multiplicative operations
 \project bee2 [cryptographic library]
 \created 2012.03.01
-\version 2023.11.09
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -827,6 +827,75 @@ size_t ppAddMulW_deep(size_t n)
 	return O_OF_W(16 + 2);
 }
 
+/*
+*******************************************************************************
+Умножение с помощью PCLMULQDQ
+
+Инструкция PCLMULQDQ умножает 64-битовые двоичные многочлены без переносов
+и возвращает 128-битовое произведение. Функция ppClMul() умножает
+многочлены из n 64-битовых слов школьным методом: произведения слов
+a[i] b[j] с одинаковой суммой i + j = k накапливаются в 128-битовом
+регистре, который затем складывается с предыдущим регистром со сдвигом
+на 64 бита.
+
+Функция используется вместо базовых функций ppMuln, если слово состоит
+из 64 битов и процессор поддерживает PCLMULQDQ (utilCLMULIsAvail()).
+Так ускоряется и умножение длинных многочленов: листья рекурсии Карацубы
+в ppMulEq() вычисляются той же функцией. Дополнительный стек не требуется.
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64) && (defined(__GNUC__) || defined(__clang__)) && \
+	defined(__x86_64__)
+	#define PP_CL
+	#define PP_CL_FN __attribute__((target("pclmul,sse2")))
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+#elif (B_PER_W == 64) && (_MSC_VER >= 1600) && defined(_M_X64)
+	#define PP_CL
+	#define PP_CL_FN
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+#endif
+
+#define PP_CL_MAX 9
+
+#ifdef PP_CL
+
+PP_CL_FN static void ppClMul(word c[], const word a[], const word b[],
+	size_t n)
+{
+	__m128i aw[PP_CL_MAX];
+	__m128i bw[PP_CL_MAX];
+	__m128i r, t;
+	size_t i, k;
+	ASSERT(0 < n && n <= PP_CL_MAX);
+	ASSERT(wwIsDisjoint2(a, n, c, 2 * n));
+	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
+	for (i = 0; i < n; ++i)
+	{
+		aw[i] = _mm_cvtsi64_si128((long long)a[i]);
+		bw[i] = _mm_cvtsi64_si128((long long)b[i]);
+	}
+	// цикл по k = i + j
+	t = _mm_setzero_si128();
+	for (k = 0; k < 2 * n - 1; ++k)
+	{
+		// r <- sum_{i + j = k} a[i] b[j]
+		i = k < n ? 0 : k - n + 1;
+		r = _mm_clmulepi64_si128(aw[i], bw[k - i], 0x00);
+		for (++i; i < n && i <= k; ++i)
+			r = _mm_xor_si128(r, _mm_clmulepi64_si128(aw[i], bw[k - i], 0x00));
+		// c[k] <- lo(r) + hi(r_{k - 1})
+		c[k] = (word)_mm_cvtsi128_si64(_mm_xor_si128(r, t));
+		t = _mm_srli_si128(r, 8);
+	}
+	c[k] = (word)_mm_cvtsi128_si64(t);
+	r = t = _mm_setzero_si128();
+}
+
+#endif // PP_CL
+
 /*
 *******************************************************************************
 Умножение в общем случае
@@ -860,7 +929,16 @@ static void ppMulEq(word c[], const word a[], const word b[], size_t n,
 	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
 	// умножение многочленов малой длины
 	if (n < COUNT_OF(_mul_procs))
+	{
+#ifdef PP_CL
+		if (n <= PP_CL_MAX && utilCLMULIsAvail())
+		{
+			ppClMul(c, a, b, n);
+			return;
+		}
+#endif
 		_mul_procs[n](c, a, b, stack);
+	}
 	// усеченный алгоритм Карацубы, n --- четное
 	else if ((n & 1) == 0)
 	{
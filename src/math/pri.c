@@ -4,13 +4,14 @@
 \brief Prime numbers
 \project bee2 [cryptographic library]
 \created 2012.08.13
-\version 2024.02.28
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/prng.h"
 #include "bee2/core/util.h"
 #include "bee2/core/word.h"
@@ -375,26 +376,156 @@ static const pri_prod_t _prods[] =
 #endif
 };
 
+/*
+*******************************************************************************
+Деление на элементы факторной базы
+
+Остатки от деления многословного числа на слово d определяются без 
+машинных делений по алгоритму Мёллера -- Гранлунда [N. Möller, T. Granlund.
+Improved division by invariant integers. IEEE Trans. Comp., 2011]. 
+Для d заранее определяются сдвиг s = clz(d), нормализованный делитель 
+d' = d << s и обратное v = \floor((B^2 - 1) / d') - B. Поскольку d делит d', 
+остаток a \mod d получается из a \mod d' дополнительным шагом деления 
+числа (a \mod d') * 2^s на d' и сдвигом результата на s позиций.
+
+Обратные рассчитываются один раз, при первом обращении к факторной базе, 
+для всех произведений из _prods и всех простых из _base.
+Остатки от деления слова-произведения на его множители определяются 
+с помощью приближенных обратных \floor((B - 1) / p) к простым p из _base. 
+
+В функции priBaseMod() произведения обрабатываются группами по 
+PRI_MOD_LANES. Остатки по произведениям группы определяются за один проход 
+по словам числа. Цепочки вычислений по разным произведениям независимы, 
+и процессор выполняет их параллельно.
+*******************************************************************************
+*/
+
+#define PRI_MOD_LANES 4
+
+typedef struct pri_inv_t
+{
+	word d;			/*< нормализованный делитель */
+	word v;			/*< обратное к d */
+	size_t s;		/*< сдвиг нормализации */
+} pri_inv_t;
+
+static pri_inv_t _prods_inv[COUNT_OF(_prods)];
+static pri_inv_t _base_inv[COUNT_OF(_base)];
+static word _base_m[COUNT_OF(_base)];
+static size_t _once;
+
+static void priInvPrepare(pri_inv_t* inv, word d)
+{
+	dword t;
+	ASSERT(d > 0);
+	inv->s = wordCLZ(d);
+	inv->d = d << inv->s;
+	t = (dword)(WORD_MAX - inv->d) << B_PER_W | WORD_MAX;
+	inv->v = (word)(t / inv->d);
+}
+
+static void priInvInit()
+{
+	size_t i;
+	for (i = 0; i < COUNT_OF(_prods); ++i)
+		priInvPrepare(_prods_inv + i, _prods[i].prod);
+	for (i = 0; i < COUNT_OF(_base); ++i)
+		priInvPrepare(_base_inv + i, _base[i]), 
+		_base_m[i] = WORD_MAX / _base[i];
+}
+
+/*	(r u) \mod d, r < d */
+static word priInvStep(word r, word u, const pri_inv_t* inv)
+{
+	dword q;
+	ASSERT(r < inv->d);
+	q = (dword)inv->v * r;
+	q += (dword)(word)(r + 1) << B_PER_W | u;
+	r = (word)(u - (word)(q >> B_PER_W) * inv->d);
+	if (r > (word)q)
+		r += inv->d;
+	if (r >= inv->d)
+		r -= inv->d;
+	return r;
+}
+
+/*	r \mod (d >> s), r < d */
+static word priInvFinal(word r, const pri_inv_t* inv)
+{
+	if (inv->s == 0)
+		return r;
+	r = priInvStep(r >> (B_PER_W - inv->s), r << inv->s, inv);
+	return r >> inv->s;
+}
+
+/*	t \mod _base[i]: частное оценивается снизу величиной 
+	\floor(t * _base_m[i] / B), ошибка оценки не превосходит 2 */
+static word priInvModBase(word t, size_t i)
+{
+	word q = (word)((dword)t * _base_m[i] >> B_PER_W);
+	t -= q * _base[i];
+	if (t >= _base[i])
+		t -= _base[i];
+	if (t >= _base[i])
+		t -= _base[i];
+	return t;
+}
+
+static word priInvMod(const word a[], size_t n, const pri_inv_t* inv)
+{
+	register word r = 0;
+	while (n--)
+		r = priInvStep(r, a[n], inv);
+	return priInvFinal(r, inv);
+}
+
 void priBaseMod(word mods[], const word a[], size_t n, size_t count)
 {
-	size_t i, j;
+	word t[PRI_MOD_LANES];
+	size_t i, j, k, l, c, p;
 	// pre
 	ASSERT(wwIsValid(a, n));
 	ASSERT(count <= priBaseSize());
 	ASSERT(wwIsValid(mods, count));
-	// пробегаем произведения простых из факторной базы
-	for (i = j = 0; i < count && j < COUNT_OF(_prods); ++j)
+	// рассчитать обратные
+	VERIFY(mtCallOnce(&_once, priInvInit));
+	// пробегаем группы произведений простых из факторной базы
+	for (i = j = 0; i < count && j < COUNT_OF(_prods); i = c, j += k)
 	{
-		size_t num = _prods[j].num;
-		// t <- a mod _base[i] * ... * _base[i + num - 1]
-		word t = zzModW(a, n, _prods[j].prod);
-		// mods[i] <- t mod _base[i]
-		while (num-- && i < count)
-			mods[i] = t % _base[i], ++i;
+		// k <- число произведений в группе, c <- число покрытых простых
+		for (k = 0, c = i; k < PRI_MOD_LANES && j + k < COUNT_OF(_prods) && 
+			c < count; ++k)
+			c += _prods[j + k].num;
+		c = MIN2(c, count);
+		// t[l] <- a mod _prods_inv[j + l].d
+		for (l = 0; l < k; ++l)
+			t[l] = 0;
+		for (l = n; l--;)
+			if (k == PRI_MOD_LANES)
+			{
+				t[0] = priInvStep(t[0], a[l], _prods_inv + j);
+				t[1] = priInvStep(t[1], a[l], _prods_inv + j + 1);
+				t[2] = priInvStep(t[2], a[l], _prods_inv + j + 2);
+				t[3] = priInvStep(t[3], a[l], _prods_inv + j + 3);
+			}
+			else
+			{
+				size_t m;
+				for (m = 0; m < k; ++m)
+					t[m] = priInvStep(t[m], a[l], _prods_inv + j + m);
+			}
+		// mods[p] <- t[l] mod _base[p]
+		for (l = 0, p = i; l < k; ++l)
+		{
+			size_t m = _prods[j + l].num;
+			t[l] = priInvFinal(t[l], _prods_inv + j + l);
+			for (; m-- && p < c; ++p)
+				mods[p] = priInvModBase(t[l], p);
+		}
 	}
 	// пробегаем оставшиеся простые из факторной базы
 	for (; i < count; ++i)
-		mods[i] = zzModW(a, n, _base[i]);
+		mods[i] = priInvMod(a, n, _base_inv + i);
 }
 
 /*
@@ -451,6 +582,8 @@ bool_t priIsSmooth(const word a[], size_t n, size_t base_count, void* stack)
 	stack = t + n;
 	// pre
 	ASSERT(base_count <= priBaseSize());
+	// рассчитать обратные
+	VERIFY(mtCallOnce(&_once, priInvInit));
 	// t <- a 
 	wwCopy(t, a, n);
 	// разделить t на степень 2
@@ -465,8 +598,7 @@ bool_t priIsSmooth(const word a[], size_t n, size_t base_count, void* stack)
 	// цикл по простым из факторной базы
 	for (i = 0; i < base_count;)
 	{
-		mod = _base[i] < WORD_BIT_HALF ? 
-			zzModW2(t, n, _base[i]) : zzModW(t, n, _base[i]);
+		mod = priInvMod(t, n, _base_inv + i);
 		// делится на простое?
 		if (mod == 0)
 		{
@@ -740,6 +872,228 @@ size_t priIsSGPrime_deep(size_t n)
 			qrPower_deep(n + 1, n, qr_deep));
 }
 
+/*
+*******************************************************************************
+Поиск в окнах
+
+Функции priNextPrime() и priExtendPrime2() перебирают кандидатов вида
+	p_j = p_0 + j * step, j = 0, 1, 2,...,
+и возвращают первого кандидата, который не делится на простые из факторной 
+базы и проходит тест простоты. Кандидаты обрабатываются окнами по 
+PRI_SIEVE_W чисел.
+
+Для окна строится битовое решето: j-й бит устанавливается, если p_j делится 
+на одно из простых b факторной базы. Для каждого b хранится величина 
+	e = -p_0 step^{-1} \mod b
+-- номер первого кандидата окна, который делится на b. Биты e, e + b, 
+e + 2b,... устанавливаются в единицу. При переходе к следующему окну 
+e уменьшается на длину окна (по модулю b). Если step делится на b, то 
+кандидаты либо все делятся на b (e = WORD_MAX), либо все не делятся (e = b).
+
+Непросеянные кандидаты окна проверяются рабочими функциями 
+priWindowWorker(), которые выполняются в потоках пула (см. mtPoolStart()).
+Пул создается функцией priWindowStart() один раз на весь поиск и
+закрывается функцией priWindowStop(). Для каждого окна пулу передается
+по одной задаче на поток. Рабочие функции выбирают кандидатов по порядку
+с помощью атомарного счетчика next и фиксируют в found минимальный номер
+кандидата, прошедшего тест. Рабочая функция прекращает выбор, как только
+очередной номер превышает found. Поэтому к окончанию работы все кандидаты с номерами меньше found 
+проверены и отвергнуты, и результат совпадает с результатом 
+последовательного перебора. В частности, результаты генерации параметров 
+pfok и stb99 не зависят от числа потоков.
+
+Пул создается, если кандидаты занимают не меньше PRI_MT_MIN слов. 
+Число потоков не превосходит PRI_MT_MAX и числа процессоров. Если пул 
+создать не удается, то кандидаты проверяются в вызывающем потоке.
+*******************************************************************************
+*/
+
+#define PRI_SIEVE_W		1024	/*< длина окна */
+#define PRI_MT_MAX		8		/*< максимальное число потоков */
+#define PRI_MT_MIN		W_OF_B(512)	/*< минимальная длина кандидатов */
+
+typedef bool_t (*pri_test_i)(const word p[], size_t j, const void* data, 
+	void* stack);
+
+typedef struct
+{
+	const word* p;			/*< [n] первый кандидат окна */
+	size_t n;				/*< длина кандидатов */
+	const word* step;		/*< [m] шаг */
+	size_t m;				/*< длина шага */
+	const octet* sieve;		/*< [count] решето */
+	size_t count;			/*< число кандидатов в окне */
+	pri_test_i test;		/*< тест простоты */
+	const void* data;		/*< данные теста */
+	void* pool;				/*< пул потоков (или 0) */
+	void* stack;			/*< стек рабочей функции (при pool == 0) */
+	size_t next;			/*< номер следующего кандидата */
+	size_t found;			/*< номер найденного простого */
+} pri_window_st;
+
+static size_t priWindowThreads(size_t n)
+{
+	size_t threads;
+	if (n < PRI_MT_MIN)
+		return 1;
+	threads = mtThrdHWCount();
+	return MIN2(threads, PRI_MT_MAX);
+}
+
+static size_t priWindow_keep(size_t n, size_t deep)
+{
+	return n < PRI_MT_MIN ? O_OF_W(W_OF_O(deep)) : 
+		utilMax(2,
+			O_OF_W(W_OF_O(deep)),
+			mtPool_keep(PRI_MT_MAX, deep));
+}
+
+static void priWindowStart(pri_window_st* w, size_t deep, void* stack)
+{
+	const size_t threads = priWindowThreads(w->n);
+	w->pool = 0, w->stack = stack;
+	if (threads > 1 && mtPoolStart(stack, threads, deep))
+		w->pool = stack;
+}
+
+static void priWindowStop(pri_window_st* w)
+{
+	if (w->pool)
+		mtPoolClose(w->pool);
+	w->pool = 0;
+}
+
+static void priWindowCand(word p[], const pri_window_st* w, size_t j)
+{
+	register word carry;
+	wwCopy(p, w->p, w->n);
+	carry = zzAddMulW(p, w->step, w->m, (word)j);
+	carry = zzAddW2(p + w->m, w->n - w->m, carry);
+	ASSERT(carry == 0);
+	carry = 0;
+}
+
+static void priWindowWorker(size_t i, void* arg, void* stack)
+{
+	pri_window_st* w = (pri_window_st*)arg;
+	size_t j, found;
+	// переменные в stack
+	word* p;
+	// раскладка stack
+	p = (word*)stack;
+	stack = p + w->n;
+	// перебор кандидатов
+	while (1)
+	{
+		j = mtAtomicIncr(&w->next) - 1;
+		if (j >= w->count || j > mtAtomicCmpSwap(&w->found, 0, 0))
+			break;
+		if (w->sieve[j / 8] & (octet)(1 << j % 8))
+			continue;
+		priWindowCand(p, w, j);
+		if (!w->test(p, j, w->data, stack))
+			continue;
+		// found <- min(found, j)
+		for (found = w->found; j < found; )
+		{
+			size_t t = mtAtomicCmpSwap(&w->found, found, j);
+			if (t == found)
+				break;
+			found = t;
+		}
+	}
+}
+
+static size_t priWindowSearch(pri_window_st* w)
+{
+	w->next = 0, w->found = SIZE_MAX;
+	// по одной задаче на поток пула
+	if (w->pool)
+		mtPoolFor(w->pool, mtPoolThreads(w->pool), priWindowWorker, w);
+	else
+		priWindowWorker(0, w, w->stack);
+	return w->found;
+}
+
+static word priInvW(register word a, register word mod)
+{
+	register word r0 = a, r1 = mod;
+	register word u0 = 1, u1 = 0;
+	register word q, t;
+	ASSERT(0 < a && a < mod);
+	while (r0 != 1)
+	{
+		q = r1 / r0;
+		t = r1 - q * r0, r1 = r0, r0 = t;
+		t = (u1 + mod - q * u0 % mod) % mod, u1 = u0, u0 = t;
+	}
+	return u0;
+}
+
+static void priWindowPrepare(word e[], const word mods[], const word steps[], 
+	size_t base_count)
+{
+	size_t i;
+	for (i = 0; i < base_count; ++i)
+		if (steps[i] == 0)
+			e[i] = mods[i] ? _base[i] : WORD_MAX;
+		else if (mods[i] == 0)
+			e[i] = 0;
+		else
+			e[i] = (_base[i] - mods[i]) * priInvW(steps[i], _base[i]) % 
+				_base[i];
+}
+
+static void priWindowSieve(octet sieve[], size_t count, const word e[], 
+	size_t base_count)
+{
+	size_t i, j;
+	ASSERT(count <= PRI_SIEVE_W);
+	memSetZero(sieve, PRI_SIEVE_W / 8);
+	for (i = 0; i < base_count; ++i)
+		if (e[i] == WORD_MAX)
+		{
+			memSet(sieve, 0xFF, PRI_SIEVE_W / 8);
+			break;
+		}
+		else if (e[i] < _base[i])
+			for (j = (size_t)e[i]; j < count; j += _base[i])
+				sieve[j / 8] |= (octet)(1 << j % 8);
+}
+
+static void priWindowShift(word e[], size_t count, size_t base_count)
+{
+	size_t i;
+	for (i = 0; i < base_count; ++i)
+		if (e[i] < _base[i])
+			e[i] = (e[i] + _base[i] - count % _base[i]) % _base[i];
+}
+
+static size_t priWindowLimit(const pri_window_st* w, size_t count, size_t l, 
+	word t[])
+{
+	size_t lo, hi;
+	ASSERT(count > 0);
+	// все кандидаты не длиннее l битов?
+	priWindowCand(t, w, 0);
+	ASSERT(wwBitSize(t, w->n) <= l);
+	lo = 1, hi = count;
+	while (lo < hi)
+	{
+		size_t mid = hi - (hi - lo) / 2;
+		register word carry;
+		wwCopy(t, w->p, w->n);
+		carry = zzAddMulW(t, w->step, w->m, (word)(mid - 1));
+		carry = zzAddW2(t + w->m, w->n - w->m, carry);
+		if (carry == 0 && wwBitSize(t, w->n) <= l)
+			lo = mid;
+		else
+			hi = mid - 1;
+		carry = 0;
+	}
+	return lo;
+}
+
 /*
 *******************************************************************************
 Следующее простое
@@ -775,20 +1129,38 @@ size_t priNextPrimeW_deep()
 	return priIsPrimeW_deep();
 }
 
+static bool_t priNextPrimeTest(const word p[], size_t j, const void* data,
+	void* stack)
+{
+	const size_t* d = (const size_t*)data;
+	return priRMTest(p, d[0], d[1], stack);
+}
+
+static size_t priNextPrimeTest_deep(size_t n)
+{
+	return O_OF_W(n) + priRMTest_deep(n);
+}
+
 bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
 	size_t base_count, size_t iter, void* stack)
 {
-	size_t l;
+	const word two = 2;
+	size_t data[2];
+	pri_window_st w[1];
+	size_t l, count, found;
 	size_t i;
-	bool_t base_success;
 	// переменные в stack
-	word* mods;
+	word* e;
+	octet* sieve;
+	word* t;
 	// pre
 	ASSERT(wwIsSameOrDisjoint(a, p, n));
 	ASSERT(base_count <= priBaseSize());
 	// раскладка stack
-	mods = (word*)stack;
-	stack = mods + base_count;
+	e = (word*)stack;
+	sieve = (octet*)(e + base_count);
+	t = (word*)(sieve + PRI_SIEVE_W / 8);
+	stack = t + n;
 	// l <- битовая длина a
 	l = wwBitSize(a, n);
 	// 0-битовых и 1-битовых простых не существует
@@ -802,39 +1174,51 @@ bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
 		// при необходимости скорректировать факторную базу
 		while (base_count > 0 && priBasePrime(base_count - 1) >= p[0])
 			--base_count;
-	// рассчитать остатки от деления на малые простые
-	priBaseMod(mods, p, n, base_count);
-	for (i = 0, base_success = TRUE; i < base_count; ++i)
-		if (mods[i] == 0)
-		{
-			base_success = FALSE;
-			break;
-		}
-	// попытки
-	while (trials == SIZE_MAX || trials--)
+	// e[i] <- номер первого кандидата, который делится на _base[i]
+	priBaseMod(e, p, n, base_count);
+	for (i = 0; i < base_count; ++i)
+		e[i] = e[i] == 0 ? 0 : (_base[i] - e[i]) * ((_base[i] + 1) / 2) % 
+			_base[i];
+	// настроить окно
+	data[0] = n, data[1] = iter;
+	w->p = p, w->n = n;
+	w->step = &two, w->m = 1;
+	w->sieve = sieve;
+	w->test = priNextPrimeTest, w->data = data;
+	priWindowStart(w, priNextPrimeTest_deep(n), stack);
+	// перебор окон
+	while (trials)
 	{
-		// проверка простоты
-		if (base_success && priRMTest(p, n, iter, stack))
-			return TRUE;
-		// к следующему кандидату
-		if (zzAddW2(p, n, 2) || wwBitSize(p, n) > l)
-			return FALSE;
-		for (i = 0, base_success = TRUE; i < base_count; ++i)
+		count = MIN2(trials, PRI_SIEVE_W);
+		w->count = priWindowLimit(w, count, l, t);
+		priWindowSieve(sieve, w->count, e, base_count);
+		// простое найдено?
+		found = priWindowSearch(w);
+		if (found != SIZE_MAX)
 		{
-			if (mods[i] < _base[i] - 2)
-				mods[i] += 2;
-			else if (mods[i] == _base[i] - 1)
-				mods[i] = 1;
-			else
-				mods[i] = 0, base_success = FALSE;
+			priWindowStop(w);
+			priWindowCand(t, w, found);
+			wwCopy(p, t, n);
+			return TRUE;
 		}
+		// кандидаты исчерпаны?
+		if (trials != SIZE_MAX)
+			trials -= w->count;
+		if (w->count < count)
+			break;
+		// к следующему окну
+		if (zzAddW2(p, n, 2 * count) || wwBitSize(p, n) > l)
+			break;
+		priWindowShift(e, count, base_count);
 	}
+	priWindowStop(w);
 	return FALSE;
 }
 
 size_t priNextPrime_deep(size_t n, size_t base_count)
 {
-	return base_count * O_PER_W + priRMTest_deep(n);
+	return base_count * O_PER_W + PRI_SIEVE_W / 8 + O_OF_W(n) + 
+		priWindow_keep(n, priNextPrimeTest_deep(n));
 }
 
 /*
@@ -880,22 +1264,91 @@ size_t priNextPrime_deep(size_t n, size_t base_count)
 *******************************************************************************
 */
 
+typedef struct
+{
+	const word* q;			/*< [n] базовое простое */
+	size_t n;				/*< длина q */
+	const word* a;			/*< [m] множитель */
+	size_t m;				/*< длина a */
+	const word* r;			/*< [nr] r для первого кандидата окна */
+	size_t nr;				/*< длина r */
+	size_t l;				/*< битовая длина кандидатов */
+} pri_demitko_st;
+
+static bool_t priExtendPrimeTest(const word p[], size_t j, const void* data,
+	void* stack)
+{
+	const pri_demitko_st* d = (const pri_demitko_st*)data;
+	const size_t np = W_OF_B(d->l);
+	const size_t npo = O_OF_B(d->l);
+	// переменные в stack
+	word* r;		/* [nr] */
+	word* t;		/* [np] */
+	word* four;		/* [np] */
+	qr_o* qr;
+	// раскладка stack
+	r = (word*)stack;
+	t = r + d->nr;
+	four = t + np;
+	qr = (qr_o*)(four + np);
+	stack = (octet*)qr + zmCreate_keep(npo);
+	// r <- r + j
+	wwCopy(r, d->r, d->nr);
+	VERIFY(zzAddW2(r, d->nr, (word)j) == 0);
+	// создать кольцо вычетов \mod p
+	wwTo(t, npo, p);
+	zmCreate(qr, (octet*)t, npo, stack);
+	// four <- 4 [в кольце qr]
+	qrAdd(four, qr->unity, qr->unity, qr);
+	qrAdd(four, four, four, qr);
+	// (4^r)^a \mod p != 1?
+	qrPower(t, four, r, d->nr, qr, stack);
+	qrPower(t, t, d->a, d->m, qr, stack);
+	if (qrCmp(t, qr->unity, qr) == 0)
+		return FALSE;
+	// ((4^r)^a)^q \mod p == 1?
+	qrPower(t, t, d->q, d->n, qr, stack);
+	return qrCmp(t, qr->unity, qr) == 0;
+}
+
+static size_t priExtendPrimeTest_deep(size_t l, size_t nr)
+{
+	const size_t np = W_OF_B(l);
+	const size_t npo = O_OF_B(l);
+	const size_t qr_deep = zmCreate_deep(npo);
+	return O_OF_W(np + nr + 2 * np) + zmCreate_keep(npo) +
+		utilMax(2,
+			qr_deep,
+			qrPower_deep(np, np, qr_deep));
+}
+
+static size_t priExtendPrimeWorker_deep(size_t l)
+{
+	const size_t np = W_OF_B(l);
+	return O_OF_W(np) + priExtendPrimeTest_deep(l, np + 1);
+}
+
 bool_t priExtendPrime2(word p[], size_t l, const word q[], size_t n,
 	const word a[], size_t m, size_t trials, size_t base_count, gen_i rng, 
 	void* rng_state, void* stack)
 {
 	const size_t np = W_OF_B(l);
 	const size_t npo = O_OF_B(l);
+	const size_t deep = priExtendPrimeWorker_deep(l);
+	pri_demitko_st d[1];
+	pri_window_st w[1];
 	size_t i;
-	size_t nqa;
+	size_t nqa, count, found;
 	// переменные в stack
 	word* qa;		/* [n + m] */
+	word* qa2;		/* [n + m + 1] */
 	word* t;		/* [np + 2] */
 	word* r;		/* [np - n - m + 3] */
-	word* four;		/* [np] */
-	word* mods;		/* base_count */
-	word* mods1;	/* base_count */
-	qr_o* qr;
+	word* e;		/* [base_count] */
+	word* mods;		/* [base_count] */
+	word* mods1;	/* [base_count] */
+	octet* sieve;	/* [PRI_SIEVE_W / 8] */
+	void* win;		/* [priWindow_keep(np, deep)] */
 	// pre
 	ASSERT(wwIsDisjoint2(p, np, q, n));
 	ASSERT(wwIsValid(a, m));
@@ -907,13 +1360,15 @@ bool_t priExtendPrime2(word p[], size_t l, const word q[], size_t n,
 	ASSERT(rng != 0);
 	// раскладка stack
 	qa = (word*)stack;
-	t = qa + n + m;
+	qa2 = qa + n + m;
+	t = qa2 + n + m + 1;
 	r = t + np + 2;
-	four = r + np - n - m + 3;
-	mods = four + np;
+	e = r + np - n - m + 3;
+	mods = e + base_count;
 	mods1 = mods + base_count;
-	qr = (qr_o*)(mods1 + base_count);
-	stack = (octet*)qr + zmCreate_keep(npo);
+	sieve = (octet*)(mods1 + base_count);
+	win = sieve + PRI_SIEVE_W / 8;
+	stack = (octet*)win + priWindow_keep(np, deep);
 	// малое p?
 	if (l < B_PER_W)
 		// при необходимости уменьшить факторную базу
@@ -924,8 +1379,29 @@ bool_t priExtendPrime2(word p[], size_t l, const word q[], size_t n,
 	zzMul(qa, q, n, a, m, stack); 
 	ASSERT(wwBitSize(qa, n + m) + 1 <= l);
 	nqa = wwWordSize(qa, n + m);
+	// qa2 <- 2 * qa
+	wwCopy(qa2, qa, nqa);
+	qa2[nqa] = 0;
+	wwShHi(qa2, nqa + 1, 1);
+	// рассчитать вычеты qa2 по малым модулям
+	priBaseMod(mods1, qa, nqa, base_count);
+	for (i = 0; i < base_count; ++i)
+		if ((mods1[i] += mods1[i]) >= _base[i])
+			mods1[i] -= _base[i];
+	// настроить тест
+	d->q = q, d->n = n;
+	d->a = a, d->m = m;
+	d->r = r, d->nr = np - nqa + 1;
+	d->l = l;
+	// настроить окно
+	w->p = p, w->n = np;
+	w->step = qa2, w->m = wwWordSize(qa2, nqa + 1);
+	ASSERT(w->m <= np);
+	w->sieve = sieve;
+	w->test = priExtendPrimeTest, w->data = d;
+	priWindowStart(w, deep, win);
 	// попытки
-	while (trials == SIZE_MAX || trials--)
+	while (trials)
 	{
 		// t <-R [2^{l - 2}, 2^{l - 1})
 		rng(t, npo, rng_state);
@@ -938,79 +1414,63 @@ bool_t priExtendPrime2(word p[], size_t l, const word q[], size_t n,
 		// t <- qa * r
 		zzMul(t, qa, nqa, r, np - nqa + 2, stack);
 		if (wwBitSize(t, np + 2) > l - 1)
+		{
+			if (trials != SIZE_MAX)
+				--trials;
 			continue;
+		}
 		// p <- 2 * t + 1
 		wwCopy(p, t, np);
 		wwShHi(p, np, 1);
 		++p[0];
 		ASSERT(wwBitSize(p, np) == l);
-		// рассчитать вычеты p, 2qa по малым модулям
+		// e[i] <- номер первого кандидата, который делится на _base[i]
 		priBaseMod(mods, p, np, base_count);
-		priBaseMod(mods1, qa, nqa, base_count);
-		for (i = 0; i < base_count; ++i)
-			if ((mods1[i] += mods1[i]) >= _base[i])
-				mods1[i] -= _base[i];
-		// проверка простоты
+		priWindowPrepare(e, mods, mods1, base_count);
+		// перебор окон
 		while (1)
 		{
-			// p делится на малые простые?
-			for (i = 0; i < base_count; ++i)
-				if (mods[i] == 0)
-					break;
-			// не делится: тест Демитко
-			if (i == base_count)
+			count = MIN2(trials, PRI_SIEVE_W);
+			w->count = priWindowLimit(w, count, l, t);
+			priWindowSieve(sieve, w->count, e, base_count);
+			// простое найдено?
+			found = priWindowSearch(w);
+			if (found != SIZE_MAX)
 			{
-				// создать кольцо вычетов \mod p
-				wwTo(t, npo, p);
-				zmCreate(qr, (octet*)t, npo, stack);
-				// four <- 4 [в кольце qr]
-				qrAdd(four, qr->unity, qr->unity, qr);
-				qrAdd(four, four, four, qr);
-				// (4^r)^a \mod p != 1?
-				qrPower(t, four, r, np - nqa + 1, qr, stack);
-				qrPower(t, t, a, m, qr, stack);
-				if (qrCmp(t, qr->unity, qr) != 0)
-				{
-					// ((4^r)^a)^q \mod p == 1?
-					qrPower(t, t, q, n, qr, stack);
-					if (qrCmp(t, qr->unity, qr) == 0)
-						return TRUE;
-				}
+				priWindowStop(w);
+				priWindowCand(t, w, found);
+				wwCopy(p, t, np);
+				return TRUE;
 			}
-			// p <- p + 2 * qa, переполнение?
-			if (zzAddW2(p + nqa, np - nqa, zzAdd2(p, qa, nqa)) ||
-				zzAddW2(p + nqa, np - nqa, zzAdd2(p, qa, nqa)) ||
+			// к следующей попытке?
+			if (trials != SIZE_MAX)
+				trials -= w->count;
+			if (w->count < count || trials == 0)
+				break;
+			// к следующему окну
+			if (zzAddW2(p + w->m, np - w->m, 
+					zzAddMulW(p, w->step, w->m, (word)count)) ||
 				wwBitSize(p, np) > l)
 				break;
-			// r <- r + 1, без переполнения
-			VERIFY(zzAddW2(r, np - nqa + 1, 1) == 0);
-			// пересчитать mods
-			for (i = 0; i < base_count; ++i)
-				if ((mods[i] += mods1[i]) >= _base[i])
-					mods[i] -= _base[i];
-			// к следующей попытке
-			if (trials != SIZE_MAX && trials-- == 0)
-				return FALSE;
+			VERIFY(zzAddW2(r, d->nr, (word)count) == 0);
+			priWindowShift(e, count, base_count);
 		}
 	}
+	priWindowStop(w);
 	return FALSE;
 }
 
 size_t priExtendPrime2_deep(size_t l, size_t n, size_t m, size_t base_count)
 {
 	const size_t np = W_OF_B(l);
-	const size_t npo = O_OF_B(l);
-	const size_t qr_deep = zmCreate_deep(npo);
 	ASSERT(np >= n);
 	ASSERT(np + 3 >= n + m);
-	return O_OF_W(3 * np + 5 + 2 * base_count) + 
-		zmCreate_keep(npo) +
-		utilMax(5,
+	return O_OF_W(n + m + 2 * np + 6 + 3 * base_count) + PRI_SIEVE_W / 8 +
+		priWindow_keep(np, priExtendPrimeWorker_deep(l)) +
+		utilMax(3,
 			zzMul_deep(n, m),
 			zzDiv_deep(np, n + m),
-			zzMul_deep(n + m, np - n - m + 3),
-			qr_deep,
-			qrPower_deep(np, np, qr_deep));
+			zzMul_deep(n + m, np - n - m + 3));
 }
 
 bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
@@ -4,7 +4,7 @@
 \brief Multiple-precision unsigned integers: modular exponentiation
 \project bee2 [cryptographic library]
 \created 2012.04.22
-\version 2016.07.01
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -16,6 +16,7 @@
 #include "bee2/math/ww.h"
 #include "bee2/math/zm.h"
 #include "bee2/math/zz.h"
+#include "zz_lcl.h"
 
 /*
 *******************************************************************************
@@ -139,3 +140,314 @@ size_t zzPowerModW_deep()
 {
 	return O_OF_W(4);
 }
+
+/*
+*******************************************************************************
+Умножение Монтгомери
+
+Реализован алгоритм CIOS (Coarsely Integrated Operand Scanning) из статьи
+[Koc C. K., Acar T., Kaliski B. S. Analyzing and comparing Montgomery 
+multiplication algorithms. IEEE Micro, 16(3): 26-33, 1996]:
+	t <- 0
+	for i = 0,..., n - 1:
+		t <- t + a * b[i]
+		m <- t[0] * mont_param \mod B
+		t <- (t + m * mod) / B
+	if (t >= mod)
+		t <- t - mod
+	return t
+Умножение на b[i] и редукция чередуются, поэтому промежуточный результат 
+занимает n + 2 слова, а не 2n слов, как при последовательном вызове zzMul() 
+и zzRedMont(). Кроме того, сокращается число обращений к памяти.
+
+Поскольку a, b < mod, на каждом шаге t < 2 mod. Итоговое вычитание 
+выполняется по маске, которая рассчитывается без ветвлений.
+*******************************************************************************
+*/
+
+void zzMulMont(word c[], const word a[], const word b[], const word mod[],
+	size_t n, register word mont_param, void* stack)
+{
+	register word carry;
+	register word m;
+	register dword prod;
+	size_t i, j;
+	// переменные в stack
+	word* t = (word*)stack;		/* [n + 2] */
+	// pre
+	ASSERT(n > 0 && mod[n - 1] != 0 && mod[0] % 2);
+	ASSERT((word)(mod[0] * mont_param + 1) == 0);
+	ASSERT(wwCmp(a, mod, n) < 0 && wwCmp(b, mod, n) < 0);
+	ASSERT(wwIsSameOrDisjoint(a, c, n) && wwIsSameOrDisjoint(b, c, n));
+	ASSERT(wwIsDisjoint(c, mod, n));
+	// t <- 0
+	wwSetZero(t, n + 2);
+	// цикл по разрядам b
+	for (i = 0; i < n; ++i)
+	{
+		// t <- t + a * b[i]
+		carry = 0;
+		for (j = 0; j < n; ++j)
+		{
+			_MUL(prod, a[j], b[i]);
+			prod += carry;
+			prod += t[j];
+			t[j] = (word)prod;
+			carry = (word)(prod >> B_PER_W);
+		}
+		prod = t[n], prod += carry;
+		t[n] = (word)prod;
+		t[n + 1] = (word)(prod >> B_PER_W);
+		// t <- (t + m * mod) / B
+		_MUL_LO(m, t[0], mont_param);
+		_MUL(prod, m, mod[0]);
+		prod += t[0];
+		carry = (word)(prod >> B_PER_W);
+		for (j = 1; j < n; ++j)
+		{
+			_MUL(prod, m, mod[j]);
+			prod += carry;
+			prod += t[j];
+			t[j - 1] = (word)prod;
+			carry = (word)(prod >> B_PER_W);
+		}
+		prod = t[n], prod += carry;
+		t[n - 1] = (word)prod;
+		t[n] = t[n + 1] + (word)(prod >> B_PER_W);
+	}
+	// m <- (t >= mod) ? WORD_MAX : 0
+	for (m = 1, i = 0; i < n; ++i)
+	{
+		m &= wordEq01(mod[i], t[i]);
+		m |= wordLess01(mod[i], t[i]);
+	}
+	m |= t[n], m = WORD_0 - m;
+	// c <- t - mod & m
+	zzSubAndW(t, mod, n, m);
+	wwCopy(c, t, n);
+	// очистка
+	carry = m = 0;
+	prod = 0;
+}
+
+size_t zzMulMont_deep(size_t n)
+{
+	return O_OF_W(n + 2);
+}
+
+/*
+*******************************************************************************
+Возведение в степень Монтгомери
+
+В функции zzPowerMont() реализован метод фиксированного окна. 
+Предварительно рассчитываются степени
+	a^(0) = R \mod mod, a^(1) = a, a^(2),..., a^(2^w - 1),
+где w --- ширина окна (см. zzPowerMontWidth()). Затем показатель b 
+разбивается на окна из w битов, начиная с младших. Старшее окно может быть 
+короче. Обработка очередного окна состоит в w возведениях в квадрат 
+и умножении на степень a, номер которой совпадает со значением окна. 
+Умножение выполняется и при нулевом значении окна (на a^(0)).
+
+В функциях zzPowerMontPre(), zzPowerMontComb() реализован метод гребенки 
+[Lim C., Lee P. More flexible exponentiation with precomputation. 
+CRYPTO'94], см. также ecMulCombA(). Показатель b битовой длины l 
+записывается в виде таблицы из w строк и d = ceil(l / w) столбцов:
+	b = \sum_{i < w} \sum_{j < d} b_{id + j} 2^{id + j}.
+Предварительно рассчитываются степени
+	pre[k] = \prod_{i: k_i = 1} a^(2^{id}), 0 <= k < 2^w,
+где k_i --- i-й бит k. Затем для j = d - 1,..., 0:
+	c <- c^(2) \circ pre[b_{j} + 2 b_{d + j} + ... + 2^{w-1} b_{(w-1)d + j}].
+
+Выбор элемента таблицы выполняется функцией zzMontSelect(), которая 
+просматривает все элементы и накапливает нужный с помощью масок.
+Возведение в квадрат выполняется функцией zzSqrMont(): zzSqr() и затем 
+zzRedMont(). Это быстрее, чем zzMulMont(c, c, c,...), поскольку при 
+возведении в квадрат число умножений слов почти вдвое меньше.
+*******************************************************************************
+*/
+
+static size_t zzPowerMontWidth(size_t l)
+{
+	if (l <= 64)
+		return 3;
+	if (l <= 512)
+		return 4;
+	return 5;
+}
+
+static void zzMontSelect(word c[], const word table[], size_t count, 
+	register size_t idx, size_t n)
+{
+	register word mask;
+	size_t i, j;
+	wwSetZero(c, n);
+	for (i = 0; i < count; ++i, table += n)
+	{
+		mask = WORD_0 - wordEq01(i, idx);
+		for (j = 0; j < n; ++j)
+			c[j] |= table[j] & mask;
+	}
+	mask = 0, idx = 0;
+}
+
+static void zzSqrMont(word c[], const word a[], const word mod[], size_t n,
+	register word mont_param, void* stack)
+{
+	word* t = (word*)stack;
+	stack = t + 2 * n;
+	zzSqr(t, a, n, stack);
+	zzRedMont(t, mod, n, mont_param, stack);
+	wwCopy(c, t, n);
+}
+
+static size_t zzSqrMont_deep(size_t n)
+{
+	return O_OF_W(2 * n) + 
+		utilMax(2,
+			zzSqr_deep(n),
+			zzRedMont_deep(n));
+}
+
+static void zzMontUnity(word u[], const word mod[], size_t n, void* stack)
+{
+	// u <- B^n - mod \mod mod
+	zzNeg(u, mod, n);
+	zzMod(u, u, n, mod, n, stack);
+}
+
+void zzPowerMont(word c[], const word a[], const word b[], size_t l, 
+	const word mod[], size_t n, register word mont_param, void* stack)
+{
+	const size_t w = zzPowerMontWidth(l);
+	const size_t count = SIZE_1 << w;
+	register word digit;
+	size_t pos, i;
+	// переменные в stack
+	word* table;	/* [count * n] степени a */
+	word* t;		/* [n] */
+	// pre
+	ASSERT(n > 0 && mod[n - 1] != 0 && mod[0] % 2);
+	ASSERT(wwCmp(a, mod, n) < 0);
+	ASSERT(wwIsValid(b, W_OF_B(l)));
+	ASSERT(wwIsSameOrDisjoint(a, c, n));
+	// раскладка stack
+	table = (word*)stack;
+	t = table + count * n;
+	stack = t + n;
+	// table[i] <- a^(i)
+	zzMontUnity(table, mod, n, stack);
+	wwCopy(table + n, a, n);
+	for (i = 2; i < count; ++i)
+		zzMulMont(table + i * n, table + i * n - n, a, mod, n, mont_param, 
+			stack);
+	// b == 0?
+	if (l == 0)
+	{
+		wwCopy(c, table, n);
+		return;
+	}
+	// c <- a^(старшее окно b)
+	pos = (l - 1) / w * w;
+	digit = wwGetBits(b, pos, l - pos);
+	zzMontSelect(c, table, count, digit, n);
+	// цикл по окнам
+	while (pos)
+	{
+		pos -= w;
+		for (i = 0; i < w; ++i)
+			zzSqrMont(c, c, mod, n, mont_param, stack);
+		digit = wwGetBits(b, pos, w);
+		zzMontSelect(t, table, count, digit, n);
+		zzMulMont(c, c, t, mod, n, mont_param, stack);
+	}
+	// очистка
+	digit = 0;
+}
+
+size_t zzPowerMont_deep(size_t n, size_t l)
+{
+	const size_t count = SIZE_1 << zzPowerMontWidth(l);
+	return O_OF_W(count * n + n) + 
+		utilMax(3,
+			zzMod_deep(n, n),
+			zzMulMont_deep(n),
+			zzSqrMont_deep(n));
+}
+
+void zzPowerMontPre(word pre[], size_t w, const word a[], size_t l, 
+	const word mod[], size_t n, register word mont_param, void* stack)
+{
+	const size_t d = (l + w - 1) / w;
+	size_t i, j, k;
+	// pre
+	ASSERT(1 <= w && w <= 8 && w <= l);
+	ASSERT(n > 0 && mod[n - 1] != 0 && mod[0] % 2);
+	ASSERT(wwCmp(a, mod, n) < 0);
+	ASSERT(wwIsDisjoint2(pre, n << w, a, n));
+	// pre[0] <- a^(0), pre[1] <- a
+	zzMontUnity(pre, mod, n, stack);
+	wwCopy(pre + n, a, n);
+	// pre[2^i + j] <- a^(2^{id}) \circ pre[j]
+	for (i = 1; i < w; ++i)
+	{
+		word* hi = pre + (n << i);
+		wwCopy(hi, pre + (n << (i - 1)), n);
+		for (k = 0; k < d; ++k)
+			zzSqrMont(hi, hi, mod, n, mont_param, stack);
+		for (j = 1; j < (SIZE_1 << i); ++j)
+			zzMulMont(hi + j * n, hi, pre + j * n, mod, n, mont_param, stack);
+	}
+}
+
+size_t zzPowerMontPre_deep(size_t n)
+{
+	return utilMax(3,
+		zzMod_deep(n, n),
+		zzMulMont_deep(n),
+		zzSqrMont_deep(n));
+}
+
+void zzPowerMontComb(word c[], const word pre[], size_t w, const word b[], 
+	size_t l, const word mod[], size_t n, register word mont_param, 
+	void* stack)
+{
+	const size_t d = (l + w - 1) / w;
+	register size_t digit;
+	size_t i, j;
+	// переменные в stack
+	word* t = (word*)stack;		/* [n] */
+	// pre
+	ASSERT(1 <= w && w <= 8 && w <= l);
+	ASSERT(n > 0 && mod[n - 1] != 0 && mod[0] % 2);
+	ASSERT(wwIsValid(b, W_OF_B(l)));
+	ASSERT(wwIsDisjoint2(pre, n << w, c, n));
+	// раскладка stack
+	stack = t + n;
+	// цикл по столбцам
+	for (j = d; j--;)
+	{
+		// digit <- b_{j} + 2 b_{d + j} + ... 
+		for (digit = 0, i = 0; i < w; ++i)
+			if (i * d + j < l)
+				digit |= (size_t)wwTestBit(b, i * d + j) << i;
+		// c <- c^(2) \circ pre[digit]
+		if (j + 1 == d)
+			zzMontSelect(c, pre, SIZE_1 << w, digit, n);
+		else
+		{
+			zzSqrMont(c, c, mod, n, mont_param, stack);
+			zzMontSelect(t, pre, SIZE_1 << w, digit, n);
+			zzMulMont(c, c, t, mod, n, mont_param, stack);
+		}
+	}
+	// очистка
+	digit = 0;
+}
+
+size_t zzPowerMontComb_deep(size_t n)
+{
+	return O_OF_W(n) + 
+		utilMax(2,
+			zzMulMont_deep(n),
+			zzSqrMont_deep(n));
+}
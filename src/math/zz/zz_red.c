@@ -4,7 +4,7 @@
 \brief Multiple-precision unsigned integers: modular reductions
 \project bee2 [cryptographic library]
 \created 2012.04.22
-\version 2019.06.26
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -278,7 +278,7 @@ void SAFE(zzRedMont)(word a[], const word mod[], size_t n,
 	}
 	ASSERT(wwIsZero(a, n));
 	// a <- a / B^n, a >= mod?
-	for (i = 0; i < n; ++i)
+	for (i = 0, w = 1; i < n; ++i)
 	{
 		a[i] = a[n + i];
 		w &= wordEq01(mod[i], a[i]);
@@ -384,7 +384,7 @@ void SAFE(zzRedCrandMont)(word a[], const word mod[], size_t n,
 	// a <- a - borrow * B^{n + 1}
 	carry -= zzSubW2(a + n + 1, n - 1, borrow);
 	// a <- a / B^n, a >= mod?
-	for (i = 0; i < n; ++i)
+	for (i = 0, w = 1; i < n; ++i)
 	{
 		a[i] = a[n + i];
 		w &= wordEq01(mod[i], a[i]);
@@ -0,0 +1,97 @@
+/*
+*******************************************************************************
+\file b64_bench.c
+\brief Benchmarks for the Base64 encoding
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/b64.h>
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/str.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости (в мегабайтах двоичных данных в секунду) кодирования
+(b64From(), b64UrlFrom()) и декодирования (b64To(), потоковое
+декодирование фрагментами по 4096 символов) буферов разной длины.
+*******************************************************************************
+*/
+
+#define b64BenchPrint(name, len, reps, ticks)\
+	printf("b64Bench::%-7s[%5u]: %6u MBytes/sec\n", name, (unsigned)(len),\
+		(unsigned)(tmSpeed(reps, ticks) * (len) >> 20))
+
+bool_t b64Bench()
+{
+	const size_t lens[] = { 48, 384, 4095, 16383 };
+	octet a[16383];
+	octet b[16383];
+	char b64[16383 / 3 * 4 + 1];
+	octet combo_state[32];
+	octet state[64];
+	size_t reps, i, j;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(state) < b64Dec_keep())
+		return FALSE;
+	// подготовить буфер
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(a, sizeof(a), combo_state);
+	// цикл по длинам
+	for (j = 0; j < COUNT_OF(lens); ++j)
+	{
+		const size_t len = lens[j];
+		size_t count;
+		reps = (16u << 20) / len;
+		// кодирование base64url
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			b64UrlFrom(b64, a, len);
+		ticks = tmTicks() - ticks;
+		b64BenchPrint("urlFrom", len, reps, ticks);
+		// кодирование
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			b64From(b64, a, len);
+		ticks = tmTicks() - ticks;
+		b64BenchPrint("from", len, reps, ticks);
+		// декодирование
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			count = sizeof(b), b64To(b, &count, b64);
+		ticks = tmTicks() - ticks;
+		b64BenchPrint("to", len, reps, ticks);
+		if (count != len || !memEq(a, b, len))
+			return FALSE;
+		// потоковое декодирование
+		memSetZero(b, len);
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		{
+			const size_t b64_len = strLen(b64);
+			size_t pos, t;
+			b64DecStart(state, FALSE);
+			for (pos = count = 0; pos < b64_len; pos += 4096, count += t)
+				if (b64DecStep(b + count, &t, b64 + pos,
+					MIN2(4096, b64_len - pos), state) != ERR_OK)
+					return FALSE;
+			if (b64DecStop(b + count, &t, state) != ERR_OK)
+				return FALSE;
+		}
+		ticks = tmTicks() - ticks;
+		if (count != len || !memEq(a, b, len))
+			return FALSE;
+		b64BenchPrint("decStep", len, reps, ticks);
+	}
+	// все нормально
+	return TRUE;
+}
@@ -4,14 +4,17 @@
 \brief Tests for base64 encoding
 \project bee2/test
 \created 2016.06.16
-\version 2016.06.16
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
 #include <bee2/core/b64.h>
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
 #include <bee2/crypto/belt.h>
 
 /*
@@ -24,7 +27,7 @@ bool_t b64Test()
 {
 	octet buf[256];
 	char b64[255 / 3 * 4 + 1];
-	size_t count;
+	size_t count, len;
 	// валидация
 	if (!b64IsValid("1234") ||
 		b64IsValid("AbC=") ||
@@ -51,6 +54,112 @@ bool_t b64Test()
 		if (!memEq(buf, beltH(), count))
 			return FALSE;
 	}
+	// base64url: валидация
+	if (!b64UrlIsValid("Ab-_") ||
+		b64IsValid("Ab-_") ||
+		b64UrlIsValid("Ab+/") ||
+		!b64UrlIsValid("AbE=") ||
+		!b64UrlIsValid("AbE") ||
+		b64UrlIsValid("AbC") ||
+		!b64UrlIsValid("AbCBDg") ||
+		b64UrlIsValid("AbCBD"))
+		return FALSE;
+	// base64url: кодировать / декодировать
+	for (count = 0; count < 256; ++count)
+	{
+		char b64url[255 / 3 * 4 + 1];
+		size_t t, pos;
+		b64From(b64, beltH(), count);
+		b64UrlFrom(b64url, beltH(), count);
+		for (pos = 0; b64[pos]; ++pos)
+			if (b64[pos] == '+' && b64url[pos] != '-' ||
+				b64[pos] == '/' && b64url[pos] != '_' ||
+				b64[pos] != '+' && b64[pos] != '/' && b64[pos] != b64url[pos])
+				return FALSE;
+		// без паддинга
+		if (count % 3)
+			b64url[strLen(b64url) - 3 + count % 3] = '\0';
+		if (!b64UrlIsValid(b64url))
+			return FALSE;
+		b64UrlTo(0, &t, b64url);
+		if (t != count)
+			return FALSE;
+		b64UrlTo(buf, &t, b64url);
+		if (t != count || !memEq(buf, beltH(), count))
+			return FALSE;
+	}
+	// потоковое кодирование / декодирование
+	{
+		const size_t steps[] = { 1, 2, 5, 40, 256 };
+		octet state[64];
+		char b64s[255 / 3 * 4 + 1];
+		size_t i, pos, t;
+		if (sizeof(state) < b64Enc_keep() || sizeof(state) < b64Dec_keep())
+			return FALSE;
+		for (count = 0; count < 256; count += 17)
+			for (i = 0; i < COUNT_OF(steps); ++i)
+			{
+				// кодировать
+				b64From(b64, beltH(), count);
+				b64EncStart(state, FALSE);
+				for (pos = t = 0; pos < count; pos += steps[i])
+					t += b64EncStep(b64s + t, beltH() + pos,
+						MIN2(steps[i], count - pos), state);
+				t += b64EncStop(b64s + t, state);
+				if (t != strLen(b64) || !strEq(b64s, b64))
+					return FALSE;
+				// декодировать
+				b64DecStart(state, FALSE);
+				for (pos = 0, len = 0; pos < strLen(b64); pos += steps[i])
+				{
+					if (b64DecStep(buf + len, &t, b64 + pos,
+						MIN2(steps[i], strLen(b64) - pos), state) != ERR_OK)
+						return FALSE;
+					len += t;
+				}
+				if (b64DecStop(buf + len, &t, state) != ERR_OK ||
+					(len += t) != count || !memEq(buf, beltH(), count))
+					return FALSE;
+				// декодировать base64url без паддинга
+				b64UrlFrom(b64, beltH(), count);
+				if (count % 3)
+					b64[strLen(b64) - 3 + count % 3] = '\0';
+				b64DecStart(state, TRUE);
+				for (pos = 0, len = 0; pos < strLen(b64); pos += steps[i])
+				{
+					if (b64DecStep(buf + len, &t, b64 + pos,
+						MIN2(steps[i], strLen(b64) - pos), state) != ERR_OK)
+						return FALSE;
+					len += t;
+				}
+				if (b64DecStop(buf + len, &t, state) != ERR_OK ||
+					(len += t) != count || !memEq(buf, beltH(), count))
+					return FALSE;
+			}
+		// некорректные строки
+		b64DecStart(state, FALSE);
+		if (b64DecStep(buf, &t, "AbC=", 4, state) != ERR_BAD_FORMAT)
+			return FALSE;
+		b64DecStart(state, FALSE);
+		if (b64DecStep(buf, &t, "AbE=AbE=", 8, state) != ERR_BAD_FORMAT)
+			return FALSE;
+		b64DecStart(state, FALSE);
+		if (b64DecStep(buf, &t, "AbE", 3, state) != ERR_OK ||
+			b64DecStop(buf, &t, state) != ERR_BAD_FORMAT)
+			return FALSE;
+		b64DecStart(state, TRUE);
+		if (b64DecStep(buf, &t, "Ab+/", 4, state) != ERR_BAD_FORMAT)
+			return FALSE;
+		b64From(b64, beltH(), 96);
+		b64[40] = '@';
+		b64DecStart(state, FALSE);
+		if (b64DecStep(buf, &t, b64, strLen(b64), state) != ERR_BAD_FORMAT)
+			return FALSE;
+		b64[40] = '-';
+		b64DecStart(state, FALSE);
+		if (b64DecStep(buf, &t, b64, strLen(b64), state) != ERR_BAD_FORMAT)
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -4,7 +4,7 @@
 \brief Tests for blob functions
 \project bee2/test
 \created 2023.03.21
-\version 2023.03.23
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -12,6 +12,114 @@
 
 #include <bee2/core/blob.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/mt.h>
+
+/*
+*******************************************************************************
+Тестирование арены
+*******************************************************************************
+*/
+
+static void blobTestThrd(void* arg)
+{
+	blob_t* b = (blob_t*)arg;
+	// закрыть чужой блоб
+	blobClose(b[0]);
+	// создать блоб, который переживет поток
+	b[1] = blobCreate(100);
+}
+
+static bool_t blobTestArena()
+{
+	blob_stat stat[1], stat1[1];
+	blob_t b[4];
+	mt_thrd_t thrd;
+	// создать арену
+	b[0] = blobCreate(1);
+	blobStat(stat);
+	blobClose(b[0]);
+	if (stat->arena_size == 0)
+		return TRUE;
+	// стековая дисциплина
+	blobStat(stat);
+	b[0] = blobCreate(100), b[1] = blobCreate(200), b[2] = blobCreate(300);
+	if (!b[0] || !b[1] || !b[2])
+	{
+		blobClose(b[2]), blobClose(b[1]), blobClose(b[0]);
+		return FALSE;
+	}
+	blobStat(stat1);
+	if (stat1->arena_count != stat->arena_count + 3 ||
+		stat1->arena_used <= stat->arena_used + 600 ||
+		stat1->arena_peak < stat1->arena_used)
+	{
+		blobClose(b[2]), blobClose(b[1]), blobClose(b[0]);
+		return FALSE;
+	}
+	// закрытие не по порядку
+	blobClose(b[1]);
+	blobStat(stat1);
+	if (stat1->arena_used <= stat->arena_used + 600)
+	{
+		blobClose(b[2]), blobClose(b[0]);
+		return FALSE;
+	}
+	blobClose(b[2]);
+	blobStat(stat1);
+	if (stat1->arena_used <= stat->arena_used + 100 ||
+		stat1->arena_used >= stat->arena_used + 300)
+	{
+		blobClose(b[0]);
+		return FALSE;
+	}
+	// изменение размера блоба арены
+	memSet(b[0], 0x36, 100);
+	b[1] = blobResize(b[0], 150);
+	if (!b[1] || !memIsRep(b[1], 100, 0x36) || 
+		!memIsZero((octet*)b[1] + 100, 50))
+	{
+		blobClose(b[1] ? b[1] : b[0]);
+		return FALSE;
+	}
+	blobClose(b[1]);
+	blobStat(stat1);
+	if (stat1->arena_used != stat->arena_used)
+		return FALSE;
+	// большой блоб -- в куче
+	b[0] = blobCreate(stat->arena_size + 1);
+	blobStat(stat1);
+	blobClose(b[0]);
+	if (!b[0] || stat1->heap_count != stat->heap_count + 1)
+		return FALSE;
+	// закрытие в другом потоке
+	b[0] = blobCreate(100), b[1] = 0;
+	if (!b[0])
+		return FALSE;
+	if (!mtThrdCreate(&thrd, blobTestThrd, b))
+		blobTestThrd(b);
+	else
+		mtThrdJoin(&thrd);
+	if (!b[1])
+		return FALSE;
+	blobClose(b[1]);
+	// после закрытия чужого блоба арена освобождается 
+	b[2] = blobCreate(100);
+	blobClose(b[2]);
+	blobStat(stat1);
+	if (!b[2] || stat1->arena_used != stat->arena_used)
+		return FALSE;
+	// закрытие арены
+	b[3] = blobCreate(100);
+	blobArenaClose();
+	blobStat(stat1);
+	if (!b[3] || stat1->arena_size != 0)
+	{
+		blobClose(b[3]);
+		return FALSE;
+	}
+	blobClose(b[3]);
+	return TRUE;
+}
 
 /*
 *******************************************************************************
@@ -58,5 +166,6 @@ bool_t blobTest()
 	blobWipe(b2);
 	blobClose(b2);
 	blobClose(b1);
-	return TRUE;
+	// арена
+	return blobTestArena();
 }
@@ -4,13 +4,14 @@
 \brief Tests for DER encoding rules
 \project bee2/test
 \created 2021.04.12
-\version 2022.11.01
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
 #include <bee2/core/der.h>
+#include <bee2/core/err.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/str.h>
@@ -41,6 +42,75 @@
 	(ptr) += t, (count) -= t;\
 }\
 
+/*
+*******************************************************************************
+Потоковое декодирование
+
+Файлом является буфер памяти, который читается порциями не более чем
+по 7 октетов. Тем самым проверяется дочитывание окна.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	const octet* der;
+	size_t count;
+	size_t pos;
+} der_test_file_t;
+
+static err_t derTestRead(size_t* read, void* buf, size_t count, void* file)
+{
+	der_test_file_t* f = (der_test_file_t*)file;
+	*read = MIN2(MIN2(count, 7), f->count - f->pos);
+	memCopy(buf, f->der + f->pos, *read);
+	f->pos += *read;
+	return (f->pos == f->count && *read < count) ? ERR_MAX : ERR_OK;
+}
+
+static bool_t derTestStream(void* state)
+{
+	u32 tag;
+	size_t len;
+	const octet* ptr;
+	// Seq3
+	if (derStreamNext(&tag, &len, state) != ERR_OK ||
+		tag != 0x30 ||
+		derStreamEnter(state) != ERR_OK)
+		return FALSE;
+	// SIZE(127)
+	if (derStreamNext(&tag, &len, state) != ERR_OK ||
+		tag != 0x02 || len != 1 ||
+		derStreamVal(&ptr, state) != ERR_OK ||
+		ptr[0] != 127 ||
+		derStreamEnter(state) != ERR_BAD_FORMAT)
+		return FALSE;
+	// SEQUENCE { NULL, OCTET STRING(300) } (пропускается)
+	if (derStreamNext(&tag, &len, state) != ERR_OK ||
+		tag != 0x30 || len != 2 + 4 + 300)
+		return FALSE;
+	// SIZE(256)
+	if (derStreamNext(&tag, &len, state) != ERR_OK ||
+		tag != 0x02 || len != 2 ||
+		derStreamVal(&ptr, state) != ERR_OK ||
+		!hexEq(ptr, "0100") ||
+		derStreamTLV(&ptr, &len, state) != ERR_OK ||
+		len != 4 || !hexEq(ptr, "02020100"))
+		return FALSE;
+	// конец Seq3
+	if (derStreamNext(&tag, &len, state) != ERR_MAX ||
+		derStreamVal(&ptr, state) != ERR_BAD_LOGIC ||
+		derStreamLeave(state) != ERR_OK ||
+		derStreamLeave(state) != ERR_BAD_LOGIC)
+		return FALSE;
+	// NULL
+	if (derStreamNext(&tag, &len, state) != ERR_OK ||
+		tag != 0x05 || len != 0 ||
+		derStreamTLV(&ptr, &len, state) != ERR_OK ||
+		len != 2 || !hexEq(ptr, "0500"))
+		return FALSE;
+	// конец кода
+	return derStreamNext(&tag, &len, state) == ERR_MAX;
+}
 
 bool_t derTest()
 {
@@ -223,6 +293,78 @@ bool_t derTest()
 		if (count != 0)
 			return FALSE;
 	}
+	// Seq3 ::= SEQUENCE { SIZE(127), SEQUENCE { NULL, OCTET STRING(300) },
+	//   SIZE(256) } || NULL (потоковое декодирование)
+	{
+		der_anchor_t Seq3[2];
+		octet oct[300];
+		octet state[1024];
+		der_test_file_t file[1];
+		u32 tag;
+		const octet* ptr;
+		// кодировать
+		memSetZero(oct, sizeof(oct));
+		count = 0;
+		derStep(derSEQEncStart(Seq3, buf, count), count);
+		derStep(derSIZEEnc(buf + count, 127), count);
+		derStep(derSEQEncStart(Seq3 + 1, buf + count, count), count);
+		derStep(derNULLEnc(buf + count), count);
+		derStep(derOCTEnc(buf + count, oct, sizeof(oct)), count);
+		derStep(derSEQEncStop(buf + count, count, Seq3 + 1), count);
+		derStep(derSIZEEnc(buf + count, 256), count);
+		derStep(derSEQEncStop(buf + count, count, Seq3), count);
+		derStep(derNULLEnc(buf + count), count);
+		if (count != 4 + 3 + 4 + 2 + 4 + 300 + 4 + 2)
+			return FALSE;
+		// декодировать буфер
+		if (sizeof(state) < derStream_keep(0) ||
+			derStreamStart2(state, buf, count) != ERR_OK ||
+			!derTestStream(state))
+			return FALSE;
+		// декодировать файл (окно вмещает все элементы)
+		file->der = buf, file->count = count, file->pos = 0;
+		if (sizeof(state) < derStream_keep(320) ||
+			derStreamStart(state, 320, derTestRead, file) != ERR_OK ||
+			!derTestStream(state))
+			return FALSE;
+		// декодировать файл (маленькое окно)
+		file->pos = 0;
+		if (derStreamStart(state, 16, derTestRead, file) != ERR_OK ||
+			!derTestStream(state))
+			return FALSE;
+		// слишком длинные элементы
+		file->pos = 0;
+		if (derStreamStart(state, 64, derTestRead, file) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamTLV(&ptr, &len, state) != ERR_OUTOFMEMORY ||
+			derStreamEnter(state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamEnter(state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			tag != 0x04 || len != 300 ||
+			derStreamVal(&ptr, state) != ERR_OUTOFMEMORY ||
+			derStreamLeave(state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			tag != 0x02 || len != 2 ||
+			derStreamVal(&ptr, state) != ERR_OK ||
+			!hexEq(ptr, "0100"))
+			return FALSE;
+		// обрезанный код
+		file->count = count - 1, file->pos = 0;
+		if (derStreamStart2(state, buf, count - 10) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_BAD_FORMAT ||
+			derStreamStart(state, 16, derTestRead, file) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_BAD_FORMAT)
+			return FALSE;
+		file->count = count - 30, file->pos = 0;
+		if (derStreamStart(state, 16, derTestRead, file) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_OK ||
+			derStreamNext(&tag, &len, state) != ERR_BAD_FORMAT)
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -0,0 +1,68 @@
+/*
+*******************************************************************************
+\file hex_bench.c
+\brief Benchmarks for hexadecimal strings
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости (в мегабайтах двоичных данных в секунду) кодирования
+(hexFrom()) и декодирования (hexTo()) буферов разной длины.
+*******************************************************************************
+*/
+
+#define hexBenchPrint(name, len, reps, ticks)\
+	printf("hexBench::%-5s[%5u]: %6u MBytes/sec\n", name, (unsigned)(len),\
+		(unsigned)(tmSpeed(reps, ticks) * (len) >> 20))
+
+bool_t hexBench()
+{
+	const size_t lens[] = { 32, 256, 4096, 16384 };
+	octet a[16384];
+	octet b[16384];
+	char hex[2 * 16384 + 1];
+	octet combo_state[32];
+	size_t reps, i, j;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep())
+		return FALSE;
+	// подготовить буфер
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(a, sizeof(a), combo_state);
+	// цикл по длинам
+	for (j = 0; j < COUNT_OF(lens); ++j)
+	{
+		const size_t len = lens[j];
+		reps = (16u << 20) / len;
+		// кодирование
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			hexFrom(hex, a, len);
+		ticks = tmTicks() - ticks;
+		hexBenchPrint("from", len, reps, ticks);
+		// декодирование
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			hexTo(b, hex);
+		ticks = tmTicks() - ticks;
+		hexBenchPrint("to", len, reps, ticks);
+		if (!memEq(a, b, len))
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
@@ -4,7 +4,7 @@
 \brief Tests for hexadecimal strings
 \project bee2/test
 \created 2016.06.17
-\version 2016.06.17
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -40,6 +40,11 @@ bool_t hexTest()
 		if (!hexEq(beltH(), hex))
 			return FALSE;
 		hexTo(buf, hex);
+		if (!memEq(buf, beltH(), count))
+			return FALSE;
+		hexLower(hex);
+		memSetZero(buf, count);
+		hexTo(buf, hex);
 		if (!memEq(buf, beltH(), count))
 			return FALSE;
 		hexFromRev(hex, beltH(), count);
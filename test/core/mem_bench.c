@@ -0,0 +1,88 @@
+/*
+*******************************************************************************
+\file mem_bench.c
+\brief Benchmarks for memory functions
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости (в мегабайтах в секунду) сложения буферов 
+(memXor(), memXor2()), регулярных проверок совпадения и нулевого 
+заполнения (SAFE(memEq)(), SAFE(memIsZero)()) и очистки (memWipe()) 
+для буферов разной длины.
+*******************************************************************************
+*/
+
+#define memBenchPrint(name, len, reps, ticks)\
+	printf("memBench::%-9s[%5u]: %6u MBytes/sec\n", name, (unsigned)(len),\
+		(unsigned)(tmSpeed(reps, ticks) * (len) >> 20))
+
+bool_t memBench()
+{
+	const size_t lens[] = { 64, 256, 1024, 16384 };
+	octet a[16384];
+	octet b[16384];
+	octet c[16384];
+	octet combo_state[32];
+	size_t reps, i, j;
+	size_t ctr = 0;
+	size_t ctr1 = 0;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep())
+		return FALSE;
+	// подготовить буферы
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(a, sizeof(a), combo_state);
+	memCopy(b, a, sizeof(a));
+	memSetZero(c, sizeof(c));
+	// цикл по длинам
+	for (j = 0; j < COUNT_OF(lens); ++j)
+	{
+		const size_t len = lens[j];
+		reps = (64u << 20) / len;
+		ctr1 += 2 * reps;
+		// memXor
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			memXor(c, a, b, len);
+		ticks = tmTicks() - ticks;
+		memBenchPrint("xor", len, reps, ticks);
+		// memXor2
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			memXor2(c, a, len);
+		ticks = tmTicks() - ticks;
+		memBenchPrint("xor2", len, reps, ticks);
+		// SAFE(memEq)
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			ctr += SAFE(memEq)(a, b, len);
+		ticks = tmTicks() - ticks;
+		memBenchPrint("eq", len, reps, ticks);
+		// SAFE(memIsZero)
+		memSetZero(c, len);
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			ctr += SAFE(memIsZero)(c, len);
+		ticks = tmTicks() - ticks;
+		memBenchPrint("isZero", len, reps, ticks);
+		// memWipe
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			memWipe(c, len);
+		ticks = tmTicks() - ticks;
+		memBenchPrint("wipe", len, reps, ticks);
+	}
+	// все нормально
+	return ctr == ctr1;
+}
@@ -4,7 +4,7 @@
 \brief Tests for memory functions
 \project bee2/test
 \created 2014.02.01
-\version 2023.03.06
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -28,6 +28,38 @@ warning (https://gcc.gnu.org/onlinedocs/gcc/Warning-Options.html).
 *******************************************************************************
 */
 
+static bool_t memTestLong()
+{
+	octet a[300];
+	octet b[300];
+	octet c[300];
+	size_t count, pos, i;
+	for (count = 60; count <= 260; count += 13)
+		for (pos = 0; pos < count; pos += 7)
+		{
+			// сдвиг относительно выравнивания
+			octet* a1 = a + pos % 5;
+			octet* b1 = b + pos % 3;
+			for (i = 0; i < count; ++i)
+				a1[i] = (octet)(i * 31 + 7), b1[i] = (octet)(i * 31 + 7);
+			if (!SAFE(memEq)(a1, b1, count) || !FAST(memEq)(a1, b1, count))
+				return FALSE;
+			b1[pos] ^= 0x40;
+			if (SAFE(memEq)(a1, b1, count) || FAST(memEq)(a1, b1, count))
+				return FALSE;
+			memXor(c, a1, b1, count);
+			if (c[pos] != 0x40 || !SAFE(memIsZero)(c, pos) ||
+				!FAST(memIsZero)(c, pos) || 
+				!SAFE(memIsZero)(c + pos + 1, count - pos - 1) ||
+				SAFE(memIsZero)(c, count) || FAST(memIsZero)(c, count))
+				return FALSE;
+			memXor2(c, a1, count);
+			if (!memEq(c, b1, count))
+				return FALSE;
+		}
+	return TRUE;
+}
+
 bool_t memTest()
 {
 	octet buf[16];
@@ -168,6 +200,6 @@ bool_t memTest()
 	memXor2(buf2, buf, 8);
 	if (!memIsRep(buf2, 8, 0) || buf2[8] != 0x08)
 		return FALSE;
-	// все нормально
-	return TRUE;
+	// длинные буферы (векторные ускорители)
+	return memTestLong();
 }
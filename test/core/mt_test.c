@@ -4,14 +4,94 @@
 \brief Tests for multithreading
 \project bee2/test
 \created 2021.05.15
-\version 2021.05.18
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
+#include <bee2/core/mem.h>
 #include <bee2/core/mt.h>
 
+/*
+*******************************************************************************
+Пул потоков
+
+Задача заполняет стек октетом, который зависит от индекса, и проверяет
+заполнение. Если бы стек использовался одновременно несколькими задачами,
+то проверка могла бы не пройти. Кроме этого, задача отмечает свой индекс
+в массиве hits и увеличивает общий счетчик.
+*******************************************************************************
+*/
+
+#define MT_TEST_DEEP	512
+#define MT_TEST_COUNT	1000
+
+typedef struct
+{
+	size_t hits[MT_TEST_COUNT];	/*< число выполнений задач */
+	size_t total;				/*< общее число выполнений */
+	size_t errors;				/*< число ошибок стека */
+} mt_test_st;
+
+static void mtTestTask(size_t i, void* arg, void* stack)
+{
+	mt_test_st* st = (mt_test_st*)arg;
+	memSet(stack, (octet)i, MT_TEST_DEEP);
+	if (!memIsRep(stack, MT_TEST_DEEP, (octet)i))
+		mtAtomicIncr(&st->errors);
+	++st->hits[i];
+	mtAtomicIncr(&st->total);
+}
+
+static bool_t mtTestPool(size_t threads)
+{
+	void* pool;
+	mt_test_st st[1];
+	bool_t ok;
+	size_t i;
+	// создать пул
+	pool = blobCreate(mtPool_keep(threads, MT_TEST_DEEP));
+	if (!pool)
+		return FALSE;
+	if (!mtPoolStart(pool, threads, MT_TEST_DEEP))
+	{
+		blobClose(pool);
+		return FALSE;
+	}
+	ok = mtPoolThreads(pool) > 0 &&
+		(threads == 0 || mtPoolThreads(pool) <= threads);
+	// параллельный цикл
+	memSetZero(st, sizeof(st));
+	mtPoolFor(pool, MT_TEST_COUNT, mtTestTask, st);
+	ok = ok && st->total == MT_TEST_COUNT && st->errors == 0;
+	for (i = 0; ok && i < MT_TEST_COUNT; ++i)
+		ok = st->hits[i] == 1;
+	// пустой цикл
+	mtPoolFor(pool, 0, mtTestTask, st);
+	ok = ok && st->total == MT_TEST_COUNT;
+	// отдельные задачи (с переполнением очередей)
+	memSetZero(st, sizeof(st));
+	for (i = 0; i < MT_TEST_COUNT; ++i)
+		mtPoolRun(pool, mtTestTask, i, st);
+	mtPoolWait(pool);
+	ok = ok && st->total == MT_TEST_COUNT && st->errors == 0;
+	for (i = 0; ok && i < MT_TEST_COUNT; ++i)
+		ok = st->hits[i] == 1;
+	// незавершенные задачи выполняются до закрытия
+	memSetZero(st, sizeof(st));
+	for (i = 0; i < 10; ++i)
+		mtPoolRun(pool, mtTestTask, i, st);
+	mtPoolClose(pool);
+	ok = ok && st->total == 10 && st->errors == 0;
+	// стеки (последние в состоянии) очищены?
+	ok = ok && memIsZero((octet*)pool + mtPool_keep(threads, 0),
+		mtPool_keep(threads, MT_TEST_DEEP) - mtPool_keep(threads, 0));
+	blobClose(pool);
+	return ok;
+}
+
 /*
 *******************************************************************************
 Тестирование
@@ -46,6 +126,9 @@ bool_t mtTest()
 		return FALSE;
 	if (!mtCallOnce(&_once, init) || !_inited)
 		return FALSE;
+	// пул потоков
+	if (!mtTestPool(1) || !mtTestPool(4) || !mtTestPool(0))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -4,7 +4,7 @@
 \brief Tests for random number generators
 \project bee2/test
 \created 2014.10.10
-\version 2023.12.16
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
+#include <bee2/core/mt.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/rng.h>
 #include <bee2/core/util.h>
@@ -75,6 +76,34 @@ bool_t rngTest()
 		rngTestFIPS2(buf) ? '+' : '-',
 		rngTestFIPS3(buf) ? '+' : '-',
 		rngTestFIPS4(buf) ? '+' : '-');
+	// фоновый сбор энтропии
+	if (rngPoolStart() == ERR_OK)
+	{
+		rng_pool_stat stat[1];
+		for (pos = 0; pos < 500; ++pos)
+		{
+			rngPoolStat(stat);
+			if (stat->level)
+				break;
+			mtSleep(10);
+		}
+		if (!stat->active || !stat->level || stat->level > stat->size)
+			return FALSE;
+		rngStepR(buf, 32, 0);
+		rngPoolStat(stat);
+		if (stat->served != 32)
+			return FALSE;
+		printf("rngPool:          %u blocks, %u rejected, %u bytes served\n",
+			(unsigned)stat->blocks, (unsigned)stat->rejected,
+			(unsigned)stat->served);
+		rngPoolStop();
+		rngPoolStat(stat);
+		if (stat->active || stat->level)
+			return FALSE;
+		// останов при закрытии генератора
+		if (rngPoolStart() != ERR_OK)
+			return FALSE;
+	}
 	if (rngCreate(0, 0) != ERR_OK)
 		return FALSE;
 	rngClose();
@@ -83,6 +112,12 @@ bool_t rngTest()
 	rngClose();
 	if (rngIsValid())
 		return FALSE;
+	{
+		rng_pool_stat stat[1];
+		rngPoolStat(stat);
+		if (stat->active)
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
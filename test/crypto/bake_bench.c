@@ -0,0 +1,232 @@
+/*
+*******************************************************************************
+\file bake_bench.c
+\brief Benchmarks for STB 34.101.66 (bake)
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/err.h>
+#include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/str.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/bake.h>
+
+/*
+*******************************************************************************
+Ключи и сертификаты сторон (таблица Б.1 СТБ 34.101.66)
+*******************************************************************************
+*/
+
+static const char _da[] =
+	"1F66B5B84B7339674533F0329C74F218"
+	"34281FED0732429E0C79235FC273E269";
+
+static const char _db[] =
+	"4C0E74B2CD5811AD21F23DE7E0FA742C"
+	"3ED6EC483C461CE15C33A77AA308B7D2";
+
+static const char _certa[] =
+	"416C696365"
+	"BD1A5650179D79E03FCEE49D4C2BD5DD"
+	"F54CE46D0CF11E4FF87BF7A890857FD0"
+	"7AC6A60361E8C8173491686D461B2826"
+	"190C2EDA5909054A9AB84D2AB9D99A90";
+
+static const char _certb[] =
+	"426F62"
+	"CCEEF1A313A406649D15DA0A851D486A"
+	"695B641B20611776252FFDCE39C71060"
+	"7C9EA1F33C23D20DFCB8485A88BE6523"
+	"A28ECC3215B47FA289D6C9BE1CE837C0";
+
+static err_t bakeBenchCertVal(octet* pubkey, const bign_params* params,
+	const octet* data, size_t len)
+{
+	if (!memIsValid(params, sizeof(bign_params)) ||
+		(params->l != 128 && params->l != 192 && params->l != 256) ||
+		!memIsNullOrValid(pubkey, params->l / 2))
+		return ERR_BAD_INPUT;
+	if (!memIsValid(data, len) ||
+		len < params->l / 2)
+		return ERR_BAD_CERT;
+	if (pubkey)
+		memCopy(pubkey, data + (len - params->l / 2), params->l / 2);
+	return ERR_OK;
+}
+
+/*
+*******************************************************************************
+Нагрузочный тест многосеансового сервера
+
+Сервер обслуживает одновременно COUNT клиентов. Сообщения передаются
+через буферы памяти (внутрипроцессный канал): сервер открывает все сеансы,
+клиенты обрабатывают первые сообщения сервера, сервер обрабатывает ответы
+клиентов одним пакетом и т.д. В замер входят действия обеих сторон.
+*******************************************************************************
+*/
+
+#define COUNT 8
+
+bool_t bakeBench()
+{
+	const size_t reps = 4;
+	bign_params params[1];
+	octet combo_state[256];
+	bake_settings settings[1];
+	octet da[32];
+	octet db[32];
+	octet certdataa[5 /* Alice */ + 64 + 3 /* align */];
+	octet certdatab[3 /* Bob */ + 64 + 5 /* align */];
+	bake_cert certa[1];
+	bake_cert certb[1];
+	const char pwd[] = "8086";
+	octet srv[COUNT * 3072];
+	octet cli[COUNT][3072];
+	octet resp[8192];
+	octet msga[COUNT][80];
+	octet msgb[COUNT][72];
+	octet keya[32];
+	octet keyb[32];
+	bake_srv_event ev[COUNT];
+	size_t i, j;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(srv) < bakeSrv_keep(128, COUNT) ||
+		sizeof(cli[0]) < utilMax(2, bakeBMQV_keep(128), bakeBPACE_keep(128)) ||
+		sizeof(resp) < bakeResp_keep(128, COUNT))
+		return FALSE;
+	// загрузить долговременные параметры
+	if (bignParamsStd(params, "1.2.112.0.2.0.34.101.45.3.1") != ERR_OK)
+		return FALSE;
+	// задать настройки
+	prngCOMBOStart(combo_state, utilNonce32());
+	memSetZero(settings, sizeof(bake_settings));
+	settings->kca = settings->kcb = TRUE;
+	settings->rng = prngCOMBOStepR;
+	settings->rng_state = combo_state;
+	// загрузить ключи и сертификаты
+	hexTo(da, _da);
+	hexTo(db, _db);
+	hexTo(certdataa, _certa);
+	hexTo(certdatab, _certb);
+	certa->data = certdataa;
+	certa->len = strLen(_certa) / 2;
+	certb->data = certdatab;
+	certb->len = strLen(_certb) / 2;
+	certa->val = certb->val = bakeBenchCertVal;
+	// запустить сервер
+	if (bakeSrvStart(srv, 128, COUNT) != ERR_OK)
+		return FALSE;
+	// нагрузка BMQV
+	for (i = 0, ticks = tmTicks(); i < reps; ++i)
+	{
+		// M1: сервер -> клиенты
+		for (j = 0; j < COUNT; ++j)
+			if (bakeSrvOpenBMQV(&ev[j].sid, msgb[j], srv, params, settings,
+					db, certb) != ERR_OK ||
+				bakeBMQVStart(cli[j], params, settings, da, certa) != ERR_OK ||
+				bakeBMQVStep3(msga[j], msgb[j], certb, cli[j]) != ERR_OK)
+				return FALSE;
+		// M2: клиенты -> сервер
+		for (j = 0; j < COUNT; ++j)
+		{
+			ev[j].in = msga[j], ev[j].in_len = 64 + 8;
+			ev[j].certa = certa;
+			ev[j].out = msgb[j];
+		}
+		bakeSrvStepBatch(ev, COUNT, srv);
+		// M3: сервер -> клиенты
+		for (j = 0; j < COUNT; ++j)
+		{
+			if (ev[j].code != ERR_OK ||
+				bakeBMQVStep5(msgb[j], cli[j]) != ERR_OK ||
+				bakeBMQVStepG(keya, cli[j]) != ERR_OK ||
+				bakeSrvStepG(keyb, ev[j].sid, srv) != ERR_OK ||
+				!memEq(keya, keyb, 32))
+				return FALSE;
+			bakeSrvClose(ev[j].sid, srv);
+		}
+	}
+	ticks = tmTicks() - ticks;
+	printf("bakeBench::bmqv[%u]:  %3u handshakes/sec\n", (unsigned)COUNT,
+		(unsigned)tmSpeed(reps * COUNT, ticks));
+	// нагрузка BPACE
+	for (i = 0, ticks = tmTicks(); i < reps; ++i)
+	{
+		// M1: сервер -> клиенты
+		for (j = 0; j < COUNT; ++j)
+			if (bakeSrvOpenBPACE(&ev[j].sid, msgb[j], srv, params, settings,
+					(const octet*)pwd, strLen(pwd)) != ERR_OK ||
+				bakeBPACEStart(cli[j], params, settings, (const octet*)pwd,
+					strLen(pwd)) != ERR_OK ||
+				bakeBPACEStep3(msga[j], msgb[j], cli[j]) != ERR_OK)
+				return FALSE;
+		// M2: клиенты -> сервер
+		for (j = 0; j < COUNT; ++j)
+		{
+			ev[j].in = msga[j], ev[j].in_len = 80;
+			ev[j].certa = 0;
+			ev[j].out = msgb[j];
+		}
+		bakeSrvStepBatch(ev, COUNT, srv);
+		// M3: сервер -> клиенты, M4: клиенты -> сервер
+		for (j = 0; j < COUNT; ++j)
+		{
+			if (ev[j].code != ERR_OK ||
+				bakeBPACEStep5(msga[j], msgb[j], cli[j]) != ERR_OK)
+				return FALSE;
+			ev[j].in_len = 8;
+		}
+		bakeSrvStepBatch(ev, COUNT, srv);
+		for (j = 0; j < COUNT; ++j)
+		{
+			if (ev[j].code != ERR_OK ||
+				bakeBPACEStepG(keya, cli[j]) != ERR_OK ||
+				bakeSrvStepG(keyb, ev[j].sid, srv) != ERR_OK ||
+				!memEq(keya, keyb, 32))
+				return FALSE;
+			bakeSrvClose(ev[j].sid, srv);
+		}
+	}
+	ticks = tmTicks() - ticks;
+	printf("bakeBench::bpace[%u]: %3u handshakes/sec\n", (unsigned)COUNT,
+		(unsigned)tmSpeed(reps * COUNT, ticks));
+	// BMQV: сторона B без контекста и с контекстом долговременного ключа
+	for (i = 0; i < 2; ++i)
+	{
+		if (i == 1 && bakeRespStart(resp, params, db, certb, COUNT) != ERR_OK)
+			return FALSE;
+		for (j = 0, ticks = tmTicks(); j < reps * COUNT; ++j)
+		{
+			if ((i == 0 ?
+					bakeBMQVStart(cli[0], params, settings, db, certb) :
+					bakeBMQVStart2(cli[0], settings, resp)) != ERR_OK ||
+				bakeBMQVStart(cli[1], params, settings, da, certa) != ERR_OK ||
+				bakeBMQVStep2(msgb[0], cli[0]) != ERR_OK ||
+				bakeBMQVStep3(msga[0], msgb[0], certb, cli[1]) != ERR_OK ||
+				bakeBMQVStep4(msgb[0], msga[0], certa, cli[0]) != ERR_OK ||
+				bakeBMQVStep5(msgb[0], cli[1]) != ERR_OK ||
+				bakeBMQVStepG(keya, cli[1]) != ERR_OK ||
+				bakeBMQVStepG(keyb, cli[0]) != ERR_OK ||
+				!memEq(keya, keyb, 32))
+				return FALSE;
+		}
+		ticks = tmTicks() - ticks;
+		printf("bakeBench::bmqv%s: %3u handshakes/sec\n", 
+			i == 0 ? "      " : "[resp]",
+			(unsigned)tmSpeed(reps * COUNT, ticks));
+	}
+	bakeRespClose(resp);
+	// все нормально
+	return bakeSrvActive(srv) == 0;
+}
@@ -4,7 +4,7 @@
 \brief Tests for STB 34.101.66 (bake)
 \project bee2/test
 \created 2014.04.23
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -217,6 +217,12 @@ bool_t bakeTest()
 	octet keyb[32];
 	octet secret[32];
 	octet iv[64];
+	octet srv[8192];
+	octet sta[4096];
+	octet msga[256];
+	octet msgb[256];
+	octet resp[8192];
+	size_t sid, sid1, len;
 	// подготовить память
 	if (sizeof(echoa) < prngEcho_keep())
 		return FALSE;
@@ -317,6 +323,122 @@ bool_t bakeTest()
 			"DAC4D8F411F9C523D28BBAAB32A5270E"
 			"4DFA1F0F757EF8E0F30AF08FBDE1E7F4"))
 		return FALSE;
+	// многосеансовый сервер (по данным из тестов Б.2 и Б.4)
+	if (sizeof(srv) < bakeSrv_keep(128, 2) ||
+		sizeof(sta) < utilMax(2, bakeBMQV_keep(128), bakeBPACE_keep(128)) ||
+		bakeSrvStart(srv, 128, 2) != ERR_OK)
+		return FALSE;
+	hexTo(randa, _bmqv_randa);
+	hexTo(randb, _bmqv_randb);
+	prngEchoStart(echoa, randa, strLen(_bmqv_randa) / 2);
+	prngEchoStart(echob, randb, strLen(_bmqv_randb) / 2);
+	if (bakeSrvOpenBMQV(&sid, msgb, srv, params, settingsb, db, 
+			certb) != ERR_OK ||
+		bakeSrvActive(srv) != 1 ||
+		bakeBMQVStart(sta, params, settingsa, da, certa) != ERR_OK ||
+		bakeBMQVStep3(msga, msgb, certb, sta) != ERR_OK ||
+		bakeSrvStep(msgb, &len, sid, msga, 64 + 8, certa, srv) != ERR_OK ||
+		len != 8 || !bakeSrvIsDone(sid, srv) ||
+		bakeBMQVStep5(msgb, sta) != ERR_OK ||
+		bakeBMQVStepG(keya, sta) != ERR_OK ||
+		bakeSrvStepG(keyb, sid, srv) != ERR_OK ||
+		!memEq(keya, keyb, 32) ||
+		!hexEq(keya,
+			"C6F86D0E468D5EF1A9955B2EE0CF0581"
+			"050C81D1B47727092408E863C7EEB48C"))
+		return FALSE;
+	hexTo(randa, _bpace_randa);
+	hexTo(randb, _bpace_randb);
+	prngEchoStart(echoa, randa, strLen(_bpace_randa) / 2);
+	prngEchoStart(echob, randb, strLen(_bpace_randb) / 2);
+	if (bakeSrvOpenBPACE(&sid1, msgb, srv, params, settingsb, 
+			(const octet*)pwd, strLen(pwd)) != ERR_OK ||
+		sid1 == sid || bakeSrvActive(srv) != 2 ||
+		bakeSrvOpenBPACE(&len, msgb, srv, params, settingsb, 
+			(const octet*)pwd, strLen(pwd)) != ERR_OUTOFMEMORY)
+		return FALSE;
+	bakeSrvClose(sid, srv);
+	bakeSrvClose(sid, srv);
+	if (bakeSrvActive(srv) != 1 ||
+		bakeBPACEStart(sta, params, settingsa, (const octet*)pwd, 
+			strLen(pwd)) != ERR_OK ||
+		bakeBPACEStep3(msga, msgb, sta) != ERR_OK ||
+		bakeSrvStep(msgb, &len, sid1, msga, 80, 0, srv) != ERR_OK ||
+		len != 64 + 8 || bakeSrvIsDone(sid1, srv) ||
+		bakeSrvStepG(keyb, sid1, srv) != ERR_BAD_LOGIC ||
+		bakeBPACEStep5(msga, msgb, sta) != ERR_OK ||
+		bakeSrvStep(msgb, &len, sid1, msga, 8, 0, srv) != ERR_OK ||
+		len != 0 || !bakeSrvIsDone(sid1, srv) ||
+		bakeBPACEStepG(keya, sta) != ERR_OK ||
+		bakeSrvStepG(keyb, sid1, srv) != ERR_OK ||
+		!memEq(keya, keyb, 32) ||
+		!hexEq(keya,
+			"DAC4D8F411F9C523D28BBAAB32A5270E"
+			"4DFA1F0F757EF8E0F30AF08FBDE1E7F4"))
+		return FALSE;
+	bakeSrvClose(sid1, srv);
+	bakeSrvClose(sid1, srv);
+	if (bakeSrvActive(srv) != 0)
+		return FALSE;
+	// контекст долговременного ключа: некорректный сертификат
+	if (sizeof(resp) < bakeResp_keep(128, 2))
+		return FALSE;
+	certdatab[certb->len - 1] ^= 1;
+	if (bakeRespStart(resp, params, db, certb, 2) == ERR_OK)
+		return FALSE;
+	certdatab[certb->len - 1] ^= 1;
+	bakeRespClose(resp);
+	if (bakeBMQVStart2(srv, settingsb, resp) == ERR_OK)
+		return FALSE;
+	// контекст долговременного ключа (по данным из тестов Б.2 и Б.3)
+	if (sizeof(resp) < bakeResp_keep(128, 2) ||
+		sizeof(srv) < bakeBSTS_keep(128) ||
+		sizeof(sta) < bakeBSTS_keep(128) ||
+		bakeRespStart(resp, params, db, certb, 2) != ERR_OK)
+		return FALSE;
+	hexTo(randa, _bmqv_randa);
+	hexTo(randb, _bmqv_randb);
+	for (len = 0; len < 2; ++len)
+	{
+		prngEchoStart(echoa, randa, strLen(_bmqv_randa) / 2);
+		prngEchoStart(echob, randb, strLen(_bmqv_randb) / 2);
+		if (bakeBMQVStart2(srv, settingsb, resp) != ERR_OK ||
+			bakeBMQVStart(sta, params, settingsa, da, certa) != ERR_OK ||
+			bakeBMQVStep2(msgb, srv) != ERR_OK ||
+			bakeBMQVStep3(msga, msgb, certb, sta) != ERR_OK ||
+			bakeBMQVStep4(msgb, msga, certa, srv) != ERR_OK ||
+			bakeBMQVStep5(msgb, sta) != ERR_OK ||
+			bakeBMQVStepG(keya, sta) != ERR_OK ||
+			bakeBMQVStepG(keyb, srv) != ERR_OK ||
+			!memEq(keya, keyb, 32) ||
+			!hexEq(keya,
+				"C6F86D0E468D5EF1A9955B2EE0CF0581"
+				"050C81D1B47727092408E863C7EEB48C"))
+			return FALSE;
+	}
+	hexTo(randa, _bsts_randa);
+	hexTo(randb, _bsts_randb);
+	for (len = 0; len < 2; ++len)
+	{
+		prngEchoStart(echoa, randa, strLen(_bsts_randa) / 2);
+		prngEchoStart(echob, randb, strLen(_bsts_randb) / 2);
+		if (bakeBSTSStart2(srv, settingsb, resp) != ERR_OK ||
+			bakeBSTSStart(sta, params, settingsa, da, certa) != ERR_OK ||
+			bakeBSTSStep2(msgb, srv) != ERR_OK ||
+			bakeBSTSStep3(msga, msgb, sta) != ERR_OK ||
+			bakeBSTSStep4(msgb, msga, 3 * 32 + certa->len + 8, 
+				bakeTestCertVal, srv) != ERR_OK ||
+			bakeBSTSStep5(msgb, 32 + certb->len + 8, bakeTestCertVal, 
+				sta) != ERR_OK ||
+			bakeBSTSStepG(keya, sta) != ERR_OK ||
+			bakeBSTSStepG(keyb, srv) != ERR_OK ||
+			!memEq(keya, keyb, 32) ||
+			!hexEq(keya,
+				"78EF2C56BD6DA2116BB5BEE80CEE5C05"
+				"394E7609183CF7F76DF0C2DCFB25C4AD"))
+			return FALSE;
+	}
+	bakeRespClose(resp);
 	// тест bakeKDF (по данным из теста Б.4)
 	hexTo(secret, 
 		"723356E335ED70620FFB1842752092C3"
@@ -335,6 +457,9 @@ bool_t bakeTest()
 			"54AC058284D679CF4C47D3D72651F3E4"
 			"EF0D61D1D0ED5BAF8FF30B8924E599D8"))
 		return FALSE;
+	if (bakeKDF2(msga, secret, 32, iv, 64, 0, 2) != ERR_OK ||
+		!memEq(msga, keya, 32) || !memEq(msga + 32, keyb, 32))
+		return FALSE;
 	// тест bakeSWU (по данным из теста Б.4)
 	hexTo(secret, 
 		"AD1362A8F9A3D42FBE1B8E6F1C88AAD5"
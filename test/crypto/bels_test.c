@@ -4,12 +4,13 @@
 \brief Tests for STB 34.101.60 (bels)
 \project bee2/test
 \created 2013.06.27
-\version 2023.03.29
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
@@ -19,6 +20,88 @@
 #include <bee2/crypto/belt.h>
 #include <bee2/crypto/brng.h>
 
+/*
+*******************************************************************************
+Контекст
+
+Разделение и восстановление на контексте сравнивается с belsShare(), 
+belsRecover(). Восстановление выполняется также на контексте 
+подмножества пользователей.
+*******************************************************************************
+*/
+
+static bool_t belsTestCtx()
+{
+	size_t len, i, j;
+	octet m0[32];
+	octet mi[32 * 5];
+	octet mj[32 * 3];
+	octet s[32 * 3];
+	octet s1[32 * 3];
+	octet si[32 * 5 * 3];
+	octet si1[32 * 5];
+	octet sj[32 * 3];
+	octet ctx[2048];
+	octet combo_state[512];
+	octet combo_state1[512];
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(ctx) < belsCtx_keep(5, 32))
+		return FALSE;
+	prngCOMBOStart(combo_state, utilNonce32());
+	for (len = 16; len <= 32; len += 8)
+	{
+		// загрузить ключи
+		belsStdM(m0, len, 0);
+		for (i = 0; i < 5; ++i)
+			belsStdM(mi + i * len, len, i + 1);
+		// запустить контекст
+		if (belsCtxStart(ctx, 5, len, m0, mi) != ERR_OK)
+			return FALSE;
+		// разделить секреты
+		prngCOMBOStepR(s, 3 * len, combo_state);
+		memCopy(combo_state1, combo_state, prngCOMBO_keep());
+		if (belsCtxShare(si, 3, 3, s, prngCOMBOStepR, combo_state, 
+			ctx) != ERR_OK)
+			return FALSE;
+		for (j = 0; j < 3; ++j)
+			if (belsShare(si1, 5, 3, len, s + j * len, m0, mi, 
+					prngCOMBOStepR, combo_state1) != ERR_OK ||
+				!memEq(si1, si + j * 5 * len, 5 * len))
+				return FALSE;
+		// восстановить секреты по всем частичным секретам
+		if (belsCtxRecover(s1, 3, si, ctx) != ERR_OK ||
+			!memEq(s1, s, 3 * len))
+			return FALSE;
+		// восстановить секреты по частичным секретам пользователей 2, 4, 5
+		memCopy(mj, mi + len, len);
+		memCopy(mj + len, mi + 3 * len, 2 * len);
+		if (belsCtxStart(ctx, 3, len, m0, mj) != ERR_OK)
+			return FALSE;
+		for (j = 0; j < 3; ++j)
+		{
+			memCopy(sj, si + j * 5 * len + len, len);
+			memCopy(sj + len, si + j * 5 * len + 3 * len, 2 * len);
+			if (belsCtxRecover(s1, 1, sj, ctx) != ERR_OK ||
+				!memEq(s1, s + j * len, len) ||
+				belsRecover(s1, 3, len, sj, m0, mj) != ERR_OK ||
+				!memEq(s1, s + j * len, len))
+				return FALSE;
+		}
+		// совпадающие ключи
+		memCopy(mj + len, mj, len);
+		if (belsCtxStart(ctx, 3, len, m0, mj) != ERR_BAD_PUBKEY)
+			return FALSE;
+		// ключ пользователя совпадает с общим ключом
+		memCopy(mj + len, mi + 3 * len, len);
+		memCopy(mj + 2 * len, m0, len);
+		if (belsCtxStart(ctx, 3, len, m0, mj) != ERR_BAD_PUBKEY ||
+			belsCtxStart(ctx, 1, len, m0, m0) != ERR_BAD_PUBKEY)
+			return FALSE;
+	}
+	return TRUE;
+}
+
 /*
 *******************************************************************************
 Самотестирование
@@ -297,6 +380,9 @@ bool_t belsTest()
 			!memEq(s, beltH(), len))
 			return FALSE;
 	}
+	// контекст
+	if (!belsTestCtx())
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -4,7 +4,7 @@
 \brief Benchmarks for STB 34.101.31 (belt)
 \project bee2/test
 \created 2014.11.18
-\version 2023.03.30
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -28,16 +28,19 @@ bool_t beltBench()
 {
 	const size_t reps = 5000;
 	octet belt_state[512];
+	octet key_state[64];
 	octet combo_state[256];
 	octet buf[1024];
+	u16 str[16];
 	octet key[32];
 	octet iv[16];
 	octet hash[32];
-	size_t i;
+	size_t i, n;
 	tm_ticks_t ticks;
 	// подготовить стек
 	if (sizeof(combo_state) < prngCOMBO_keep() ||
-		sizeof(belt_state) < utilMax(10,
+		sizeof(key_state) < beltKey_keep() ||
+		sizeof(belt_state) < utilMax(11,
 			beltECB_keep(),
 			beltCBC_keep(),
 			beltCFB_keep(),
@@ -47,7 +50,8 @@ bool_t beltBench()
 			beltCHE_keep(),
 			beltHash_keep(),
 			beltBDE_keep(),
-			beltSDE_keep()))
+			beltSDE_keep(),
+			beltFMT_keep(10, 16)))
 		return FALSE;
 	// псевдослучайная генерация объектов
 	prngCOMBOStart(combo_state, utilNonce32());
@@ -63,6 +67,17 @@ bool_t beltBench()
 	printf("beltBench::belt-ecb:  %3u cpb [%5u kBytes/sec]\n",
 		(unsigned)(ticks / 2048 / reps),
 		(unsigned)tmSpeed(2 * reps, ticks));
+	// cкорость belt-ecb в зависимости от числа блоков
+	for (n = 16; n <= 1024; n *= 8)
+	{
+		beltECBStart(belt_state, key, 32);
+		for (i = 0, ticks = tmTicks(); i < reps * 1024 / n; ++i)
+			beltECBStepE(buf, n, belt_state);
+		ticks = tmTicks() - ticks;
+		printf("beltBench::belt-ecb[%4u]: %3u cpb [%5u kBytes/sec]\n",
+			(unsigned)n, (unsigned)(ticks / 1024 / reps),
+			(unsigned)tmSpeed(reps, ticks));
+	}
 	// cкорость belt-cbc
 	beltCBCStart(belt_state, key, 32, iv);
 	for (i = 0, ticks = tmTicks(); i < reps; ++i)
@@ -99,6 +114,22 @@ bool_t beltBench()
 	printf("beltBench::belt-mac:  %3u cpb [%5u kBytes/sec]\n",
 		(unsigned)(ticks / 1024 / reps),
 		(unsigned)tmSpeed(reps, ticks));
+	// cкорость belt-mac на коротких сообщениях (с разделяемым ключом и без)
+	beltKeyStart(key_state, key, 32);
+	for (i = 0, ticks = tmTicks(); i < 8 * reps; ++i)
+		beltMACStart(belt_state, key, 32),
+		beltMACStepA(buf, 32, belt_state),
+		beltMACStepG(hash, belt_state);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-mac[32]:       %7u messages/sec\n",
+		(unsigned)tmSpeed(8 * reps, ticks));
+	for (i = 0, ticks = tmTicks(); i < 8 * reps; ++i)
+		beltMACStart2(belt_state, key_state),
+		beltMACStepA(buf, 32, belt_state),
+		beltMACStepG(hash, belt_state);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-mac[32,key]:   %7u messages/sec\n",
+		(unsigned)tmSpeed(8 * reps, ticks));
 	// cкорость belt-dwp
 	beltDWPStart(belt_state, key, 32, iv);
 	for (i = 0, ticks = tmTicks(); i < reps; ++i)
@@ -146,6 +177,15 @@ bool_t beltBench()
 	printf("beltBench::belt-sde:  %3u cpb [%5u kBytes/sec]\n",
 		(unsigned)(ticks / 2048 / reps),
 		(unsigned)tmSpeed(2 * reps, ticks));
+	// cкорость belt-fmt (номера карт: 16 десятичных цифр)
+	for (i = 0; i < COUNT_OF(str); ++i)
+		str[i] = buf[i % sizeof(buf)] % 10;
+	beltFMTStart(belt_state, 10, 16, key, 32);
+	for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		beltFMTStepE(str, iv, belt_state);
+	ticks = tmTicks() - ticks;
+	printf("beltBench::belt-fmt:  %5u strings/sec\n",
+		(unsigned)tmSpeed(reps, ticks));
 	// все нормально
 	return TRUE;
 }
@@ -4,7 +4,7 @@
 \brief Tests for STB 34.101.31 (belt)
 \project bee2/test
 \created 2012.06.20
-\version 2024.01.25
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -109,6 +109,163 @@ static bool_t beltTestZerosum()
 	return sum[0] == 0 && sum[1] == 0 && sum[2] == 0 && sum[3] == 0;
 }
 
+/*
+*******************************************************************************
+Разделяемый ключ
+
+Проверяется, что инициализация режимов по разделяемому ключу дает те же 
+результаты, что и обычная инициализация. Разделяемый ключ строится 
+по 24-октетному ключу, чтобы проверить расширение.
+*******************************************************************************
+*/
+
+static bool_t beltTestKey()
+{
+	octet key_state[64];
+	octet state[1024];
+	octet state1[1024];
+	octet buf[48];
+	octet buf1[48];
+	octet mac[8];
+	octet mac1[8];
+	octet level[12];
+	// подготовить память
+	if (sizeof(key_state) < beltKey_keep() ||
+		sizeof(state) < utilMax(5,
+			beltCTR_keep(),
+			beltMAC_keep(),
+			beltDWP_keep(),
+			beltCHE_keep(),
+			beltKRP_keep()))
+		return FALSE;
+	// разделяемый ключ
+	beltKeyStart(key_state, beltH() + 128, 24);
+	// CTR
+	beltCTRStart(state, beltH() + 128, 24, beltH() + 192);
+	beltCTRStart2(state1, key_state, beltH() + 192);
+	memCopy(buf, beltH(), 48), memCopy(buf1, beltH(), 48);
+	beltCTRStepE(buf, 48, state);
+	beltCTRStepE(buf1, 48, state1);
+	if (!memEq(buf, buf1, 48))
+		return FALSE;
+	// MAC
+	beltMACStart(state, beltH() + 128, 24);
+	beltMACStart2(state1, key_state);
+	beltMACStepA(beltH(), 37, state);
+	beltMACStepA(beltH(), 37, state1);
+	beltMACStepG(mac, state);
+	beltMACStepG(mac1, state1);
+	if (!memEq(mac, mac1, 8))
+		return FALSE;
+	// DWP
+	beltDWPStart(state, beltH() + 128, 24, beltH() + 192);
+	beltDWPStart2(state1, key_state, beltH() + 192);
+	memCopy(buf, beltH(), 48), memCopy(buf1, beltH(), 48);
+	beltDWPStepI(beltH() + 64, 23, state);
+	beltDWPStepI(beltH() + 64, 23, state1);
+	beltDWPStepE(buf, 48, state), beltDWPStepA(buf, 48, state);
+	beltDWPStepE(buf1, 48, state1), beltDWPStepA(buf1, 48, state1);
+	beltDWPStepG(mac, state);
+	beltDWPStepG(mac1, state1);
+	if (!memEq(buf, buf1, 48) || !memEq(mac, mac1, 8))
+		return FALSE;
+	// CHE
+	beltCHEStart(state, beltH() + 128, 24, beltH() + 192);
+	beltCHEStart2(state1, key_state, beltH() + 192);
+	memCopy(buf, beltH(), 48), memCopy(buf1, beltH(), 48);
+	beltCHEStepI(beltH() + 64, 23, state);
+	beltCHEStepI(beltH() + 64, 23, state1);
+	beltCHEStepE(buf, 48, state), beltCHEStepA(buf, 48, state);
+	beltCHEStepE(buf1, 48, state1), beltCHEStepA(buf1, 48, state1);
+	beltCHEStepG(mac, state);
+	beltCHEStepG(mac1, state1);
+	if (!memEq(buf, buf1, 48) || !memEq(mac, mac1, 8))
+		return FALSE;
+	// KRP
+	memSetZero(level, 12);
+	level[0] = 1;
+	beltKRPStart(state, beltH() + 128, 24, level);
+	beltKRPStart2(state1, key_state, level);
+	beltKRPStepG(buf, 24, beltH() + 32, state);
+	beltKRPStepG(buf1, 24, beltH() + 32, state1);
+	if (!memEq(buf, buf1, 24))
+		return FALSE;
+	// все нормально
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Групповая обработка блоков
+
+Длинные сообщения зашифровываются в режимах ECB, CTR и BDE группами
+по несколько блоков. Результаты сравниваются с результатами поблочной
+обработки тех же данных.
+*******************************************************************************
+*/
+
+static bool_t beltTestLong()
+{
+	octet state[1024];
+	octet state1[1024];
+	octet buf[40 * 16 + 15];
+	octet buf1[40 * 16 + 15];
+	size_t n, i;
+	// подготовить память
+	if (sizeof(state) < utilMax(3,
+			beltECB_keep(),
+			beltCTR_keep(),
+			beltBDE_keep()))
+		return FALSE;
+	// цикл по длинам
+	for (n = 1; n <= 40; ++n)
+	{
+		// ECB (с кражей блока)
+		for (i = 0; i < sizeof(buf); ++i)
+			buf[i] = beltH()[i % 256] ^ (octet)(i / 256);
+		memCopy(buf1, buf, sizeof(buf));
+		beltECBStart(state, beltH() + 128, 32);
+		beltECBStepE(buf, 16 * n + 7, state);
+		for (i = 0; i + 1 < n; ++i)
+			beltECBStepE(buf1 + 16 * i, 16, state);
+		beltECBStepE(buf1 + 16 * i, 16 + 7, state);
+		if (!memEq(buf, buf1, sizeof(buf)))
+			return FALSE;
+		beltECBStepD(buf, 16 * n + 7, state);
+		for (i = 0; i + 1 < n; ++i)
+			beltECBStepD(buf1 + 16 * i, 16, state);
+		beltECBStepD(buf1 + 16 * i, 16 + 7, state);
+		if (!memEq(buf, buf1, sizeof(buf)))
+			return FALSE;
+		// CTR
+		beltCTRStart(state, beltH() + 128, 32, beltH() + 192);
+		beltCTRStart(state1, beltH() + 128, 32, beltH() + 192);
+		beltCTRStepE(buf, 16 * n + 5, state);
+		for (i = 0; i < n; ++i)
+			beltCTRStepE(buf1 + 16 * i, 16, state1);
+		beltCTRStepE(buf1 + 16 * i, 5, state1);
+		if (!memEq(buf, buf1, sizeof(buf)))
+			return FALSE;
+		// BDE
+		beltBDEStart(state, beltH() + 128, 32, beltH() + 192);
+		beltBDEStart(state1, beltH() + 128, 32, beltH() + 192);
+		beltBDEStepE(buf, 16 * n, state);
+		for (i = 0; i < n; ++i)
+			beltBDEStepE(buf1 + 16 * i, 16, state1);
+		if (!memEq(buf, buf1, sizeof(buf)))
+			return FALSE;
+		beltBDEStart(state, beltH() + 128, 32, beltH() + 192);
+		beltBDEStart(state1, beltH() + 128, 32, beltH() + 192);
+		beltBDEStepD(buf, 16 * n, state);
+		for (i = 0; i < n; ++i)
+			beltBDEStepD(buf1 + 16 * i, 16, state1);
+		if (!memEq(buf, buf1, sizeof(buf)))
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
+
 /*
 *******************************************************************************
 Самотестирование
@@ -117,6 +274,8 @@ static bool_t beltTestZerosum()
 	и из приложения Б к СТБ 34.101.47.
 -#	Номера тестов соответствуют номерам таблиц приложений.
 -#	Дополнительно выполняется тест Zerosum.
+-#	Дополнительно проверяется инициализация по разделяемому ключу.
+-#	Дополнительно проверяется групповая обработка блоков.
 *******************************************************************************
 */
 
@@ -762,6 +921,19 @@ bool_t beltTest()
 	beltKRP(buf1, 32, beltH() + 128, 32, level, beltH() + 32);
 	if (!memEq(buf, buf1, 32))
 		return FALSE;
+	// belt-keyrep: тиражирование нескольких ключей
+	beltKRPStepGN(buf, 32, beltH() + 32, 3, state);
+	if (!memEq(buf, buf1, 32))
+		return FALSE;
+	memCopy(buf1 + 96, beltH() + 32, 16);
+	for (count = 1; count < 3; ++count)
+	{
+		size_t pos;
+		for (pos = 96; pos < 112 && ++buf1[pos] == 0; ++pos);
+		beltKRPStepG(buf1, 32, buf1 + 96, state);
+		if (!memEq(buf + 32 * count, buf1, 32))
+			return FALSE;
+	}
 	// belt-hmac: тест Б.1-1
 	beltHMACStart(state, beltH() + 128, 29);
 	beltHMACStepA(beltH() + 128 + 64, 32, state);
@@ -801,6 +973,11 @@ bool_t beltTest()
 	// zerosum
 	if (!beltTestZerosum())
 		return FALSE;
+	// разделяемый ключ
+	if (!beltTestKey())
+		return FALSE;
+	if (!beltTestLong())
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
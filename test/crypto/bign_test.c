@@ -136,8 +136,17 @@ bool_t bignTest()
 	char pwd[] = "B194BAC80A08F53B";
 	size_t iter = 10000;
 	octet key[32];
+	octet id_hashes[6 * 32];
+	octet hashes[6 * 32];
+	octet id_sigs[6 * 48];
+	octet id_pubkeys[6 * 64];
+	err_t codes[6];
+	octet ctx[8192];
+	octet tokens[6 * (32 + 16 + 32)];
+	size_t i;
 	// подготовить память
 	if (sizeof(brng_state) < brngCTRX_keep() ||
+		sizeof(ctx) < bignCtx_keep(256) ||
 		sizeof(zz_stack) < zzMulMod_deep(W_OF_O(32)))
 		return FALSE;
 	// проверить таблицы Б.1, Б.2, Б.3
@@ -393,6 +402,75 @@ bool_t bignTest()
 		id_pubkey, pubkey) == ERR_OK)
 		return FALSE;
 	id_pubkey[0] ^= 1;
+	// пакетная проверка
+	for (i = 0; i < 6; ++i)
+	{
+		memCopy(id_hashes + 32 * i, id_hash, 32);
+		memCopy(id_pubkeys + 64 * i, id_pubkey, 64);
+		if (beltHash(hashes + 32 * i, beltH(), 13 * i) != ERR_OK ||
+			bignIdSign2(id_sigs + 48 * i, params, der, count, 
+				id_hashes + 32 * i, hashes + 32 * i, id_privkey, 
+				&i, sizeof(i)) != ERR_OK)
+			return FALSE;
+	}
+	if (bignIdVerifyBatch(codes, params, der, count, 6, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_OK ||
+		codes[0] != ERR_OK || codes[5] != ERR_OK ||
+		bignIdVerifyBatch(0, params, der, count, 2, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_OK ||
+		bignIdVerifyBatch(0, params, der, count, 0, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_OK)
+		return FALSE;
+	id_sigs[48 * 3] ^= 1;
+	if (bignIdVerifyBatch(codes, params, der, count, 6, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_BAD_SIG ||
+		codes[2] != ERR_OK || codes[3] != ERR_BAD_SIG || codes[4] != ERR_OK ||
+		bignIdVerifyBatch(0, params, der, count, 6, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_BAD_SIG ||
+		bignIdVerifyBatch(0, params, der, count, 3, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_OK)
+		return FALSE;
+	id_sigs[48 * 3] ^= 1, id_pubkeys[64 * 4] ^= 1;
+	if (bignIdVerifyBatch(codes, params, der, count, 6, id_hashes, hashes,
+			id_sigs, id_pubkeys, pubkey) != ERR_BAD_PUBKEY ||
+		codes[3] != ERR_OK || codes[4] != ERR_BAD_PUBKEY)
+		return FALSE;
+	id_pubkeys[64 * 4] ^= 1;
+	// токены для нескольких получателей
+	if (bignPubkeyCalc(id_pubkey, params, id_privkey) != ERR_OK)
+		return FALSE;
+	for (i = 0; i < 6; ++i)
+		memCopy(id_pubkeys + 64 * i, i % 2 ? id_pubkey : pubkey, 64);
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64, beltH(), 8 * 32,
+		brng_state);
+	if (bignCtxStart(ctx, params) != ERR_OK ||
+		bignKeyWrapBatch(tokens, ctx, beltH(), 32, beltH() + 64, 6, 
+			id_pubkeys, brngCTRXStepR, brng_state) != ERR_OK ||
+		bignKeyWrapBatch(tokens, ctx, tokens, 32, 0, 6, 
+			id_pubkeys, brngCTRXStepR, brng_state) != ERR_BAD_INPUT)
+		return FALSE;
+	brngCTRXStart(beltH() + 128, beltH() + 128 + 64, beltH(), 8 * 32,
+		brng_state);
+	for (i = 0; i < 6; ++i)
+	{
+		if (bignKeyWrap(token, params, beltH(), 32, beltH() + 64,
+				id_pubkeys + 64 * i, brngCTRXStepR, brng_state) != ERR_OK ||
+			!memEq(token, tokens + 80 * i, 80) ||
+			bignKeyUnwrap(token, params, tokens + 80 * i, 80, beltH() + 64,
+				i % 2 ? id_privkey : privkey) != ERR_OK ||
+			!memEq(token, beltH(), 32))
+			return FALSE;
+	}
+	memSet(id_pubkeys + 64 * 2, 0xFF, 32);
+	if (bignKeyWrapBatch(tokens, ctx, beltH(), 32, 0, 6, id_pubkeys, 
+		brngCTRXStepR, brng_state) == ERR_OK)
+		return FALSE;
+	memCopy(params1, params, sizeof(bign_params));
+	memSet(params1->yG, 0xFF, 32);
+	if (bignCtxStart(ctx, params1) == ERR_OK ||
+		bignKeyWrapBatch(tokens, ctx, beltH(), 32, 0, 1, id_pubkeys, 
+			brngCTRXStepR, brng_state) == ERR_OK)
+		return FALSE;
 	// тест E.5
 	beltPBKDF2(key, (const octet*)pwd, strLen(pwd), iter, 
 		beltH() + 128 + 64, 8);
@@ -0,0 +1,103 @@
+/*
+*******************************************************************************
+\file botp_bench.c
+\brief Benchmarks for STB 34.101.47/botp
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/blob.h>
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/botp.h>
+
+/*
+*******************************************************************************
+Замер производительности: волна входов
+
+Сервер обслуживает USERS пользователей режима TOTP. Пользователи входят 
+в систему в случайном порядке, часы части пользователей отстают на один 
+шаг времени. Сервер проверяет пароль в окне из трех отметок (t - 1, t, 
+t + 1) двумя способами:
+-	высокоуровневой функцией botpTOTPVerify() для каждой отметки окна
+	(до первого совпадения);
+-	функцией botpTOTPStepVW() на заранее подготовленном состоянии 
+	пользователя.
+*******************************************************************************
+*/
+
+#define USERS 1024
+#define REPS 2048
+
+bool_t botpBench()
+{
+	const tm_time_t t = 1449165288 / 60;
+	octet combo_state[256];
+	octet keys[USERS][32];
+	size_t logins[REPS];
+	char otps[REPS][10];
+	blob_t states;
+	size_t keep, i, u;
+	tm_time_t ts;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep())
+		return FALSE;
+	keep = O_OF_W(W_OF_O(botpTOTP_keep()));
+	states = blobCreate(USERS * keep);
+	if (!states)
+		return FALSE;
+	// зарегистрировать пользователей
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(keys, sizeof(keys), combo_state);
+	for (u = 0; u < USERS; ++u)
+		botpTOTPStart((octet*)states + u * keep, 8, keys[u], 32);
+	// подготовить волну входов
+	for (i = 0; i < REPS; ++i)
+	{
+		prngCOMBOStepR(&u, sizeof(u), combo_state);
+		logins[i] = u %= USERS;
+		botpTOTPRand(otps[i], 8, keys[u], 32, t - (tm_time_t)(u & 1));
+	}
+	// проверка без подготовленных состояний
+	for (i = 0, ticks = tmTicks(); i < REPS; ++i)
+	{
+		u = logins[i];
+		if (botpTOTPVerify(otps[i], keys[u], 32, t) != ERR_OK &&
+			botpTOTPVerify(otps[i], keys[u], 32, t - 1) != ERR_OK &&
+			botpTOTPVerify(otps[i], keys[u], 32, t + 1) != ERR_OK)
+		{
+			blobClose(states);
+			return FALSE;
+		}
+	}
+	ticks = tmTicks() - ticks;
+	printf("botpBench::totp[%u users]: verify %6u logins/sec\n", 
+		(unsigned)USERS, (unsigned)tmSpeed(REPS, ticks));
+	// проверка на подготовленных состояниях
+	for (i = 0, ticks = tmTicks(); i < REPS; ++i)
+	{
+		u = logins[i];
+		if (!botpTOTPStepVW(&ts, otps[i], t, 1, 1, 
+				(octet*)states + u * keep) || 
+			ts != t - (tm_time_t)(u & 1))
+		{
+			blobClose(states);
+			return FALSE;
+		}
+	}
+	ticks = tmTicks() - ticks;
+	printf("botpBench::totp[%u users]: stepVW %6u logins/sec\n", 
+		(unsigned)USERS, (unsigned)tmSpeed(REPS, ticks));
+	// завершить
+	blobClose(states);
+	return TRUE;
+}
@@ -4,7 +4,7 @@
 \brief Tests for STB 34.101.47/botp
 \project bee2/test
 \created 2015.11.06
-\version 2023.03.29
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -34,7 +34,7 @@ bool_t botpTest()
 	octet p[32];
 	char p_str[72];
 	char s_str[136];
-	tm_time_t t;
+	tm_time_t t, ts;
 	octet state[2048];
 	// подготовить память
 	if (sizeof(state) < utilMax(3,
@@ -66,6 +66,16 @@ bool_t botpTest()
 	if (!strEq(otp3, "26078636"))
 		return FALSE;
 	botpHOTPStepG(ctr, state);
+	// HOTP.window
+	botpHOTPStepS(state, beltH() + 192);
+	if (botpHOTPStepVW(otp3, 2, state) ||
+		!botpHOTPStepVW(otp3, 3, state))
+		return FALSE;
+	botpHOTPStepG(p, state);
+	if (!memEq(p, ctr, 8) || 
+		botpHOTPStepVW(otp3, 8, state) ||
+		botpHOTPStepVW("2607863", 8, state))
+		return FALSE;
 	// TOTP.1
 	t = 1449165288;
 	ASSERT(t != TIME_ERR);
@@ -79,6 +89,15 @@ bool_t botpTest()
 	if (!strEq(otp, "97660664") ||
 		botpTOTPVerify(otp, beltH() + 128, 32, t / 60) != ERR_OK)
 		return FALSE;
+	// TOTP.window
+	if (!botpTOTPStepVW(&ts, otp, t / 60 + 1, 1, 0, state) || 
+		ts != t / 60 ||
+		!botpTOTPStepVW(&ts, otp, t / 60 - 2, 0, 2, state) || 
+		ts != t / 60 ||
+		botpTOTPStepVW(&ts, otp, t / 60 + 2, 1, 1, state) ||
+		ts != TIME_ERR ||
+		botpTOTPStepVW(0, "9766066", t / 60, 1, 1, state))
+		return FALSE;
 	// TOTP.2
 	t /= 60, ++t, t *= 60;
 	botpTOTPStart(state, 8, beltH() + 128, 32);
@@ -139,6 +158,13 @@ bool_t botpTest()
 	botpOCRAStepR(otp, (const octet*)q, strLen(q), ++t, state);
 	if (!strEq(otp, "21318915"))
 		return FALSE;
+	// HOTP.long_key
+	if (beltHMAC(p, ctr, 8, beltH(), 48) != ERR_OK)
+		return FALSE;
+	botpDT(otp1, 8, p, 32);
+	if (botpHOTPRand(otp, 8, beltH(), 48, ctr) != ERR_OK ||
+		!strEq(otp, otp1))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -0,0 +1,106 @@
+/*
+*******************************************************************************
+\file btok_bench.c
+\brief Benchmarks for STB 34.101.79 (btok)
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/apdu.h>
+#include <bee2/core/err.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/belt.h>
+#include <bee2/crypto/btok.h>
+
+/*
+*******************************************************************************
+Замер производительности SM
+
+Терминал и карта обмениваются защищенными командами и ответами: терминал
+защищает команду, карта снимает защиту, защищает ответ, терминал снимает
+защиту с ответа. Оценивается число таких циклов в секунду для нескольких
+длин данных. Дополнительно оценивается скорость установки защиты команд
+по фрагментам (btokSMCmdWrap2()).
+*******************************************************************************
+*/
+
+bool_t btokBench()
+{
+	const size_t reps = 5000;
+	const size_t lens[] = { 16, 128, 1024 };
+	octet state_t[512];
+	octet state_ct[512];
+	octet combo_state[256];
+	octet stack[4 * 1100];
+	apdu_cmd_t* cmd = (apdu_cmd_t*)stack;
+	apdu_cmd_t* cmd1 = (apdu_cmd_t*)(stack + 1100);
+	apdu_resp_t* resp = (apdu_resp_t*)(stack + 2 * 1100);
+	apdu_resp_t* resp1 = (apdu_resp_t*)(stack + 3 * 1100);
+	octet apdu[1100];
+	btok_sm_frag frags[2];
+	size_t count, size, i, j;
+	tm_ticks_t ticks;
+	// подготовить память
+	if (sizeof(state_t) < btokSM_keep() ||
+		sizeof(state_ct) < btokSM_keep() ||
+		sizeof(combo_state) < prngCOMBO_keep())
+		return FALSE;
+	// запустить SM
+	btokSMStart(state_t, beltH());
+	btokSMStart(state_ct, beltH());
+	// подготовить команду и ответ
+	prngCOMBOStart(combo_state, utilNonce32());
+	memSetZero(cmd, sizeof(apdu_cmd_t));
+	cmd->cla = 0x00, cmd->ins = 0xD6, cmd->p1 = 0x00, cmd->p2 = 0x00;
+	memSetZero(resp, sizeof(apdu_resp_t));
+	resp->sw1 = 0x90, resp->sw2 = 0x00;
+	prngCOMBOStepR(cmd->cdf, 1024, combo_state);
+	prngCOMBOStepR(resp->rdf, 1024, combo_state);
+	// цикл команда-ответ
+	for (j = 0; j < COUNT_OF(lens); ++j)
+	{
+		cmd->cdf_len = resp->rdf_len = lens[j];
+		cmd->rdf_len = 256;
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		{
+			btokSMCtrInc(state_t), btokSMCtrInc(state_ct);
+			if (btokSMCmdWrap(apdu, &count, cmd, state_t) != ERR_OK ||
+				btokSMCmdUnwrap(cmd1, &size, apdu, count, state_ct) != ERR_OK)
+				return FALSE;
+			btokSMCtrInc(state_t), btokSMCtrInc(state_ct);
+			if (btokSMRespWrap(apdu, &count, resp, state_ct) != ERR_OK ||
+				btokSMRespUnwrap(resp1, &size, apdu, count, state_t) != ERR_OK)
+				return FALSE;
+		}
+		ticks = tmTicks() - ticks;
+		printf("btokBench::sm[%4u]:  %6u exchanges/sec\n",
+			(unsigned)lens[j], (unsigned)tmSpeed(reps, ticks));
+	}
+	// установка защиты по фрагментам (нечетные значения счетчика)
+	btokSMCtrInc(state_t);
+	for (j = 0; j < COUNT_OF(lens); ++j)
+	{
+		frags[0].buf = cmd->cdf, frags[0].len = lens[j] / 2;
+		frags[1].buf = cmd->cdf + lens[j] / 2, frags[1].len = lens[j] / 2;
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+		{
+			btokSMCtrInc(state_t), btokSMCtrInc(state_t);
+			if (btokSMCmdWrap2(apdu, &count, (const octet*)cmd, 256, frags, 2,
+				state_t) != ERR_OK)
+				return FALSE;
+		}
+		ticks = tmTicks() - ticks;
+		printf("btokBench::wrap2[%4u]: %6u commands/sec\n",
+			(unsigned)lens[j], (unsigned)tmSpeed(reps, ticks));
+	}
+	// все нормально
+	return TRUE;
+}
@@ -4,7 +4,7 @@
 \brief Tests for STB 34.101.79 (btok)
 \project bee2/test
 \created 2022.07.07
-\version 2023.12.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -280,6 +280,9 @@ static bool_t btokSMTest()
 	apdu_resp_t* resp = (apdu_resp_t*)(stack + 2 * 1024);
 	apdu_resp_t* resp1 = (apdu_resp_t*)(stack + 3 * 1024);
 	octet apdu[1024];
+	octet apdu1[1024];
+	btok_sm_frag frags[3];
+	octet sw[2];
 	size_t count, count1;
 	size_t size, size1;
 	// подготовить состояния
@@ -399,6 +402,34 @@ static bool_t btokSMTest()
 				size1 != size || !memEq(resp, resp1, size))
 				return FALSE;
 		}
+	// защита по фрагментам
+	for (cmd->cdf_len = 0; cmd->cdf_len <= 257; cmd->cdf_len += 37)
+	{
+		cmd->rdf_len = 257 - cmd->cdf_len;
+		frags[0].buf = cmd->cdf, frags[0].len = cmd->cdf_len / 3;
+		frags[1].buf = cmd->cdf + frags[0].len, frags[1].len = 0;
+		frags[2].buf = frags[1].buf, frags[2].len = cmd->cdf_len - frags[0].len;
+		btokSMCtrInc(state_t);
+		memCopy(state_ct, state_t, btokSM_keep());
+		if (btokSMCmdWrap(apdu, &count, cmd, state_t) != ERR_OK ||
+			btokSMCmdWrap2(0, &count1, (const octet*)cmd, cmd->rdf_len,
+				frags, 3, state_ct) != ERR_OK ||
+			count1 != count ||
+			btokSMCmdWrap2(apdu1, &count1, (const octet*)cmd, cmd->rdf_len,
+				frags, 3, state_ct) != ERR_OK ||
+			count1 != count || !memEq(apdu, apdu1, count))
+			return FALSE;
+		resp->rdf_len = cmd->cdf_len;
+		frags[0].buf = resp->rdf;
+		frags[1].buf = frags[2].buf = resp->rdf + frags[0].len;
+		sw[0] = resp->sw1, sw[1] = resp->sw2;
+		btokSMCtrInc(state_t);
+		memCopy(state_ct, state_t, btokSM_keep());
+		if (btokSMRespWrap(apdu, &count, resp, state_t) != ERR_OK ||
+			btokSMRespWrap2(apdu1, &count1, frags, 3, sw, state_ct) != ERR_OK ||
+			count1 != count || !memEq(apdu, apdu1, count))
+			return FALSE;
+	}
 	// все хорошо
 	return TRUE;
 }
@@ -0,0 +1,105 @@
+/*
+*******************************************************************************
+\file dstu_bench.c
+\brief Benchmarks for DSTU 4145-2002 (Ukraine)
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/dstu.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости генерации ключей, выработки и проверки ЭЦП на кривых 
+над полями GF(2^163), GF(2^257) и GF(2^431) из таблицы Г.2 ДСТУ. Базовые 
+точки генерируются перед замером. Каждая операция выполняется 
+без контекста (описание кривой строится при каждом вызове) и с контекстом 
+кривой (dstuCtxStart()). Печатается число операций в секунду.
+*******************************************************************************
+*/
+
+bool_t dstuBench()
+{
+	const char* names[] = {
+		"1.2.804.2.1.1.1.1.3.1.1.1.2.0", 
+		"1.2.804.2.1.1.1.1.3.1.1.1.2.6", 
+		"1.2.804.2.1.1.1.1.3.1.1.1.2.9",
+	};
+	const size_t degs[] = { 163, 257, 431 };
+	dstu_params params[1];
+	octet privkey[DSTU_SIZE];
+	octet pubkey[2 * DSTU_SIZE];
+	octet hash[32];
+	octet sig[2 * DSTU_SIZE];
+	octet combo_state[256];
+	octet ctx[8192];
+	size_t i, j, k;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(ctx) < dstuCtx_keep(431))
+		return FALSE;
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(hash, sizeof(hash), combo_state);
+	// цикл по кривым
+	for (j = 0; j < COUNT_OF(names); ++j)
+	{
+		const size_t reps = 20;
+		const size_t ld = 16 * ((2 * degs[j] + 15) / 16);
+		tm_ticks_t ticks, ticks1, ticks2;
+		// загрузить параметры, создать контекст
+		if (dstuParamsStd(params, names[j]) != ERR_OK ||
+			dstuPointGen(params->P, params, prngCOMBOStepR, 
+				combo_state) != ERR_OK ||
+			dstuCtxStart(ctx, params) != ERR_OK)
+			return FALSE;
+		// без контекста (k == 0) и с контекстом (k == 1)
+		for (k = 0; k < 2; ++k)
+		{
+			// генерация ключей
+			for (i = 0, ticks = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					dstuKeypairGen(privkey, pubkey, params, prngCOMBOStepR,
+						combo_state) :
+					dstuKeypairGen2(privkey, pubkey, ctx, prngCOMBOStepR,
+						combo_state)) != ERR_OK)
+					return FALSE;
+			ticks = tmTicks() - ticks;
+			// выработка ЭЦП
+			for (i = 0, ticks1 = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					dstuSign(sig, params, ld, hash, 32, privkey, 
+						prngCOMBOStepR, combo_state) :
+					dstuSign2(sig, ctx, ld, hash, 32, privkey, 
+						prngCOMBOStepR, combo_state)) != ERR_OK)
+					return FALSE;
+			ticks1 = tmTicks() - ticks1;
+			// проверка ЭЦП
+			for (i = 0, ticks2 = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					dstuVerify(params, ld, hash, 32, sig, pubkey) :
+					dstuVerify2(ctx, ld, hash, 32, sig, pubkey)) != ERR_OK)
+					return FALSE;
+			ticks2 = tmTicks() - ticks2;
+			// печать результатов
+			printf("dstuBench::%3u%s: keygen %5u/sec, sign %5u/sec, "
+				"verify %5u/sec\n",
+				(unsigned)degs[j], k == 0 ? "     " : "[ctx]",
+				(unsigned)tmSpeed(reps, ticks),
+				(unsigned)tmSpeed(reps, ticks1),
+				(unsigned)tmSpeed(reps, ticks2));
+		}
+	}
+	// все нормально
+	return TRUE;
+}
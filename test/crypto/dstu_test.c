@@ -4,7 +4,7 @@
 \brief Tests for DSTU 4145-2002 (Ukraine)
 \project bee2/test
 \created 2012.03.01
-\version 2024.02.29
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -29,6 +29,7 @@ COMBO-генератор
 Самотестирование
 
 -#	Выполняются тесты из приложения Б к ДСТУ 4145-2002.
+-#	Тесты из приложения Б повторяются для функций с контекстом кривой.
 -#	Дополнительно проверяются кривые в полиномиальном базисе, заданные 
 	в приложении Г.
 
@@ -45,11 +46,15 @@ bool_t dstuTest()
 	octet pubkey[2 * DSTU_SIZE];
 	octet hash[32];
 	octet sig[2 * DSTU_SIZE];
+	octet pubkey1[2 * DSTU_SIZE];
+	octet sig1[2 * DSTU_SIZE];
 	size_t ld;
 	octet state[512];
+	octet ctx[4096];
 	// подготовить память
 	if (sizeof(state) < prngEcho_keep() ||
-		sizeof(state) < prngCOMBO_keep())
+		sizeof(state) < prngCOMBO_keep() ||
+		sizeof(ctx) < dstuCtx_keep(163))
 		return FALSE;
 	// тест Б.1 [загрузка параметров]
 	if (dstuParamsStd(params, "1.2.804.2.1.1.1.1.3.1.1.1.2.0") != ERR_OK ||
@@ -94,6 +99,31 @@ bool_t dstuTest()
 	sig[0] ^= 1;
 	if (dstuVerify(params, ld, hash, 21, sig, pubkey) == ERR_OK)
 		return FALSE;
+	// тест Б.1 [контекст кривой]
+	if (dstuCtxStart(ctx, params) != ERR_OK)
+		return FALSE;
+	prngEchoStart(state, privkey, memNonZeroSize(params->n, O_OF_B(163)));
+	if (dstuKeypairGen2(buf, pubkey1, ctx, prngEchoStepR, state) != ERR_OK ||
+		!memEq(buf, privkey, O_OF_B(163)) ||
+		!memEq(pubkey1, pubkey, 2 * O_OF_B(163)))
+		return FALSE;
+	hexToRev(buf, 
+		"01025E40BD97DB012B7A1D79DE8E1293"
+		"2D247F61C6");
+	prngEchoStart(state, buf, memNonZeroSize(params->n, O_OF_B(163)));
+	sig[0] ^= 1;
+	if (dstuSign2(sig1, ctx, ld, hash, 21, privkey, prngEchoStepR, 
+			state) != ERR_OK ||
+		!memEq(sig1, sig, O_OF_B(ld)) ||
+		dstuVerify2(ctx, ld, hash, 21, sig1, pubkey) != ERR_OK ||
+		(sig1[0] ^= 1, dstuVerify2(ctx, ld, hash, 21, sig1, pubkey) == ERR_OK))
+		return FALSE;
+	// тест Б.1 [неудачное построение контекста]
+	params->A ^= 2;
+	if (dstuCtxStart(ctx, params) == ERR_OK ||
+		dstuVerify2(ctx, ld, hash, 21, sig, pubkey) == ERR_OK)
+		return FALSE;
+	params->A ^= 2;
 	// создать генератор COMBO
 	prngCOMBOStart(state, utilNonce32());
 	// максимальная длина ЭЦП
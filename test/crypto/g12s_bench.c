@@ -0,0 +1,100 @@
+/*
+*******************************************************************************
+\file g12s_bench.c
+\brief Benchmarks for GOST R 34.10-2012 (Russia)
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/crypto/g12s.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости генерации ключей, выработки и проверки ЭЦП
+для стандартных параметров с уровнями стойкости 256 и 512. Каждая
+операция выполняется без контекста (описание кривой строится при каждом
+вызове) и с контекстом кривой (g12sCtxStart()). Печатается число
+операций в секунду.
+*******************************************************************************
+*/
+
+bool_t g12sBench()
+{
+	const char* names[] = {
+		"1.2.643.2.2.35.1",
+		"1.2.643.7.1.2.1.2.1",
+	};
+	g12s_params params[1];
+	octet privkey[G12S_ORDER_SIZE];
+	octet pubkey[2 * G12S_FIELD_SIZE];
+	octet hash[G12S_ORDER_SIZE];
+	octet sig[2 * G12S_ORDER_SIZE];
+	octet combo_state[256];
+	octet ctx[16384];
+	size_t i, j, k;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(ctx) < g12sCtx_keep(512))
+		return FALSE;
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(hash, sizeof(hash), combo_state);
+	// цикл по параметрам
+	for (j = 0; j < COUNT_OF(names); ++j)
+	{
+		const size_t reps = 50;
+		tm_ticks_t ticks, ticks1, ticks2;
+		// загрузить параметры, создать контекст
+		if (g12sParamsStd(params, names[j]) != ERR_OK ||
+			g12sCtxStart(ctx, params) != ERR_OK)
+			return FALSE;
+		// без контекста (k == 0) и с контекстом (k == 1)
+		for (k = 0; k < 2; ++k)
+		{
+			// генерация ключей
+			for (i = 0, ticks = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					g12sKeypairGen(privkey, pubkey, params, prngCOMBOStepR,
+						combo_state) :
+					g12sKeypairGen2(privkey, pubkey, ctx, prngCOMBOStepR,
+						combo_state)) != ERR_OK)
+					return FALSE;
+			ticks = tmTicks() - ticks;
+			// выработка ЭЦП
+			for (i = 0, ticks1 = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					g12sSign(sig, params, hash, privkey, prngCOMBOStepR,
+						combo_state) :
+					g12sSign2(sig, ctx, hash, privkey, prngCOMBOStepR,
+						combo_state)) != ERR_OK)
+					return FALSE;
+			ticks1 = tmTicks() - ticks1;
+			// проверка ЭЦП
+			for (i = 0, ticks2 = tmTicks(); i < reps; ++i)
+				if ((k == 0 ?
+					g12sVerify(params, hash, sig, pubkey) :
+					g12sVerify2(ctx, hash, sig, pubkey)) != ERR_OK)
+					return FALSE;
+			ticks2 = tmTicks() - ticks2;
+			// печать результатов
+			printf("g12sBench::%3u%s: keygen %5u/sec, sign %5u/sec, "
+				"verify %5u/sec\n",
+				(unsigned)params->l, k == 0 ? "     " : "[ctx]",
+				(unsigned)tmSpeed(reps, ticks),
+				(unsigned)tmSpeed(reps, ticks1),
+				(unsigned)tmSpeed(reps, ticks2));
+		}
+	}
+	// все нормально
+	return TRUE;
+}
@@ -4,7 +4,7 @@
 \brief Tests for GOST R 34.10-2012 (Russia)
 \project bee2/test
 \created 2014.04.07
-\version 2023.09.22
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -21,6 +21,7 @@
 Самотестирование
 
 -#	Выполняются тесты из приложения A к ГОСТ Р 34.10-2012.
+-#	Тест A.1 повторяется для функций с контекстом кривой.
 -#	Дополнительно проверяются стандартные кривые.
 *******************************************************************************
 */
@@ -33,10 +34,14 @@ bool_t g12sTest()
 	octet pubkey[2 * G12S_FIELD_SIZE];
 	octet hash[64];
 	octet sig[2 * G12S_ORDER_SIZE];
+	octet pubkey1[2 * G12S_FIELD_SIZE];
+	octet sig1[2 * G12S_ORDER_SIZE];
 	octet echo[64];
+	octet ctx[8192];
 	// подготовить память
 	if (sizeof(echo) < prngEcho_keep() ||
-		sizeof(echo) < prngCOMBO_keep())
+		sizeof(echo) < prngCOMBO_keep() ||
+		sizeof(ctx) < g12sCtx_keep(256))
 		return FALSE;
 	// тест A.1 [загрузка параметров]
 	if (g12sParamsStd(params, "1.2.643.2.2.35.0") != ERR_OK ||
@@ -76,6 +81,30 @@ bool_t g12sTest()
 	if (g12sVerify(params, hash, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, g12sVerify(params, hash, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// тест A.1 [контекст кривой]
+	if (g12sCtxStart(ctx, params) != ERR_OK)
+		return FALSE;
+	prngEchoStart(echo, privkey, 32);
+	if (g12sKeypairGen2(buf, pubkey1, ctx, prngEchoStepR, echo) != ERR_OK ||
+		!memEq(buf, privkey, 32) ||
+		!memEq(pubkey1, pubkey, 64))
+		return FALSE;
+	hexToRev(buf, 
+		"77105C9B20BCD3122823C8CF6FCC7B95"
+		"6DE33814E95B7FE64FED924594DCEAB3");
+	prngEchoStart(echo, buf, 32);
+	sig[0] ^= 1;
+	if (g12sSign2(sig1, ctx, hash, privkey, prngEchoStepR, echo) != ERR_OK ||
+		!memEq(sig1, sig, 64) ||
+		g12sVerify2(ctx, hash, sig1, pubkey) != ERR_OK ||
+		(sig1[0] ^= 1, g12sVerify2(ctx, hash, sig1, pubkey) == ERR_OK))
+		return FALSE;
+	// тест A.1 [неудачное построение контекста]
+	params->q[0] ^= 1;
+	if (g12sCtxStart(ctx, params) == ERR_OK ||
+		g12sVerify2(ctx, hash, sig, pubkey) == ERR_OK)
+		return FALSE;
+	params->q[0] ^= 1;
 	// тест A.2 [загрузка параметров]
 	if (g12sParamsStd(params, "1.2.643.7.1.2.1.2.0") != ERR_OK ||
 		g12sParamsVal(params) != ERR_OK)
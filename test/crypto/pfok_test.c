@@ -4,7 +4,7 @@
 \brief Tests for Draft of RD_RB (pfok)
 \project bee2/test
 \created 2014.07.08
-\version 2024.02.29
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -16,6 +16,7 @@
 #include <bee2/core/str.h>
 #include <bee2/core/util.h>
 #include <bee2/math/ww.h>
+#include <bee2/math/zm.h>
 #include <bee2/math/zz.h>
 #include <bee2/crypto/pfok.h>
 
@@ -119,6 +120,72 @@ bool_t pfokTestParamsStd()
 	return TRUE;
 }
 
+/*
+*******************************************************************************
+Контекст фиксированного основания
+
+Открытые ключи, построенные по контексту и без него, сравниваются между 
+собой. Для параметров с l + 2 < B_OF_W(W_OF_B(l)) дополнительно проверяется 
+совпадение с возведением в степень в кольце zmMontCreate(qr, p, no, l + 2).
+*******************************************************************************
+*/
+
+static bool_t pfokTestCtx(const char* name)
+{
+	pfok_params params[1];
+	octet combo_state[128];
+	octet ctx[65536];
+	octet x[O_OF_B(259)];
+	octet y[O_OF_B(2942)];
+	octet y1[O_OF_B(2942)];
+	word g[W_OF_B(2942)];
+	word e[W_OF_B(259)];
+	octet stack[16384];
+	qr_o* qr = (qr_o*)stack;
+	size_t no, i;
+	// загрузить параметры
+	if (pfokParamsStd(params, 0, name) != ERR_OK ||
+		sizeof(ctx) < pfokCtx_keep(params->l) ||
+		sizeof(combo_state) < prngCOMBO_keep())
+		return FALSE;
+	no = O_OF_B(params->l);
+	if (sizeof(stack) < zmMontCreate_keep(no) + 
+		utilMax(2,
+			zmMontCreate_deep(no),
+			qrPower_deep(W_OF_O(no), W_OF_B(params->r), 
+				zmMontCreate_deep(no))))
+		return FALSE;
+	// создать контекст
+	if (pfokCtxStart(ctx, params) != ERR_OK)
+		return FALSE;
+	// построить кольцо Монтгомери
+	zmMontCreate(qr, params->p, no, params->l + 2, stack + 
+		zmMontCreate_keep(no));
+	prngCOMBOStart(combo_state, utilNonce32());
+	for (i = 0; i < 3; ++i)
+	{
+		// y <- g^(x) по контексту и без него
+		if (pfokKeypairGen2(x, y, ctx, prngCOMBOStepR, combo_state) != 
+				ERR_OK ||
+			pfokPubkeyVal(params, y) != ERR_OK ||
+			pfokPubkeyCalc(y1, params, x) != ERR_OK ||
+			!memEq(y, y1, no) ||
+			pfokPubkeyCalc2(y1, ctx, x) != ERR_OK ||
+			!memEq(y, y1, no))
+			return FALSE;
+		// эталон: qrPower()
+		wwFrom(g, params->g, no);
+		wwFrom(e, x, O_OF_B(params->r));
+		qrPower(g, g, e, W_OF_B(params->r), qr, 
+			stack + zmMontCreate_keep(no));
+		qrTo(y1, g, qr, stack + zmMontCreate_keep(no));
+		if (!memEq(y, y1, no))
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
+
 bool_t pfokTest()
 {
 	pfok_params params[1];
@@ -253,6 +320,10 @@ bool_t pfokTest()
 			"5A4C323604206C8898BF6C234F75A537"
 			"DF75E9A249D87F1E55CBD7B40C4FDAFA"))
 		return FALSE;
+	// контекст фиксированного основания
+	if (!pfokTestCtx("test") ||
+		!pfokTestCtx("1.2.112.0.2.0.1176.2.3.10.2"))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
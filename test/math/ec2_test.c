@@ -0,0 +1,153 @@
+/*
+*******************************************************************************
+\file ec2_test.c
+\brief Tests for elliptic curves over binary fields
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <bee2/core/hex.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/obj.h>
+#include <bee2/core/util.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/ec2.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Проверочная кривая: NIST K-163 (кривая Коблица, A = B = 1)
+*******************************************************************************
+*/
+
+static const size_t no = 21;
+static size_t p[4] = {163, 7, 6, 3};
+static char a[] =
+	"000000000000000000000000000000000000000001";
+static char b[] =
+	"000000000000000000000000000000000000000001";
+static char q[] =
+	"04000000000000000000020108A2E0CC0D99F8A5EF";
+static char xbase[] =
+	"02FE13C0537BBC11ACAA07D793DE4E6D5E5C94EEE8";
+static char ybase[] =
+	"0289070FB05D38FF58321F2E800536D538CCDAA3D9";
+static u32 cofactor = 2;
+
+/*
+*******************************************************************************
+Тестирование
+*******************************************************************************
+*/
+
+bool_t ec2Test()
+{
+	// размерности
+	const size_t n = W_OF_O(no);
+	const size_t f_keep = gf2Create_keep(163);
+	const size_t ec_keep = ec2CreateLD_keep(n);
+	const size_t f_deep = gf2Create_deep(163);
+	// состояние и стек
+	octet state[2048];
+	octet stack[2048];
+	octet t[24 * 5];
+	// поле и эк
+	qr_o* f;
+	ec_o* ec;
+	// подготовить память
+	if (sizeof(state) < f_keep + ec_keep ||
+		sizeof(stack) < f_deep ||
+		sizeof(t) < 3 * no)
+		return FALSE;
+	// создать f = GF(2^163)
+	f = (qr_o*)(state + ec_keep);
+	if (!gf2Create(f, p, stack))
+		return FALSE;
+	// создать ec = EC_{ab}(f)
+	hexToRev(t, a), hexToRev(t + no, b);
+	ec = (ec_o*)state;
+	if (sizeof(stack) < ec2CreateLD_deep(n, f_deep) ||
+		!ec2CreateLD(ec, f, t, t + no, stack))
+		return FALSE;
+	// создать группу точек ec
+	hexToRev(t, xbase), hexToRev(t + no, ybase), hexToRev(t + 2 * no, q);
+	if (sizeof(stack) < ecCreateGroup_deep(f_deep) ||
+		!ecCreateGroup(ec, t, t + no, t + 2 * no, no, cofactor, stack))
+		return FALSE;
+	// присоединить f к ec
+	objAppend(ec, f, 0);
+	// корректная кривая и группа?
+	if (sizeof(stack) < utilMax(2,
+			ec2IsValid_deep(n),
+			ec2SeemsValidGroup_deep(n, f_deep)) ||
+		!ec2IsValid(ec, stack) ||
+		!ec2SeemsValidGroup(ec, stack))
+		return FALSE;
+	// базовая точка имеет порядок q?
+	if (sizeof(stack) < ecHasOrderA_deep(n, ec->d, ec->deep, n) ||
+		!ecHasOrderA(ec->base, ec, ec->order, n, stack))
+		return FALSE;
+	// лестница Монтгомери
+	if (sizeof(t) < 5 * O_OF_W(n) ||
+		sizeof(stack) < utilMax(3,
+			ec2MulLadderA_deep(n, f_deep),
+			ecMulA_deep(n, ec->d, ec->deep, n),
+			ec2IsOnA_deep(n, f_deep)))
+		return FALSE;
+	{
+		word* pts = (word*)t;
+		word* d = pts + 4 * n;
+		size_t i;
+		// d <- 1, 2, q - 1, q - 2, ybase, ybase + 1
+		for (i = 0; i < 6; ++i)
+		{
+			if (i < 2)
+				wwSetW(d, n, (word)(i + 1));
+			else if (i < 4)
+				wwCopy(d, ec->order, n), d[0] -= (word)(i - 1);
+			else
+				hexToRev(d, ybase), wwFrom(d, d, no), d[0] += (word)(i - 4);
+			if (!ecMulA(pts, ec->base, ec, d, n, stack) ||
+				!ec2MulLadderA(pts + 2 * n, ec->base, ec, d, n, stack) ||
+				!wwEq(pts, pts + 2 * n, 2 * n) ||
+				!ec2IsOnA(pts, ec, stack))
+				return FALSE;
+		}
+		// d <- q - 1 => d G == -G
+		wwCopy(d, ec->order, n), --d[0];
+		wwCopy(pts, ec->base, 2 * n);
+		gf2Add2(ecY(pts, n), ecX(pts), ec->f);
+		if (!ec2MulLadderA(pts + 2 * n, ec->base, ec, d, n, stack) ||
+			!wwEq(pts, pts + 2 * n, 2 * n))
+			return FALSE;
+		// d <- q, 0 => d G == O
+		wwCopy(d, ec->order, n);
+		if (ec2MulLadderA(pts, ec->base, ec, d, n, stack))
+			return FALSE;
+		wwSetZero(d, n);
+		if (ec2MulLadderA(pts, ec->base, ec, d, n, stack))
+			return FALSE;
+		// P <- (0, \sqrt{B}) = (0, 1) -- точка порядка 2
+		qrSetZero(ecX(pts), ec->f);
+		qrSetUnity(ecY(pts, n), ec->f);
+		if (!ec2IsOnA(pts, ec, stack))
+			return FALSE;
+		// d <- 1, 2, 3
+		for (i = 1; i <= 3; ++i)
+		{
+			bool_t odd = (bool_t)(i % 2);
+			wwSetW(d, n, (word)i);
+			if (ecMulA(pts + 2 * n, pts, ec, d, n, stack) != odd ||
+				(odd && !wwEq(pts, pts + 2 * n, 2 * n)) ||
+				ec2MulLadderA(pts + 2 * n, pts, ec, d, n, stack) != odd ||
+				(odd && !wwEq(pts, pts + 2 * n, 2 * n)))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
@@ -4,7 +4,7 @@
 \brief Tests for elliptic curves over prime fields
 \project bee2/test
 \created 2017.05.29
-\version 2023.03.30
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -137,6 +137,66 @@ bool_t ecpTest()
 		if (!memEq(pts, pts + 2 * n, 2 * n))
 			return FALSE;
 	}
+	// кратные базовой точки: гребенчатый метод
+	if (sizeof(t) < 5 * no ||
+		sizeof(stack) < utilMax(4,
+			ecPreCombA_deep(n, ec->d, ec->deep),
+			ecMulCombA_deep(n, ec->d, ec->deep),
+			ecMulA_deep(n, ec->d, ec->deep, n),
+			ecpIsOnA_deep(n, f_deep)))
+		return FALSE;
+	{
+		word pre[15 * 2 * W_OF_O(32)];
+		word* pts = (word*)t;
+		word* d = pts + 4 * n;
+		if (!ecPreCombA(pre, ec->base, ec, 4, n, stack))
+			return FALSE;
+		// d <- q - 1 => d G == -G
+		wwCopy(d, ec->order, n), --d[0];
+		ecpNegA(pts, ec->base, ec);
+		if (!ecMulCombA(pts + 2 * n, pre, ec, 4, d, n, stack) ||
+			!wwEq(pts, pts + 2 * n, 2 * n))
+			return FALSE;
+		// d <- ybase
+		hexToRev(d, ybase), wwFrom(d, d, no);
+		if (!ecMulA(pts, ec->base, ec, d, n, stack) ||
+			!ecMulCombA(pts + 2 * n, pre, ec, 4, d, n, stack) ||
+			!wwEq(pts, pts + 2 * n, 2 * n) ||
+			!ecpIsOnA(pts, ec, stack))
+			return FALSE;
+		// d <- 0 => d G == O
+		wwSetZero(d, n);
+		if (ecMulCombA(pts, pre, ec, 4, d, n, stack))
+			return FALSE;
+	}
+	// кратные базовой точки: регулярный гребенчатый метод
+	if (sizeof(stack) < utilMax(3,
+			ecPreSCombA_deep(n, ec->d, ec->deep),
+			ecMulSCombA_deep(n, ec->d, ec->deep, n),
+			ecMulA_deep(n, ec->d, ec->deep, n)))
+		return FALSE;
+	{
+		word pre[16 * 2 * W_OF_O(32)];
+		word* pts = (word*)t;
+		word* d = pts + 4 * n;
+		size_t i;
+		if (!ecPreSCombA(pre, ec->base, ec, 4, n, stack))
+			return FALSE;
+		// d <- 1, 2, q - 1, q - 2, ybase, ybase + 1
+		for (i = 0; i < 6; ++i)
+		{
+			if (i < 2)
+				wwSetW(d, n, (word)(i + 1));
+			else if (i < 4)
+				wwCopy(d, ec->order, n), d[0] -= (word)(i - 1);
+			else
+				hexToRev(d, ybase), wwFrom(d, d, no), d[0] += (word)(i - 4);
+			if (!ecMulA(pts, ec->base, ec, d, n, stack) ||
+				!ecMulSCombA(pts + 2 * n, pre, ec, 4, d, n, stack) ||
+				!wwEq(pts, pts + 2 * n, 2 * n))
+				return FALSE;
+		}
+	}
 	// вывести f = GF(p) за пределы ec
 	f = (qr_o*)(state + ec_keep);
 	memMove(f, objPtr(ec, 0, qr_o), f_keep);
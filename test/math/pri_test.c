@@ -4,7 +4,7 @@
 \brief Tests for prime numbers
 \project bee2/test
 \created 2014.07.07
-\version 2024.02.26
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -17,6 +17,119 @@
 #include <bee2/math/pri.h>
 #include <bee2/math/ww.h>
 
+/*
+*******************************************************************************
+Поиск длинных простых
+
+Для длинных кандидатов функции priNextPrime(), priExtendPrime() 
+используют решето по окнам и (при наличии нескольких процессоров) 
+параллельную проверку кандидатов. Проверяется, что найденное простое 
+является первым простым среди кандидатов и что результат зависит только 
+от состояния генератора.
+*******************************************************************************
+*/
+
+static bool_t priTestLong()
+{
+	const size_t n = W_OF_B(640);
+	const size_t np = W_OF_B(700);
+	word a[W_OF_B(640)];
+	word p[W_OF_B(640)];
+	word c[W_OF_B(640)];
+	word q[W_OF_B(700)];
+	word q1[W_OF_B(700)];
+	octet combo_state[32];
+	octet combo_state1[32];
+	octet stack[131072];
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < priNextPrime_deep(n, 100) ||
+		sizeof(stack) < priIsSieved_deep(100) ||
+		sizeof(stack) < priIsPrime_deep(np) ||
+		sizeof(stack) < priExtendPrime_deep(700, n, 100))
+		return FALSE;
+	// a <-R [2^639, 2^640)
+	prngCOMBOStart(combo_state, utilNonce32());
+	prngCOMBOStepR(a, O_OF_W(n), combo_state);
+	wwFrom(a, a, O_OF_W(n));
+	wwTrimHi(a, n, 639);
+	wwSetBit(a, 639, 1);
+	// p <- первое простое >= a
+	if (!priNextPrime(p, a, n, SIZE_MAX, 100, 20, stack) ||
+		wwCmp(p, a, n) < 0 ||
+		!priIsPrime(p, n, stack))
+		return FALSE;
+	// между a и p нет простых
+	for (wwCopy(c, a, n), c[0] |= 1; wwCmp(c, p, n) < 0; zzAddW2(c, n, 2))
+		if (priIsSieved(c, n, 100, stack) && priRMTest(c, n, 1, stack))
+			return FALSE;
+	// за одну попытку находится только p
+	if (priNextPrime(c, a, n, 1, 100, 20, stack) && !wwEq(c, p, n))
+		return FALSE;
+	// расширить p дважды при одинаковом состоянии генератора
+	memCopy(combo_state1, combo_state, sizeof(combo_state));
+	if (!priExtendPrime(q, 700, p, n, SIZE_MAX, 100, prngCOMBOStepR, 
+			combo_state, stack) ||
+		!priExtendPrime(q1, 700, p, n, SIZE_MAX, 100, prngCOMBOStepR, 
+			combo_state1, stack) ||
+		!wwEq(q, q1, np) ||
+		wwBitSize(q, np) != 700 ||
+		!priIsPrime(q, np, stack))
+		return FALSE;
+	// все нормально
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Шаг, кратный малым простым
+
+Если множитель a в priExtendPrime2() делится на простые факторной базы,
+то на них делится и шаг между кандидатами. Кандидаты при этом не делятся
+на такие простые и не должны отсеиваться. Проверяется, что результат
+поиска с решетом совпадает с результатом поиска без решета
+(base_count == 0) при одинаковом состоянии генератора.
+*******************************************************************************
+*/
+
+static bool_t priTestStep()
+{
+	const size_t n = W_OF_B(256);
+	const size_t np = W_OF_B(320);
+	word q[W_OF_B(256)];
+	word a[1];
+	word p[W_OF_B(320)];
+	word p1[W_OF_B(320)];
+	octet combo_state[32];
+	octet combo_state1[32];
+	octet stack[16384];
+	u32 seed;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < priExtendPrime2_deep(320, n, 1, 100) ||
+		sizeof(stack) < priIsPrime_deep(np))
+		return FALSE;
+	// q <- 2^256 - 189, a <- 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23
+	memSet(q, 0xFF, O_OF_B(256));
+	q[0] = WORD_MAX - 188;
+	a[0] = 223092870 / 2;
+	// сравнить поиск с решетом и без решета
+	for (seed = 1; seed <= 8; ++seed)
+	{
+		prngCOMBOStart(combo_state, seed);
+		memCopy(combo_state1, combo_state, sizeof(combo_state));
+		if (!priExtendPrime2(p, 320, q, n, a, 1, SIZE_MAX, 100,
+				prngCOMBOStepR, combo_state, stack) ||
+			!priExtendPrime2(p1, 320, q, n, a, 1, SIZE_MAX, 0,
+				prngCOMBOStepR, combo_state1, stack) ||
+			!wwEq(p, p1, np) ||
+			!priIsPrime(p, np, stack))
+			return FALSE;
+	}
+	// все нормально
+	return TRUE;
+}
+
 /*
 *******************************************************************************
 Тестирование
@@ -91,6 +204,23 @@ bool_t priTest()
 			priBasePrime(i) < WORD_BIT_HALF &&
 				mods[i] != zzModW2(a, W_OF_B(521), priBasePrime(i)))
 			return FALSE;
+	// остатки случайного числа и числа B^m - 1
+	{
+		word* b = (word*)stack;
+		const size_t m = W_OF_B(521);
+		const size_t count = MIN2(COUNT_OF(mods), priBaseSize());
+		size_t j;
+		ASSERT(sizeof(stack) >= 2 * O_OF_W(m));
+		prngCOMBOStepR(b, O_OF_W(m), combo_state);
+		wwRepW(b + m, m, WORD_MAX);
+		for (j = 0; j < 2; ++j)
+		{
+			priBaseMod(mods, b + j * m, m, count);
+			for (i = 0; i < count; ++i)
+				if (mods[i] != zzModW(b + j * m, m, priBasePrime(i)))
+					return FALSE;
+		}
+	}
 	// найти 2-битовое нечетное простое число
 	a[0] = 2;
 	if (sizeof(stack) < priNextPrime_deep(1, 0) ||
@@ -155,6 +285,12 @@ bool_t priTest()
 			prngCOMBOStepR, combo_state, stack) ||
 		p[0] != 23)
 		return FALSE;
+	// шаг, кратный малым простым
+	if (!priTestStep())
+		return FALSE;
+	// длинные простые
+	if (!priTestLong())
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
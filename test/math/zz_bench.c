@@ -0,0 +1,88 @@
+/*
+*******************************************************************************
+\file zz_bench.c
+\brief Benchmarks for multiple-precision unsigned integers
+\project bee2/test
+\created 2026.10.18
+\version 2026.10.18
+\copyright The Bee2 authors
+\license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
+*******************************************************************************
+*/
+
+#include <stdio.h>
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/tm.h>
+#include <bee2/core/util.h>
+#include <bee2/core/word.h>
+#include <bee2/math/zz.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Замер производительности
+
+Оцениваются скорости умножения, возведения в квадрат и возведения
+в степень по модулю для чисел разной длины. Длины охватывают как
+эллиптическую криптографию (256 -- 512 битов), так и алгоритмы
+СТБ 1176.2 и pfok (1024 -- 3072 битов).
+*******************************************************************************
+*/
+
+bool_t zzBench()
+{
+	enum { bmax = 3072, nmax = bmax / B_PER_W };
+	const size_t bits[] = { 256, 512, 1024, 2048, 3072 };
+	word a[nmax];
+	word b[nmax];
+	word mod[nmax];
+	word c[2 * nmax];
+	octet combo_state[32];
+	octet stack[32768];
+	size_t i, j;
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < utilMax(3,
+			zzMul_deep(nmax, nmax),
+			zzSqr_deep(nmax),
+			zzPowerMod_deep(nmax, nmax)))
+		return FALSE;
+	// инициализировать генератор COMBO
+	prngCOMBOStart(combo_state, utilNonce32());
+	// цикл по длинам
+	for (j = 0; j < COUNT_OF(bits); ++j)
+	{
+		const size_t n = bits[j] / B_PER_W;
+		const size_t reps = 4096 / n * 64;
+		const size_t reps_pow = 2 + 
+			100 * (bmax / bits[j]) * (bmax / bits[j]) / 36;
+		tm_ticks_t ticks, ticks1, ticks2;
+		// подготовить операнды
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		prngCOMBOStepR(mod, O_OF_W(n), combo_state);
+		mod[0] |= 1, mod[n - 1] |= WORD_BIT_HI;
+		a[n - 1] &= ~WORD_BIT_HI;
+		// умножение
+		for (i = 0, ticks = tmTicks(); i < reps; ++i)
+			zzMul(c, a, n, b, n, stack);
+		ticks = tmTicks() - ticks;
+		// возведение в квадрат
+		for (i = 0, ticks1 = tmTicks(); i < reps; ++i)
+			zzSqr(c, a, n, stack);
+		ticks1 = tmTicks() - ticks1;
+		// возведение в степень
+		for (i = 0, ticks2 = tmTicks(); i < reps_pow; ++i)
+			zzPowerMod(c, a, n, b, n, mod, stack);
+		ticks2 = tmTicks() - ticks2;
+		// печать результатов
+		printf("zzBench::%4u: mul %7u/sec, sqr %7u/sec, "
+			"powmod %5u/sec\n", (unsigned)bits[j],
+			(unsigned)tmSpeed(reps, ticks),
+			(unsigned)tmSpeed(reps, ticks1),
+			(unsigned)tmSpeed(reps_pow, ticks2));
+	}
+	// все нормально
+	return TRUE;
+}
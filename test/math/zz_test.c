@@ -4,7 +4,7 @@
 \brief Tests for multiple-precision unsigned integers
 \project bee2/test
 \created 2014.07.15
-\version 2023.11.10
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -192,6 +192,148 @@ static bool_t zzTestMul()
 	return TRUE;
 }
 
+static bool_t zzTestMulLarge()
+{
+	enum { n = 100 };
+	const size_t lens[] = { 23, 24, 25, 47, 48, 49, 64, 97, 100 };
+	size_t reps = 20;
+	word a[n];
+	word b[n];
+	word c[2 * n];
+	word c1[2 * n];
+	octet combo_state[32];
+	octet stack[4096];
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < utilMax(2,
+			zzMul_deep(n, n),
+			zzSqr_deep(n)))
+		return FALSE;
+	// инициализировать генератор COMBO
+	prngCOMBOStart(combo_state, utilNonce32());
+	// умножение длинных чисел (в том числе по Карацубе)
+	while (reps--)
+	{
+		size_t i, j;
+		prngCOMBOStepR(a, O_OF_W(n), combo_state);
+		prngCOMBOStepR(b, O_OF_W(n), combo_state);
+		// максимальные значения (проверка переносов)
+		if (reps == 0)
+			memSet(a, 0xFF, sizeof(a)), memSet(b, 0xFF, sizeof(b));
+		for (j = 0; j < COUNT_OF(lens); ++j)
+		{
+			const size_t na = lens[j];
+			// c1 <- a * b (по столбцам)
+			wwSetZero(c1, 2 * na);
+			for (i = 0; i < na; ++i)
+				c1[i + na] = zzAddMulW(c1 + i, b, na, a[i]);
+			// zzMul / zzSqr
+			zzMul(c, a, na, b, na, stack);
+			if (!wwEq(c, c1, 2 * na))
+				return FALSE;
+			zzMul(c1, a, na, a, na, stack);
+			zzSqr(c, a, na, stack);
+			if (!wwEq(c, c1, 2 * na))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
+
+static bool_t zzTestMont()
+{
+	enum { n = 12 };
+	size_t reps = 100;
+	word mod[n];
+	word a[n];
+	word b[n];
+	word c[2 * n];
+	word c1[2 * n];
+	word pre[n << 4];
+	octet combo_state[32];
+	octet stack[8192];
+	// подготовить память
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < utilMax(8,
+			zzMulMont_deep(n),
+			zzRedMont_deep(n),
+			zzMod_deep(2 * n, n),
+			zzPowerMod_deep(n, n),
+			zzMulMod_deep(n),
+			zzSqrMod_deep(n),
+			zzPowerMontPre_deep(n),
+			zzPowerMontComb_deep(n)) ||
+		sizeof(stack) < zzPowerMont_deep(n, B_OF_W(n)))
+		return FALSE;
+	// инициализировать генератор COMBO
+	prngCOMBOStart(combo_state, utilNonce32());
+	// умножение / возведение в степень
+	while (reps--)
+	{
+		size_t nm = reps % n + 1;
+		size_t l = B_OF_W(reps % nm + 1) - reps % 7;
+		size_t i;
+		word mont_param;
+		// mod <- нечетное, a, b <- вычеты
+		prngCOMBOStepR(mod, O_OF_W(nm), combo_state);
+		mod[0] |= 1, mod[nm - 1] |= WORD_1;
+		mont_param = wordNegInv(mod[0]);
+		zzRandMod(a, mod, nm, prngCOMBOStepR, combo_state);
+		zzRandMod(b, mod, nm, prngCOMBOStepR, combo_state);
+		// zzMulMont / zzRedMont
+		zzMul(c, a, nm, b, nm, stack);
+		zzRedMont(c, mod, nm, mont_param, stack);
+		zzMulMont(c1, a, b, mod, nm, mont_param, stack);
+		if (!wwEq(c, c1, nm))
+			return FALSE;
+		zzMulMont(a, a, a, mod, nm, mont_param, stack);
+		zzMulMont(c1, c1, c1, mod, nm, mont_param, stack);
+		zzMul(c, b, nm, b, nm, stack);
+		zzRedMont(c, mod, nm, mont_param, stack);
+		zzMulMont(c, c, a, mod, nm, mont_param, stack);
+		if (!wwEq(c, c1, nm))
+			return FALSE;
+		// c1 <- (a R)^(b) R^{-1} = a^b \mod mod
+		wwSetZero(c, nm);
+		wwCopy(c + nm, a, nm);
+		zzMod(c, c, 2 * nm, mod, nm, stack);
+		wwTrimHi(b, nm, l);
+		zzPowerMont(c1, c, b, l, mod, nm, mont_param, stack);
+		wwSetZero(c1 + nm, nm);
+		zzRedMont(c1, mod, nm, mont_param, stack);
+		// c <- a^b \mod mod (бинарный метод)
+		wwSetZero(c, nm), c[0] = 1;
+		zzMod(c, c, nm, mod, nm, stack);
+		for (i = l; i--;)
+		{
+			zzSqrMod(c, c, mod, nm, stack);
+			if (wwTestBit(b, i))
+				zzMulMod(c, c, a, mod, nm, stack);
+		}
+		if (!wwEq(c, c1, nm))
+			return FALSE;
+		// zzPowerMod
+		zzPowerMod(c1, a, nm, b, nm, mod, stack);
+		if (!wwEq(c, c1, nm))
+			return FALSE;
+		// zzPowerMontPre / zzPowerMontComb
+		if (l >= 4)
+		{
+			wwSetZero(c, nm);
+			wwCopy(c + nm, a, nm);
+			zzMod(c, c, 2 * nm, mod, nm, stack);
+			zzPowerMontPre(pre, 4, c, l, mod, nm, mont_param, stack);
+			zzPowerMontComb(c + nm, pre, 4, b, l, mod, nm, mont_param, stack);
+			zzPowerMont(c, c, b, l, mod, nm, mont_param, stack);
+			if (!wwEq(c, c + nm, nm))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
+
 static bool_t zzTestMod()
 {
 	enum { n = 8 };
@@ -390,6 +532,51 @@ static bool_t zzTestGCD()
 	return TRUE;
 }
 
+static bool_t zzTestLCMLarge()
+{
+	enum { n = 193, m = 192 };
+	size_t reps = 20;
+	size_t deep;
+	word a[n];
+	word b[m];
+	word t[m];
+	word t1[n + m];
+	word p[n + m];
+	word p1[n + m + m];
+	octet combo_state[32];
+	octet stack[12288];
+	// подготовить память
+	deep = zzLCM_deep(n, m);
+	if (sizeof(combo_state) < prngCOMBO_keep() ||
+		sizeof(stack) < deep + 64 ||
+		sizeof(stack) < utilMax(2,
+			zzMul_deep(n, m),
+			zzGCD_deep(n, m)))
+		return FALSE;
+	// инициализировать генератор COMBO
+	prngCOMBOStart(combo_state, utilNonce32());
+	// после нормализации длины a и b совпадают
+	while (reps--)
+	{
+		prngCOMBOStepR(a, O_OF_W(m), combo_state);
+		prngCOMBOStepR(b, O_OF_W(m), combo_state);
+		wwSetZero(a + m, n - m);
+		a[m - 1] |= WORD_1, b[m - 1] |= WORD_1;
+		// контрольные октеты за пределами zzLCM_deep(n, m)
+		memSet(stack + deep, 0x5A, 64);
+		zzLCM(t1, a, n, b, m, stack);
+		if (!memIsRep(stack + deep, 64, 0x5A))
+			return FALSE;
+		// НОД * НОК == a * b
+		zzGCD(t, a, n, b, m, stack);
+		zzMul(p, a, n, b, m, stack);
+		zzMul(p1, t, m, t1, n + m, stack);
+		if (wwCmp2(p, n + m, p1, n + m + m) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
 static bool_t zzTestRed()
 {
 	enum { n = 8 };
@@ -545,8 +732,11 @@ bool_t zzTest()
 {
 	return zzTestAdd() && 
 		zzTestMul() && 
+		zzTestMulLarge() &&
+		zzTestMont() &&
 		zzTestMod() && 
 		zzTestGCD() && 
+		zzTestLCMLarge() &&
 		zzTestRed() &&
 		zzTestEtc();
 }
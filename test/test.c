@@ -4,7 +4,7 @@
 \brief Bee2 testing
 \project bee2/test
 \created 2014.04.02
-\version 2023.12.19
+\version 2026.10.18
 \copyright The Bee2 authors
 \license Licensed under the Apache License, Version 2.0 (see LICENSE.txt).
 *******************************************************************************
@@ -21,11 +21,14 @@
 
 extern bool_t apduTest();
 extern bool_t b64Test();
+extern bool_t b64Bench();
 extern bool_t blobTest();
 extern bool_t decTest();
 extern bool_t derTest();
 extern bool_t hexTest();
+extern bool_t hexBench();
 extern bool_t memTest();
+extern bool_t memBench();
 extern bool_t mtTest();
 extern bool_t objTest();
 extern bool_t oidTest();
@@ -44,11 +47,14 @@ int testCore()
 	int ret = 0;
 	printf("apduTest: %s\n", (code = apduTest()) ? "OK" : "Err"), ret |= !code;
 	printf("b64Test: %s\n", (code = b64Test()) ? "OK" : "Err"), ret |= !code;
+	code = b64Bench(), ret |= !code;
 	printf("blobTest: %s\n", (code = blobTest()) ? "OK" : "Err"), ret |= !code;
 	printf("decTest: %s\n", (code = decTest()) ? "OK" : "Err"), ret |= !code;
 	printf("derTest: %s\n", (code = derTest()) ? "OK" : "Err"), ret |= !code;
 	printf("hexTest: %s\n", (code = hexTest()) ? "OK" : "Err"), ret |= !code;
+	code = hexBench(), ret |= !code;
 	printf("memTest: %s\n", (code = memTest()) ? "OK" : "Err"), ret |= !code;
+	code = memBench(), ret |= !code;
 	printf("mtTest: %s\n", (code = mtTest()) ? "OK" : "Err"), ret |= !code;
 	printf("objTest: %s\n", (code = objTest()) ? "OK" : "Err"), ret |= !code;
 	printf("oidTest: %s\n", (code = oidTest()) ? "OK" : "Err"), ret |= !code;
@@ -72,8 +78,10 @@ int testCore()
 extern bool_t wordTest();
 extern bool_t wwTest();
 extern bool_t zzTest();
+extern bool_t zzBench();
 extern bool_t ppTest();
 extern bool_t priTest();
+extern bool_t ec2Test();
 extern bool_t ecpTest();
 extern bool_t ecpBench();
 
@@ -84,8 +92,10 @@ int testMath()
 	printf("wordTest: %s\n", (code = wordTest()) ? "OK" : "Err"), ret |= !code;
 	printf("wwTest: %s\n", (code = wwTest()) ? "OK" : "Err"), ret |= !code;
 	printf("zzTest: %s\n", (code = zzTest()) ? "OK" : "Err"), ret |= !code;
+	code = zzBench(), ret |= !code;
 	printf("ppTest: %s\n", (code = ppTest()) ? "OK" : "Err"), ret |= !code;
 	printf("priTest: %s\n", (code = priTest()) ? "OK" : "Err"), ret |= !code;
+	printf("ec2Test: %s\n", (code = ec2Test()) ? "OK" : "Err"), ret |= !code;
 	printf("ecpTest: %s\n", (code = ecpTest()) ? "OK" : "Err"), ret |= !code;
 	code = ecpBench(), ret |= !code;
 	return ret;
@@ -104,14 +114,19 @@ extern bool_t bign96Test();
 extern bool_t brngTest();
 extern bool_t belsTest();
 extern bool_t bakeTest();
+extern bool_t bakeBench();
 extern bool_t bakeDemo();
 extern bool_t bashTest();
 extern bool_t bashBench();
 extern bool_t botpTest();
+extern bool_t botpBench();
 extern bool_t bpkiTest();
 extern bool_t btokTest();
+extern bool_t btokBench();
 extern bool_t dstuTest();
+extern bool_t dstuBench();
 extern bool_t g12sTest();
+extern bool_t g12sBench();
 extern bool_t pfokTest();
 extern bool_t pfokTestParamsStd();
 extern bool_t stb99Test();
@@ -128,13 +143,18 @@ int testCrypto()
 	printf("bign96Test: %s\n", (code = bign96Test()) ? "OK" : "Err"),
 		ret |= !code;
 	printf("botpTest: %s\n", (code = botpTest()) ? "OK" : "Err"), ret |= !code;
+	code = botpBench(), ret |= !code;
 	printf("brngTest: %s\n", (code = brngTest()) ? "OK" : "Err"), ret |= !code;
 	printf("belsTest: %s\n", (code = belsTest()) ? "OK" : "Err"), ret |= !code;
 	printf("bakeTest: %s\n", (code = bakeTest()) ? "OK" : "Err"), ret |= !code;
+	code = bakeBench(), ret |= !code;
 	printf("bpkiTest: %s\n", (code = bpkiTest()) ? "OK" : "Err"), ret |= !code;
 	printf("btokTest: %s\n", (code = btokTest()) ? "OK" : "Err"), ret |= !code;
+	code = btokBench(), ret |= !code;
 	printf("dstuTest: %s\n", (code = dstuTest()) ? "OK" : "Err"), ret |= !code;
+	code = dstuBench(), ret |= !code;
 	printf("g12sTest: %s\n", (code = g12sTest()) ? "OK" : "Err"), ret |= !code;
+	code = g12sBench(), ret |= !code;
 	printf("pfokTest: %s\n", (code = pfokTest()) ? "OK" : "Err"), ret |= !code;
 	printf("stb99Test: %s\n", (code = stb99Test()) ? "OK" : "Err"),
 		ret |= !code;